@@ -12,6 +12,11 @@ if(NOT DEFINED UNIT_TESTS)
 endif()
 message(STATUS "--> UNIT_TESTS: ${UNIT_TESTS}")
 
+if(NOT DEFINED BENCHMARKS)
+    option(BENCHMARKS "Building benchmarks" OFF)
+endif()
+message(STATUS "--> BENCHMARKS: ${BENCHMARKS}")
+
 #
 # Compiler configuration
 #
@@ -44,6 +44,35 @@ static const U8 MAX_REFERENCE_BITMAPS_COUNT = 10U;
 static const U8 MAX_WINDOWS_COUNT = 1U;
 static const U8 MAX_WIDGET_CHILDREN_COUNT = 10U;
 
+// Display constants
+/**
+ * Maximum number of rectangles which are redrawn separately in one frame (see @c psc::DamageRegion).
+ */
+static const U8 MAX_DAMAGE_RECTS = 4U;
+
+/**
+ * Maximum number of textures in the @c psc::TextureCache (every pgl implementation provides 64 textures).
+ */
+static const U16 MAX_TEXTURES_COUNT = 64U;
+
+/**
+ * Default budget of the @c psc::TextureCache for the pixels of the loaded textures in bytes.
+ */
+static const U32 TEXTURE_CACHE_BYTES = 16U * 1024U * 1024U;
+
+/**
+ * Time per frame in milliseconds which the engine spends loading the textures of all bitmaps until they are loaded
+ * (see @c psc::DisplayManager::prewarm), 0: all textures are loaded before the first frame.
+ */
+static const U32 TEXTURE_PREWARM_BUDGET_MS = 5U;
+
+// Database constants
+/**
+ * Number of images of the imgbin whose atlas placeholders are resolved and verified when the database is loaded
+ * (see @c psc::BitmapAccess), the images behind them are resolved at each lookup.
+ */
+static const U16 MAX_IMAGES_COUNT = 512U;
+
 // DataHandler constants
 static const U32 MAX_DYNAMIC_DATA = 40U;
 
@@ -18,7 +18,7 @@ set(DATABASEMOCK_SOURCES
     ${DATABASE_BASE}/src/BitmapAccess.cpp
     ${DATABASE_BASE}/src/FonBinReader.cpp
     ${DATABASE_BASE}/src/PopulusImage.cpp
-    ${DATABASE_BASE}/src/StaticBitmap.cpp
     ${DATABASE_BASE}/src/gen/DDHType.cpp
     ${DATABASE_BASE}/test/DatabaseMock.cpp
+    ${DATABASE_BASE}/test/StaticBitmapMock.cpp
 )
@@ -32,6 +32,8 @@
 #include "ddh_defs.h"
 #include "PSCError.h"
 #include "StaticBitmap.h"
+#include "PopulusImage.h"
+#include "PscLimits.h"
 
 namespace psc
 {
@@ -49,13 +51,66 @@ public:
 
     StaticBitmap getBitmap(BitmapId bitmapId, U16 skin) const;
 
+    /**
+     * Returns the image which contains the pixels of the bitmap (the base image of an atlas placeholder)
+     */
     ResourceBuffer getBitmapBuffer(const StaticBitmap& bitmap) const;
 
+    /**
+     * Returns an id of the image of getBitmapBuffer (image table index + 1), which is shared by all bitmaps of an atlas
+     * 0 is returned if the bitmap has no image
+     */
+    U16 getBitmapImageId(const StaticBitmap& bitmap) const;
+
+    /**
+     * Returns the index of the atlas frame of the bitmap within its image, PopulusImage::NO_ATLAS_FRAME if it uses the whole image
+     */
+    U32 getBitmapAtlasFrame(const StaticBitmap& bitmap) const;
+
+    /**
+     * Returns the frame of an animated image which is shown at the given time (see PopulusImage::getAnimationFrame)
+     * Bitmaps of an atlas are not animated, they use the first frame of the base image
+     */
+    U32 getBitmapAnimationFrame(const StaticBitmap& bitmap, const U32 monotonicTimeMs, U32& remainingMs) const;
+
+    /**
+     * Returns the attributes (size, alpha channel) of the image which belongs to the bitmap
+     * A default constructed ImageAttributes object is returned if the fonbin contains no attributes
+     */
+    ImageAttributes getBitmapAttributes(const StaticBitmap& bitmap) const;
+
 private:
+    /**
+     * An image of the imgbin with its atlas placeholder resolved
+     */
+    struct ResolvedImage
+    {
+        PopulusImage image; ///< the verified image with the pixels (first frame)
+        U32 atlasFrame; ///< PopulusImage::NO_ATLAS_FRAME: the whole image
+        U16 imageIx; ///< table index of image
+        bool valid; ///< false if the base image of an atlas placeholder has no such atlas frame
+    };
+
+    void resolveImages();
+    bool getImageIndex(const StaticBitmap& bitmap, U16& imageIx) const;
+
+    /**
+     * Resolves the atlas placeholder of an image table entry
+     * @return false if the placeholder refers to a missing image, a placeholder, an image which fails the verification
+     * or an atlas frame which the base image doesn't have
+     */
+    bool resolveImage(const U32 imageIx, ResolvedImage& resolved) const;
+
+    /**
+     * Returns the resolved image of the bitmap, false if the bitmap has no (valid) image
+     */
+    bool resolveImage(const StaticBitmap& bitmap, ResolvedImage& resolved) const;
     const BitmapDefinitionType* getBitmapDefinition(BitmapId bitmapId, U16 skin) const;
     const DDHType* m_ddh;
     FonBinReader m_fonbin;
     PSCError m_error;
+    ResolvedImage m_images[MAX_IMAGES_COUNT]; ///< the first images of the image table, the others are resolved at each lookup
+    U32 m_imageCount; ///< resolved images in m_images, 0 if the imgbin could not be read
 };
 
 } // namespace database
@@ -48,6 +48,11 @@ namespace psc
 
         StaticBitmap getBitmap(BitmapId bitmapId) const;
 
+        /**
+         * Returns the bitmap of the given skin (the bitmap of the default skin if the skin doesn't override it)
+         */
+        StaticBitmap getBitmap(BitmapId bitmapId, const U16 skin) const;
+
         void setSkin(const U8 skinId);
 
     private:
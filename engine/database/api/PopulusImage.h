@@ -37,6 +37,7 @@ namespace PopulusImageTypes
 {
     struct ImgHeader;
     struct FrameHeader;
+    struct PlaceholderImg;
 }
 
 class PopulusImage
@@ -60,16 +61,106 @@ public:
         PIXEL_FORMAT_BGRA8888 = PIXEL_SIZE_4BYTE + 1
     };
 
-    explicit PopulusImage(const ResourceBuffer& buf);
+    /**
+     * Encodings of the pixel data which can be loaded (see PopulusImageTypes::Encoding and PGLEncoding)
+     */
+    enum Encoding
+    {
+        ENCODING_RAW = 0,
+        ENCODING_RLE = 1,
+        ENCODING_PALETTE = 2, ///< one byte per pixel: the index of a palette color (the pixel format is the format of the colors)
+        ENCODING_FLZ = 4,
+        ENCODING_RLE2 = 16 ///< RLE with the bytes of each pixel reversed
+    };
+
+    static const U32 NO_ATLAS_FRAME = 0xFFFFFFFFU; ///< the whole image is used
+    static const U32 MAX_PALETTE_SIZE = 256U; ///< colors of ENCODING_PALETTE images
+
+    /**
+     * A sub-rectangle of an atlas image in pixels
+     */
+    struct AtlasFrame
+    {
+        U16 x;
+        U16 y;
+        U16 width;
+        U16 height;
+    };
+
+    /**
+     * An empty image without pixels
+     */
+    PopulusImage();
+
+    /**
+     * @param frame the frame of a multi-frame image whose pixels are returned (all frames are verified)
+     */
+    explicit PopulusImage(const ResourceBuffer& buf, const U32 frame = 0U);
 
     U32 getWidth() const;
     U32 getHeight() const;
     PixelFormat getPixelFormat() const;
     const void* getPixelData() const;
+    Encoding getEncoding() const;
+
+    /**
+     * Returns the size of the (encoded) pixel data in bytes
+     */
+    U32 getPixelDataSize() const;
+
+    /**
+     * Returns the number of palette colors of an ENCODING_PALETTE image, 0 for other images
+     */
+    U32 getPaletteSize() const;
+
+    /**
+     * Returns the palette colors (in the pixel format of the image), NULL if the image has no palette
+     */
+    const void* getPalette() const;
+
+    /**
+     * Returns the number of frames of the image (more than 1 for animations)
+     */
+    U32 getFrameCount() const;
+
+    /**
+     * Returns the frame of an animation which is shown at the given time, the animation is repeated endlessly
+     * (0 for single-frame images)
+     * @param timeMs time since the start of the animation in milliseconds
+     * @param remainingMs receives the time until the next frame is shown, 0 if the frame doesn't change
+     */
+    U32 getAnimationFrame(const U32 timeMs, U32& remainingMs) const;
+
+    /**
+     * Returns the number of sub-images of an atlas image, 0 for other images
+     */
+    U32 getAtlasFrameCount() const;
+
+    /**
+     * Returns the sub-rectangle of an atlas image
+     * @return false if the image has no atlas frame with the given index
+     */
+    bool getAtlasFrame(const U32 index, AtlasFrame& frame) const;
+
+    /**
+     * Returns true if the buffer contains an atlas placeholder, which refers to a frame of another image (it has no pixel data)
+     */
+    bool isAtlasPlaceholder() const;
+
+    /**
+     * Returns the index of the image which contains the pixels of an atlas placeholder (image data table of the fonbin)
+     */
+    U32 getBaseImageId() const;
+
+    /**
+     * Returns the index of the atlas frame of an atlas placeholder within the base image
+     */
+    U32 getAtlasFrameId() const;
 
 private:
     const PopulusImageTypes::ImgHeader* m_image;
     const PopulusImageTypes::FrameHeader* m_frame;
+    const PopulusImageTypes::PlaceholderImg* m_placeholder;
 };
 
 } // namespace psc
@@ -28,6 +28,7 @@
 ******************************************************************************/
 
 #include "ResourceBuffer.h"
+#include "ImageAttributes.h"
 #include "BitmapStateDefinitionType.h"
 
 namespace psc
@@ -45,16 +46,42 @@ public:
     StaticBitmap(const BitmapAccess& db, const BitmapStateDefinitionType* const bmp);
 
     ResourceBuffer getData() const;
+    ImageAttributes getAttributes() const;
     U16 getId() const;
 
+    /**
+     * Returns the id of the image which contains the pixels, bitmaps of the same atlas return the same id (0: no image)
+     */
+    U16 getImageId() const;
+
+    /**
+     * Returns the part of the image which belongs to the bitmap (PopulusImage::NO_ATLAS_FRAME: the whole image)
+     */
+    U32 getAtlasFrame() const;
+
+    /**
+     * Returns the frame of an animated bitmap which is shown at the given time (0 for bitmaps without animation)
+     * All animations run in the same time base, so every field which shows the bitmap selects the same frame.
+     * @param remainingMs receives the time until the next frame is shown, 0 if the frame doesn't change
+     */
+    U32 getAnimationFrame(const U32 monotonicTimeMs, U32& remainingMs) const;
+
+    /**
+     * The frame of the image which is drawn / verified (see getAnimationFrame)
+     */
+    U32 getFrame() const;
+    void setFrame(const U32 frame);
+
 private:
     const BitmapAccess& m_db;
     const BitmapStateDefinitionType* m_bmp;
+    U32 m_frame;
 };
 
 inline StaticBitmap::StaticBitmap(const BitmapAccess& db, const BitmapStateDefinitionType* const bmp)
 : m_db(db)
 , m_bmp(bmp)
+, m_frame(0U)
 {
 }
 
@@ -63,6 +90,16 @@ inline U16 StaticBitmap::getId() const
     return m_bmp ? m_bmp->GetStateBitmapId() : 0;
 }
 
+inline U32 StaticBitmap::getFrame() const
+{
+    return m_frame;
+}
+
+inline void StaticBitmap::setFrame(const U32 frame)
+{
+    m_frame = frame;
+}
+
 }
 
 #endif //RESOURCE_STATIC_BITMAP_H
@@ -30,6 +30,8 @@
 #include "BitmapDefinitionType.h"
 #include "BitmapStateDefinitionType.h"
 #include "SkinType.h"
+#include "PopulusImage.h"
+#include "pgw.h"
 
 namespace psc
 {
@@ -40,6 +42,7 @@ BitmapAccess::BitmapAccess(const DDHType* ddh, const ResourceBuffer& imgbin)
 : m_ddh(ddh)
 , m_fonbin()
 , m_error(PSC_NO_ERROR)
+, m_imageCount(0U)
 {
     if (ddh)
     {
@@ -48,6 +51,10 @@ BitmapAccess::BitmapAccess(const DDHType* ddh, const ResourceBuffer& imgbin)
         {
             m_error = PSC_DB_IMGBIN_VERSION_MISMATCH;
         }
+        else
+        {
+            resolveImages();
+        }
     }
     else
     {
@@ -97,25 +104,138 @@ const BitmapDefinitionType *BitmapAccess::getBitmapDefinition(BitmapId bitmapId,
     return result;
 }
 
-ResourceBuffer BitmapAccess::getBitmapBuffer(const StaticBitmap& bmp) const
+bool BitmapAccess::getImageIndex(const StaticBitmap& bmp, U16& imageIx) const
 {
-    ResourceBuffer image;
     const BitmapStateDefinitionType* pStateBitmap = bmp.m_bmp;
     if (pStateBitmap)
     {
         const FonBinReader::StateBitmapTable stateTable = m_fonbin.getStateBitmapTable();
-        const FonBinReader::ImageDataTable imageDataTable = m_fonbin.getImageDataTable();
         const U16 stateBitmapIx = pStateBitmap->GetStateBitmapId() - 1;
         ASSERT(stateBitmapIx < stateTable.GetSize());
-        const U16 bitmapIx = stateTable.GetImageIndex(stateBitmapIx);
-        ASSERT(bitmapIx < imageDataTable.GetSize());
+        imageIx = stateTable.GetImageIndex(stateBitmapIx);
+        ASSERT(imageIx < m_fonbin.getImageDataTable().GetSize());
+    }
+    return (NULL != pStateBitmap);
+}
+
+void BitmapAccess::resolveImages()
+{
+    // the first images are verified once, the bitmaps only look up their table index
+    const U32 count = m_fonbin.getImageDataTable().GetSize();
+    m_imageCount = (count < MAX_IMAGES_COUNT) ? count : MAX_IMAGES_COUNT;
+    for (U32 i = 0U; i < m_imageCount; ++i)
+    {
+        static_cast<void>(resolveImage(i, m_images[i]));
+    }
+}
+
+bool BitmapAccess::resolveImage(const U32 imageIx, ResolvedImage& resolved) const
+{
+    const FonBinReader::ImageDataTable table = m_fonbin.getImageDataTable();
+    resolved.imageIx = static_cast<U16>(imageIx);
+    resolved.atlasFrame = PopulusImage::NO_ATLAS_FRAME;
+    resolved.valid = true;
+    U32 size = 0U;
+    const U8* buf = table.ReadImage(imageIx, size);
+    resolved.image = PopulusImage(ResourceBuffer(buf, size));
+    if (resolved.image.isAtlasPlaceholder())
+    {
+        // an atlas placeholder refers to a part of another image in the same table
+        const U32 baseIx = resolved.image.getBaseImageId();
+        const U32 atlasFrame = resolved.image.getAtlasFrameId();
+        PopulusImage base;
+        if (baseIx < table.GetSize())
+        {
+            buf = table.ReadImage(baseIx, size);
+            base = PopulusImage(ResourceBuffer(buf, size));
+        }
+        // a base image which is a placeholder itself or fails the verification has no atlas frames
+        PopulusImage::AtlasFrame frame = { 0U, 0U, 0U, 0U };
+        resolved.valid = base.getAtlasFrame(atlasFrame, frame);
+        if (resolved.valid)
+        {
+            resolved.imageIx = static_cast<U16>(baseIx);
+            resolved.atlasFrame = atlasFrame;
+            resolved.image = base;
+        }
+        else
+        {
+            // the bitmap has no image: it is not drawn and its verification fails
+            pgwError(PSC_DB_ERROR, "BitmapAccess: atlas placeholder without a valid base image frame");
+        }
+    }
+    return resolved.valid;
+}
+
+bool BitmapAccess::resolveImage(const StaticBitmap& bmp, ResolvedImage& resolved) const
+{
+    U16 imageIx = 0U;
+    bool found = getImageIndex(bmp, imageIx);
+    if (found && (imageIx < m_imageCount))
+    {
+        resolved = m_images[imageIx];
+        found = resolved.valid;
+    }
+    else if (found)
+    {
+        // beyond the resolved images: resolved and verified at each lookup
+        found = (imageIx < m_fonbin.getImageDataTable().GetSize()) && resolveImage(imageIx, resolved);
+    }
+    else
+    {
+        // the bitmap has no state
+    }
+    return found;
+}
+
+ResourceBuffer BitmapAccess::getBitmapBuffer(const StaticBitmap& bmp) const
+{
+    ResourceBuffer image;
+    ResolvedImage resolved;
+    if (resolveImage(bmp, resolved))
+    {
         U32 imageBufSize = 0U;
-        const U8* imageBuf = imageDataTable.ReadImage(static_cast<U32>(bitmapIx), imageBufSize);
+        const U8* imageBuf = m_fonbin.getImageDataTable().ReadImage(static_cast<U32>(resolved.imageIx), imageBufSize);
         image = ResourceBuffer(imageBuf, imageBufSize);
     }
     return image;
 }
 
+U16 BitmapAccess::getBitmapImageId(const StaticBitmap& bmp) const
+{
+    ResolvedImage resolved;
+    return resolveImage(bmp, resolved) ? static_cast<U16>(resolved.imageIx + 1U) : 0U;
+}
+
+U32 BitmapAccess::getBitmapAtlasFrame(const StaticBitmap& bmp) const
+{
+    ResolvedImage resolved;
+    return resolveImage(bmp, resolved) ? resolved.atlasFrame : PopulusImage::NO_ATLAS_FRAME;
+}
+
+U32 BitmapAccess::getBitmapAnimationFrame(const StaticBitmap& bmp, const U32 monotonicTimeMs, U32& remainingMs) const
+{
+    U32 frame = 0U;
+    remainingMs = 0U;
+    ResolvedImage resolved;
+    if (resolveImage(bmp, resolved) && (resolved.atlasFrame == PopulusImage::NO_ATLAS_FRAME))
+    {
+        frame = resolved.image.getAnimationFrame(monotonicTimeMs, remainingMs);
+    }
+    return frame;
+}
+
+ImageAttributes BitmapAccess::getBitmapAttributes(const StaticBitmap& bmp) const
+{
+    ImageAttributes attributes = ImageAttributes();
+    U16 bitmapIx = 0U;
+    if (getImageIndex(bmp, bitmapIx))
+    {
+        attributes = m_fonbin.getImageDataTable().GetAttributes(bitmapIx);
+    }
+    return attributes;
+}
+
 PSCError BitmapAccess::getError() const
 {
     PSCError ret = m_error;
@@ -55,4 +55,10 @@ StaticBitmap Database::getBitmap(BitmapId id) const
     return m_bitmapAccess.getBitmap(id, 0U);
 }
 
+StaticBitmap Database::getBitmap(BitmapId id, const U16 skin) const
+{
+    ASSERT(m_ddh != NULL);
+    return m_bitmapAccess.getBitmap(id, skin);
+}
+
 }
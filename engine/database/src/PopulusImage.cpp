@@ -35,10 +35,38 @@ namespace psc
 
 using namespace PopulusImageTypes;
 P_STATIC_ASSERT(sizeof(GUID) < sizeof(ImgHeader), "");
+P_STATIC_ASSERT(sizeof(PlaceholderImg) <= sizeof(ImgHeader) + sizeof(FrameHeader), "placeholders are smaller than images");
+
+const U32 PopulusImage::NO_ATLAS_FRAME;
+const U32 PopulusImage::MAX_PALETTE_SIZE;
 
 namespace
 {
-    const FrameHeader* verifyFrame(const FrameHeader* frame, const size_t size)
+    const AtlasFrameDescription* getAtlasFrames(const FrameHeader* frame)
+    {
+        return reinterpret_cast<const AtlasFrameDescription*>(reinterpret_cast<const U8*>(frame) + sizeof(FrameHeader));
+    }
+
+    // Bytes of one pixel or palette color
+    U32 getColorSize(const U8 pixelformat)
+    {
+        U32 size = 4U;
+        if (pixelformat == PopulusImage::PIXEL_FORMAT_RGB565)
+        {
+            size = 2U;
+        }
+        else if ((pixelformat == PopulusImage::PIXEL_FORMAT_RGB888) || (pixelformat == PopulusImage::PIXEL_FORMAT_BGR888))
+        {
+            size = 3U;
+        }
+        else
+        {
+            // 32 bit formats
+        }
+        return size;
+    }
+
+    const FrameHeader* verifyFrame(const ImgHeader* image, const FrameHeader* frame, const size_t size)
     {
         bool verified = true;
         switch (frame->pixelformat)
@@ -54,55 +82,164 @@ namespace
             verified = false;
             break;
         }
-        if (frame->atlasFrames)
+        if (frame->atlasFrames > (size - sizeof(FrameHeader)) / sizeof(AtlasFrameDescription))
         {
-            pgwError(PSC_DB_ERROR, "PopulusImage: atlas frames are not supported");
+            pgwError(PSC_DB_ERROR, "PopulusImage: atlas frames out of bounds");
             verified = false;
         }
-        if (frame->encoding != ENCODING_RAW)
+        else
         {
-            pgwError(PSC_DB_ERROR, "PopulusImage: raw encoding is required");
+            const AtlasFrameDescription* atlas = getAtlasFrames(frame);
+            for (U32 i = 0U; i < frame->atlasFrames; ++i)
+            {
+                if ((atlas[i].width == 0U) || (atlas[i].height == 0U)
+                    || ((static_cast<U32>(atlas[i].posX) + atlas[i].width) > image->width)
+                    || ((static_cast<U32>(atlas[i].posY) + atlas[i].height) > image->height))
+                {
+                    pgwError(PSC_DB_ERROR, "PopulusImage: atlas frame outside of the image");
+                    verified = false;
+                }
+            }
+            // the pixels follow the frame header and the atlas frames
+            if ((sizeof(FrameHeader) + static_cast<size_t>(frame->atlasFrames) * sizeof(AtlasFrameDescription) + frame->imageDataSize) > size)
+            {
+                pgwError(PSC_DB_ERROR, "PopulusImage: size out of bounds");
+                verified = false;
+            }
+        }
+        switch (frame->encoding)
+        {
+        case PopulusImage::ENCODING_RAW:
+            break;
+        case PopulusImage::ENCODING_PALETTE:
+            // one byte per pixel, the pixel format is the format of the palette colors
+            if (frame->pixelformat == PopulusImage::PIXEL_FORMAT_BGR888)
+            {
+                pgwError(PSC_DB_ERROR, "PopulusImage: unsupported palette format");
+                verified = false;
+            }
+            if (frame->pitch != image->width)
+            {
+                pgwError(PSC_DB_ERROR, "PopulusImage: encoded images require pitch == width");
+                verified = false;
+            }
+            break;
+        case PopulusImage::ENCODING_RLE:
+        case PopulusImage::ENCODING_RLE2:
+        case PopulusImage::ENCODING_FLZ:
+            // the encoded rows are not padded
+            if (frame->pitch != image->width)
+            {
+                pgwError(PSC_DB_ERROR, "PopulusImage: encoded images require pitch == width");
+                verified = false;
+            }
+            break;
+        default:
+            pgwError(PSC_DB_ERROR, "PopulusImage: unsupported encoding");
             verified = false;
+            break;
         }
-        if (frame->imageDataSize > size)
+        if (((frame->paletteSize > 0U) != (frame->encoding == PopulusImage::ENCODING_PALETTE)) || (frame->paletteSize > PopulusImage::MAX_PALETTE_SIZE))
         {
-            pgwError(PSC_DB_ERROR, "PopulusImage: size out of bounds");
+            pgwError(PSC_DB_ERROR, "PopulusImage: bad palette size");
             verified = false;
         }
-        if (frame->paletteSize > 0)
+        else if (verified && (frame->paletteSize > 0U)
+            && ((static_cast<size_t>(frame->atlasFrames) * sizeof(AtlasFrameDescription) + frame->paletteSize * getColorSize(frame->pixelformat)
+                + frame->nOfPalettePadBytes + frame->imageDataSize) > (size - sizeof(FrameHeader))))
         {
-            pgwError(PSC_DB_ERROR, "PopulusImage: palette images are not supported");
+            pgwError(PSC_DB_ERROR, "PopulusImage: palette out of bounds");
             verified = false;
         }
+        else
+        {
+            // no palette or palette and pixels are inside of the buffer
+        }
         return verified ? frame : NULL;
     }
+
+    // Bytes of a frame from its header up to the next frame
+    size_t getFrameSize(const FrameHeader* frame)
+    {
+        size_t size = sizeof(FrameHeader) + static_cast<size_t>(frame->atlasFrames) * sizeof(AtlasFrameDescription)
+            + frame->imageDataSize + frame->nOfPadBytes;
+        if (frame->paletteSize > 0U)
+        {
+            size += frame->paletteSize * getColorSize(frame->pixelformat) + frame->nOfPalettePadBytes;
+        }
+        return size;
+    }
+
+    const FrameHeader* getNextFrame(const FrameHeader* frame)
+    {
+        return reinterpret_cast<const FrameHeader*>(reinterpret_cast<const U8*>(frame) + getFrameSize(frame));
+    }
+
+    // Verifies all frames (getAnimationFrame walks through them) and returns the frame with the given index
+    const FrameHeader* verifyFrames(const ImgHeader* image, size_t size, const U32 index)
+    {
+        const FrameHeader* selected = NULL;
+        const FrameHeader* frame = reinterpret_cast<const FrameHeader*>(reinterpret_cast<const U8*>(image) + sizeof(ImgHeader));
+        bool verified = true;
+        for (U32 i = 0U; verified && (i < image->frames); ++i)
+        {
+            verified = (NULL != verifyFrame(image, frame, size));
+            if (verified && (i == index))
+            {
+                selected = frame;
+            }
+            if (verified && ((i + 1U) < image->frames))
+            {
+                // the next frame header has to follow inside of the buffer
+                const size_t frameSize = getFrameSize(frame);
+                if (frameSize > (size - sizeof(FrameHeader)))
+                {
+                    pgwError(PSC_DB_ERROR, "PopulusImage: frame out of bounds");
+                    verified = false;
+                }
+                else
+                {
+                    frame = getNextFrame(frame);
+                    size -= frameSize;
+                }
+            }
+        }
+        return verified ? selected : NULL;
+    }
+}
+
+PopulusImage::PopulusImage()
+    : m_image(NULL)
+    , m_frame(NULL)
+    , m_placeholder(NULL)
+{
 }
 
-PopulusImage::PopulusImage(const ResourceBuffer& buf)
+PopulusImage::PopulusImage(const ResourceBuffer& buf, const U32 frame)
     : m_image(NULL)
     , m_frame(NULL)
+    , m_placeholder(NULL)
 {
     const void* data = buf.getData();
     const size_t minimumSize = sizeof(ImgHeader) + sizeof(FrameHeader);
-    if ((NULL != data) && buf.getSize() >= minimumSize)
+    if ((NULL != data) && buf.getSize() >= sizeof(PlaceholderImg))
     {
         // detect image type by GUID in image header
         const GUID* guid = static_cast<const GUID*>(data);
-        if (memcmp(guid, &simpleGuid, sizeof(GUID)) == 0)
+        if ((buf.getSize() >= minimumSize) && (memcmp(guid, &simpleGuid, sizeof(GUID)) == 0))
         {
             m_image = static_cast<const ImgHeader*>(data);
-            if (m_image->frames != 1U)
+            if (frame >= m_image->frames)
             {
-                pgwError(PSC_DB_ERROR, "PopulusImage: multiframe images are not supported on this platform");
+                pgwError(PSC_DB_ERROR, "PopulusImage: frame out of range");
             }
             else
             {
-                const void* frameData = static_cast<const U8*>(data) + sizeof(ImgHeader);
-                m_frame = verifyFrame(static_cast<const FrameHeader*>(frameData), buf.getSize() - sizeof(ImgHeader));
-                if (NULL == m_frame)
-                {
-                    m_image = NULL;
-                }
+                m_frame = verifyFrames(m_image, buf.getSize() - sizeof(ImgHeader), frame);
+            }
+            if (NULL == m_frame)
+            {
+                m_image = NULL;
             }
         }
         else if (memcmp(guid, &placeholderGuid, sizeof(GUID)) == 0)
@@ -111,7 +248,13 @@ PopulusImage::PopulusImage(const ResourceBuffer& buf)
         }
         else if (memcmp(guid, &atlasPlaceholderGuid, sizeof(GUID)) == 0)
         {
-            pgwError(PSC_DB_ERROR, "PopulusImage: atlas images are not supported on this platform");
+            // the pixels are in a frame of the base image, which is resolved by BitmapAccess
+            m_placeholder = static_cast<const PlaceholderImg*>(data);
+            if (m_placeholder->frame != 0U)
+            {
+                pgwError(PSC_DB_ERROR, "PopulusImage: multiframe images are not supported on this platform");
+                m_placeholder = NULL;
+            }
         }
         else
         {
@@ -141,12 +284,116 @@ PopulusImage::PixelFormat PopulusImage::getPixelFormat() const
 
 const void* PopulusImage::getPixelData() const
 {
-    const void* buf = m_frame;
+    const U8* buf = static_cast<const U8*>(getPalette());
     if (NULL != buf)
     {
-        buf = static_cast<const U8*>(buf)+sizeof(FrameHeader);
+        buf += m_frame->paletteSize * getColorSize(m_frame->pixelformat) + ((m_frame->paletteSize > 0U) ? m_frame->nOfPalettePadBytes : 0U);
+    }
+    else if (NULL != m_frame)
+    {
+        buf = reinterpret_cast<const U8*>(m_frame) + sizeof(FrameHeader) + m_frame->atlasFrames * sizeof(AtlasFrameDescription);
+    }
+    else
+    {
+        // not a populus image
     }
     return buf;
 }
 
+U32 PopulusImage::getPaletteSize() const
+{
+    return (NULL != m_frame) ? m_frame->paletteSize : 0U;
+}
+
+const void* PopulusImage::getPalette() const
+{
+    const void* buf = NULL;
+    if ((NULL != m_frame) && (m_frame->paletteSize > 0U))
+    {
+        buf = reinterpret_cast<const U8*>(m_frame) + sizeof(FrameHeader) + m_frame->atlasFrames * sizeof(AtlasFrameDescription);
+    }
+    return buf;
+}
+
+PopulusImage::Encoding PopulusImage::getEncoding() const
+{
+    return (NULL != m_frame) ? static_cast<Encoding>(m_frame->encoding) : ENCODING_RAW;
+}
+
+U32 PopulusImage::getPixelDataSize() const
+{
+    return (NULL != m_frame) ? m_frame->imageDataSize : 0U;
+}
+
+U32 PopulusImage::getFrameCount() const
+{
+    return (NULL != m_image) ? m_image->frames : 0U;
+}
+
+U32 PopulusImage::getAnimationFrame(const U32 timeMs, U32& remainingMs) const
+{
+    U32 index = 0U;
+    remainingMs = 0U;
+    const U32 frames = getFrameCount();
+    if (frames > 1U)
+    {
+        const FrameHeader* first = reinterpret_cast<const FrameHeader*>(reinterpret_cast<const U8*>(m_image) + sizeof(ImgHeader));
+        const FrameHeader* frame = first;
+        U32 total = frame->duration;
+        for (U32 i = 1U; i < frames; ++i)
+        {
+            frame = getNextFrame(frame);
+            total += frame->duration;
+        }
+        if (total > 0U)
+        {
+            // frames with a duration of 0 are skipped, t < total ensures that the loop stops at the last frame
+            U32 t = timeMs % total;
+            frame = first;
+            while (t >= frame->duration)
+            {
+                t -= frame->duration;
+                frame = getNextFrame(frame);
+                ++index;
+            }
+            remainingMs = frame->duration - t;
+        }
+    }
+    return index;
+}
+
+U32 PopulusImage::getAtlasFrameCount() const
+{
+    return (NULL != m_frame) ? m_frame->atlasFrames : 0U;
+}
+
+bool PopulusImage::getAtlasFrame(const U32 index, AtlasFrame& frame) const
+{
+    const bool valid = (index < getAtlasFrameCount());
+    if (valid)
+    {
+        const AtlasFrameDescription& atlas = getAtlasFrames(m_frame)[index];
+        frame.x = atlas.posX;
+        frame.y = atlas.posY;
+        frame.width = atlas.width;
+        frame.height = atlas.height;
+    }
+    return valid;
+}
+
+bool PopulusImage::isAtlasPlaceholder() const
+{
+    return (NULL != m_placeholder);
+}
+
+U32 PopulusImage::getBaseImageId() const
+{
+    return (NULL != m_placeholder) ? m_placeholder->baseImageID : 0U;
+}
+
+U32 PopulusImage::getAtlasFrameId() const
+{
+    return (NULL != m_placeholder) ? m_placeholder->metaFrameId : 0U;
+}
+
 }
@@ -37,12 +37,14 @@ namespace psc
     *
     *  ImgHeader
     *  FrameHeader, frame 1
+    *  AtlasFrameDescription * FrameHeader::atlasFrames (if any), frame 1
     *  Palette data (if any), frame 1
     *  Pad bytes, frame 1
     *  Image data, frame 1
     *  Pad bytes, frame 1
     *  ...
     *  FrameHeader, frame n
+    *  AtlasFrameDescription * FrameHeader::atlasFrames (if any), frame n
     *  Palette data (if any), frame n
     *  Pad bytes, frame n
     *  Image data, frame n
@@ -134,14 +136,14 @@ namespace PopulusImageTypes
         U8 encoding; ///< The encoding of the frame.
         U8 reserved1; ///< Reserved.
         U16 paletteSize; ///< in number of colors not bytes
-        U8 reserved2; ///< Reserved.
-        U8 reserved3; ///< Reserved.
+        U16 duration; ///< Display time of the frame in milliseconds (animations, ImgHeader::frames > 1)
 
         U32 atlasFrames; ///< Number of atlas frames in this frame.
     };
 
     /**
-    * Atlas frame information.
+    * Atlas frame information: the part of the frame which contains the image of an atlas placeholder
+    * (PlaceholderImg::metaFrameId is the index of the description).
     */
     struct AtlasFrameDescription
     {
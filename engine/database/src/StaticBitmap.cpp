@@ -35,4 +35,24 @@ ResourceBuffer StaticBitmap::getData() const
     return m_db.getBitmapBuffer(*this);
 }
 
+ImageAttributes StaticBitmap::getAttributes() const
+{
+    return m_db.getBitmapAttributes(*this);
+}
+
+U16 StaticBitmap::getImageId() const
+{
+    return m_db.getBitmapImageId(*this);
+}
+
+U32 StaticBitmap::getAtlasFrame() const
+{
+    return m_db.getBitmapAtlasFrame(*this);
+}
+
+U32 StaticBitmap::getAnimationFrame(const U32 monotonicTimeMs, U32& remainingMs) const
+{
+    return m_db.getBitmapAnimationFrame(*this, monotonicTimeMs, remainingMs);
+}
+
 }
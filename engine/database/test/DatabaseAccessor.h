@@ -48,12 +48,24 @@ public:
 
     BitmapId getRequestedBitmapId() const;
 
+    /**
+     * Makes every bitmap of the mock an animation with @c frames frames
+     * which are shown for @c frameDurationMs each.
+     */
+    void setAnimation(U32 frames, U32 frameDurationMs);
+
+    U32 getAnimationFrames() const;
+
+    U32 getFrameDuration() const;
+
     ~DatabaseAccessor();
 
 private:
     DatabaseAccessor();
 
     BitmapId m_bitmapId;
+    U32 m_animationFrames;
+    U32 m_frameDurationMs;
 };
 
 inline DatabaseAccessor::DatabaseAccessor()
@@ -67,6 +79,8 @@ inline DatabaseAccessor::~DatabaseAccessor()
 inline void DatabaseAccessor::toDefault()
 {
     m_bitmapId = 0U;
+    m_animationFrames = 1U;
+    m_frameDurationMs = 0U;
 }
 
 inline void DatabaseAccessor::setRequestedBitmapId(BitmapId id)
@@ -79,6 +93,22 @@ inline BitmapId DatabaseAccessor::getRequestedBitmapId() const
     return m_bitmapId;
 }
 
+inline void DatabaseAccessor::setAnimation(U32 frames, U32 frameDurationMs)
+{
+    m_animationFrames = frames;
+    m_frameDurationMs = frameDurationMs;
+}
+
+inline U32 DatabaseAccessor::getAnimationFrames() const
+{
+    return m_animationFrames;
+}
+
+inline U32 DatabaseAccessor::getFrameDuration() const
+{
+    return m_frameDurationMs;
+}
+
 } // namespace ddh
 
 #endif // POPULUSSC_DATABASEACCESSOR_H
@@ -47,4 +47,10 @@ StaticBitmap Database::getBitmap(BitmapId id) const
     return StaticBitmap(m_bitmapAccess, NULL);
 }
 
+StaticBitmap Database::getBitmap(BitmapId id, const U16 skin) const
+{
+    static_cast<void>(skin);
+    return getBitmap(id);
+}
+
 } // namespace ddh
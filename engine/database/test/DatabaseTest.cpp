@@ -32,6 +32,7 @@
 #include "Database.h"
 #include "ResourceBuffer.h"
 #include "PopulusImage.h"
+#include "PopulusImageTypes.h"
 #include "DDHType.h"
 #include "FUDatabaseType.h"
 #include "FUClassType.h"
@@ -126,6 +127,38 @@ TEST_F(BitmapAccessTest, getBitmap)
     }
 }
 
+TEST_F(BitmapAccessTest, invalidAtlasPlaceholders)
+{
+    const DDHType* ddh = static_cast<const DDHType*>(m_ddhbin.getData());
+    BitmapAccess access(ddh, m_imgbin);
+    const StaticBitmap bmp = access.getBitmap(1, 0);
+    const StaticBitmap other = access.getBitmap(2, 0);
+    ASSERT_GT(bmp.getImageId(), 0U);
+    ASSERT_GT(other.getImageId(), 0U);
+    ASSERT_NE(bmp.getImageId(), other.getImageId());
+    const size_t offset = static_cast<const char*>(bmp.getData().getData()) - static_cast<const char*>(m_imgbin.getData());
+
+    // the image of bitmap 1 is replaced by a placeholder which refers to: itself (a placeholder), an image without
+    // atlas frames and a missing image
+    const U32 baseImages[] = { bmp.getImageId() - 1U, other.getImageId() - 1U, 0xffffU };
+    for (size_t i = 0U; i < sizeof(baseImages) / sizeof(baseImages[0]); ++i)
+    {
+        std::string data(static_cast<const char*>(m_imgbin.getData()), m_imgbin.getSize());
+        PopulusImageTypes::PlaceholderImg placeholder = PopulusImageTypes::PlaceholderImg();
+        placeholder.guid = PopulusImageTypes::atlasPlaceholderGuid;
+        placeholder.baseImageID = baseImages[i];
+        placeholder.metaFrameId = 0U;
+        memcpy(&data[offset], &placeholder, sizeof(placeholder));
+        BitmapAccess broken(ddh, ResourceBuffer(data.c_str(), data.size()));
+        EXPECT_EQ(PSC_NO_ERROR, broken.getError());
+        // the bitmap has no image, the others are not affected
+        const StaticBitmap resolved = broken.getBitmap(1, 0);
+        EXPECT_EQ(0U, resolved.getImageId()) << i;
+        EXPECT_EQ(0U, resolved.getData().getSize()) << i;
+        EXPECT_EQ(PopulusImage::NO_ATLAS_FRAME, resolved.getAtlasFrame()) << i;
+        EXPECT_EQ(other.getImageId(), broken.getBitmap(2, 0).getImageId()) << i;
+    }
+}
 
 TEST_F(DatabaseTest, Database)
 {
@@ -176,6 +209,20 @@ TEST_F(DatabaseTest, getBitmap)
     EXPECT_TRUE(pixelData != NULL);
 }
 
+TEST_F(DatabaseTest, getBitmapAttributes)
+{
+    Database db(m_ddhbin, m_imgbin);
+    const ImageAttributes attr = db.getBitmap(1).getAttributes();
+    EXPECT_EQ(102u, attr.width);
+    EXPECT_EQ(68u, attr.height);
+    EXPECT_TRUE(attr.hasAlpha);
+
+    const ImageAttributes none = db.getBitmap(0).getAttributes();
+    EXPECT_EQ(0u, none.width);
+    EXPECT_EQ(0u, none.height);
+    EXPECT_FALSE(none.hasAlpha);
+}
+
 TEST_F(DatabaseTest, pageDatabase)
 {
     Database db(m_ddhbin, m_imgbin);
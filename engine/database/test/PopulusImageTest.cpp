@@ -28,6 +28,8 @@
 #include "PopulusImage.h"
 #include "PopulusImageTypes.h"
 
+#include <cstring>
+
 using psc::PopulusImage;
 using psc::ResourceBuffer;
 using namespace psc::PopulusImageTypes;
@@ -95,31 +97,112 @@ TEST(PopulusImageTest, placeholder)
 
 TEST(PopulusImageTest, atlas)
 {
-    Image data = {0};
-    data.img.guid = atlasPlaceholderGuid;
+    PlaceholderImg data = {0};
+    data.guid = atlasPlaceholderGuid;
+    data.baseImageID = 3;
+    data.metaFrameId = 5;
     ResourceBuffer buf(&data, sizeof(data));
     g_lastErrorMsg = "";
     PopulusImage img(buf);
-    EXPECT_EQ("PopulusImage: atlas images are not supported on this platform", g_lastErrorMsg);
+    EXPECT_EQ("", g_lastErrorMsg);
+    EXPECT_TRUE(img.isAtlasPlaceholder());
+    EXPECT_EQ(3u, img.getBaseImageId());
+    EXPECT_EQ(5u, img.getAtlasFrameId());
+    // the pixels are in the base image
     EXPECT_EQ(0u, img.getHeight());
     EXPECT_EQ(0u, img.getWidth());
     EXPECT_EQ(NULL, img.getPixelData());
     EXPECT_EQ(PopulusImage::PIXEL_FORMAT_UNKNOWN, img.getPixelFormat());
+
+    data.frame = 1;
+    PopulusImage img2(buf);
+    EXPECT_EQ("PopulusImage: multiframe images are not supported on this platform", g_lastErrorMsg);
+    EXPECT_FALSE(img2.isAtlasPlaceholder());
 }
 
 TEST(PopulusImageTest, multiframe)
 {
-    Image data = {0};
+    // 3 frames with 2x1 BGRA pixels, the second one is skipped by animations
+    struct AnimatedFrame
+    {
+        FrameHeader frame;
+        U32 pixels[2];
+        U8 pad[4];
+    };
+    struct
+    {
+        ImgHeader img;
+        AnimatedFrame frames[3];
+    } data;
+    memset(&data, 0, sizeof(data));
     data.img.guid = simpleGuid;
-    data.img.frames = 2;
+    data.img.frames = 3;
+    data.img.width = 2;
+    data.img.height = 1;
+    const U16 durations[] = { 100, 0, 300 };
+    for (U32 i = 0U; i < 3U; ++i)
+    {
+        data.frames[i].frame.pixelformat = PopulusImage::PIXEL_FORMAT_BGRA8888;
+        data.frames[i].frame.pitch = 2;
+        data.frames[i].frame.imageDataSize = sizeof(data.frames[i].pixels);
+        data.frames[i].frame.nOfPadBytes = sizeof(data.frames[i].pad);
+        data.frames[i].frame.duration = durations[i];
+    }
     ResourceBuffer buf(&data, sizeof(data));
     g_lastErrorMsg = "";
-    PopulusImage img(buf);
-    EXPECT_EQ("PopulusImage: multiframe images are not supported on this platform", g_lastErrorMsg);
-    EXPECT_EQ(0u, img.getHeight());
-    EXPECT_EQ(0u, img.getWidth());
-    EXPECT_EQ(NULL, img.getPixelData());
-    EXPECT_EQ(PopulusImage::PIXEL_FORMAT_UNKNOWN, img.getPixelFormat());
+    PopulusImage img(buf, 2U);
+    EXPECT_EQ("", g_lastErrorMsg);
+    EXPECT_EQ(3u, img.getFrameCount());
+    EXPECT_EQ(2u, img.getWidth());
+    EXPECT_EQ(&data.frames[2].pixels[0], img.getPixelData());
+    EXPECT_EQ(&data.frames[0].pixels[0], PopulusImage(buf).getPixelData());
+
+    U32 remaining = 0U;
+    EXPECT_EQ(0u, img.getAnimationFrame(0U, remaining));
+    EXPECT_EQ(100u, remaining);
+    EXPECT_EQ(2u, img.getAnimationFrame(150U, remaining));
+    EXPECT_EQ(250u, remaining);
+    EXPECT_EQ(0u, img.getAnimationFrame(4U * 400U + 60U, remaining));
+    EXPECT_EQ(40u, remaining);
+
+    // without durations the first frame is shown
+    data.frames[0].frame.duration = 0;
+    data.frames[2].frame.duration = 0;
+    EXPECT_EQ(0u, img.getAnimationFrame(150U, remaining));
+    EXPECT_EQ(0u, remaining);
+
+    PopulusImage outOfRange(buf, 3U);
+    EXPECT_EQ("PopulusImage: frame out of range", g_lastErrorMsg);
+    EXPECT_EQ(NULL, outOfRange.getPixelData());
+    EXPECT_EQ(0u, outOfRange.getFrameCount());
+
+    // the frame after the second one is outside of the buffer
+    g_lastErrorMsg = "";
+    data.frames[1].frame.nOfPadBytes = 64;
+    PopulusImage truncated(buf);
+    EXPECT_EQ("PopulusImage: frame out of bounds", g_lastErrorMsg);
+    EXPECT_EQ(NULL, truncated.getPixelData());
+
+    // the pixels of the last frame exceed the buffer
+    data.frames[1].frame.nOfPadBytes = sizeof(data.frames[1].pad);
+    data.frames[2].frame.imageDataSize = sizeof(data.frames[2].pixels) + sizeof(data.frames[2].pad) + 1U;
+    g_lastErrorMsg = "";
+    PopulusImage lastFrameTooBig(buf, 0U);
+    EXPECT_EQ("PopulusImage: size out of bounds", g_lastErrorMsg);
+    EXPECT_EQ(NULL, lastFrameTooBig.getPixelData());
+
+    data.frames[2].frame.imageDataSize = sizeof(data.frames[2].pixels);
+    data.frames[1].frame.pixelformat = 5; // invalid enum value
+    g_lastErrorMsg = "";
+    PopulusImage invalidFrame(buf);
+    EXPECT_EQ("PopulusImage: unsupported pixel format", g_lastErrorMsg);
+    EXPECT_EQ(0u, invalidFrame.getFrameCount());
+
+    data.img.frames = 0;
+    g_lastErrorMsg = "";
+    PopulusImage noFrames(buf);
+    EXPECT_EQ("PopulusImage: frame out of range", g_lastErrorMsg);
+    EXPECT_EQ(0u, noFrames.getWidth());
 }
 
 TEST(PopulusImageTest, altasFrames)
@@ -127,16 +210,62 @@ TEST(PopulusImageTest, altasFrames)
     Image data = {0};
     data.img.guid = simpleGuid;
     data.img.frames = 1;
+    data.img.width = 8;
+    data.img.height = 4;
     data.frame.atlasFrames = 2;
-    data.frame.pixelformat = 22; // invalid enum value
+    data.frame.encoding = ENCODING_RAW;
+    data.frame.imageDataSize = 8 * 4 * 2;
+    data.frame.pitch = 8 * 2;
+    data.frame.pixelformat = PopulusImage::PIXEL_FORMAT_RGB565;
+    AtlasFrameDescription* atlas = reinterpret_cast<AtlasFrameDescription*>(data.data);
+    const AtlasFrameDescription frames[] = { { 0, 0, 4, 4 }, { 4, 1, 4, 3 } };
+    atlas[0] = frames[0];
+    atlas[1] = frames[1];
     ResourceBuffer buf(&data, sizeof(data));
     g_lastErrorMsg = "";
     PopulusImage img(buf);
-    EXPECT_EQ("PopulusImage: atlas frames are not supported", g_lastErrorMsg);
-    EXPECT_EQ(0u, img.getHeight());
-    EXPECT_EQ(0u, img.getWidth());
+    EXPECT_EQ("", g_lastErrorMsg);
+    EXPECT_EQ(4u, img.getHeight());
+    EXPECT_EQ(8u, img.getWidth());
+    EXPECT_EQ(&data.data[2 * sizeof(AtlasFrameDescription)], img.getPixelData());
+    EXPECT_EQ(PopulusImage::PIXEL_FORMAT_RGB565, img.getPixelFormat());
+    EXPECT_FALSE(img.isAtlasPlaceholder());
+
+    EXPECT_EQ(2u, img.getAtlasFrameCount());
+    PopulusImage::AtlasFrame frame = { 0, 0, 0, 0 };
+    EXPECT_TRUE(img.getAtlasFrame(1, frame));
+    EXPECT_EQ(4u, frame.x);
+    EXPECT_EQ(1u, frame.y);
+    EXPECT_EQ(4u, frame.width);
+    EXPECT_EQ(3u, frame.height);
+    EXPECT_FALSE(img.getAtlasFrame(2, frame));
+    EXPECT_FALSE(img.getAtlasFrame(PopulusImage::NO_ATLAS_FRAME, frame));
+}
+
+TEST(PopulusImageTest, altasFrameOutside)
+{
+    Image data = {0};
+    data.img.guid = simpleGuid;
+    data.img.frames = 1;
+    data.img.width = 8;
+    data.img.height = 4;
+    data.frame.atlasFrames = 1;
+    data.frame.encoding = ENCODING_RAW;
+    data.frame.pixelformat = PopulusImage::PIXEL_FORMAT_RGB565;
+    const AtlasFrameDescription frame = { 4, 1, 5, 3 };
+    *reinterpret_cast<AtlasFrameDescription*>(data.data) = frame;
+    ResourceBuffer buf(&data, sizeof(data));
+    g_lastErrorMsg = "";
+    PopulusImage img(buf);
+    EXPECT_EQ("PopulusImage: atlas frame outside of the image", g_lastErrorMsg);
     EXPECT_EQ(NULL, img.getPixelData());
-    EXPECT_EQ(PopulusImage::PIXEL_FORMAT_UNKNOWN, img.getPixelFormat());
+    EXPECT_EQ(0u, img.getAtlasFrameCount());
+
+    data.frame.atlasFrames = 1000;
+    g_lastErrorMsg = "";
+    PopulusImage img2(buf);
+    EXPECT_EQ("PopulusImage: atlas frames out of bounds", g_lastErrorMsg);
+    EXPECT_EQ(NULL, img2.getPixelData());
 }
 
 TEST(PopulusImageTest, unsupportedEncoding)
@@ -145,18 +274,53 @@ TEST(PopulusImageTest, unsupportedEncoding)
     data.img.guid = simpleGuid;
     data.img.frames = 1;
     data.frame.atlasFrames = 0;
-    data.frame.encoding = ENCODING_PALETTE;
+    data.frame.encoding = ENCODING_DIFF;
     data.frame.pixelformat = 1; // invalid enum value
     ResourceBuffer buf(&data, sizeof(data));
     g_lastErrorMsg = "";
     PopulusImage img(buf);
-    EXPECT_EQ("PopulusImage: raw encoding is required", g_lastErrorMsg);
+    EXPECT_EQ("PopulusImage: unsupported encoding", g_lastErrorMsg);
     EXPECT_EQ(0u, img.getHeight());
     EXPECT_EQ(0u, img.getWidth());
     EXPECT_EQ(NULL, img.getPixelData());
     EXPECT_EQ(PopulusImage::PIXEL_FORMAT_UNKNOWN, img.getPixelFormat());
 }
 
+TEST(PopulusImageTest, encodings)
+{
+    Image data = {0};
+    data.img.guid = simpleGuid;
+    data.img.frames = 1;
+    data.img.width = 8;
+    data.img.height = 4;
+    data.frame.pitch = 8;
+    data.frame.imageDataSize = 20;
+    data.frame.pixelformat = PopulusImage::PIXEL_FORMAT_BGRA8888;
+    const U8 encodings[] = { ENCODING_RLE, ENCODING_RLE2, ENCODING_FLZ };
+    const PopulusImage::Encoding expected[] = { PopulusImage::ENCODING_RLE, PopulusImage::ENCODING_RLE2, PopulusImage::ENCODING_FLZ };
+    for (size_t i = 0U; i < sizeof(encodings); ++i)
+    {
+        data.frame.encoding = encodings[i];
+        ResourceBuffer buf(&data, sizeof(data));
+        g_lastErrorMsg = "";
+        PopulusImage img(buf);
+        EXPECT_EQ("", g_lastErrorMsg);
+        EXPECT_EQ(expected[i], img.getEncoding());
+        EXPECT_EQ(20u, img.getPixelDataSize());
+        EXPECT_EQ(&data.data[0], img.getPixelData());
+    }
+
+    // the decoded rows have no padding
+    data.frame.pitch = 16;
+    ResourceBuffer buf(&data, sizeof(data));
+    g_lastErrorMsg = "";
+    PopulusImage img(buf);
+    EXPECT_EQ("PopulusImage: encoded images require pitch == width", g_lastErrorMsg);
+    EXPECT_EQ(NULL, img.getPixelData());
+    EXPECT_EQ(PopulusImage::ENCODING_RAW, img.getEncoding());
+    EXPECT_EQ(0u, img.getPixelDataSize());
+}
+
 TEST(PopulusImageTest, bad_size)
 {
     Image data = {0};
@@ -174,6 +338,29 @@ TEST(PopulusImageTest, bad_size)
     EXPECT_EQ(0u, img.getWidth());
     EXPECT_EQ(NULL, img.getPixelData());
     EXPECT_EQ(PopulusImage::PIXEL_FORMAT_UNKNOWN, img.getPixelFormat());
+
+    // the frame header and the atlas frames come before the pixels
+    data.frame.pixelformat = PopulusImage::PIXEL_FORMAT_BGRA8888;
+    data.frame.imageDataSize = sizeof(data.data);
+    g_lastErrorMsg = "";
+    EXPECT_TRUE(PopulusImage(buf).getPixelData() != NULL);
+    EXPECT_EQ("", g_lastErrorMsg);
+    data.frame.imageDataSize = sizeof(data.data) + 1U;
+    EXPECT_EQ(NULL, PopulusImage(buf).getPixelData());
+    EXPECT_EQ("PopulusImage: size out of bounds", g_lastErrorMsg);
+    // a 1x1 atlas frame
+    data.img.width = 1;
+    data.img.height = 1;
+    const AtlasFrameDescription atlas = { 0U, 0U, 1U, 1U };
+    memcpy(&data.data[0], &atlas, sizeof(atlas));
+    data.frame.atlasFrames = 1U;
+    data.frame.imageDataSize = sizeof(data.data) - sizeof(atlas);
+    g_lastErrorMsg = "";
+    EXPECT_TRUE(PopulusImage(buf).getPixelData() != NULL);
+    EXPECT_EQ("", g_lastErrorMsg);
+    data.frame.imageDataSize = sizeof(data.data) - sizeof(atlas) + 1U;
+    EXPECT_EQ(NULL, PopulusImage(buf).getPixelData());
+    EXPECT_EQ("PopulusImage: size out of bounds", g_lastErrorMsg);
 }
 
 TEST(PopulusImageTest, bad_palette_size)
@@ -189,13 +376,59 @@ TEST(PopulusImageTest, bad_palette_size)
     ResourceBuffer buf(&data, sizeof(data));
     g_lastErrorMsg = "";
     PopulusImage img(buf);
-    EXPECT_EQ("PopulusImage: palette images are not supported", g_lastErrorMsg);
+    EXPECT_EQ("PopulusImage: bad palette size", g_lastErrorMsg);
     EXPECT_EQ(0u, img.getHeight());
     EXPECT_EQ(0u, img.getWidth());
     EXPECT_EQ(NULL, img.getPixelData());
     EXPECT_EQ(PopulusImage::PIXEL_FORMAT_UNKNOWN, img.getPixelFormat());
 }
 
+TEST(PopulusImageTest, palette)
+{
+    Image data = {0};
+    data.img.guid = simpleGuid;
+    data.img.frames = 1;
+    data.img.width = 8;
+    data.img.height = 4;
+    data.frame.atlasFrames = 0;
+    data.frame.encoding = ENCODING_PALETTE;
+    data.frame.pixelformat = PopulusImage::PIXEL_FORMAT_RGB565;
+    data.frame.pitch = 8;
+    data.frame.imageDataSize = 8 * 4;
+    data.frame.paletteSize = 3;
+    data.frame.nOfPalettePadBytes = 2;
+    ResourceBuffer buf(&data, sizeof(data));
+    g_lastErrorMsg = "";
+    PopulusImage img(buf);
+    EXPECT_EQ("", g_lastErrorMsg);
+    EXPECT_EQ(PopulusImage::ENCODING_PALETTE, img.getEncoding());
+    EXPECT_EQ(3u, img.getPaletteSize());
+    EXPECT_EQ(&data.data[0], img.getPalette());
+    // 3 colors with 2 bytes and 2 pad bytes
+    EXPECT_EQ(&data.data[8], img.getPixelData());
+
+    // the indices don't fit into the buffer
+    data.frame.imageDataSize = sizeof(data.data) - 7U;
+    g_lastErrorMsg = "";
+    PopulusImage img2(buf);
+    EXPECT_EQ("PopulusImage: palette out of bounds", g_lastErrorMsg);
+    EXPECT_EQ(NULL, img2.getPalette());
+    EXPECT_EQ(NULL, img2.getPixelData());
+
+    data.frame.imageDataSize = 8 * 4;
+    data.frame.paletteSize = 0;
+    g_lastErrorMsg = "";
+    PopulusImage img3(buf);
+    EXPECT_EQ("PopulusImage: bad palette size", g_lastErrorMsg);
+
+    data.frame.paletteSize = 3;
+    data.frame.pixelformat = PopulusImage::PIXEL_FORMAT_BGR888;
+    g_lastErrorMsg = "";
+    PopulusImage img4(buf);
+    EXPECT_EQ("PopulusImage: unsupported palette format", g_lastErrorMsg);
+    EXPECT_EQ(0u, img4.getPaletteSize());
+}
+
 TEST(PopulusImageTest, badFormat)
 {
     Image data = {0};
@@ -0,0 +1,69 @@
+/******************************************************************************
+**
+**   File:        StaticBitmapMock.cpp
+**   Description:
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include "StaticBitmap.h"
+#include "BitmapAccess.h"
+#include "DatabaseAccessor.h"
+
+namespace psc
+{
+
+ResourceBuffer StaticBitmap::getData() const
+{
+    return m_db.getBitmapBuffer(*this);
+}
+
+ImageAttributes StaticBitmap::getAttributes() const
+{
+    return m_db.getBitmapAttributes(*this);
+}
+
+U16 StaticBitmap::getImageId() const
+{
+    return m_db.getBitmapImageId(*this);
+}
+
+U32 StaticBitmap::getAtlasFrame() const
+{
+    return m_db.getBitmapAtlasFrame(*this);
+}
+
+U32 StaticBitmap::getAnimationFrame(const U32 monotonicTimeMs, U32& remainingMs) const
+{
+    // the animation is configured by the test, see DatabaseAccessor::setAnimation
+    const U32 frames = DatabaseAccessor::instance().getAnimationFrames();
+    const U32 durationMs = DatabaseAccessor::instance().getFrameDuration();
+    U32 frame = 0U;
+    remainingMs = 0U;
+    if ((frames > 1U) && (durationMs > 0U))
+    {
+        frame = (monotonicTimeMs / durationMs) % frames;
+        remainingMs = durationMs - (monotonicTimeMs % durationMs);
+    }
+    return frame;
+}
+
+} // namespace psc
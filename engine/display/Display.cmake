@@ -12,6 +12,7 @@ endif()
 
 include_directories(
     ${POPULUSROOT}/pgl/api
+    ${POPULUSROOT}/pgw/api
     ${POPULUSENGINE}/common/api
     ${POPULUSENGINE}/database/api
     ${POPULUSENGINE}/database/api/gen
@@ -19,8 +20,13 @@ include_directories(
     ${DISPLAY_BASE}/src
 )
 
+# verification of the drawn bitmaps: every pixel or the tile CRCs of the textures (calculated when they are loaded)
+set(DISPLAY_VERIFICATION "PGL_VERIFY_PIXELS" CACHE STRING "Verification of the drawn bitmaps (PGL_VERIFY_PIXELS or PGL_VERIFY_TILE_CRC)")
+add_definitions(-DDISPLAY_VERIFICATION=${DISPLAY_VERIFICATION})
+
 set(DISPLAY_HEADERS
     ${DISPLAY_BASE}/api/Canvas.h
+    ${DISPLAY_BASE}/api/DamageRegion.h
     ${DISPLAY_BASE}/api/DisplayManager.h
     ${DISPLAY_BASE}/api/Texture.h
     ${DISPLAY_BASE}/api/TextureCache.h
@@ -30,6 +36,7 @@ set(DISPLAY_HEADERS
 
 set(DISPLAY_SOURCES
     ${DISPLAY_BASE}/src/Canvas.cpp
+    ${DISPLAY_BASE}/src/DamageRegion.cpp
     ${DISPLAY_BASE}/src/DisplayManager.cpp
     ${DISPLAY_BASE}/src/Texture.cpp
     ${DISPLAY_BASE}/src/TextureCache.cpp
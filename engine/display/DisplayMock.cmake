@@ -15,6 +15,7 @@ set(DISPLAYMOCK_HEADERS
 )
 
 set(DISPLAYMOCK_SOURCES
+    ${DISPLAY_BASE}/src/DamageRegion.cpp
     ${DISPLAY_BASE}/src/DisplayManager.cpp
     ${DISPLAY_BASE}/src/Texture.cpp
     ${DISPLAY_BASE}/src/TextureCache.cpp
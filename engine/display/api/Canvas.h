@@ -41,6 +41,11 @@ class Canvas
 {
 public:
     void clear(const Color& color);
+
+    /**
+     * Clears only the given area (absolute coordinates) - used for partial redraws
+     */
+    void clear(const Color& color, const Area& area);
     void drawBitmap(const StaticBitmap& bitmap, const Area& area);
     bool verify(const StaticBitmap& bitmap, const Area& area);
     U16 getWidth() const;
@@ -0,0 +1,98 @@
+#ifndef POPULUSSC_DAMAGEREGION_H
+#define POPULUSSC_DAMAGEREGION_H
+
+/******************************************************************************
+**
+**   File:        DamageRegion.h
+**   Description:
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include "PscTypes.h"
+#include "PscLimits.h"
+#include "Area.h"
+
+namespace psc
+{
+
+/**
+ * Collects the areas of a window which have to be redrawn in the next frame.
+ *
+ * The region consists of at most @c MAX_DAMAGE_RECTS disjoint rectangles.
+ * Overlapping areas are merged into their bounding rectangle. If the region is full,
+ * a new area is merged with the rectangle whose bounding rectangle grows least.
+ */
+class DamageRegion
+{
+public:
+    DamageRegion();
+
+    /**
+     * Adds an area (absolute coordinates) to the region.
+     *
+     * @return @c true if the region has changed, @c false if the area was already covered.
+     */
+    bool add(const Area& area);
+
+    /**
+     * Removes all areas.
+     */
+    void clear();
+
+    /**
+     * @return @c true if the given area has common pixels with the region.
+     */
+    bool isOverlapping(const Area& area) const;
+
+    /**
+     * @return @c true if the given area is completely inside one rectangle of the region.
+     */
+    bool contains(const Area& area) const;
+
+    bool isEmpty() const;
+    std::size_t getCount() const;
+
+    /**
+     * @param[in] index rectangle index in [0, @c getCount()).
+     */
+    const Area& getArea(const std::size_t index) const;
+
+private:
+    void remove(const std::size_t index);
+
+    Area m_areas[MAX_DAMAGE_RECTS];
+    std::size_t m_count;
+};
+
+inline bool DamageRegion::isEmpty() const
+{
+    return (m_count == 0U);
+}
+
+inline std::size_t DamageRegion::getCount() const
+{
+    return m_count;
+}
+
+} // namespace psc
+
+#endif // POPULUSSC_DAMAGEREGION_H
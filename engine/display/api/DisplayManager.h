@@ -33,6 +33,7 @@
 namespace psc
 {
 class StaticBitmap;
+class Database;
 
 class DisplayManager
 {
@@ -48,9 +49,41 @@ public: // but internal to the component
      */
     Texture* loadTexture(const StaticBitmap& bmp);
 
+    /**
+     * Binds the texture and selects the blending mode unless they are already set
+     * (consecutive bitmaps of an atlas don't change the context)
+     */
+    void bindTexture(const Texture& texture, const bool blending);
+
+    void setBlending(const bool blending);
+
+    /**
+     * Called when a frame has been swapped, the textures drawn so far may be evicted from the texture cache afterwards
+     * (the pgl lists of the frame which refer to them have been submitted)
+     */
+    void endFrame();
+
+    TextureCache& getTextureCache();
+
+    /**
+     * Loads the textures of all bitmaps of the database (every skin, every frame of animated images) into the texture cache,
+     * so the first frame which shows a bitmap doesn't have to load it.
+     * Loading stops when the texture cache budget is reached, the remaining textures are loaded when they are drawn.
+     * Bitmaps whose images can't be loaded are skipped.
+     * @param budgetMs time after which the call returns, the next call continues with the next bitmap (0: no limit)
+     * @return true if all textures have been loaded (or the budget is reached)
+     */
+    bool prewarm(const Database& db, const U32 budgetMs);
+
 private:
     TextureCache m_textureCache;
     PGLContext m_context;
+    const Texture* m_boundTexture;
+    bool m_blending;
+    // next texture to prewarm
+    U16 m_prewarmSkin;
+    U16 m_prewarmBitmap;
+    U32 m_prewarmFrame;
 };
 
 inline PGLContext DisplayManager::getContext() const
@@ -58,6 +91,16 @@ inline PGLContext DisplayManager::getContext() const
     return m_context;
 }
 
+inline void DisplayManager::endFrame()
+{
+    m_textureCache.endFrame();
+}
+
+inline TextureCache& DisplayManager::getTextureCache()
+{
+    return m_textureCache;
+}
+
 }
 
 #endif // POPULUSSC_DISPLAYMANAGER_H
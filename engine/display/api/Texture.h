@@ -29,6 +29,8 @@
 
 #include "pgl.h"
 #include "PscTypes.h"
+#include "PopulusImage.h"
+#include "Area.h"
 
 namespace psc
 {
@@ -42,28 +44,50 @@ public:
     bool isLoaded() const;
 
     /**
-     * data contains an image in POI format (populus image)
+     * data contains an image in POI format (populus image), which may be an atlas of several bitmaps
+     * frame selects the frame of an animated image
+     * A loaded texture is replaced by the new image (the pgl texture is reused)
+     * If pgl rejects the image, the texture is not loaded (isLoaded() returns false) and must not be bound
      */
-    void load(PGLContext ctx, const ResourceBuffer& data, const bool needsCopy);
+    void load(PGLContext ctx, const ResourceBuffer& data, const U32 frame, const bool needsCopy);
+
+    /**
+     * Marks the pixels as outdated, e.g. when the slot of the texture is evicted from the cache.
+     * The pgl texture is kept and reused by the next load.
+     */
+    void unload();
 
     /**
      * Bind the texture to the context
+     * The blending mode depends on the bitmap which is drawn (see DisplayManager::bindTexture)
      */
-    void bind(PGLContext ctx);
+    void bind(PGLContext ctx) const;
 
     U16 getWidth() const;
     U16 getHeight() const;
 
+    /**
+     * Returns the texels of an atlas frame (PopulusImage::NO_ATLAS_FRAME: the whole texture)
+     */
+    Area getArea(const U32 atlasFrame) const;
+
 private:
     PGLTexture m_texture;
+    bool m_loaded; ///< m_texture holds the pixels of m_image
     PGLFormat m_format;
     U16 m_width;
     U16 m_height;
+    PopulusImage m_image;
 };
 
 inline bool Texture::isLoaded() const
 {
-    return (m_texture != NULL);
+    return m_loaded;
+}
+
+inline void Texture::unload()
+{
+    m_loaded = false;
 }
 
 inline U16 Texture::getWidth() const
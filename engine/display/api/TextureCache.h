@@ -28,6 +28,7 @@
 ******************************************************************************/
 
 #include "pgl.h"
+#include "PscLimits.h"
 #include "Texture.h"
 
 namespace psc
@@ -36,27 +37,96 @@ namespace psc
 class StaticBitmap;
 class DisplayManager;
 
+/**
+ * Keeps the textures of the drawn bitmaps loaded within a budget of textures and bytes.
+ * If a budget is exceeded, the least recently used textures which have not been used since the last endFrame are evicted,
+ * their pgl textures are reused for the next images (pgl has no function to delete a texture).
+ */
 class TextureCache
 {
 public:
+    struct Statistics
+    {
+        U32 hits; ///< load calls which returned a loaded texture
+        U32 misses; ///< load calls which had to load the image
+        U32 evictions; ///< textures which have been evicted to stay within the budget
+        U32 loadTimeMs; ///< time spent loading images
+        U32 bytes; ///< pixel bytes of the loaded textures
+        U16 textures; ///< number of loaded textures
+    };
+
     explicit TextureCache(const DisplayManager&);
 
     /**
      * Loads a texture from the given StaticBitmap
-     * If the StaticBitmap is already loaded as a texture the loaded texture is returned instead
+     * If the image of the StaticBitmap is already loaded as a texture the loaded texture is returned instead
+     * (all bitmaps of an atlas share one texture)
+     * Each frame of an animated image (StaticBitmap::getFrame) is a separate texture
+     * The textures which have been used in the current frame are never evicted: if the byte budget is exceeded by them,
+     * the image is loaded anyway, if all slots are used by them NULL is returned.
      * returns NULL on error
      */
     Texture* load(const StaticBitmap& bmp);
 
+    /**
+     * Loads the texture of the StaticBitmap in advance unless it's already loaded (see DisplayManager::prewarm)
+     * The texture is only loaded if it fits into the budget without evicting another one, it is not marked as used in the
+     * current frame and not counted as hit or miss.
+     * @return false if the texture doesn't fit into the budget, true if it is loaded or can't be loaded at all (skipped)
+     */
+    bool prewarm(const StaticBitmap& bmp);
+
+    /**
+     * Sets the budget, textures which exceed it are evicted by the next load calls
+     * @param maxTextures number of textures, at most MAX_TEXTURES_COUNT
+     * @param maxBytes pixel bytes of all textures
+     */
+    void setBudget(const U16 maxTextures, const U32 maxBytes);
+
+    /**
+     * Marks the end of a frame (see DisplayManager::endFrame), the textures used so far may be evicted afterwards
+     */
+    void endFrame();
+
+    const Statistics& getStatistics() const;
+
 private:
-    enum
+    static const U16 NO_IMAGE = 0U;
+
+    struct Entry
     {
-        MAX_TEXTURES = 40 // TODO: limits.h
+        Texture texture;
+        U16 imageId; ///< StaticBitmap::getImageId of the loaded texture, NO_IMAGE if the slot is free
+        U32 frame; ///< StaticBitmap::getFrame of the loaded texture
+        U32 bytes;
+        U32 lastUse; ///< value of m_useCount when the texture has been used last
+        U32 lastFrame; ///< value of m_frame when the texture has been used last
     };
+
+    // Returns the index of the loaded texture, MAX_TEXTURES_COUNT if it is not loaded
+    U16 find(const U16 imageId, const U32 frame) const;
+    // Loads the texture into a free slot, allowEviction: unused textures are evicted to stay within the budget
+    // Returns MAX_TEXTURES_COUNT if it can't be loaded
+    U16 insert(const StaticBitmap& bmp, const bool allowEviction);
+    // Returns the least recently used texture which has not been used in the current frame, MAX_TEXTURES_COUNT if there is none
+    U16 findEvictable() const;
+    void evict(const U16 index);
+
     const DisplayManager& m_displayManager;
-    Texture m_textures[MAX_TEXTURES];
+    Entry m_entries[MAX_TEXTURES_COUNT];
+    U16 m_count; ///< number of slots which have been used so far
+    U16 m_maxTextures;
+    U32 m_maxBytes;
+    U32 m_useCount;
+    U32 m_frame;
+    Statistics m_statistics;
 };
 
+inline const TextureCache::Statistics& TextureCache::getStatistics() const
+{
+    return m_statistics;
+}
+
 }
 
 #endif // POPULUSSC_TEXTURE_CACHE_H
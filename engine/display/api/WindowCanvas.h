@@ -34,6 +34,7 @@ namespace psc
 {
 
 class DisplayManager;
+class DamageRegion;
 struct WindowDefinition;
 
 /**
@@ -47,12 +48,36 @@ public:
     void makeCurrent();
     void swapBuffers();
 
+    /**
+     * Presents only the areas of the region. The rest of the window must not have changed since the last swap.
+     */
+    void swapBuffers(const DamageRegion& region);
+
+    /**
+     * @return false if the window content is undefined after a swap, every frame has to be drawn completely
+     */
+    bool isBufferPreserved() const;
+
+    /**
+     * Starts recording the drawing commands into the display list of the window (see pglBeginList)
+     * @return false if the commands can't be recorded, they are drawn directly
+     */
+    bool beginList();
+
+    /**
+     * Stops recording and draws the display list. The backend may drop overdrawn commands and merge or reorder the others.
+     * @return false if the list was too small for the recorded commands, nothing has been drawn
+     */
+    bool submitList();
+
     /**
      * @return true to indicate that the window has been closed by the window system
      */
     bool handleWindowEvents();
 private:
     PGLSurface m_surface;
+    PGLList m_list;
+    bool m_preserved;
 };
 
 }
@@ -30,6 +30,7 @@
 #include "Area.h"
 #include "Color.h"
 #include "Assertion.h"
+#include "StaticBitmap.h"
 
 namespace psc
 {
@@ -52,23 +53,40 @@ void Canvas::clear(const Color& color)
     pglClear(ctx);
 }
 
+void Canvas::clear(const Color& color, const Area& area)
+{
+    PGLContext ctx = m_dsp.getContext();
+    pglSetColor(ctx, color.getRed(), color.getGreen(), color.getBlue(), color.getAlpha());
+    m_dsp.setBlending(false); // the area is replaced like with pglClear
+    pglDrawArea(ctx, area.getLeftFP(), area.getTopFP(), area.getRightFP(), area.getBottomFP());
+}
+
 void Canvas::drawBitmap(const StaticBitmap& bitmap, const Area& area)
 {
     Texture* t = m_dsp.loadTexture(bitmap);
-    ASSERT(t != NULL);
-    PGLContext ctx = m_dsp.getContext();
-    t->bind(ctx);
-    // output coordinates
-    const I32 x1 = area.getLeftFP();
-    const I32 y1 = area.getTopFP();
-    const I32 x2 = area.getRightFP();
-    const I32 y2 = area.getBottomFP();
-    // TODO: get texture coordinates
-    const I32 u1 = 0;
-    const I32 v1 = 0;
-    const I32 u2 = (t->getWidth() - 1) << 4;
-    const I32 v2 = (t->getHeight() - 1) << 4;
-    pglDrawQuad(ctx, x1, y1, u1, v1, x2, y2, u2, v2);
+    if (NULL != t)
+    {
+        PGLContext ctx = m_dsp.getContext();
+        // opaque bitmaps are copied, which is faster
+        m_dsp.bindTexture(*t, bitmap.getAttributes().hasAlpha);
+        // output coordinates
+        const I32 x1 = area.getLeftFP();
+        const I32 y1 = area.getTopFP();
+        const I32 x2 = area.getRightFP();
+        const I32 y2 = area.getBottomFP();
+        // texture coordinates of the bitmap (a part of an atlas texture)
+        const Area texels = t->getArea(bitmap.getAtlasFrame());
+        const I32 u1 = texels.getLeftFP();
+        const I32 v1 = texels.getTopFP();
+        const I32 u2 = texels.getRightFP();
+        const I32 v2 = texels.getBottomFP();
+        pglDrawQuad(ctx, x1, y1, u1, v1, x2, y2, u2, v2);
+    }
+    else
+    {
+        // the texture cache is full with the textures of this frame or the image has been rejected:
+        // nothing is drawn, the verification of the bitmap fails
+    }
 }
 
 bool Canvas::verify(const StaticBitmap& bitmap, const Area& area)
@@ -78,17 +96,19 @@ bool Canvas::verify(const StaticBitmap& bitmap, const Area& area)
     if (NULL != t)
     {
         PGLContext ctx = m_dsp.getContext();
-        t->bind(ctx);
+        // opaque bitmaps are copied, which is faster
+        m_dsp.bindTexture(*t, bitmap.getAttributes().hasAlpha);
         // output coordinates
         const I32 x1 = area.getLeftFP();
         const I32 y1 = area.getTopFP();
         const I32 x2 = area.getRightFP();
         const I32 y2 = area.getBottomFP();
-        // TODO: get texture coordinates
-        const I32 u1 = 0;
-        const I32 v1 = 0;
-        const I32 u2 = (t->getWidth() - 1) << 4;
-        const I32 v2 = (t->getHeight() - 1) << 4;
+        // texture coordinates of the bitmap (a part of an atlas texture)
+        const Area texels = t->getArea(bitmap.getAtlasFrame());
+        const I32 u1 = texels.getLeftFP();
+        const I32 v1 = texels.getTopFP();
+        const I32 u2 = texels.getRightFP();
+        const I32 v2 = texels.getBottomFP();
         PGLBoolean ret = pglVerify(ctx, x1, y1, u1, v1, x2, y2, u2, v2);
         verified = (ret == PGL_TRUE);
     }
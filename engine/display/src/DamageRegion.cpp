@@ -0,0 +1,160 @@
+/******************************************************************************
+**
+**   File:        DamageRegion.cpp
+**   Description:
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include "DamageRegion.h"
+#include "Assertion.h"
+
+namespace psc
+{
+
+namespace
+{
+
+I32 minimum(const I32 a, const I32 b)
+{
+    return (a < b) ? a : b;
+}
+
+I32 maximum(const I32 a, const I32 b)
+{
+    return (a > b) ? a : b;
+}
+
+/**
+ * @return the smallest area which contains both areas
+ */
+Area boundingArea(const Area& a, const Area& b)
+{
+    Area bounds(a);
+    bounds.setLeftFP(minimum(a.getLeftFP(), b.getLeftFP()));
+    bounds.setTopFP(minimum(a.getTopFP(), b.getTopFP()));
+    bounds.setRightFP(maximum(a.getRightFP(), b.getRightFP()));
+    bounds.setBottomFP(maximum(a.getBottomFP(), b.getBottomFP()));
+    return bounds;
+}
+
+I32 pixelCount(const Area& area)
+{
+    return area.getWidth() * area.getHeight();
+}
+
+} // anonymous namespace
+
+DamageRegion::DamageRegion()
+    : m_count(0U)
+{
+}
+
+bool DamageRegion::add(const Area& area)
+{
+    bool changed = false;
+    if (!area.isEmpty() && !contains(area))
+    {
+        Area merged(area);
+        std::size_t i = 0U;
+        while (i < m_count)
+        {
+            if (m_areas[i].isOverlapping(merged))
+            {
+                // the bounding area may overlap rectangles which have been checked before
+                merged = boundingArea(merged, m_areas[i]);
+                remove(i);
+                i = 0U;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        if (m_count == MAX_DAMAGE_RECTS)
+        {
+            std::size_t best = 0U;
+            I32 bestGrowth = pixelCount(boundingArea(merged, m_areas[0U])) - pixelCount(m_areas[0U]);
+            for (i = 1U; i < m_count; ++i)
+            {
+                const I32 growth = pixelCount(boundingArea(merged, m_areas[i])) - pixelCount(m_areas[i]);
+                if (growth < bestGrowth)
+                {
+                    best = i;
+                    bestGrowth = growth;
+                }
+            }
+            merged = boundingArea(merged, m_areas[best]);
+            remove(best);
+            static_cast<void>(add(merged)); // the grown area may overlap further rectangles
+        }
+        else
+        {
+            m_areas[m_count] = merged;
+            ++m_count;
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+void DamageRegion::clear()
+{
+    m_count = 0U;
+}
+
+bool DamageRegion::isOverlapping(const Area& area) const
+{
+    bool overlapping = false;
+    for (std::size_t i = 0U; (i < m_count) && !overlapping; ++i)
+    {
+        overlapping = m_areas[i].isOverlapping(area);
+    }
+    return overlapping;
+}
+
+bool DamageRegion::contains(const Area& area) const
+{
+    bool contained = false;
+    for (std::size_t i = 0U; (i < m_count) && !contained; ++i)
+    {
+        const Area& r = m_areas[i];
+        contained = (r.getLeftFP() <= area.getLeftFP()) && (r.getTopFP() <= area.getTopFP())
+            && (r.getRightFP() >= area.getRightFP()) && (r.getBottomFP() >= area.getBottomFP());
+    }
+    return contained;
+}
+
+const Area& DamageRegion::getArea(const std::size_t index) const
+{
+    ASSERT(index < m_count);
+    return m_areas[index];
+}
+
+void DamageRegion::remove(const std::size_t index)
+{
+    ASSERT(index < m_count);
+    --m_count;
+    m_areas[index] = m_areas[m_count];
+}
+
+} // namespace psc
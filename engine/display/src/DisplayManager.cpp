@@ -25,14 +25,33 @@
 ******************************************************************************/
 
 #include "DisplayManager.h"
+#include "Database.h"
+#include "DDHType.h"
+#include "SkinDatabaseType.h"
+#include "SkinType.h"
+#include "BitmapDefinitionType.h"
+#include "PopulusImage.h"
+#include "pgw.h"
+
+#ifndef DISPLAY_VERIFICATION
+#define DISPLAY_VERIFICATION PGL_VERIFY_PIXELS // see Display.cmake
+#endif
 
 namespace psc
 {
 
 DisplayManager::DisplayManager()
 : m_textureCache(*this)
+, m_boundTexture(NULL)
+, m_blending(false)
+, m_prewarmSkin(0U)
+, m_prewarmBitmap(0U)
+, m_prewarmFrame(0U)
 {
-    m_context = pglCreateContext();
+    // the bitmaps are compared pixel by pixel unless tile CRCs are configured (a few bytes per tile instead of every texture pixel)
+    const PGLContextConfig config = { 1U, DISPLAY_VERIFICATION };
+    m_context = pglCreateContext(&config);
+    pglSetBlending(m_context, PGL_FALSE);
 }
 
 Texture* DisplayManager::loadTexture(const StaticBitmap& bmp)
@@ -40,4 +59,65 @@ Texture* DisplayManager::loadTexture(const StaticBitmap& bmp)
     return m_textureCache.load(bmp);
 }
 
+void DisplayManager::bindTexture(const Texture& texture, const bool blending)
+{
+    if (&texture != m_boundTexture)
+    {
+        texture.bind(m_context);
+        m_boundTexture = &texture;
+    }
+    setBlending(blending);
+}
+
+void DisplayManager::setBlending(const bool blending)
+{
+    if (blending != m_blending)
+    {
+        pglSetBlending(m_context, blending ? PGL_TRUE : PGL_FALSE);
+        m_blending = blending;
+    }
+}
+
+bool DisplayManager::prewarm(const Database& db, const U32 budgetMs)
+{
+    const SkinDatabaseType* skins = db.getDdh()->GetSkinDatabase();
+    const U16 skinCount = (NULL != skins) ? skins->GetSkinCount() : 0U;
+    const U32 start = pgwGetMonotonicTime();
+    bool full = false;
+    while (!full && (m_prewarmSkin < skinCount) && ((0U == budgetMs) || ((pgwGetMonotonicTime() - start) < budgetMs)))
+    {
+        const SkinType* skin = skins->GetSkin(m_prewarmSkin);
+        const BitmapDefinitionType* bitmap = (NULL != skin) ? skin->GetBitmap(m_prewarmBitmap) : NULL;
+        if (NULL != bitmap)
+        {
+            StaticBitmap bmp = db.getBitmap(bitmap->GetBitmapId(), m_prewarmSkin);
+            U32 frameCount = 1U;
+            if ((bmp.getImageId() > 0U) && (bmp.getAtlasFrame() == PopulusImage::NO_ATLAS_FRAME))
+            {
+                // every frame of an animated image is a separate texture (bitmaps of an atlas are not animated)
+                frameCount = PopulusImage(bmp.getData()).getFrameCount();
+            }
+            bmp.setFrame(m_prewarmFrame);
+            full = !m_textureCache.prewarm(bmp);
+            ++m_prewarmFrame;
+            if (m_prewarmFrame >= frameCount)
+            {
+                m_prewarmFrame = 0U;
+                ++m_prewarmBitmap;
+            }
+        }
+        else
+        {
+            m_prewarmBitmap = 0U;
+            ++m_prewarmSkin;
+        }
+    }
+    if (full)
+    {
+        // the remaining textures are loaded when they are drawn
+        m_prewarmSkin = skinCount;
+    }
+    return (m_prewarmSkin >= skinCount);
+}
+
 }
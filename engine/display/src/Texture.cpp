@@ -32,19 +32,70 @@
 namespace psc
 {
 
+namespace
+{
+    PGLEncoding getEncoding(const PopulusImage::Encoding encoding)
+    {
+        PGLEncoding ret = PGL_ENCODING_RAW;
+        switch (encoding)
+        {
+        case PopulusImage::ENCODING_RLE:
+            ret = PGL_ENCODING_RLE;
+            break;
+        case PopulusImage::ENCODING_RLE2:
+            ret = PGL_ENCODING_RLE2;
+            break;
+        case PopulusImage::ENCODING_FLZ:
+            ret = PGL_ENCODING_FLZ;
+            break;
+        default:
+            break;
+        }
+        return ret;
+    }
+
+    // Indexed format with colors of the given format, PGL_FORMAT_INVALID if there is none
+    PGLFormat getPaletteFormat(const PGLFormat format)
+    {
+        PGLFormat ret = PGL_FORMAT_INVALID;
+        switch (format)
+        {
+        case PGL_FORMAT_RGB_565:
+            ret = PGL_FORMAT_P_8_RGB_565;
+            break;
+        case PGL_FORMAT_RGB_888:
+            ret = PGL_FORMAT_P_8_RGB_888;
+            break;
+        case PGL_FORMAT_RGBA_8888:
+            ret = PGL_FORMAT_P_8_RGBA_8888;
+            break;
+        case PGL_FORMAT_BGRA_8888:
+            ret = PGL_FORMAT_P_8_BGRA_8888;
+            break;
+        default:
+            break;
+        }
+        return ret;
+    }
+}
+
 Texture::Texture()
 : m_texture(NULL)
+, m_loaded(false)
 , m_format(PGL_FORMAT_ARGB_8888)
 , m_width(0)
 , m_height(0)
+, m_image(ResourceBuffer())
 {
 }
 
-void Texture::load(PGLContext ctx, const ResourceBuffer& buf, const bool needsCopy)
+void Texture::load(PGLContext ctx, const ResourceBuffer& buf, const U32 frame, const bool needsCopy)
 {
     ASSERT(buf.getSize() > 0);
 
-    PopulusImage img(buf);
+    m_loaded = false; // the pixels of a previous image are replaced
+    m_image = PopulusImage(buf, frame);
+    const PopulusImage& img = m_image;
     m_height = img.getHeight();
     m_width = img.getWidth();
     const void* pixelData = img.getPixelData();
@@ -54,10 +105,10 @@ void Texture::load(PGLContext ctx, const ResourceBuffer& buf, const bool needsCo
         m_format = PGL_FORMAT_RGB_565;
         break;
     case PopulusImage::PIXEL_FORMAT_RGB888:
-        ASSERT_MSG(0, "pgl format not supported");
+        m_format = PGL_FORMAT_RGB_888;
         break;
     case PopulusImage::PIXEL_FORMAT_BGR888:
-        ASSERT_MSG(0, "pgl format not supported");
+        m_format = PGL_FORMAT_BGR_888;
         break;
     case PopulusImage::PIXEL_FORMAT_RGBA8888:
         m_format = PGL_FORMAT_RGBA_8888;
@@ -70,17 +121,48 @@ void Texture::load(PGLContext ctx, const ResourceBuffer& buf, const bool needsCo
         pixelData = NULL;
         break;
     }
-    if (NULL != pixelData)
+    if ((NULL != pixelData) && (NULL == m_texture))
     {
+        // an evicted texture of the TextureCache keeps its pgl texture for the next image
         m_texture = pglCreateTexture(ctx);
-        pglLoadTexture(m_texture, m_width, m_height, m_format, needsCopy, pixelData);
+    }
+    if ((NULL != pixelData) && (NULL != m_texture))
+    {
+        PGLBoolean loaded = PGL_FALSE;
+        if (img.getEncoding() == PopulusImage::ENCODING_RAW)
+        {
+            loaded = pglLoadTexture(m_texture, m_width, m_height, m_format, needsCopy, pixelData);
+        }
+        else if (img.getEncoding() == PopulusImage::ENCODING_PALETTE)
+        {
+            m_format = getPaletteFormat(m_format);
+            loaded = pglLoadTexturePalette(m_texture, m_width, m_height, m_format, needsCopy, pixelData, img.getPaletteSize(), img.getPalette());
+        }
+        else
+        {
+            // RLE data is kept encoded and decoded while drawing (if supported by pgl), it must stay available like needsCopy == false
+            loaded = pglLoadTextureEncoded(m_texture, m_width, m_height, m_format, getEncoding(img.getEncoding()), img.getPixelDataSize(), pixelData);
+        }
+        // a rejected image keeps the pgl texture for the next load, but it must not be drawn
+        m_loaded = (loaded == PGL_TRUE);
     }
 }
 
-void Texture::bind(PGLContext context)
+void Texture::bind(PGLContext context) const
 {
     ASSERT(isLoaded());
     pglBindTexture(context, m_texture);
 }
 
+Area Texture::getArea(const U32 atlasFrame) const
+{
+    Area area(0, 0, static_cast<I32>(m_width) - 1, static_cast<I32>(m_height) - 1);
+    PopulusImage::AtlasFrame frame;
+    if ((atlasFrame != PopulusImage::NO_ATLAS_FRAME) && m_image.getAtlasFrame(atlasFrame, frame))
+    {
+        area = Area(frame.x, frame.y, frame.x + frame.width - 1, frame.y + frame.height - 1);
+    }
+    return area;
+}
+
 }
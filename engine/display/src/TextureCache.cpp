@@ -27,29 +27,216 @@
 #include "TextureCache.h"
 #include "StaticBitmap.h"
 #include "DisplayManager.h"
-#include <algorithm>
+#include "PopulusImage.h"
+#include "pgw.h"
 
 namespace psc
 {
 
+namespace
+{
+    // Pixel bytes of the texture of an image (palette images are counted like RGBA textures, the largest expansion)
+    U32 getTextureSize(const PopulusImage& img)
+    {
+        U32 bpp = 4U;
+        switch (img.getPixelFormat())
+        {
+        case PopulusImage::PIXEL_FORMAT_RGB565:
+            bpp = 2U;
+            break;
+        case PopulusImage::PIXEL_FORMAT_RGB888:
+        case PopulusImage::PIXEL_FORMAT_BGR888:
+            bpp = 3U;
+            break;
+        default:
+            break;
+        }
+        if (img.getEncoding() == PopulusImage::ENCODING_PALETTE)
+        {
+            bpp = 4U;
+        }
+        return img.getWidth() * img.getHeight() * bpp;
+    }
+}
+
 TextureCache::TextureCache(const DisplayManager& dsp)
 : m_displayManager(dsp)
+, m_count(0U)
+, m_maxTextures(MAX_TEXTURES_COUNT)
+, m_maxBytes(TEXTURE_CACHE_BYTES)
+, m_useCount(0U)
+, m_frame(0U)
 {
+    for (U16 i = 0U; i < MAX_TEXTURES_COUNT; ++i)
+    {
+        m_entries[i].imageId = NO_IMAGE;
+        m_entries[i].frame = 0U;
+        m_entries[i].bytes = 0U;
+        m_entries[i].lastUse = 0U;
+        m_entries[i].lastFrame = 0U;
+    }
+    m_statistics.hits = 0U;
+    m_statistics.misses = 0U;
+    m_statistics.evictions = 0U;
+    m_statistics.loadTimeMs = 0U;
+    m_statistics.bytes = 0U;
+    m_statistics.textures = 0U;
 }
 
 Texture* TextureCache::load(const StaticBitmap& bmp)
 {
     Texture* texture = NULL;
-    const U16 id = bmp.getId();
-    if (id > 0 && id <= MAX_TEXTURES)
+    const U16 id = bmp.getImageId();
+    U16 index = find(id, bmp.getFrame());
+    if (index < MAX_TEXTURES_COUNT)
+    {
+        ++m_statistics.hits;
+    }
+    else if (id != NO_IMAGE)
+    {
+        ++m_statistics.misses;
+        index = insert(bmp, true);
+    }
+    else
+    {
+        // the bitmap has no image
+    }
+    if (index < MAX_TEXTURES_COUNT)
     {
-        texture = &m_textures[id - 1];
-        if (!texture->isLoaded())
+        Entry& entry = m_entries[index];
+        entry.lastUse = ++m_useCount;
+        entry.lastFrame = m_frame;
+        texture = &entry.texture;
+    }
+    return texture;
+}
+
+bool TextureCache::prewarm(const StaticBitmap& bmp)
+{
+    bool full = false;
+    if ((bmp.getImageId() != NO_IMAGE) && (find(bmp.getImageId(), bmp.getFrame()) == MAX_TEXTURES_COUNT))
+    {
+        const U16 index = insert(bmp, false);
+        if (index < MAX_TEXTURES_COUNT)
+        {
+            // like a texture of the previous frame: the first frame which needs the space may evict it
+            Entry& entry = m_entries[index];
+            entry.lastUse = ++m_useCount;
+            entry.lastFrame = m_frame - 1U;
+        }
+        else
         {
-            texture->load(m_displayManager.getContext(), bmp.getData(), false); // no copy for static bitmap
+            // an image which can't be loaded is skipped, only the budget stops prewarming
+            const U32 bytes = getTextureSize(PopulusImage(bmp.getData(), bmp.getFrame()));
+            full = (m_statistics.textures >= m_maxTextures) || ((m_statistics.bytes + bytes) > m_maxBytes);
         }
     }
-    return texture;
+    return !full;
+}
+
+U16 TextureCache::find(const U16 imageId, const U32 frame) const
+{
+    U16 index = MAX_TEXTURES_COUNT;
+    // evicted slots have no image, a bitmap without an image never matches them
+    for (U16 i = 0U; (NO_IMAGE != imageId) && (i < m_count) && (MAX_TEXTURES_COUNT == index); ++i)
+    {
+        if ((m_entries[i].imageId == imageId) && (m_entries[i].frame == frame))
+        {
+            index = i;
+        }
+    }
+    return index;
+}
+
+U16 TextureCache::insert(const StaticBitmap& bmp, const bool allowEviction)
+{
+    const ResourceBuffer data = bmp.getData();
+    const U32 frame = bmp.getFrame();
+    const U32 bytes = getTextureSize(PopulusImage(data, frame));
+    if (allowEviction)
+    {
+        // make room: unused textures are evicted until the new one fits into the budget
+        U16 evictable = findEvictable();
+        while ((evictable < MAX_TEXTURES_COUNT)
+            && ((m_statistics.textures >= m_maxTextures) || ((m_statistics.bytes + bytes) > m_maxBytes)))
+        {
+            evict(evictable);
+            evictable = findEvictable();
+        }
+    }
+    // the byte budget may be exceeded by the textures of the current frame, but not by a prewarmed texture
+    const bool fits = (m_statistics.textures < m_maxTextures) && (allowEviction || ((m_statistics.bytes + bytes) <= m_maxBytes));
+    U16 index = MAX_TEXTURES_COUNT;
+    for (U16 i = 0U; fits && (i < m_count) && (MAX_TEXTURES_COUNT == index); ++i)
+    {
+        if (m_entries[i].imageId == NO_IMAGE)
+        {
+            index = i; // the slot of an evicted texture, its pgl texture is reused
+        }
+    }
+    if (fits && (MAX_TEXTURES_COUNT == index) && (m_count < MAX_TEXTURES_COUNT))
+    {
+        index = m_count;
+        ++m_count;
+    }
+    if (index < MAX_TEXTURES_COUNT)
+    {
+        Entry& entry = m_entries[index];
+        const U32 start = pgwGetMonotonicTime();
+        entry.texture.load(m_displayManager.getContext(), data, frame, false); // no copy for static bitmap
+        m_statistics.loadTimeMs += pgwGetMonotonicTime() - start;
+        if (entry.texture.isLoaded())
+        {
+            entry.imageId = bmp.getImageId();
+            entry.frame = frame;
+            entry.bytes = bytes;
+            m_statistics.bytes += bytes;
+            ++m_statistics.textures;
+        }
+        else
+        {
+            // no pgl texture available or the image has been rejected: the slot stays free, the bitmap is not drawn
+            index = MAX_TEXTURES_COUNT;
+        }
+    }
+    return index;
+}
+
+void TextureCache::setBudget(const U16 maxTextures, const U32 maxBytes)
+{
+    m_maxTextures = (maxTextures < MAX_TEXTURES_COUNT) ? maxTextures : MAX_TEXTURES_COUNT;
+    m_maxBytes = maxBytes;
+}
+
+void TextureCache::endFrame()
+{
+    ++m_frame;
+}
+
+U16 TextureCache::findEvictable() const
+{
+    U16 index = MAX_TEXTURES_COUNT;
+    for (U16 i = 0U; i < m_count; ++i)
+    {
+        const Entry& entry = m_entries[i];
+        if ((entry.imageId != NO_IMAGE) && (entry.lastFrame != m_frame)
+            && ((MAX_TEXTURES_COUNT == index) || (entry.lastUse < m_entries[index].lastUse)))
+        {
+            index = i;
+        }
+    }
+    return index;
+}
+
+void TextureCache::evict(const U16 index)
+{
+    Entry& entry = m_entries[index];
+    m_statistics.bytes -= entry.bytes;
+    --m_statistics.textures;
+    ++m_statistics.evictions;
+    entry.imageId = NO_IMAGE;
+    entry.bytes = 0U;
+    entry.texture.unload();
 }
 
 }
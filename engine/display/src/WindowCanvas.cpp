@@ -27,6 +27,7 @@
 #include "WindowCanvas.h"
 #include "WindowDefinition.h"
 #include "DisplayManager.h"
+#include "DamageRegion.h"
 
 namespace psc
 {
@@ -35,6 +36,8 @@ WindowCanvas::WindowCanvas(DisplayManager& dsp, const WindowDefinition& config)
 : Canvas(dsp, config.width, config.height)
 {
     m_surface = pglCreateWindow(config.id, config.xPos, config.yPos, config.width, config.height);
+    m_list = pglCreateList(dsp.getContext());
+    m_preserved = (pglIsBufferPreserved(m_surface) == PGL_TRUE);
 }
 
 void WindowCanvas::makeCurrent()
@@ -45,6 +48,40 @@ void WindowCanvas::makeCurrent()
 void WindowCanvas::swapBuffers()
 {
     pglSwapBuffers(m_surface);
+    getDisplayManager().endFrame();
+}
+
+void WindowCanvas::swapBuffers(const DamageRegion& region)
+{
+    PGLRect rects[MAX_DAMAGE_RECTS];
+    const std::size_t count = region.getCount();
+    for (std::size_t i = 0U; i < count; ++i)
+    {
+        const Area& area = region.getArea(i);
+        rects[i].x1 = area.getLeftFP();
+        rects[i].y1 = area.getTopFP();
+        rects[i].x2 = area.getRightFP();
+        rects[i].y2 = area.getBottomFP();
+    }
+    pglSwapBuffersRegion(m_surface, rects, static_cast<uint32_t>(count));
+    getDisplayManager().endFrame();
+}
+
+bool WindowCanvas::isBufferPreserved() const
+{
+    return m_preserved;
+}
+
+bool WindowCanvas::beginList()
+{
+    return (NULL != m_list) && (pglBeginList(getDisplayManager().getContext(), m_list) == PGL_TRUE);
+}
+
+bool WindowCanvas::submitList()
+{
+    PGLContext ctx = getDisplayManager().getContext();
+    const bool complete = (pglEndList(ctx) == PGL_TRUE);
+    return complete && (pglSubmit(ctx, m_list) == PGL_TRUE);
 }
 
 bool WindowCanvas::handleWindowEvents()
@@ -27,6 +27,7 @@
 #include "Canvas.h"
 #include "DisplayManager.h"
 #include "DisplayAccessor.h"
+#include "StaticBitmap.h"
 
 
 namespace psc
@@ -43,13 +44,19 @@ void Canvas::clear(const psc::Color& color)
 {
 }
 
+void Canvas::clear(const psc::Color& color, const psc::Area& area)
+{
+}
+
 void Canvas::drawBitmap(const psc::StaticBitmap& bitmap, const psc::Area& area)
 {
     DisplayAccessor::instance().drawBitmapWasExecuted(true);
+    DisplayAccessor::instance().setBitmapFrame(bitmap.getFrame());
 }
 
 bool Canvas::verify(const psc::StaticBitmap& bitmap, const psc::Area& area)
 {
+    DisplayAccessor::instance().setBitmapFrame(bitmap.getFrame());
     return DisplayAccessor::instance().getVerifyFlag();
 }
 
@@ -0,0 +1,88 @@
+/******************************************************************************
+**
+**   File:        DamageRegionTest.cpp
+**   Description:
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+
+#include <gtest/gtest.h>
+#include "DamageRegion.h"
+#include "Area.h"
+
+using namespace psc;
+
+TEST(DamageRegionTest, EmptyTest)
+{
+    DamageRegion region;
+    EXPECT_TRUE(region.isEmpty());
+    EXPECT_FALSE(region.add(Area()));
+    EXPECT_TRUE(region.isEmpty());
+    EXPECT_FALSE(region.isOverlapping(Area(0, 0, 10, 10)));
+    EXPECT_FALSE(region.contains(Area(0, 0, 10, 10)));
+}
+
+TEST(DamageRegionTest, AddDisjointTest)
+{
+    DamageRegion region;
+    EXPECT_TRUE(region.add(Area(0, 0, 10, 10)));
+    EXPECT_TRUE(region.add(Area(50, 50, 60, 60)));
+    EXPECT_EQ(2U, region.getCount());
+    EXPECT_TRUE(region.isOverlapping(Area(5, 5, 20, 20)));
+    EXPECT_FALSE(region.isOverlapping(Area(20, 20, 30, 30)));
+    EXPECT_TRUE(region.contains(Area(52, 52, 58, 58)));
+    EXPECT_FALSE(region.contains(Area(5, 5, 55, 55)));
+
+    // already covered
+    EXPECT_FALSE(region.add(Area(2, 2, 8, 8)));
+    EXPECT_EQ(2U, region.getCount());
+
+    region.clear();
+    EXPECT_TRUE(region.isEmpty());
+}
+
+TEST(DamageRegionTest, MergeOverlappingTest)
+{
+    DamageRegion region;
+    EXPECT_TRUE(region.add(Area(0, 0, 10, 10)));
+    EXPECT_TRUE(region.add(Area(40, 0, 50, 10)));
+    // bridges both rectangles
+    EXPECT_TRUE(region.add(Area(5, 0, 45, 5)));
+    ASSERT_EQ(1U, region.getCount());
+    EXPECT_EQ(Area(0, 0, 50, 10), region.getArea(0U));
+}
+
+TEST(DamageRegionTest, MergeWhenFullTest)
+{
+    DamageRegion region;
+    for (I32 i = 0; i < static_cast<I32>(MAX_DAMAGE_RECTS); ++i)
+    {
+        EXPECT_TRUE(region.add(Area(i * 100, 0, i * 100 + 10, 10)));
+    }
+    EXPECT_EQ(MAX_DAMAGE_RECTS, region.getCount());
+
+    // closest to the first rectangle
+    EXPECT_TRUE(region.add(Area(0, 20, 10, 30)));
+    EXPECT_EQ(MAX_DAMAGE_RECTS, region.getCount());
+    EXPECT_TRUE(region.contains(Area(0, 0, 10, 30)));
+    EXPECT_TRUE(region.contains(Area(100, 0, 110, 10)));
+}
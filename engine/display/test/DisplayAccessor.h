@@ -47,6 +47,12 @@ public:
     void setVerifyFlag(bool flag);
     bool getVerifyFlag() const;
 
+    void setBitmapFrame(U32 frame);
+    /**
+     * Returns the frame of the bitmap which has been drawn or verified last.
+     */
+    U32 getBitmapFrame() const;
+
     ~DisplayAccessor();
 
 private:
@@ -54,6 +60,7 @@ private:
 
     bool m_drawBitmap;
     bool m_verifyFlag;
+    U32 m_bitmapFrame;
 };
 
 inline DisplayAccessor::DisplayAccessor()
@@ -68,6 +75,7 @@ inline void DisplayAccessor::toDefault()
 {
     m_drawBitmap = false;
     m_verifyFlag = true;
+    m_bitmapFrame = 0U;
 }
 
 inline void DisplayAccessor::drawBitmapWasExecuted(bool flag)
@@ -90,6 +98,16 @@ inline bool DisplayAccessor::getVerifyFlag() const
     return m_verifyFlag;
 }
 
+inline void DisplayAccessor::setBitmapFrame(U32 frame)
+{
+    m_bitmapFrame = frame;
+}
+
+inline U32 DisplayAccessor::getBitmapFrame() const
+{
+    return m_bitmapFrame;
+}
+
 
 } // namespace psc
 
@@ -81,6 +81,7 @@ TEST_F(DisplayManagerTest, empty)
     config.width = 400;
     config.height = 320;
     WindowCanvas canvas(dsp, config);
+    EXPECT_TRUE(canvas.isBufferPreserved());
 
     // draw on the window
     canvas.makeCurrent();
@@ -98,3 +99,24 @@ TEST_F(DisplayManagerTest, empty)
     // TODO : verify captured stdout
 }
 
+TEST_F(DisplayManagerTest, bitmapWithoutTextureIsNotDrawn)
+{
+    testing::internal::CaptureStdout();
+    pglInit();
+    DisplayManager dsp;
+    WindowDefinition config = WindowDefinition();
+    config.width = 400;
+    config.height = 320;
+    WindowCanvas canvas(dsp, config);
+    canvas.makeCurrent();
+
+    // the only texture slot is used by the first bitmap of the frame, there is no texture for the second one
+    dsp.getTextureCache().setBudget(1U, TEXTURE_CACHE_BYTES);
+    canvas.drawBitmap(m_db->getBitmap(1), Area(10, 15, 42, 52));
+    canvas.drawBitmap(m_db->getBitmap(2), Area(50, 15, 82, 52));
+    EXPECT_TRUE(canvas.verify(m_db->getBitmap(1), Area(10, 15, 42, 52)));
+    EXPECT_FALSE(canvas.verify(m_db->getBitmap(2), Area(50, 15, 82, 52)));
+    canvas.swapBuffers();
+    testing::internal::GetCapturedStdout();
+}
+
@@ -0,0 +1,245 @@
+/******************************************************************************
+**
+**   File:        TextureCacheTest.cpp
+**   Description: Tests the budget and the statistics of the TextureCache
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "DisplayManager.h"
+#include "TextureCache.h"
+#include "StaticBitmap.h"
+#include "Database.h"
+#include <fstream>
+#include <string>
+
+using namespace psc;
+
+namespace
+{
+const char* ddhbin = ROOT_PATH "/test/database/Telltales/Output/Telltales.ddhbin";
+const char* imgbin = ROOT_PATH "/test/database/Telltales/Output/Telltales.imgbin";
+}
+
+class TextureCacheTest : public ::testing::Test
+{
+    void SetUp() P_OVERRIDE
+    {
+        std::ifstream ifs1(ddhbin, std::ios::binary);
+        m_ddhbinData.assign((std::istreambuf_iterator<char>(ifs1)), (std::istreambuf_iterator<char>()));
+        std::ifstream ifs2(imgbin, std::ios::binary);
+        m_imgbinData.assign((std::istreambuf_iterator<char>(ifs2)), (std::istreambuf_iterator<char>()));
+        m_db = new Database(ResourceBuffer(m_ddhbinData.c_str(), m_ddhbinData.size()),
+                            ResourceBuffer(m_imgbinData.c_str(), m_imgbinData.size()));
+        pglInit();
+    }
+
+    void TearDown() P_OVERRIDE
+    {
+        delete m_db;
+        m_db = NULL;
+    }
+
+    std::string m_ddhbinData;
+    std::string m_imgbinData;
+
+protected:
+    // the tests use bitmaps of three different images
+    static bool differentImages(const StaticBitmap& a, const StaticBitmap& b, const StaticBitmap& c)
+    {
+        return (a.getImageId() != b.getImageId()) && (b.getImageId() != c.getImageId()) && (a.getImageId() != c.getImageId());
+    }
+
+    Database* m_db;
+};
+
+TEST_F(TextureCacheTest, hitsAndMisses)
+{
+    DisplayManager dsp;
+    TextureCache& cache = dsp.getTextureCache();
+    const StaticBitmap bmp = m_db->getBitmap(1);
+    Texture* texture = cache.load(bmp);
+    ASSERT_TRUE(texture != NULL);
+    EXPECT_TRUE(texture->isLoaded());
+    EXPECT_EQ(texture, cache.load(bmp));
+    const TextureCache::Statistics& stats = cache.getStatistics();
+    EXPECT_EQ(1U, stats.hits);
+    EXPECT_EQ(1U, stats.misses);
+    EXPECT_EQ(0U, stats.evictions);
+    EXPECT_EQ(1U, stats.textures);
+    EXPECT_GT(stats.bytes, 0U);
+}
+
+TEST_F(TextureCacheTest, leastRecentlyUsedIsEvicted)
+{
+    DisplayManager dsp;
+    TextureCache& cache = dsp.getTextureCache();
+    const StaticBitmap a = m_db->getBitmap(1);
+    const StaticBitmap b = m_db->getBitmap(2);
+    const StaticBitmap c = m_db->getBitmap(3);
+    ASSERT_TRUE(differentImages(a, b, c));
+    cache.setBudget(2U, TEXTURE_CACHE_BYTES);
+    Texture* textureA = cache.load(a);
+    Texture* textureB = cache.load(b);
+    ASSERT_TRUE((textureA != NULL) && (textureB != NULL));
+    dsp.endFrame();
+    EXPECT_EQ(textureA, cache.load(a));
+    dsp.endFrame();
+
+    // b has not been used for the longest time, its slot is reused for c
+    EXPECT_EQ(textureB, cache.load(c));
+    EXPECT_EQ(1U, cache.getStatistics().evictions);
+    EXPECT_EQ(2U, cache.getStatistics().textures);
+    EXPECT_EQ(textureA, cache.load(a));
+    dsp.endFrame();
+    EXPECT_EQ(textureB, cache.load(b));
+    EXPECT_EQ(2U, cache.getStatistics().evictions);
+    EXPECT_EQ(4U, cache.getStatistics().misses);
+    EXPECT_EQ(2U, cache.getStatistics().hits);
+}
+
+TEST_F(TextureCacheTest, texturesOfTheCurrentFrameAreKept)
+{
+    DisplayManager dsp;
+    TextureCache& cache = dsp.getTextureCache();
+    const StaticBitmap a = m_db->getBitmap(1);
+    const StaticBitmap b = m_db->getBitmap(2);
+    const StaticBitmap c = m_db->getBitmap(3);
+    ASSERT_TRUE(differentImages(a, b, c));
+    cache.setBudget(1U, TEXTURE_CACHE_BYTES);
+    EXPECT_TRUE(cache.load(a) != NULL);
+    // a may be referenced by a pgl list of this frame
+    EXPECT_TRUE(cache.load(b) == NULL);
+    EXPECT_EQ(0U, cache.getStatistics().evictions);
+    dsp.endFrame();
+    EXPECT_TRUE(cache.load(b) != NULL);
+    EXPECT_EQ(1U, cache.getStatistics().evictions);
+    EXPECT_EQ(1U, cache.getStatistics().textures);
+}
+
+TEST_F(TextureCacheTest, evictedSlotsAreNotFound)
+{
+    DisplayManager dsp;
+    TextureCache& cache = dsp.getTextureCache();
+    const StaticBitmap a = m_db->getBitmap(1);
+    const StaticBitmap b = m_db->getBitmap(2);
+    const StaticBitmap c = m_db->getBitmap(3);
+    const StaticBitmap noImage = m_db->getBitmap(0xffffU);
+    ASSERT_TRUE(differentImages(a, b, c));
+    ASSERT_EQ(0U, noImage.getImageId());
+    Texture* textureA = cache.load(a);
+    Texture* textureB = cache.load(b);
+    ASSERT_TRUE((textureA != NULL) && (textureB != NULL));
+    dsp.endFrame();
+
+    // both textures are evicted to make room for c, which reuses the first slot
+    cache.setBudget(1U, TEXTURE_CACHE_BYTES);
+    EXPECT_EQ(textureA, cache.load(c));
+    EXPECT_EQ(2U, cache.getStatistics().evictions);
+    EXPECT_FALSE(textureB->isLoaded());
+
+    // the evicted slot has no image, but a bitmap without an image doesn't get its stale texture
+    EXPECT_TRUE(cache.load(noImage) == NULL);
+    EXPECT_EQ(1U, cache.getStatistics().textures);
+}
+
+TEST_F(TextureCacheTest, byteBudget)
+{
+    DisplayManager dsp;
+    TextureCache& cache = dsp.getTextureCache();
+    const StaticBitmap a = m_db->getBitmap(1);
+    const StaticBitmap b = m_db->getBitmap(2);
+    const StaticBitmap c = m_db->getBitmap(3);
+    ASSERT_TRUE(differentImages(a, b, c));
+    EXPECT_TRUE(cache.load(a) != NULL);
+    const U32 bytesA = cache.getStatistics().bytes;
+    cache.setBudget(MAX_TEXTURES_COUNT, bytesA);
+    dsp.endFrame();
+    EXPECT_TRUE(cache.load(b) != NULL);
+    EXPECT_EQ(1U, cache.getStatistics().evictions);
+    EXPECT_EQ(1U, cache.getStatistics().textures);
+    const U32 bytesB = cache.getStatistics().bytes;
+
+    // the budget is exceeded by the textures of the current frame, which are not evicted
+    EXPECT_TRUE(cache.load(c) != NULL);
+    EXPECT_EQ(2U, cache.getStatistics().textures);
+    EXPECT_GT(cache.getStatistics().bytes, bytesB);
+}
+
+TEST_F(TextureCacheTest, prewarm)
+{
+    DisplayManager dsp;
+    TextureCache& cache = dsp.getTextureCache();
+    // a time budget spreads the loading over several calls
+    U32 calls = 1U;
+    while (!dsp.prewarm(*m_db, 1U) && (calls < 1000U))
+    {
+        ++calls;
+    }
+    EXPECT_TRUE(dsp.prewarm(*m_db, 0U));
+    const U16 textures = cache.getStatistics().textures;
+    EXPECT_GE(textures, 3U);
+    EXPECT_EQ(0U, cache.getStatistics().misses);
+
+    // drawing doesn't load anything
+    EXPECT_TRUE(cache.load(m_db->getBitmap(1)) != NULL);
+    EXPECT_TRUE(cache.load(m_db->getBitmap(3)) != NULL);
+    EXPECT_EQ(2U, cache.getStatistics().hits);
+    EXPECT_EQ(0U, cache.getStatistics().misses);
+    EXPECT_EQ(textures, cache.getStatistics().textures);
+}
+
+TEST_F(TextureCacheTest, prewarmStopsAtTheBudget)
+{
+    DisplayManager dsp;
+    TextureCache& cache = dsp.getTextureCache();
+    const StaticBitmap a = m_db->getBitmap(1);
+    const StaticBitmap b = m_db->getBitmap(2);
+    const StaticBitmap c = m_db->getBitmap(3);
+    ASSERT_TRUE(differentImages(a, b, c));
+    cache.setBudget(2U, TEXTURE_CACHE_BYTES);
+    EXPECT_TRUE(dsp.prewarm(*m_db, 0U));
+    EXPECT_EQ(2U, cache.getStatistics().textures);
+    EXPECT_EQ(0U, cache.getStatistics().evictions);
+
+    // the prewarmed textures are not used by the current frame, they make room for the drawn ones
+    EXPECT_TRUE(cache.load(a) != NULL);
+    EXPECT_TRUE(cache.load(b) != NULL);
+    dsp.endFrame();
+    EXPECT_TRUE(cache.load(c) != NULL);
+    EXPECT_EQ(2U, cache.getStatistics().textures);
+}
+
+TEST_F(TextureCacheTest, prewarmSkipsFailingImages)
+{
+    DisplayManager dsp;
+    TextureCache& cache = dsp.getTextureCache();
+    // no pgl texture left: no image can be loaded, but the budget isn't reached
+    U32 created = 0U;
+    while ((NULL != pglCreateTexture(dsp.getContext())) && (created < 1000U))
+    {
+        ++created;
+    }
+    EXPECT_TRUE(cache.prewarm(m_db->getBitmap(1)));
+    EXPECT_TRUE(dsp.prewarm(*m_db, 0U));
+    EXPECT_EQ(0U, cache.getStatistics().textures);
+}
@@ -90,8 +90,8 @@ private:
 
     /**
      * Method updates internal variables (evaluates value of bitmap ID).
-     * If new value differs from the older one, the invalidated flag
-     * will be risen (see @c psc::Widget::invalidate method).
+     * If new value differs from the older one or the frame of an animated bitmap
+     * changes, the invalidated flag will be risen (see @c psc::Widget::invalidate method).
      *
      * @param[in] monotonicTimeMs current monotonic system time in milliseconds.
      */
@@ -28,6 +28,7 @@
 ******************************************************************************/
 
 #include "Widget.h"
+#include "ddh_defs.h"
 
 namespace psc
 {
@@ -65,8 +66,40 @@ public:
 
 protected:
     Field();
+
+    /**
+     * Method selects the frame of an animated bitmap at the given time.
+     * The frame is looked up on the first call and again if the bitmap has changed or
+     * the current frame has been shown for its duration.
+     *
+     * @param[in] db              object provides work with database.
+     * @param[in] bitmapId        the bitmap which is shown.
+     * @param[in] monotonicTimeMs current monotonic system time in milliseconds.
+     * @param[in] bitmapChanged   @c true if @c bitmapId has changed since the last call.
+     *
+     * @return @c true if the frame has changed, @c false otherwise.
+     */
+    bool updateFrame(const Database& db, const BitmapId bitmapId, const U32 monotonicTimeMs, const bool bitmapChanged);
+
+    /**
+     * Method returns the frame which was selected by @c updateFrame.
+     *
+     * @return frame index (see @c psc::StaticBitmap::setFrame).
+     */
+    U32 getFrame() const;
+
+private:
+    U32 m_frame;
+    U32 m_nextFrameTime;
+    bool m_animated;
+    bool m_frameSelected;
 };
 
+inline U32 Field::getFrame() const
+{
+    return m_frame;
+}
+
 } // namespace psc
 
 #endif // POPULUSSC_FIELD_H
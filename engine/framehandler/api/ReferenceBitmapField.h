@@ -96,9 +96,8 @@ private:
     bool setup(DataContext* pContext, PSCErrorCollector& error);
 
     /**
-     * Method updates internal variables (evaluates value of bitmap ID).
-     * If new value differs from the older one, the invalidated flag
-     * will be risen (see @c psc::Widget::invalidate method).
+     * Method updates internal variables (evaluates value of bitmap ID and
+     * selects the frame of an animated bitmap which is verified).
      *
      * @param[in] monotonicTimeMs current monotonic system time in milliseconds.
      */
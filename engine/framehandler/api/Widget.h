@@ -42,6 +42,7 @@ namespace psc
 
 class BoolExpression;
 class Canvas;
+class DamageRegion;
 class WidgetPool;
 
 /**
@@ -81,6 +82,33 @@ public:
      */
     void draw(Canvas& canvas, const Area& area);
 
+    /**
+     * Draws only the widgets of the tree which overlap the damage region.
+     * All widgets are validated, also the ones which are not drawn.
+     *
+     * @param[in] canvas canvas, see @c Canvas.
+     * @param[in] area area in absolute coordinates.
+     * @param[in] damage areas of the canvas which have been cleared for the redraw.
+     */
+    void draw(Canvas& canvas, const Area& area, const DamageRegion& damage);
+
+    /**
+     * Adds the areas of all invalidated widgets (absolute coordinates) to the damage region.
+     * The children of an invalidated widget are covered by its area.
+     *
+     * @param[out] damage the region which collects the damaged areas.
+     * @param[in]  area   area of this widget in absolute coordinates.
+     */
+    void collectDamage(DamageRegion& damage, const Area& area) const;
+
+    /**
+     * Adds the complete area of every visible widget which draws content and overlaps the damage region.
+     * Such a widget is redrawn completely, so its whole area has to be cleared before.
+     *
+     * @return @c true if the region has changed - widgets which overlap the added areas have to be checked again.
+     */
+    bool expandDamage(DamageRegion& damage, const Area& area) const;
+
     /**
      * Performs a pixel verification on the given canvas
      *
@@ -249,6 +277,10 @@ protected:
      */
     void updateVisibility(/* const U32 monotonicTimeMs */);
 private:
+    /**
+     * Draws the widget tree, @c pDamage equal to @c NULL draws all widgets.
+     */
+    void draw(Canvas& canvas, const Area& area, const DamageRegion* pDamage);
 
     Area m_area;
     std::size_t m_childrenCount;
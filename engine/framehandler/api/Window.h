@@ -75,6 +75,7 @@ public:
     /**
      * Method renders window widget and all its children on internal canvas.
      * Render operation will be evaluated only if window or its children are in invalidated state.
+     * Only the areas of the invalidated widgets are cleared, redrawn and presented (see @c DamageRegion).
      *
      * @return @c true if rendering was emitted, @c false otherwise.
      */
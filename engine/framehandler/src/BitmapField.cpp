@@ -62,6 +62,7 @@ BitmapField* BitmapField::create(WidgetPool& widgetPool,
 BitmapField::BitmapField(const Database& db, const StaticBitmapFieldType* const pDdh)
     : m_pDdh(pDdh)
     , m_db(db)
+    , m_bitmapId(0U)
 {
     ASSERT(NULL != m_pDdh);
 }
@@ -106,22 +107,30 @@ bool BitmapField::setupBitmapExr(DataContext* pContext)
     return res;
 }
 
-void BitmapField::onUpdate(const U32 /* monotonicTimeMs */)
+void BitmapField::onUpdate(const U32 monotonicTimeMs)
 {
+    bool bitmapChanged = false;
     BitmapId tmpValue;
     if (tryToUpdateValue(m_bitmapExpr, tmpValue))
     {
         if (m_bitmapId != tmpValue)
         {
             m_bitmapId = tmpValue;
-            invalidate();
+            bitmapChanged = true;
         }
     }
+    // animations are only redrawn when the frame changes
+    const bool frameChanged = updateFrame(m_db, m_bitmapId, monotonicTimeMs, bitmapChanged);
+    if (bitmapChanged || frameChanged)
+    {
+        invalidate();
+    }
 }
 
 void BitmapField::onDraw(Canvas& canvas, const Area& area)
 {
     StaticBitmap bitmap = m_db.getBitmap(m_bitmapId);
+    bitmap.setFrame(getFrame());
 
     canvas.drawBitmap(bitmap, area);
 }
@@ -29,6 +29,7 @@
 #include "ReferenceBitmapField.h"
 
 #include <FieldType.h>
+#include <Database.h>
 
 namespace psc
 {
@@ -70,6 +71,28 @@ Field* Field::create(WidgetPool& widgetPool,
 }
 
 Field::Field()
+    : m_frame(0U)
+    , m_nextFrameTime(0U)
+    , m_animated(false)
+    , m_frameSelected(false)
 {}
 
+bool Field::updateFrame(const Database& db, const BitmapId bitmapId, const U32 monotonicTimeMs, const bool bitmapChanged)
+{
+    bool changed = false;
+    // the difference is evaluated signed, which works when the monotonic time wraps around
+    // the first lookup doesn't depend on bitmapChanged, the initial bitmap may be unchanged
+    if (bitmapChanged || !m_frameSelected || (m_animated && (static_cast<I32>(monotonicTimeMs - m_nextFrameTime) >= 0)))
+    {
+        U32 remainingMs = 0U;
+        const U32 frame = db.getBitmap(bitmapId).getAnimationFrame(monotonicTimeMs, remainingMs);
+        changed = (frame != m_frame);
+        m_frame = frame;
+        m_animated = (remainingMs > 0U);
+        m_nextFrameTime = monotonicTimeMs + remainingMs;
+        m_frameSelected = true;
+    }
+    return changed;
+}
+
 } // namespace psc
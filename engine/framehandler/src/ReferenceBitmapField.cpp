@@ -63,6 +63,7 @@ ReferenceBitmapField::ReferenceBitmapField(const Database& db, const ReferenceBi
     : m_pDdh(pDdh)
     , m_db(db)
     , m_pContext(NULL)
+    , m_bitmapId(0U)
 {
     ASSERT(NULL != m_pDdh);
 }
@@ -107,16 +108,20 @@ bool ReferenceBitmapField::setupBitmapExr(DataContext* pContext)
     return res;
 }
 
-void ReferenceBitmapField::onUpdate(const U32 /* monotonicTimeMs */)
+void ReferenceBitmapField::onUpdate(const U32 monotonicTimeMs)
 {
+    bool bitmapChanged = false;
     BitmapId tmpValue;
     if (tryToUpdateValue(m_bitmapExpr, tmpValue))
     {
         if (m_bitmapId != tmpValue)
         {
             m_bitmapId = tmpValue;
+            bitmapChanged = true;
         }
     }
+    // the same frame as the drawn bitmap is verified, animations share the time base
+    static_cast<void>(updateFrame(m_db, m_bitmapId, monotonicTimeMs, bitmapChanged));
 }
 
 void ReferenceBitmapField::onDraw(Canvas& /* canvas */, const Area& /* area */)
@@ -131,6 +136,7 @@ bool ReferenceBitmapField::onVerify(Canvas& canvas, const Area& area)
     {
         verified = false;
         StaticBitmap bitmap = m_db.getBitmap(m_bitmapId);
+        bitmap.setFrame(getFrame());
         verified = canvas.verify(bitmap, area);
 
         if (!verified)
@@ -28,6 +28,8 @@
 #include "WidgetPool.h"
 #include "Assertion.h"
 
+#include <DamageRegion.h>
+
 namespace psc
 {
 
@@ -175,12 +177,25 @@ void Widget::update(const U32 monotonicTimeMs)
 }
 
 void Widget::draw(Canvas& canvas, const Area& area)
+{
+    draw(canvas, area, NULL);
+}
+
+void Widget::draw(Canvas& canvas, const Area& area, const DamageRegion& damage)
+{
+    draw(canvas, area, &damage);
+}
+
+void Widget::draw(Canvas& canvas, const Area& area, const DamageRegion* pDamage)
 {
     m_isInvalidated = false;
 
     if (isVisible())
     {
-        onDraw(canvas, area);
+        if ((NULL == pDamage) || pDamage->isOverlapping(area))
+        {
+            onDraw(canvas, area);
+        }
 
         for (std::size_t i = 0U; i < m_childrenCount; ++i)
         {
@@ -191,9 +206,66 @@ void Widget::draw(Canvas& canvas, const Area& area)
             childArea.moveByFP(area.getLeftFP(), area.getTopFP());
 
             // coverity[stack_use_unknown]
-            pChild->draw(canvas, childArea);
+            pChild->draw(canvas, childArea, pDamage);
+        }
+    }
+}
+
+void Widget::collectDamage(DamageRegion& damage, const Area& area) const
+{
+    if (m_isInvalidated)
+    {
+        static_cast<void>(damage.add(area));
+    }
+    else if (isVisible())
+    {
+        for (std::size_t i = 0U; i < m_childrenCount; ++i)
+        {
+            const Widget* pChild = m_children[i];
+            ASSERT(pChild != NULL);
+
+            Area childArea(pChild->getArea());
+            childArea.moveByFP(area.getLeftFP(), area.getTopFP());
+
+            // coverity[stack_use_unknown]
+            pChild->collectDamage(damage, childArea);
+        }
+    }
+    else
+    {
+        // an invisible widget is not on screen - its children don't damage anything
+    }
+}
+
+bool Widget::expandDamage(DamageRegion& damage, const Area& area) const
+{
+    bool changed = false;
+    if (isVisible())
+    {
+        // only bitmap fields draw pixels, containers just position their children
+        const WidgetType type = getType();
+        const bool drawsContent = (type == WIDGET_TYPE_BITMAP_FIELD) || (type == WIDGET_TYPE_REF_BITMAP_FIELD);
+        if (drawsContent && damage.isOverlapping(area))
+        {
+            changed = damage.add(area);
+        }
+
+        for (std::size_t i = 0U; i < m_childrenCount; ++i)
+        {
+            const Widget* pChild = m_children[i];
+            ASSERT(pChild != NULL);
+
+            Area childArea(pChild->getArea());
+            childArea.moveByFP(area.getLeftFP(), area.getTopFP());
+
+            // coverity[stack_use_unknown]
+            if (pChild->expandDamage(damage, childArea))
+            {
+                changed = true;
+            }
         }
     }
+    return changed;
 }
 
 bool Widget::verify(Canvas& canvas, const Area& area)
@@ -35,6 +35,7 @@
 #include <Color.h>
 
 #include <WindowCanvas.h>
+#include <DamageRegion.h>
 
 #include <new>
 
@@ -53,13 +54,49 @@ bool Window::render()
     bool res = false;
     if (isInvalidated())
     {
+        DamageRegion damage;
+        collectDamage(damage, getArea());
         m_canvas.makeCurrent();
         Color color;
-        m_canvas.clear(color);
-        draw(m_canvas, getArea());
-        m_canvas.swapBuffers();
-
-        res = true;
+        if (damage.contains(getArea()) || (!damage.isEmpty() && !m_canvas.isBufferPreserved()))
+        {
+            // e.g. the first frame - it is recorded as a whole, so the backend can skip the overdrawn parts.
+            // Without a preserved buffer the pixels outside of the damage are undefined after the swap,
+            // so every frame is drawn completely.
+            bool drawn = false;
+            if (m_canvas.beginList())
+            {
+                m_canvas.clear(color);
+                draw(m_canvas, getArea());
+                drawn = m_canvas.submitList();
+            }
+            if (!drawn)
+            {
+                m_canvas.clear(color);
+                draw(m_canvas, getArea());
+            }
+            m_canvas.swapBuffers();
+            res = true;
+        }
+        else if (!damage.isEmpty())
+        {
+            // bitmaps which are partly inside the damage are redrawn completely
+            while (expandDamage(damage, getArea()))
+            {
+            }
+            for (std::size_t i = 0U; i < damage.getCount(); ++i)
+            {
+                m_canvas.clear(color, damage.getArea(i));
+            }
+            draw(m_canvas, getArea(), damage);
+            m_canvas.swapBuffers(damage);
+            res = true;
+        }
+        else
+        {
+            // only invisible widgets have changed: the presented frame is still valid, the list of the last
+            // complete frame isn't submitted again (the back buffer is kept up to date by pglSwapBuffersRegion)
+        }
     }
     return res;
 }
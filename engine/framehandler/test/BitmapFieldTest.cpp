@@ -30,6 +30,7 @@
 #include <PSCErrorCollector.h>
 
 #include <BitmapField.h>
+#include <DamageRegion.h>
 
 #include <gtest/gtest.h>
 
@@ -67,6 +68,13 @@ protected:
         return field;
     }
 
+    bool isDamaged(const psc::BitmapField& field, const psc::Area& area)
+    {
+        psc::DamageRegion damage;
+        field.collectDamage(damage, area);
+        return !damage.isEmpty();
+    }
+
     framehandlertests::DdhStaticBitmapFieldBuilder m_builder;
 };
 
@@ -195,3 +203,64 @@ TEST_F(BitmapFieldTest, DrawBitmapFieldTest)
 
     EXPECT_TRUE(psc::DisplayAccessor::instance().wasDrawBitmapExecuted());
 }
+
+TEST_F(BitmapFieldTest, AnimationFrameChangeInvalidatesTest)
+{
+    psc::AreaType areaType;
+    psc::DynamicDataType dataType;
+    m_builder.create(areaType, true, dataType);
+    psc::BitmapField* field = createField(m_builder);
+
+    // 4 frames, each shown for 100 ms
+    psc::DatabaseAccessor::instance().setAnimation(4U, 100U);
+    initDataHandler(6U);
+
+    // the damage region ignores empty areas
+    psc::Area area(0, 0, 10, 10);
+
+    field->update(0U);
+    EXPECT_TRUE(isDamaged(*field, area));
+    field->draw(m_canvas, area);
+    EXPECT_EQ(0U, psc::DisplayAccessor::instance().getBitmapFrame());
+    EXPECT_FALSE(isDamaged(*field, area));
+
+    // the frame index is unchanged, nothing has to be redrawn
+    field->update(99U);
+    EXPECT_FALSE(isDamaged(*field, area));
+
+    // the frame boundary is crossed
+    field->update(100U);
+    EXPECT_TRUE(isDamaged(*field, area));
+    field->draw(m_canvas, area);
+    EXPECT_EQ(1U, psc::DisplayAccessor::instance().getBitmapFrame());
+    EXPECT_FALSE(isDamaged(*field, area));
+
+    // a late update skips frames and wraps around the animation
+    field->update(450U);
+    EXPECT_TRUE(isDamaged(*field, area));
+    field->draw(m_canvas, area);
+    EXPECT_EQ(0U, psc::DisplayAccessor::instance().getBitmapFrame());
+
+    EXPECT_EQ(PSC_NO_ERROR, field->getError());
+}
+
+TEST_F(BitmapFieldTest, StaticBitmapIsNotInvalidatedTest)
+{
+    psc::AreaType areaType;
+    psc::DynamicDataType dataType;
+    m_builder.create(areaType, true, dataType);
+    psc::BitmapField* field = createField(m_builder);
+
+    initDataHandler(6U);
+
+    // the damage region ignores empty areas
+    psc::Area area(0, 0, 10, 10);
+
+    field->update(0U);
+    field->draw(m_canvas, area);
+    EXPECT_FALSE(isDamaged(*field, area));
+
+    // the time passes, but a bitmap without animation keeps its frame
+    field->update(1000U);
+    EXPECT_FALSE(isDamaged(*field, area));
+}
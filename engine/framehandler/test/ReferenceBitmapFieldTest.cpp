@@ -351,3 +351,39 @@ TEST_F(ReferenceBitmapFieldTest, DrawMethodDrawsNothingTest)
     // Check on empty implementation
     EXPECT_FALSE(psc::DisplayAccessor::instance().wasDrawBitmapExecuted());
 }
+
+TEST_F(ReferenceBitmapFieldTest, VerifiedFrameFollowsAnimationTest)
+{
+    psc::AreaType areaType;
+    psc::DynamicDataType dataType;
+    m_builder.create(43U, areaType, true, dataType);
+    psc::ReferenceBitmapField* field = createField(m_builder);
+
+    // 3 frames, each shown for 40 ms
+    psc::DatabaseAccessor::instance().setAnimation(3U, 40U);
+    initDataHandler(6U);
+
+    psc::Area area(&areaType);
+
+    field->update(0U);
+    EXPECT_TRUE(field->verify(m_canvas, area));
+    EXPECT_EQ(0U, psc::DisplayAccessor::instance().getBitmapFrame());
+
+    field->update(39U);
+    EXPECT_TRUE(field->verify(m_canvas, area));
+    EXPECT_EQ(0U, psc::DisplayAccessor::instance().getBitmapFrame());
+
+    field->update(40U);
+    EXPECT_TRUE(field->verify(m_canvas, area));
+    EXPECT_EQ(1U, psc::DisplayAccessor::instance().getBitmapFrame());
+
+    field->update(80U);
+    EXPECT_TRUE(field->verify(m_canvas, area));
+    EXPECT_EQ(2U, psc::DisplayAccessor::instance().getBitmapFrame());
+
+    field->update(120U);
+    EXPECT_TRUE(field->verify(m_canvas, area));
+    EXPECT_EQ(0U, psc::DisplayAccessor::instance().getBitmapFrame());
+
+    EXPECT_EQ(PSC_NO_ERROR, field->getError());
+}
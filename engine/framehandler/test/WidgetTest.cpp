@@ -44,6 +44,7 @@
 #include <MockDataHandler.h>
 
 #include <DisplayManager.h>
+#include <DamageRegion.h>
 #include <WindowDefinition.h>
 
 #include <PscLimits.h>
@@ -532,6 +533,93 @@ TEST(WidgetTest, OnDrawWithNotVisibleObjectTest)
     widget.draw(canvas, area);
 }
 
+TEST(WidgetTest, OnDrawDamagedTest)
+{
+    MockWidget widget;
+    MockWidget child1;
+    MockWidget child2;
+    widget.addChild(&child1);
+    widget.addChild(&child2);
+
+    psc::DisplayManager dsp;
+    TestCanvas canvas(dsp, 640U, 480U);
+    psc::Area widgetArea(0, 0, 100, 100);
+    child1.setArea(psc::Area(10, 10, 20, 20));
+    child2.setArea(psc::Area(50, 50, 60, 60));
+
+    widget.update(0U);
+
+    psc::DamageRegion damage;
+    damage.add(psc::Area(12, 12, 14, 14));
+
+    EXPECT_CALL(widget, onDraw(Ref(canvas), _))
+        .Times(1);
+    EXPECT_CALL(child1, onDraw(Ref(canvas), _))
+        .Times(1);
+    EXPECT_CALL(child2, onDraw(Ref(canvas), _))
+        .Times(0);
+
+    widget.draw(canvas, widgetArea, damage);
+
+    // the widgets outside of the damage region are validated as well
+    EXPECT_FALSE(widget.isInvalidated());
+}
+
+TEST(WidgetTest, CollectDamageTest)
+{
+    MockWidget widget;
+    MockWidget child1;
+    MockWidget child2;
+    widget.addChild(&child1);
+    widget.addChild(&child2);
+
+    psc::DisplayManager dsp;
+    TestCanvas canvas(dsp, 640U, 480U);
+    psc::Area widgetArea(5, 5, 100, 100);
+    child1.setArea(psc::Area(10, 10, 20, 20));
+    child2.setArea(psc::Area(50, 50, 60, 60));
+
+    widget.update(0U);
+    EXPECT_CALL(widget, onDraw(Ref(canvas), _));
+    EXPECT_CALL(child1, onDraw(Ref(canvas), _));
+    EXPECT_CALL(child2, onDraw(Ref(canvas), _));
+    widget.draw(canvas, widgetArea);
+
+    psc::DamageRegion damage;
+    widget.collectDamage(damage, widgetArea);
+    EXPECT_TRUE(damage.isEmpty());
+
+    child2.invalidate();
+    widget.collectDamage(damage, widgetArea);
+    ASSERT_EQ(1U, damage.getCount());
+    // child areas are relative to the parent
+    EXPECT_EQ(psc::Area(55, 55, 65, 65), damage.getArea(0U));
+}
+
+TEST(WidgetTest, ExpandDamageTest)
+{
+    MockWidget widget;
+    MockWidget child1;
+    MockWidget child2;
+    widget.addChild(&child1);
+    widget.addChild(&child2);
+
+    psc::Area widgetArea(0, 0, 100, 100);
+    widget.setArea(widgetArea);
+    child1.setArea(psc::Area(10, 10, 30, 30));
+    child2.setArea(psc::Area(25, 25, 40, 40));
+    widget.update(0U);
+
+    psc::DamageRegion damage;
+    damage.add(psc::Area(12, 12, 14, 14));
+    while (widget.expandDamage(damage, psc::Area(0, 0, 20, 20)))
+    {
+    }
+    ASSERT_EQ(1U, damage.getCount());
+    // the whole widget and the transitively overlapping child areas
+    EXPECT_TRUE(damage.contains(psc::Area(0, 0, 40, 40)));
+}
+
 TEST(WidgetTest, CalculationAreaTest)
 {
     MockWidget widget;
@@ -26,6 +26,7 @@
 
 #include "Engine.h"
 #include "OdiTypes.h"
+#include "PscLimits.h"
 #include <pgw.h>
 
 namespace psc
@@ -38,6 +39,7 @@ Engine::Engine(const Database& db, IMsgDispatcher& msgDispatcher)
 , m_dataHandler(db)
 , m_frameHandler(m_db, m_dataHandler, m_display)
 , m_error(db.getError())
+, m_prewarmed(false)
 {
     if (PSC_NO_ERROR == m_error)
     {
@@ -62,6 +64,11 @@ bool Engine::render()
     m_error = m_msgDispatcher.handleIncomingData(0);
     const U32 monotonicTime = pgwGetMonotonicTime();
     m_frameHandler.update(monotonicTime);
+    if (!m_prewarmed)
+    {
+        // the textures are loaded in advance, so a telltale which appears later doesn't delay its frame
+        m_prewarmed = m_display.prewarm(m_db, TEXTURE_PREWARM_BUDGET_MS);
+    }
     return m_frameHandler.render();
 }
 
@@ -54,6 +54,7 @@ private:
     DataHandler m_dataHandler;
     FrameHandler m_frameHandler;
     PSCError m_error;
+    bool m_prewarmed; ///< all textures have been loaded in advance (DisplayManager::prewarm)
 };
 
 } // namespace psc
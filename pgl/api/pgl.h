@@ -60,6 +60,7 @@ typedef int PGLBoolean;
 typedef struct pgl_surface_t* PGLSurface;
 typedef struct pgl_context_t* PGLContext;
 typedef struct pgl_texture_t* PGLTexture;
+typedef struct pgl_list_t* PGLList;
 
 #define PGL_FALSE 0
 #define PGL_TRUE 1
@@ -76,14 +77,79 @@ typedef enum
     PGL_FORMAT_RGB_565,
     PGL_FORMAT_BGR_565,
     PGL_FORMAT_2_BPP, 	  ///< all formats before use less than 2 byte per pixel
+    PGL_FORMAT_RGB_888,       ///< 24 bit, bytes in memory: R, G, B
+    PGL_FORMAT_BGR_888,       ///< 24 bit, bytes in memory: B, G, R
     PGL_FORMAT_3_BPP, 	  ///< all formats before use less than 3 byte per pixel
     PGL_FORMAT_ARGB_8888,
     PGL_FORMAT_BGRA_8888,
     PGL_FORMAT_RGBA_8888,
+    PGL_FORMAT_BGRA_8888_PRE, ///< BGRA_8888 with premultiplied alpha
+    PGL_FORMAT_RGBA_8888_PRE, ///< RGBA_8888 with premultiplied alpha
     PGL_FORMAT_4_BPP, 	  ///< all formats before use less than 4 byte per pixel
 	PGL_FORMAT_INVALID
 } PGLFormat;
 
+/**
+ * Rectangle in 28.4 fixed point coordinates. x2 / y2 is the last pixel inside the rectangle (same as pglDrawArea).
+ */
+typedef struct
+{
+    int32_t x1;
+    int32_t y1;
+    int32_t x2;
+    int32_t y2;
+} PGLRect;
+
+/**
+ * Compression of the pixel data of pglLoadTextureEncoded
+ */
+typedef enum
+{
+    PGL_ENCODING_RAW,  ///< uncompressed rows (like pglLoadTexture)
+    PGL_ENCODING_RLE,  ///< run length encoded rows: packets of a header byte with the number of pixels - 1 in the lower 7 bits.
+                       ///< If the upper bit is set one pixel follows, which is repeated, otherwise the pixels follow one after the other.
+                       ///< A packet never continues in the next row.
+    PGL_ENCODING_RLE2, ///< like PGL_ENCODING_RLE with the bytes of each pixel in reversed order (switched endianness)
+    PGL_ENCODING_FLZ   ///< FastLZ (level 1) compressed rows
+} PGLEncoding;
+
+/**
+ * Texture sampling of scaled pglDrawQuad calls
+ */
+typedef enum
+{
+    PGL_FILTER_NEAREST, ///< the nearest texel is used (sharp edges, no new colors)
+    PGL_FILTER_LINEAR   ///< bilinear interpolation of the four nearest texels
+} PGLFilter;
+
+/**
+ * How pglVerify compares the surface with the texture
+ */
+typedef enum
+{
+    PGL_VERIFY_PIXELS,  ///< every pixel of the surface is compared with the texture
+    PGL_VERIFY_TILE_CRC ///< the CRC of fixed size tiles of the surface is compared with the tile CRCs of the texture (calculated once per texture,
+                        ///< when a texture of the context is loaded).
+                        ///< Implementations fall back to pixels if the CRCs can't be used (e.g. scaled or blended quads).
+} PGLVerification;
+
+/**
+ * Options of a rendering context (see pglCreateContext)
+ */
+typedef struct
+{
+    /**
+     * Number of threads which execute the drawing commands (0 or 1: the commands are executed immediately by the calling thread).
+     * With more threads the commands are recorded and the surface is split into tiles, which are rasterized in parallel
+     * before pglVerify, pglSwapBuffers or pglSwapBuffersRegion. Implementations without threading support ignore the value.
+     */
+    uint32_t threads;
+    /**
+     * Comparison of pglVerify (PGL_VERIFY_PIXELS by default)
+     */
+    PGLVerification verification;
+} PGLContextConfig;
+
 typedef enum
 {
     PGL_NO_ERROR = 0,
@@ -109,8 +175,9 @@ PGL_API PGLSurface pglCreateWindow(uint8_t window, int32_t x, int32_t y, int32_t
 
 /**
  * Creates a rendering context
+ * @param config context options, NULL uses the defaults (single threaded)
  */
-PGL_API PGLContext pglCreateContext(void);
+PGL_API PGLContext pglCreateContext(const PGLContextConfig* config);
 
 /**
  * Attaches the rendering context to a surface (in which the results of drawing commands will be stored)
@@ -141,6 +208,28 @@ PGL_API PGLTexture pglCreateTexture(PGLContext context);
  */
 PGL_API PGLBoolean pglLoadTexture(PGLTexture, uint32_t width, uint32_t height, PGLFormat format, PGLBoolean copy, const void* data);
 
+/**
+ * Loads compressed pixel data into the texture. The data has to stay valid until shutdown (e.g. textures in ROM).
+ * Implementations may draw RLE textures directly from the encoded data, other encodings are decompressed into texture
+ * memory of the implementation. Scaled quads of RLE textures may need texture memory as well (decoded at their first use).
+ * @param encoding compression of data
+ * @param size size of data in bytes
+ * @return PGL_FALSE if the encoding isn't supported, the data is invalid or there is no texture memory left
+ */
+PGL_API PGLBoolean pglLoadTextureEncoded(PGLTexture t, uint32_t width, uint32_t height, PGLFormat format, PGLEncoding encoding, uint32_t size, const void* data);
+
+/**
+ * Loads an indexed color texture: data contains one byte per pixel, the index of its color in the palette.
+ * Implementations may draw indexed textures directly from the indices or expand them when they are loaded. Scaled quads
+ * may need texture memory for the expanded colors (expanded at their first use).
+ * @param format PGL_FORMAT_P_8_*, which defines the format of the palette colors (e.g. RGB_565 for PGL_FORMAT_P_8_RGB_565)
+ * @param copy see pglLoadTexture, applies to data (the palette is always copied)
+ * @param colors number of palette colors (at most 256), pixels with a larger index are transparent black
+ * @param palette the colors
+ * @return PGL_FALSE if the format isn't supported or there is no palette memory left
+ */
+PGL_API PGLBoolean pglLoadTexturePalette(PGLTexture t, uint32_t width, uint32_t height, PGLFormat format, PGLBoolean copy, const void* data, uint32_t colors, const void* palette);
+
 /**
  * Assigns a texture to the context
  *
@@ -149,7 +238,26 @@ PGL_API PGLBoolean pglLoadTexture(PGLTexture, uint32_t width, uint32_t height, P
 PGL_API void pglBindTexture(PGLContext context, PGLTexture t);
 
 /**
- * Sets the clipping area for subsequent drawing commands
+ * Enables or disables alpha blending for subsequent pglDrawQuad calls (disabled by default)
+ * If enabled, textures with an alpha channel are blended over the surface content ("source over").
+ * Textures in a premultiplied format (e.g. PGL_FORMAT_BGRA_8888_PRE) are blended with premultiplied alpha.
+ * If disabled, the texture pixels are copied (faster, suitable for opaque images).
+ * pglVerify can only check the opaque pixels of a texture while blending is enabled.
+ */
+PGL_API PGLBoolean pglSetBlending(PGLContext context, PGLBoolean enable);
+
+/**
+ * Sets the texture filter for subsequent pglDrawQuad and pglVerify calls (PGL_FILTER_NEAREST by default)
+ * The filter is only applied if the destination and the texture rectangle of pglDrawQuad have different sizes.
+ */
+PGL_API PGLBoolean pglSetFilter(PGLContext context, PGLFilter filter);
+
+/**
+ * Sets the clipping area for subsequent drawing commands (pglClear, pglDrawArea, pglDrawQuad and pglVerify)
+ * Pixels outside of the area are not modified, pglVerify only checks the pixels inside the area.
+ * The coordinates use the same coverage as pglDrawArea: x2 / y2 is the last pixel inside the area.
+ * By default a context does not clip, an area which covers the whole surface disables clipping again.
+ * @return PGL_FALSE if x2 < x1 or y2 < y1
  */
 PGL_API PGLBoolean pglSetClip(PGLContext context, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
 
@@ -164,7 +272,8 @@ PGL_API void pglClear(PGLContext context);
 PGL_API void pglDrawArea(PGLContext ctx, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
 
 /**
- * Draws a rectangle with the current texture reference (interface allows scaling, what happens if coordinates oustide bounds?)
+ * Draws a rectangle with the current texture reference
+ * If the sizes of the destination and the texture rectangle differ, the texture is scaled (see pglSetFilter).
  * @param x1 Specify the start point X1 of the drawing coordinate system.
  * @param y1 Specify the start point Y1 of the drawing coordinate system.
  * @param u1 Specify the U1 of source coordinate system corresponding to the value, (X1, Y1) of drawing coordinate system.
@@ -178,17 +287,60 @@ PGL_API void pglDrawArea(PGLContext ctx, int32_t x1, int32_t y1, int32_t x2, int
  */
 PGL_API void pglDrawQuad(PGLContext ctx, int32_t x1, int32_t y1, int32_t u1, int32_t v1, int32_t x2, int32_t y2, int32_t u2, int32_t v2);
 
+/**
+ * Creates a new (empty) display list
+ */
+PGL_API PGLList pglCreateList(PGLContext context);
+
+/**
+ * Starts recording a display list: subsequent pglClear, pglDrawArea and pglDrawQuad calls are appended to the list
+ * together with the current state (surface, texture, color, blending, filter and clip area) instead of being drawn.
+ * A previous content of the list is discarded. The surface can't be changed while recording.
+ */
+PGL_API PGLBoolean pglBeginList(PGLContext context, PGLList list);
+
+/**
+ * Stops recording. The implementation may optimize the list without changing the result, e.g. drop commands which are
+ * completely overdrawn by later ones, merge neighbouring commands or reorder commands which don't overlap.
+ * @return PGL_FALSE if the list was too small for the recorded commands - it can't be submitted, the commands have to be drawn directly
+ */
+PGL_API PGLBoolean pglEndList(PGLContext context);
+
+/**
+ * Draws the commands of a display list into the surface which was current at pglBeginList (it becomes the current surface).
+ * A list can be submitted any number of times, e.g. to repeat a frame which didn't change. The textures and the pixel data
+ * which have been used while recording have to stay valid.
+ */
+PGL_API PGLBoolean pglSubmit(PGLContext context, PGLList list);
+
 /**
  * Post the window buffer to the display
  * Only works for window surfaces
  */
 PGL_API PGLBoolean pglSwapBuffers(PGLSurface surface);
 
+/**
+ * Posts only the given parts of the window buffer to the display
+ * The content outside of the rectangles has to be unchanged since the last swap (partial redraw), which requires
+ * a preserved buffer (see pglIsBufferPreserved). Implementations which can't present parts of a buffer post the whole buffer.
+ * @param rects the changed areas of the window
+ * @param count number of rectangles, 0 posts the whole buffer
+ */
+PGL_API PGLBoolean pglSwapBuffersRegion(PGLSurface surface, const PGLRect* rects, uint32_t count);
+
+/**
+ * Checks if the window buffer keeps its content across pglSwapBuffers and pglSwapBuffersRegion.
+ * @return PGL_FALSE if the content is undefined after a swap - every frame has to be drawn completely (no partial redraw)
+ */
+PGL_API PGLBoolean pglIsBufferPreserved(PGLSurface surface);
+
 /**
  * Checks the current surface with the currently bound texture
  * @param context the context will contain the reference texture and has bound the surface which is about to be verified
  * @param x1...y2 coordinates on the surface to verify
  * @param u1...v2 coordinates on the texture
+ * Only the pixels inside the clip area (pglSetClip) and the surface are compared, a partly clipped region is verified
+ * by its visible part. PGL_FALSE is returned if no pixel has been compared (the region is completely clipped).
  */
 PGL_API PGLBoolean pglVerify(PGLContext context, int32_t x1, int32_t y1, int32_t u1, int32_t v1, int32_t x2, int32_t y2, int32_t u2, int32_t v2);
 
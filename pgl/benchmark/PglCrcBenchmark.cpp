@@ -0,0 +1,110 @@
+/******************************************************************************
+**
+**   File:        PglCrcBenchmark.cpp
+**   Description: Measures the throughput of the CRC32 / CRC32C implementations
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+// Usage: pglCrcBenchmark [iterations]
+// Every implementation of both polynomials hashes a 16x16 tile, a 64x64 telltale and a 1280x720 frame (32 bit pixels).
+// The results are checked against the byte wise implementation, the time per buffer and the throughput are printed.
+
+#include "crc32.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+struct Size
+{
+    const char* name;
+    uint32_t bytes;
+};
+
+const Size SIZES[] =
+{
+    { "16x16 tile", 16U * 16U * 4U },
+    { "64x64 telltale", 64U * 64U * 4U },
+    { "1280x720 frame", 1280U * 720U * 4U }
+};
+
+const char* const POLYNOMIAL_NAMES[] = { "crc32", "crc32c" };
+const char* const IMPLEMENTATION_NAMES[] = { "bytewise", "slicing-by-8", "hardware" };
+}
+
+int main(int argc, char* argv[])
+{
+    const uint32_t iterations = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], NULL, 10)) : 20U;
+    if (iterations == 0U)
+    {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    initCrc32();
+    std::vector<uint8_t> data(SIZES[2].bytes);
+    uint32_t seed = 1U;
+    for (size_t i = 0U; i < data.size(); ++i)
+    {
+        seed = seed * 1103515245U + 12345U;
+        data[i] = static_cast<uint8_t>(seed >> 16);
+    }
+
+    bool ok = true;
+    printf("%-36s %13s %11s\n", "case", "time", "throughput");
+    for (uint32_t p = CRC32_IEEE; p <= CRC32_CASTAGNOLI; ++p)
+    {
+        const Crc32Polynomial polynomial = static_cast<Crc32Polynomial>(p);
+        for (size_t s = 0U; s < sizeof(SIZES) / sizeof(SIZES[0]); ++s)
+        {
+            const uint32_t reference = getCrc32Function(polynomial, CRC32_BYTEWISE)(0xffffffffU, &data[0], SIZES[s].bytes);
+            // the small buffers are hashed more often to get measurable times
+            const uint32_t repeat = iterations * (SIZES[2].bytes / SIZES[s].bytes);
+            for (uint32_t i = CRC32_BYTEWISE; i <= CRC32_HARDWARE; ++i)
+            {
+                const Crc32Function function = getCrc32Function(polynomial, static_cast<Crc32Implementation>(i));
+                char name[64];
+                snprintf(name, sizeof(name), "%s %s, %s", POLYNOMIAL_NAMES[p], IMPLEMENTATION_NAMES[i], SIZES[s].name);
+                if (function == NULL)
+                {
+                    printf("%-36s %13s\n", name, "n/a");
+                    continue;
+                }
+                uint32_t crc = 0U;
+                const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+                for (uint32_t r = 0U; r < repeat; ++r)
+                {
+                    crc = function(0xffffffffU, &data[0], SIZES[s].bytes);
+                }
+                const std::chrono::duration<double, std::micro> elapsed = std::chrono::high_resolution_clock::now() - start;
+                const double tCall = elapsed.count() / repeat;
+                const bool identical = (crc == reference);
+                printf("%-36s %10.2f us %7.0f MB/s %s\n", name, tCall, SIZES[s].bytes / tCall, identical ? "" : "MISMATCH");
+                ok &= identical;
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+/******************************************************************************
+**
+**   File:        PglGlesBenchmark.cpp
+**   Description: Draw calls and frame time of the GLES2 renderer (pbuffer, e.g. Mesa llvmpipe)
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+// Usage: pglGlesBenchmark [iterations]
+// Renders a 1280x720 cluster frame with the GLES2 pgl on a headless pbuffer and prints the time per frame
+// (drawing + pglSwapBuffers, which waits for the rasterizer), the number of GL draw calls and of pglVerify calls
+// which had to wait for the GPU per frame. The telltales are drawn from one atlas, first grouped, then interleaved with
+// their fills (which breaks the batches) and finally grouped and verified.
+
+#include "pgl.h"
+#include "pgl_gles2.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+const int32_t WIDTH = 1280;
+const int32_t HEIGHT = 720;
+const int32_t TELLTALES = 64;
+const int32_t ICON_SIZE = 32;
+const int32_t ATLAS_COLUMNS = 8; // 8x8 icons of 32x32 pixels
+
+std::vector<uint32_t> createImage(int32_t w, int32_t h, uint32_t seed, bool translucent)
+{
+    std::vector<uint32_t> image(static_cast<size_t>(w * h));
+    for (size_t i = 0u; i < image.size(); ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        const uint32_t alpha = (translucent && ((seed >> 28) < 4u)) ? ((seed >> 8) & 0xffu) : 0xffu;
+        image[i] = (alpha << 24) | (seed >> 8 & 0x00ffffffu);
+    }
+    return image;
+}
+
+// Position of telltale i on the surface and its icon in the atlas: x1, y1, u1, v1, x2, y2, u2, v2
+void getTelltale(int32_t i, int32_t* c)
+{
+    const int32_t x = 16 + (i % 32) * 39;
+    const int32_t y = 16 + (i / 32) * 40;
+    const int32_t u = (i % ATLAS_COLUMNS) * ICON_SIZE;
+    const int32_t v = (i / ATLAS_COLUMNS) * ICON_SIZE;
+    const int32_t coords[] = { x << 4, y << 4, u << 4, v << 4, (x + ICON_SIZE - 1) << 4, (y + ICON_SIZE - 1) << 4,
+        (u + ICON_SIZE - 1) << 4, (v + ICON_SIZE - 1) << 4 };
+    memcpy(c, coords, sizeof(coords));
+}
+
+void drawFill(PGLContext context, int32_t i)
+{
+    const int32_t x = 16 + (i % 32) * 39;
+    const int32_t y = 640 + (i / 32) * 36;
+    pglSetColor(context, static_cast<uint8_t>(i * 4), 0x80, 0x20, 0xff);
+    pglDrawArea(context, x << 4, y << 4, (x + ICON_SIZE - 1) << 4, (y + 31) << 4);
+}
+
+// A cluster frame: background, gauges (scaled, blended) and telltales (blended atlas icons and fills)
+// Returns false if a verified telltale differs
+bool drawFrame(PGLContext context, PGLTexture background, PGLTexture gauge, PGLTexture atlas, bool interleaved, bool verify)
+{
+    pglSetBlending(context, PGL_FALSE);
+    pglBindTexture(context, background);
+    pglDrawQuad(context, 0, 0, 0, 0, (WIDTH - 1) << 4, (HEIGHT - 1) << 4, (WIDTH - 1) << 4, (HEIGHT - 1) << 4);
+    pglSetBlending(context, PGL_TRUE);
+    pglSetFilter(context, PGL_FILTER_LINEAR);
+    pglBindTexture(context, gauge);
+    pglDrawQuad(context, 80 << 4, 120 << 4, 0, 0, 559 << 4, 599 << 4, 239 << 4, 239 << 4);
+    pglDrawQuad(context, 720 << 4, 120 << 4, 0, 0, 1199 << 4, 599 << 4, 239 << 4, 239 << 4);
+    pglSetFilter(context, PGL_FILTER_NEAREST);
+    pglBindTexture(context, atlas);
+    for (int32_t i = 0; i < TELLTALES; ++i)
+    {
+        int32_t c[8];
+        getTelltale(i, c);
+        pglDrawQuad(context, c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7]);
+        if (interleaved)
+        {
+            drawFill(context, i);
+        }
+    }
+    for (int32_t i = 0; !interleaved && (i < TELLTALES); ++i)
+    {
+        drawFill(context, i);
+    }
+    bool verified = true;
+    for (int32_t i = 0; verify && (i < TELLTALES); ++i)
+    {
+        int32_t c[8];
+        getTelltale(i, c);
+        verified &= (pglVerify(context, c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7]) == PGL_TRUE);
+    }
+    return verified;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const uint32_t iterations = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], NULL, 10)) : 100u;
+    if (iterations == 0u)
+    {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    pglInit();
+    PGLSurface window = pglCreateWindow(0, 0, 0, WIDTH, HEIGHT);
+    PGLContext context = pglCreateContext(NULL);
+    if ((window == NULL) || (context == NULL) || (pglSetSurface(context, window) != PGL_TRUE))
+    {
+        fprintf(stderr, "window creation failed\n");
+        return 1;
+    }
+    const std::vector<uint32_t> backgroundImage = createImage(WIDTH, HEIGHT, 1u, false);
+    const std::vector<uint32_t> gaugeImage = createImage(240, 240, 2u, true);
+    const std::vector<uint32_t> atlasImage = createImage(ATLAS_COLUMNS * ICON_SIZE, ATLAS_COLUMNS * ICON_SIZE, 3u, true);
+    PGLTexture background = pglCreateTexture(context);
+    PGLTexture gauge = pglCreateTexture(context);
+    PGLTexture atlas = pglCreateTexture(context);
+    pglLoadTexture(background, WIDTH, HEIGHT, PGL_FORMAT_RGBA_8888, PGL_FALSE, &backgroundImage[0]);
+    pglLoadTexture(gauge, 240, 240, PGL_FORMAT_RGBA_8888, PGL_FALSE, &gaugeImage[0]);
+    pglLoadTexture(atlas, ATLAS_COLUMNS * ICON_SIZE, ATLAS_COLUMNS * ICON_SIZE, PGL_FORMAT_RGBA_8888, PGL_FALSE, &atlasImage[0]);
+
+    bool ok = true;
+    printf("%-32s %13s %11s %8s\n", "frame", "time", "draw calls", "stalls");
+    const char* names[] = { "telltales grouped", "telltales interleaved", "telltales grouped, verified" };
+    for (int32_t mode = 0; mode < 3; ++mode)
+    {
+        // the first frame is not measured (shader compilation, texture upload, first readback of the verified regions)
+        ok &= drawFrame(context, background, gauge, atlas, mode == 1, mode == 2);
+        pglSwapBuffers(window);
+        const uint32_t calls = pglGetDrawCallCount(context);
+        const uint32_t stalls = pglGetReadbackStallCount(context);
+        const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0u; i < iterations; ++i)
+        {
+            ok &= drawFrame(context, background, gauge, atlas, mode == 1, mode == 2);
+            pglSwapBuffers(window);
+        }
+        const std::chrono::duration<double, std::micro> elapsed = std::chrono::high_resolution_clock::now() - start;
+        const double callsPerFrame = static_cast<double>(pglGetDrawCallCount(context) - calls) / iterations;
+        const double stallsPerFrame = static_cast<double>(pglGetReadbackStallCount(context) - stalls) / iterations;
+        printf("%-32s %10.2f us %11.1f %8.1f\n", names[mode], elapsed.count() / iterations, callsPerFrame, stallsPerFrame);
+    }
+    return (ok && (pglGetError(context) == PGL_NO_ERROR)) ? 0 : 1;
+}
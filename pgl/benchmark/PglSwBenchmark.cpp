@@ -0,0 +1,480 @@
+/******************************************************************************
+**
+**   File:        PglSwBenchmark.cpp
+**   Description: Measures the SW renderer kernels against their reference implementations
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+// Usage: pglSwBenchmark [iterations]
+// Every case runs the reference ("before") and the current kernel ("after") on the same data,
+// checks that both produce identical results and prints the time per call.
+
+#include "pgl_sw_renderer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+/**
+ * The original per pixel implementation of pgl_sw_bitblit_copy: each pixel checks all pointers against the
+ * memory boundaries and dispatches on the bytes per pixel.
+ */
+void referenceBitblitCopy(PGL_SW_Surface *dest, PGL_SW_Surface *source, PGLFormat format)
+{
+    const uint8_t bpp = pgl_helper_getbpp(format);
+    PGL_SW_Pointer ps = source->p + source->y*source->alignment + source->x*bpp;
+    PGL_SW_Pointer pd = dest->p + dest->y*dest->alignment + dest->x*bpp;
+    const int32_t offsets = source->alignment - source->w*bpp;
+    const int32_t offsetd = dest->alignment - source->w*bpp;
+    const PGL_SW_Pointer psBegin = source->p;
+    const PGL_SW_Pointer psEnd = psBegin + source->bytes;
+    const PGL_SW_Pointer pdBegin = dest->p;
+    const PGL_SW_Pointer pdEnd = pdBegin + dest->bytes;
+    for (int32_t y = 0; y < source->h; ++y)
+    {
+        for (int32_t x = 0; x < source->w; ++x)
+        {
+            if ((ps >= psBegin) && (ps < psEnd) && (pd >= pdBegin) && (pd < pdEnd))
+            {
+                switch (bpp)
+                {
+                    case 1u:
+                        *pd = *ps;
+                        break;
+                    case 2u:
+                        *((uint16_t*)(pd)) = *((uint16_t*)(ps));
+                        break;
+                    case 4u:
+                        *((uint32_t*)(pd)) = *((uint32_t*)(ps));
+                        break;
+                }
+            }
+            ps += bpp;
+            pd += bpp;
+        }
+        ps += offsets;
+        pd += offsetd;
+    }
+}
+
+/**
+ * The original implementation of pgl_sw_compare: per pixel pointer checks and a bpp dispatch, always counts all pixels.
+ */
+uint32_t referenceCompare(const PGL_SW_Surface *dest, const PGL_SW_Surface *source, PGLFormat format)
+{
+    const uint8_t bpp = pgl_helper_getbpp(format);
+    PGL_SW_Pointer ps = source->p + source->y*source->alignment + source->x*bpp;
+    PGL_SW_Pointer pd = dest->p + dest->y*dest->alignment + dest->x*bpp;
+    const int32_t offsets = source->alignment - source->w*bpp;
+    const int32_t offsetd = dest->alignment - source->w*bpp;
+    const PGL_SW_Pointer psBegin = source->p;
+    const PGL_SW_Pointer psEnd = psBegin + source->bytes;
+    const PGL_SW_Pointer pdBegin = dest->p;
+    const PGL_SW_Pointer pdEnd = pdBegin + dest->bytes;
+    uint32_t failures = 0;
+    for (int32_t y = 0; y < source->h; ++y)
+    {
+        for (int32_t x = 0; x < source->w; ++x)
+        {
+            if ((ps >= psBegin) && (ps < psEnd) && (pd >= pdBegin) && (pd < pdEnd))
+            {
+                switch (bpp)
+                {
+                    case 1u:
+                        failures += (*pd != *ps) ? 1u : 0u;
+                        break;
+                    case 2u:
+                        failures += (*((uint16_t*)(pd)) != *((uint16_t*)(ps))) ? 1u : 0u;
+                        break;
+                    case 4u:
+                        failures += (*((uint32_t*)(pd)) != *((uint32_t*)(ps))) ? 1u : 0u;
+                        break;
+                }
+            }
+            else
+            {
+                ++failures;
+            }
+            ps += bpp;
+            pd += bpp;
+        }
+        ps += offsets;
+        pd += offsetd;
+    }
+    return failures;
+}
+
+uint32_t equalAsCount(const PGL_SW_Surface *dest, const PGL_SW_Surface *source, PGLFormat format)
+{
+    return pgl_sw_equal(dest, source, format) ? 0u : 1u;
+}
+
+/**
+ * Straightforward per pixel "source over" blending with straight alpha (no clipping, same rounding as the kernel)
+ */
+void referenceBitblitBlend(PGL_SW_Surface *dest, PGL_SW_Surface *source, PGLFormat format)
+{
+    for (int32_t y = 0; y < source->h; ++y)
+    {
+        const uint8_t* ps = source->p + (source->y + y) * source->alignment + source->x * 4;
+        uint8_t* pd = dest->p + (dest->y + y) * dest->alignment + dest->x * 4;
+        for (int32_t x = 0; x < source->w; ++x)
+        {
+            const uint32_t a = ps[3];
+            for (int32_t c = 0; c < 3; ++c)
+            {
+                pd[c] = static_cast<uint8_t>((ps[c] * a + pd[c] * (255u - a) + 127u) / 255u);
+            }
+            pd[3] = static_cast<uint8_t>(a + (pd[3] * (255u - a) + 127u) / 255u);
+            ps += 4;
+            pd += 4;
+        }
+    }
+}
+
+typedef void (*BlitFunction)(PGL_SW_Surface *dest, PGL_SW_Surface *source, PGLFormat format);
+
+struct Image
+{
+    Image(int32_t width, int32_t height, uint8_t bpp)
+        : memory(static_cast<size_t>(width * height * bpp) + 16u, 0u)
+    {
+        // 16 byte aligned start like the surfaces of the platform layers
+        const uintptr_t offset = (16u - (reinterpret_cast<uintptr_t>(&memory[0]) & 15u)) & 15u;
+        PGL_SW_Surface s = { &memory[offset], 0, 0, width, height, width * bpp, width * height * bpp };
+        surface = s;
+    }
+
+    void fill(uint32_t seed)
+    {
+        for (int32_t i = 0; i < surface.bytes; ++i)
+        {
+            seed = seed * 1103515245u + 12345u;
+            surface.p[i] = static_cast<uint8_t>(seed >> 16);
+        }
+    }
+
+    std::vector<uint8_t> memory;
+    PGL_SW_Surface surface;
+};
+
+double measureBlit(BlitFunction blit, Image& dest, Image& source, int32_t x, int32_t y, PGLFormat format, uint32_t iterations)
+{
+    const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0u; i < iterations; ++i)
+    {
+        PGL_SW_Surface d = dest.surface;
+        PGL_SW_Surface s = source.surface;
+        d.x = x;
+        d.y = y;
+        d.w = s.w;
+        d.h = s.h;
+        blit(&d, &s, format);
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::high_resolution_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+bool runBlitCase(const char* name, BlitFunction reference, BlitFunction kernel, int32_t destW, int32_t destH, int32_t srcW, int32_t srcH, int32_t x, int32_t y, PGLFormat format, uint32_t iterations)
+{
+    const uint8_t bpp = pgl_helper_getbpp(format);
+    Image source(srcW, srcH, bpp);
+    Image before(destW, destH, bpp);
+    Image after(destW, destH, bpp);
+    source.fill(42u);
+
+    const double tBefore = measureBlit(reference, before, source, x, y, format, iterations);
+    const double tAfter = measureBlit(kernel, after, source, x, y, format, iterations);
+    const bool identical = (0 == memcmp(before.surface.p, after.surface.p, static_cast<size_t>(before.surface.bytes)));
+
+    printf("%-32s %10.2f us %10.2f us %8.2fx %s\n", name, tBefore, tAfter, tBefore / tAfter, identical ? "" : "MISMATCH");
+    return identical;
+}
+
+typedef uint32_t (*CompareFunction)(const PGL_SW_Surface *dest, const PGL_SW_Surface *source, PGLFormat format);
+
+double measureCompare(CompareFunction compare, Image& dest, Image& source, PGLFormat format, uint32_t iterations, uint32_t* result)
+{
+    const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0u; i < iterations; ++i)
+    {
+        *result = compare(&dest.surface, &source.surface, format);
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::high_resolution_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+/**
+ * Compares the reference against the full count mode and the first mismatch mode.
+ * @param mismatchAt index of a byte which is modified in the destination, -1 for identical content
+ */
+bool runCompareCase(const char* name, int32_t w, int32_t h, PGLFormat format, int32_t mismatchAt, uint32_t iterations)
+{
+    const uint8_t bpp = pgl_helper_getbpp(format);
+    Image source(w, h, bpp);
+    Image dest(w, h, bpp);
+    source.fill(7u);
+    dest.fill(7u);
+    if (mismatchAt >= 0)
+    {
+        dest.surface.p[mismatchAt] ^= 0xffu;
+    }
+
+    uint32_t rBefore = 0u;
+    uint32_t rCount = 0u;
+    uint32_t rEqual = 0u;
+    const double tBefore = measureCompare(&referenceCompare, dest, source, format, iterations, &rBefore);
+    const double tCount = measureCompare(&pgl_sw_compare, dest, source, format, iterations, &rCount);
+    const double tEqual = measureCompare(&equalAsCount, dest, source, format, iterations, &rEqual);
+    const bool identical = (rBefore == rCount) && ((rBefore == 0u) == (rEqual == 0u));
+
+    char countName[64];
+    char equalName[64];
+    snprintf(countName, sizeof(countName), "%s count", name);
+    snprintf(equalName, sizeof(equalName), "%s first", name);
+    printf("%-32s %10.2f us %10.2f us %8.2fx %s\n", countName, tBefore, tCount, tBefore / tCount, identical ? "" : "MISMATCH");
+    printf("%-32s %10.2f us %10.2f us %8.2fx %s\n", equalName, tBefore, tEqual, tBefore / tEqual, identical ? "" : "MISMATCH");
+    return identical;
+}
+
+
+/**
+ * Straightforward per pixel conversion between RGB_565 and BGRA_8888 (no clipping, same bit replication and truncation as the kernel)
+ */
+void referenceConvert(PGL_SW_Surface *dest, PGLFormat destFormat, PGL_SW_Surface *source, PGLFormat sourceFormat)
+{
+    const uint8_t dbpp = pgl_helper_getbpp(destFormat);
+    const uint8_t sbpp = pgl_helper_getbpp(sourceFormat);
+    for (int32_t y = 0; y < source->h; ++y)
+    {
+        const uint8_t* ps = source->p + (source->y + y) * source->alignment + source->x * sbpp;
+        uint8_t* pd = dest->p + (dest->y + y) * dest->alignment + dest->x * dbpp;
+        for (int32_t x = 0; x < source->w; ++x)
+        {
+            if (sourceFormat == PGL_FORMAT_RGB_565)
+            {
+                uint16_t v;
+                memcpy(&v, ps + x * 2, 2u);
+                const uint32_t r = v >> 11;
+                const uint32_t g = (v >> 5) & 0x3fu;
+                const uint32_t b = v & 0x1fu;
+                pd[x * 4 + 0] = static_cast<uint8_t>((b << 3) | (b >> 2));
+                pd[x * 4 + 1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+                pd[x * 4 + 2] = static_cast<uint8_t>((r << 3) | (r >> 2));
+                pd[x * 4 + 3] = 255u;
+            }
+            else
+            {
+                const uint16_t v = static_cast<uint16_t>(((ps[x * 4 + 2] >> 3) << 11) | ((ps[x * 4 + 1] >> 2) << 5) | (ps[x * 4 + 0] >> 3));
+                memcpy(pd + x * 2, &v, 2u);
+            }
+        }
+    }
+}
+
+bool runConvertCase(const char* name, int32_t w, int32_t h, PGLFormat destFormat, PGLFormat sourceFormat, uint32_t iterations)
+{
+    Image source(w, h, pgl_helper_getbpp(sourceFormat));
+    Image before(w, h, pgl_helper_getbpp(destFormat));
+    Image after(w, h, pgl_helper_getbpp(destFormat));
+    source.fill(3u);
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0u; i < iterations; ++i)
+    {
+        referenceConvert(&before.surface, destFormat, &source.surface, sourceFormat);
+    }
+    const std::chrono::duration<double, std::micro> elapsedBefore = std::chrono::high_resolution_clock::now() - start;
+    start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0u; i < iterations; ++i)
+    {
+        pgl_sw_bitblit_convert(&after.surface, destFormat, &source.surface, sourceFormat, PGL_FALSE);
+    }
+    const std::chrono::duration<double, std::micro> elapsedAfter = std::chrono::high_resolution_clock::now() - start;
+    const bool identical = (0 == memcmp(before.surface.p, after.surface.p, static_cast<size_t>(before.surface.bytes)));
+
+    const double tBefore = elapsedBefore.count() / iterations;
+    const double tAfter = elapsedAfter.count() / iterations;
+    printf("%-32s %10.2f us %10.2f us %8.2fx %s\n", name, tBefore, tAfter, tBefore / tAfter, identical ? "" : "MISMATCH");
+    return identical;
+}
+
+
+/**
+ * Per pixel fill of a BGRA_8888 rectangle which is inside the surface
+ */
+void referenceFill(PGL_SW_Surface *dest, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha)
+{
+    const uint32_t color = (static_cast<uint32_t>(alpha) << 24) | (static_cast<uint32_t>(red) << 16) | (static_cast<uint32_t>(green) << 8) | blue;
+    for (int32_t y = dest->y; y < dest->y + dest->h; ++y)
+    {
+        for (int32_t x = dest->x; x < dest->x + dest->w; ++x)
+        {
+            memcpy(dest->p + y * dest->alignment + x * 4, &color, 4u);
+        }
+    }
+}
+
+bool runFillCase(const char* name, int32_t destW, int32_t destH, int32_t x, int32_t y, int32_t w, int32_t h, uint32_t iterations)
+{
+    Image before(destW, destH, 4u);
+    Image after(destW, destH, 4u);
+    PGL_SW_Surface rectBefore = before.surface;
+    PGL_SW_Surface rectAfter = after.surface;
+    rectBefore.x = rectAfter.x = x;
+    rectBefore.y = rectAfter.y = y;
+    rectBefore.w = rectAfter.w = w;
+    rectBefore.h = rectAfter.h = h;
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0u; i < iterations; ++i)
+    {
+        referenceFill(&rectBefore, 0x20, 0x40, 0x60, 0xff);
+    }
+    const std::chrono::duration<double, std::micro> elapsedBefore = std::chrono::high_resolution_clock::now() - start;
+    start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0u; i < iterations; ++i)
+    {
+        pgl_sw_fill(&rectAfter, PGL_FORMAT_BGRA_8888, 0x20, 0x40, 0x60, 0xff);
+    }
+    const std::chrono::duration<double, std::micro> elapsedAfter = std::chrono::high_resolution_clock::now() - start;
+    const bool identical = (0 == memcmp(before.surface.p, after.surface.p, static_cast<size_t>(before.surface.bytes)));
+
+    const double tBefore = elapsedBefore.count() / iterations;
+    const double tAfter = elapsedAfter.count() / iterations;
+    printf("%-32s %10.2f us %10.2f us %8.2fx %s\n", name, tBefore, tAfter, tBefore / tAfter, identical ? "" : "MISMATCH");
+    return identical;
+}
+
+
+int32_t clampTexel(int32_t i, int32_t last)
+{
+    return (i < 0) ? 0 : ((i > last) ? last : i);
+}
+
+uint8_t lerp8(uint32_t a, uint32_t b, uint32_t f)
+{
+    return static_cast<uint8_t>((a * (256u - f) + b * f + 128u) >> 8u);
+}
+
+/**
+ * Per pixel scaling of a whole BGRA_8888 image: every destination pixel computes its source position from scratch
+ */
+void referenceScale(PGL_SW_Surface *dest, const PGL_SW_Surface *source, const PGL_SW_Scale *scale, PGLFilter filter)
+{
+    for (int32_t y = 0; y < dest->h; ++y)
+    {
+        for (int32_t x = 0; x < dest->w; ++x)
+        {
+            const int32_t u = scale->u + x * scale->du;
+            const int32_t v = scale->v + y * scale->dv;
+            uint8_t* pd = dest->p + y * dest->alignment + x * 4;
+            if (filter == PGL_FILTER_NEAREST)
+            {
+                memcpy(pd, source->p + clampTexel(v >> 16, source->h - 1) * source->alignment + clampTexel(u >> 16, source->w - 1) * 4, 4u);
+            }
+            else
+            {
+                const int32_t pu = u - 0x8000;
+                const int32_t pv = v - 0x8000;
+                const uint8_t* row0 = source->p + clampTexel(pv >> 16, source->h - 1) * source->alignment;
+                const uint8_t* row1 = source->p + clampTexel((pv >> 16) + 1, source->h - 1) * source->alignment;
+                const int32_t x0 = clampTexel(pu >> 16, source->w - 1) * 4;
+                const int32_t x1 = clampTexel((pu >> 16) + 1, source->w - 1) * 4;
+                const uint32_t fx = static_cast<uint32_t>(pu >> 8) & 0xffu;
+                const uint32_t fy = static_cast<uint32_t>(pv >> 8) & 0xffu;
+                for (int32_t c = 0; c < 4; ++c)
+                {
+                    pd[c] = lerp8(lerp8(row0[x0 + c], row0[x1 + c], fx), lerp8(row1[x0 + c], row1[x1 + c], fx), fy);
+                }
+            }
+        }
+    }
+}
+
+bool runScaleCase(const char* name, int32_t destW, int32_t destH, int32_t srcW, int32_t srcH, PGLFilter filter, uint32_t iterations)
+{
+    Image source(srcW, srcH, 4u);
+    Image before(destW, destH, 4u);
+    Image after(destW, destH, 4u);
+    source.fill(5u);
+    PGL_SW_Scale scale;
+    pgl_sw_scale_init(&scale, 0, 0, 0, 0, (destW - 1) << 4, (destH - 1) << 4, (srcW - 1) << 4, (srcH - 1) << 4);
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0u; i < iterations; ++i)
+    {
+        referenceScale(&before.surface, &source.surface, &scale, filter);
+    }
+    const std::chrono::duration<double, std::micro> elapsedBefore = std::chrono::high_resolution_clock::now() - start;
+    start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0u; i < iterations; ++i)
+    {
+        pgl_sw_bitblit_scale(&after.surface, PGL_FORMAT_BGRA_8888, &source.surface, PGL_FORMAT_BGRA_8888, &scale, filter, PGL_FALSE);
+    }
+    const std::chrono::duration<double, std::micro> elapsedAfter = std::chrono::high_resolution_clock::now() - start;
+    const bool identical = (0 == memcmp(before.surface.p, after.surface.p, static_cast<size_t>(before.surface.bytes)));
+
+    const double tBefore = elapsedBefore.count() / iterations;
+    const double tAfter = elapsedAfter.count() / iterations;
+    printf("%-32s %10.2f us %10.2f us %8.2fx %s\n", name, tBefore, tAfter, tBefore / tAfter, identical ? "" : "MISMATCH");
+    return identical;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const uint32_t iterations = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], NULL, 10)) : 200u;
+    if (iterations == 0u)
+    {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    bool ok = true;
+    printf("%-32s %13s %13s %9s\n", "case", "before", "after", "speedup");
+    ok &= runBlitCase("copy 800x480 BGRA_8888", &referenceBitblitCopy, &pgl_sw_bitblit_copy, 800, 480, 800, 480, 0, 0, PGL_FORMAT_BGRA_8888, iterations);
+    ok &= runBlitCase("copy 800x480 RGB_565", &referenceBitblitCopy, &pgl_sw_bitblit_copy, 800, 480, 800, 480, 0, 0, PGL_FORMAT_RGB_565, iterations);
+    ok &= runBlitCase("copy 800x480 A_8", &referenceBitblitCopy, &pgl_sw_bitblit_copy, 800, 480, 800, 480, 0, 0, PGL_FORMAT_A_8, iterations);
+    ok &= runBlitCase("copy 1920x720 BGRA_8888", &referenceBitblitCopy, &pgl_sw_bitblit_copy, 1920, 720, 1920, 720, 0, 0, PGL_FORMAT_BGRA_8888, iterations);
+    ok &= runBlitCase("copy 41x15 BGRA_8888 (icon)", &referenceBitblitCopy, &pgl_sw_bitblit_copy, 800, 480, 41, 15, 20, 30, PGL_FORMAT_BGRA_8888, iterations * 100u);
+    ok &= runBlitCase("copy 256x256 BGRA_8888 (bottom)", &referenceBitblitCopy, &pgl_sw_bitblit_copy, 800, 480, 256, 256, 500, 400, PGL_FORMAT_BGRA_8888, iterations);
+    ok &= runBlitCase("blend 800x480 BGRA_8888", &referenceBitblitBlend, &pgl_sw_bitblit_blend, 800, 480, 800, 480, 0, 0, PGL_FORMAT_BGRA_8888, iterations);
+    ok &= runBlitCase("blend 48x48 BGRA_8888 (telltale)", &referenceBitblitBlend, &pgl_sw_bitblit_blend, 800, 480, 48, 48, 20, 30, PGL_FORMAT_BGRA_8888, iterations * 20u);
+    ok &= runCompareCase("compare 800x480 BGRA_8888", 800, 480, PGL_FORMAT_BGRA_8888, -1, iterations);
+    ok &= runCompareCase("compare 800x480 RGB_565", 800, 480, PGL_FORMAT_RGB_565, -1, iterations);
+    ok &= runCompareCase("compare 41x15 BGRA_8888", 41, 15, PGL_FORMAT_BGRA_8888, -1, iterations * 100u);
+    ok &= runCompareCase("compare 800x480 diff@row 10", 800, 480, PGL_FORMAT_BGRA_8888, 10 * 800 * 4 + 17, iterations);
+    ok &= runConvertCase("convert 800x480 565->BGRA", 800, 480, PGL_FORMAT_BGRA_8888, PGL_FORMAT_RGB_565, iterations);
+    ok &= runConvertCase("convert 800x480 BGRA->565", 800, 480, PGL_FORMAT_RGB_565, PGL_FORMAT_BGRA_8888, iterations);
+    ok &= runFillCase("fill 800x480 BGRA_8888 (clear)", 800, 480, 0, 0, 800, 480, iterations);
+    ok &= runFillCase("fill 48x48 BGRA_8888 (area)", 800, 480, 100, 100, 48, 48, iterations * 20u);
+    ok &= runScaleCase("scale 48->72 nearest (telltale)", 72, 72, 48, 48, PGL_FILTER_NEAREST, iterations * 20u);
+    ok &= runScaleCase("scale 48->72 bilinear (telltale)", 72, 72, 48, 48, PGL_FILTER_LINEAR, iterations * 20u);
+    ok &= runScaleCase("scale 400x240->800x480 bilinear", 800, 480, 400, 240, PGL_FILTER_LINEAR, iterations);
+    return ok ? 0 : 1;
+}
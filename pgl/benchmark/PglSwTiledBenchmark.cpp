@@ -0,0 +1,147 @@
+/******************************************************************************
+**
+**   File:        PglSwTiledBenchmark.cpp
+**   Description: Measures how the tiled SW renderer scales with the number of threads
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+// Usage: pglSwTiledBenchmark [iterations]
+// Renders the same 1280x720 frame with 1, 2, 4 and 8 threads (one context each), checks that all contexts produce
+// identical frames and prints the time per frame (drawing + pglSwapBuffers) and the speedup against 1 thread.
+
+#include "pgl.h"
+#include "pgl_linux.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+const int32_t WIDTH = 1280;
+const int32_t HEIGHT = 720;
+
+std::vector<uint32_t> createImage(int32_t w, int32_t h, uint32_t seed, bool translucent)
+{
+    std::vector<uint32_t> image(static_cast<size_t>(w * h));
+    for (size_t i = 0u; i < image.size(); ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        const uint32_t alpha = (translucent && ((seed >> 28) < 4u)) ? ((seed >> 8) & 0xffu) : 0xffu;
+        image[i] = (alpha << 24) | (seed >> 8 & 0x00ffffffu);
+    }
+    return image;
+}
+
+// A cluster frame: background, gauges (scaled, blended) and telltales (blended icons and fills)
+void drawFrame(PGLContext context, PGLTexture background, PGLTexture gauge, PGLTexture icon)
+{
+    pglSetBlending(context, PGL_FALSE);
+    pglBindTexture(context, background);
+    pglDrawQuad(context, 0, 0, 0, 0, (WIDTH - 1) << 4, (HEIGHT - 1) << 4, (WIDTH - 1) << 4, (HEIGHT - 1) << 4);
+    pglSetBlending(context, PGL_TRUE);
+    pglSetFilter(context, PGL_FILTER_LINEAR);
+    pglBindTexture(context, gauge);
+    pglDrawQuad(context, 80 << 4, 120 << 4, 0, 0, 559 << 4, 599 << 4, 239 << 4, 239 << 4);
+    pglDrawQuad(context, 720 << 4, 120 << 4, 0, 0, 1199 << 4, 599 << 4, 239 << 4, 239 << 4);
+    pglSetFilter(context, PGL_FILTER_NEAREST);
+    pglBindTexture(context, icon);
+    for (int32_t i = 0; i < 16; ++i)
+    {
+        const int32_t x = 40 + i * 76;
+        pglDrawQuad(context, x << 4, 20 << 4, 0, 0, (x + 47) << 4, 67 << 4, 47 << 4, 47 << 4);
+        pglSetColor(context, static_cast<uint8_t>(i * 16), 0x80, 0x20, 0xff);
+        pglDrawArea(context, x << 4, 660 << 4, (x + 47) << 4, 699 << 4);
+    }
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const uint32_t iterations = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], NULL, 10)) : 100u;
+    if (iterations == 0u)
+    {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    pglInit();
+    PGLSurface window = pglCreateWindow(0, 0, 0, WIDTH, HEIGHT);
+    PGL_SW_Surface sw;
+    if ((window == NULL) || (pglSurfaceToSWSurface(window, &sw, NULL) != PGL_TRUE))
+    {
+        fprintf(stderr, "window creation failed\n");
+        return 1;
+    }
+    const std::vector<uint32_t> backgroundImage = createImage(WIDTH, HEIGHT, 1u, false);
+    const std::vector<uint32_t> gaugeImage = createImage(240, 240, 2u, true);
+    const std::vector<uint32_t> iconImage = createImage(48, 48, 3u, true);
+    std::vector<uint8_t> reference;
+
+    bool ok = true;
+    double tSingle = 0.0;
+    printf("%-32s %13s %9s\n", "threads", "frame", "speedup");
+    const uint32_t threads[] = { 1u, 2u, 4u, 8u }; // one context per entry (PGL_MAX_CONTEXTS)
+    for (size_t t = 0u; t < sizeof(threads) / sizeof(threads[0]); ++t)
+    {
+        PGLContextConfig config = { threads[t] };
+        PGLContext context = pglCreateContext(&config);
+        if ((context == NULL) || (pglSetSurface(context, window) != PGL_TRUE))
+        {
+            fprintf(stderr, "context creation failed\n");
+            return 1;
+        }
+        PGLTexture background = pglCreateTexture(context);
+        PGLTexture gauge = pglCreateTexture(context);
+        PGLTexture icon = pglCreateTexture(context);
+        pglLoadTexture(background, WIDTH, HEIGHT, PGL_FORMAT_BGRA_8888, PGL_FALSE, &backgroundImage[0]);
+        pglLoadTexture(gauge, 240, 240, PGL_FORMAT_BGRA_8888, PGL_FALSE, &gaugeImage[0]);
+        pglLoadTexture(icon, 48, 48, PGL_FORMAT_BGRA_8888, PGL_FALSE, &iconImage[0]);
+
+        const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0u; i < iterations; ++i)
+        {
+            drawFrame(context, background, gauge, icon);
+            pglSwapBuffers(window);
+        }
+        const std::chrono::duration<double, std::micro> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+        bool identical = true;
+        if (reference.empty())
+        {
+            reference.assign(sw.p, sw.p + sw.bytes);
+        }
+        else
+        {
+            identical = (0 == memcmp(&reference[0], sw.p, reference.size()));
+        }
+        const double tFrame = elapsed.count() / iterations;
+        tSingle = (t == 0u) ? tFrame : tSingle;
+        char name[32];
+        snprintf(name, sizeof(name), "1280x720 frame, %u thread(s)", static_cast<unsigned>(threads[t]));
+        printf("%-32s %10.2f us %8.2fx %s\n", name, tFrame, tSingle / tFrame, identical ? "" : "MISMATCH");
+        ok &= identical;
+    }
+    return ok ? 0 : 1;
+}
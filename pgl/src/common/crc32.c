@@ -0,0 +1,313 @@
+/******************************************************************************
+**
+**   File:        crc32.c
+**   Description: CRC32 (IEEE 802.3) and CRC32C (Castagnoli) of memory blocks, shared by the pgl implementations
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include "crc32.h"
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <nmmintrin.h>
+#define CRC32_SSE42 1
+#define CRC32_SSE42_TARGET __attribute__((target("sse4.2"))) // the instructions are only used after the cpuid check
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <nmmintrin.h>
+#define CRC32_SSE42 1
+#define CRC32_SSE42_TARGET
+#elif defined(__ARM_FEATURE_CRC32)
+// ARMv8 has no portable way to query the CRC extension at runtime: it is used if the compiler targets it (e.g. -march=armv8-a+crc)
+#include <arm_acle.h>
+#define CRC32_ARM 1
+#endif
+
+
+/*-
+ *  COPYRIGHT (C) 1986 Gary S. Brown.  You may use this program, or
+ *  code or tables extracted from it, as desired without restriction.
+ *
+ *  First, the polynomial itself and its table of feedback terms.  The
+ *  polynomial is
+ *  X^32+X^26+X^23+X^22+X^16+X^12+X^11+X^10+X^8+X^7+X^5+X^4+X^2+X^1+X^0
+ *
+ *  Note that we take it "backwards" and put the highest-order term in
+ *  the lowest-order bit.  The X^32 term is "implied"; the LSB is the
+ *  X^31 term, etc.  The X^0 term (usually shown as "+1") results in
+ *  the MSB being 1
+ *
+ *  Note that the usual hardware shift register implementation, which
+ *  is what we're using (we're merely optimizing it by doing eight-bit
+ *  chunks at a time) shifts bits into the lowest-order term.  In our
+ *  implementation, that means shifting towards the right.  Why do we
+ *  do it this way?  Because the calculated CRC must be transmitted in
+ *  order from highest-order term to lowest-order term.  UARTs transmit
+ *  characters in order from LSB to MSB.  By storing the CRC this way
+ *  we hand it to the UART in the order low-byte to high-byte; the UART
+ *  sends each low-bit to hight-bit; and the result is transmission bit
+ *  by bit from highest- to lowest-order term without requiring any bit
+ *  shuffling on our part.  Reception works similarly
+ *
+ *  The feedback terms table consists of 256, 32-bit entries.  Notes
+ *
+ *      The table can be generated at runtime if desired; code to do so
+ *      is shown later.  It might not be obvious, but the feedback
+ *      terms simply represent the results of eight shift/xor opera
+ *      tions for all combinations of data and CRC register values
+ *
+ *      The values must be right-shifted by eight bits by the "updcrc
+ *      logic; the shift must be unsigned (bring in zeroes).  On some
+ *      hardware you could probably optimize the shift in assembler by
+ *      using byte-swap instructions
+ *      polynomial $edb88320
+ *
+ *
+ * CRC32 code derived from work by Gary S. Brown.
+ */
+
+
+// The tables are generated by initCrc32. Table 0 is the classic byte wise table,
+// table k contains the CRC of a byte followed by k zero bytes (slicing-by-8).
+static uint32_t crc32Tables[2][8][256];
+static Crc32Function crc32Selected[2] = { NULL, NULL };
+
+static void createTables(const uint32_t polynomial, uint32_t tables[8][256])
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t c = i;
+        for (uint32_t bit = 0; bit < 8; bit++)
+        {
+            c = (c & 1) ? ((c >> 1) ^ polynomial) : (c >> 1);
+        }
+        tables[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        for (uint32_t k = 1; k < 8; k++)
+        {
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+        }
+    }
+}
+
+static uint32_t updateBytewise(const uint32_t table[256], uint32_t crcvalue, const uint8_t* bytePtr, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++)
+    {
+        crcvalue = table[(*(bytePtr++) ^ crcvalue) & 0xFF] ^ (crcvalue >> 8);
+    }
+    return crcvalue;
+}
+
+// 8 bytes per step with independent lookups. The words are assembled from bytes, which works on every endianness and alignment.
+static uint32_t updateSlicingBy8(uint32_t tables[8][256], uint32_t crcvalue, const uint8_t* bytePtr, uint32_t size)
+{
+    for (; size >= 8; size -= 8)
+    {
+        const uint32_t low = crcvalue ^ ((uint32_t)bytePtr[0] | ((uint32_t)bytePtr[1] << 8) | ((uint32_t)bytePtr[2] << 16) | ((uint32_t)bytePtr[3] << 24));
+        crcvalue = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24]
+            ^ tables[3][bytePtr[4]] ^ tables[2][bytePtr[5]] ^ tables[1][bytePtr[6]] ^ tables[0][bytePtr[7]];
+        bytePtr += 8;
+    }
+    return updateBytewise(tables[0], crcvalue, bytePtr, size);
+}
+
+static uint32_t crc32Bytewise(uint32_t crcvalue, const uint8_t* bytePtr, uint32_t size)
+{
+    return updateBytewise(crc32Tables[CRC32_IEEE][0], crcvalue, bytePtr, size);
+}
+
+static uint32_t crc32cBytewise(uint32_t crcvalue, const uint8_t* bytePtr, uint32_t size)
+{
+    return updateBytewise(crc32Tables[CRC32_CASTAGNOLI][0], crcvalue, bytePtr, size);
+}
+
+static uint32_t crc32SlicingBy8(uint32_t crcvalue, const uint8_t* bytePtr, uint32_t size)
+{
+    return updateSlicingBy8(crc32Tables[CRC32_IEEE], crcvalue, bytePtr, size);
+}
+
+static uint32_t crc32cSlicingBy8(uint32_t crcvalue, const uint8_t* bytePtr, uint32_t size)
+{
+    return updateSlicingBy8(crc32Tables[CRC32_CASTAGNOLI], crcvalue, bytePtr, size);
+}
+
+#if defined(CRC32_SSE42)
+
+static int hasSse42(void)
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && ((ecx & bit_SSE4_2) != 0);
+#endif
+}
+
+CRC32_SSE42_TARGET static uint32_t crc32cSse42(uint32_t crcvalue, const uint8_t* bytePtr, uint32_t size)
+{
+    for (; (size > 0) && (((uintptr_t)bytePtr & 7) != 0); size--)
+    {
+        crcvalue = _mm_crc32_u8(crcvalue, *(bytePtr++));
+    }
+#if defined(__x86_64__) || defined(_M_X64)
+    for (; size >= 8; size -= 8)
+    {
+        uint64_t word;
+        memcpy(&word, bytePtr, sizeof(word));
+        crcvalue = (uint32_t)_mm_crc32_u64(crcvalue, word);
+        bytePtr += 8;
+    }
+#endif
+    for (; size >= 4; size -= 4)
+    {
+        uint32_t word;
+        memcpy(&word, bytePtr, sizeof(word));
+        crcvalue = _mm_crc32_u32(crcvalue, word);
+        bytePtr += 4;
+    }
+    for (; size > 0; size--)
+    {
+        crcvalue = _mm_crc32_u8(crcvalue, *(bytePtr++));
+    }
+    return crcvalue;
+}
+
+#elif defined(CRC32_ARM)
+
+static uint32_t crc32Arm(uint32_t crcvalue, const uint8_t* bytePtr, uint32_t size)
+{
+    for (; (size > 0) && (((uintptr_t)bytePtr & 7) != 0); size--)
+    {
+        crcvalue = __crc32b(crcvalue, *(bytePtr++));
+    }
+    for (; size >= 8; size -= 8)
+    {
+        uint64_t word;
+        memcpy(&word, bytePtr, sizeof(word));
+        crcvalue = __crc32d(crcvalue, word);
+        bytePtr += 8;
+    }
+    for (; size > 0; size--)
+    {
+        crcvalue = __crc32b(crcvalue, *(bytePtr++));
+    }
+    return crcvalue;
+}
+
+static uint32_t crc32cArm(uint32_t crcvalue, const uint8_t* bytePtr, uint32_t size)
+{
+    for (; (size > 0) && (((uintptr_t)bytePtr & 7) != 0); size--)
+    {
+        crcvalue = __crc32cb(crcvalue, *(bytePtr++));
+    }
+    for (; size >= 8; size -= 8)
+    {
+        uint64_t word;
+        memcpy(&word, bytePtr, sizeof(word));
+        crcvalue = __crc32cd(crcvalue, word);
+        bytePtr += 8;
+    }
+    for (; size > 0; size--)
+    {
+        crcvalue = __crc32cb(crcvalue, *(bytePtr++));
+    }
+    return crcvalue;
+}
+
+#endif
+
+static Crc32Function getHardwareFunction(Crc32Polynomial polynomial)
+{
+    Crc32Function function = NULL;
+#if defined(CRC32_SSE42)
+    if ((polynomial == CRC32_CASTAGNOLI) && hasSse42())
+    {
+        function = crc32cSse42;
+    }
+#elif defined(CRC32_ARM)
+    function = (polynomial == CRC32_CASTAGNOLI) ? crc32cArm : crc32Arm;
+#else
+    (void)polynomial;
+#endif
+    return function;
+}
+
+void initCrc32(void)
+{
+    if (crc32Selected[CRC32_IEEE] == NULL)
+    {
+        createTables(0xEDB88320, crc32Tables[CRC32_IEEE]);
+        createTables(0x82F63B78, crc32Tables[CRC32_CASTAGNOLI]);
+        crc32Selected[CRC32_CASTAGNOLI] = getHardwareFunction(CRC32_CASTAGNOLI) ? getHardwareFunction(CRC32_CASTAGNOLI) : crc32cSlicingBy8;
+        crc32Selected[CRC32_IEEE] = getHardwareFunction(CRC32_IEEE) ? getHardwareFunction(CRC32_IEEE) : crc32SlicingBy8; // set last, marks the initialization as done
+    }
+}
+
+Crc32Function getCrc32Function(Crc32Polynomial polynomial, Crc32Implementation implementation)
+{
+    Crc32Function function = NULL;
+    initCrc32();
+    switch (implementation)
+    {
+    case CRC32_BYTEWISE:
+        function = (polynomial == CRC32_CASTAGNOLI) ? crc32cBytewise : crc32Bytewise;
+        break;
+    case CRC32_SLICING_BY_8:
+        function = (polynomial == CRC32_CASTAGNOLI) ? crc32cSlicingBy8 : crc32SlicingBy8;
+        break;
+    case CRC32_HARDWARE:
+        function = getHardwareFunction(polynomial);
+        break;
+    default:
+        break;
+    }
+    return function;
+}
+
+uint32_t updateCrc32(uint32_t crcvalue, const uint8_t* bytePtr, uint32_t size)
+{
+    initCrc32();
+    return crc32Selected[CRC32_IEEE](crcvalue, bytePtr, size);
+}
+
+uint32_t calcCrc32Complete(const uint8_t* bytePtr, uint32_t size)
+{
+    return ~updateCrc32(0xFFFFFFFF, bytePtr, size);
+}
+
+uint32_t updateCrc32c(uint32_t crcvalue, const uint8_t* bytePtr, uint32_t size)
+{
+    initCrc32();
+    return crc32Selected[CRC32_CASTAGNOLI](crcvalue, bytePtr, size);
+}
+
+uint32_t calcCrc32cComplete(const uint8_t* bytePtr, uint32_t size)
+{
+    return ~updateCrc32c(0xFFFFFFFF, bytePtr, size);
+}
@@ -0,0 +1,100 @@
+#ifndef _CRC32_H_
+#define _CRC32_H_
+
+/******************************************************************************
+**
+**   File:        crc32.h
+**   Description: CRC32 (IEEE 802.3) and CRC32C (Castagnoli) of memory blocks, shared by the pgl implementations
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    CRC32_IEEE,      ///< polynomial 0xedb88320 (zlib, Ethernet)
+    CRC32_CASTAGNOLI ///< polynomial 0x82f63b78 (CRC32C, iSCSI)
+} Crc32Polynomial;
+
+typedef enum
+{
+    CRC32_BYTEWISE,     ///< one table lookup per byte
+    CRC32_SLICING_BY_8, ///< eight table lookups per 8 bytes (portable)
+    CRC32_HARDWARE      ///< CRC instructions: SSE4.2 (CRC32C only) or ARMv8 CRC32 (both polynomials)
+} Crc32Implementation;
+
+/**
+* Continues a CRC calculation with the next buffer, see updateCrc32
+*/
+typedef uint32_t (*Crc32Function)(uint32_t crcvalue, const uint8_t* bytePtr, uint32_t size);
+
+/**
+* Creates the lookup tables and selects the fastest implementation of each polynomial which the CPU supports.
+* Called by pglInit. The other functions call it on their first use, which must not happen concurrently.
+*/
+void initCrc32(void);
+
+/**
+* Returns a specific implementation (e.g. for tests and benchmarks)
+* @return NULL if the implementation is not available for the polynomial on this CPU
+*/
+Crc32Function getCrc32Function(Crc32Polynomial polynomial, Crc32Implementation implementation);
+
+/**
+* Continues a CRC32 calculation with the next buffer (e.g. the next row of an image).
+* Start with 0xFFFFFFFF and invert the final value.
+*
+* @param[in] crcvalue intermediate value of the previous buffers
+* @param[in] bytePtr pointer to the data
+* @param[in] size size of buffer in bytePtr in bytes
+* @return intermediate value including the buffer
+*/
+uint32_t updateCrc32(uint32_t crcvalue, const uint8_t* bytePtr, uint32_t size);
+
+/**
+* Calculate the CRC32 of a buffer in memory.
+*
+* @param[in] bytePtr pointer to the data
+* @param[in] size size of buffer in bytePtr in bytes
+* @return crcvalue containing the crc32 checksum
+*/
+uint32_t calcCrc32Complete(const uint8_t* bytePtr, uint32_t size);
+
+/**
+* Same as updateCrc32 with the CRC32C polynomial, which has hardware support on more CPUs (SSE4.2 and ARMv8)
+*/
+uint32_t updateCrc32c(uint32_t crcvalue, const uint8_t* bytePtr, uint32_t size);
+
+/**
+* Same as calcCrc32Complete with the CRC32C polynomial
+*/
+uint32_t calcCrc32cComplete(const uint8_t* bytePtr, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
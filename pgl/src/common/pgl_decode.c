@@ -0,0 +1,198 @@
+/******************************************************************************
+**
+**   File:        pgl_decode.c
+**   Description: Decoders of compressed texture data (PGLEncoding), shared by the pgl implementations
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include "pgl_decode.h"
+#include <stddef.h>
+#include <string.h>
+
+uint32_t pgl_rle_packet(const uint8_t *p, const uint8_t *end, uint32_t bpp, uint32_t *size)
+{
+    uint32_t pixels = 0u;
+    if (p < end)
+    {
+        pixels = (uint32_t)(p[0] & PGL_RLE_COUNT) + 1u;
+        *size = 1u + (((p[0] & PGL_RLE_RUN) != 0u) ? bpp : pixels * bpp);
+        if ((uint32_t)(end - p) < *size)
+        {
+            pixels = 0u;
+        }
+    }
+    return pixels;
+}
+
+void pgl_swap_pixels(uint8_t *dest, const uint8_t *src, uint32_t pixels, uint32_t bpp)
+{
+    for (uint32_t i = 0u; i < pixels; ++i)
+    {
+        for (uint32_t b = 0u; b < bpp; ++b)
+        {
+            dest[i * bpp + b] = src[i * bpp + bpp - 1u - b];
+        }
+    }
+}
+
+PGLBoolean pgl_rle_decode(uint8_t *dest, uint32_t width, uint32_t height, uint32_t bpp, PGLBoolean swapped, const uint8_t *src, uint32_t size)
+{
+    const uint8_t *p = src;
+    const uint8_t *end = src + size;
+    PGLBoolean valid = PGL_TRUE;
+    for (uint32_t y = 0u; (y < height) && valid; ++y)
+    {
+        uint32_t x = 0u;
+        while ((x < width) && valid)
+        {
+            uint32_t bytes = 0u;
+            const uint32_t pixels = pgl_rle_packet(p, end, bpp, &bytes);
+            valid = ((pixels > 0u) && (pixels <= (width - x))) ? PGL_TRUE : PGL_FALSE;
+            if (!valid)
+            {
+                // truncated data or a packet which continues in the next row
+            }
+            else if ((p[0] & PGL_RLE_RUN) != 0u)
+            {
+                uint8_t pixel[4];
+                pgl_swap_pixels(pixel, p + 1, 1u, bpp);
+                const uint8_t *value = swapped ? pixel : (p + 1);
+                for (uint32_t i = 0u; i < pixels; ++i)
+                {
+                    memcpy(dest + (x + i) * bpp, value, bpp);
+                }
+            }
+            else if (swapped)
+            {
+                pgl_swap_pixels(dest + x * bpp, p + 1, pixels, bpp);
+            }
+            else
+            {
+                memcpy(dest + x * bpp, p + 1, pixels * bpp);
+            }
+            p += bytes;
+            x += pixels;
+        }
+        dest += width * bpp;
+    }
+    return (valid && (p == end)) ? PGL_TRUE : PGL_FALSE;
+}
+
+uint32_t pgl_flz_decode(uint8_t *dest, uint32_t destSize, const uint8_t *src, uint32_t size)
+{
+    // the upper 3 bits of the first byte contain the compression level - 1
+    PGLBoolean valid = ((size > 0u) && ((src[0] >> 5) == 0u)) ? PGL_TRUE : PGL_FALSE;
+    PGLBoolean done = PGL_FALSE;
+    uint32_t ip = 1u;
+    uint32_t op = 0u;
+    uint32_t ctrl = valid ? (src[0] & 31u) : 0u;
+    while (valid && !done)
+    {
+        if (ctrl >= 32u)
+        {
+            // match: length - 2 in the upper 3 bits (7: an extra length byte follows), 13 bit distance - 1
+            uint32_t len = (ctrl >> 5) - 1u;
+            uint32_t distance = ((ctrl & 31u) << 8) + 1u;
+            if ((len == 6u) && (ip < size))
+            {
+                len += src[ip++];
+            }
+            valid = (ip < size) ? PGL_TRUE : PGL_FALSE;
+            if (valid)
+            {
+                distance += src[ip++];
+                len += 3u;
+                valid = ((distance <= op) && (len <= (destSize - op))) ? PGL_TRUE : PGL_FALSE;
+            }
+            if (valid)
+            {
+                // the source may overlap the destination (repeated patterns), so it is copied bytewise
+                for (uint32_t i = 0u; i < len; ++i)
+                {
+                    dest[op + i] = dest[op + i - distance];
+                }
+                op += len;
+            }
+        }
+        else
+        {
+            // literal run of ctrl + 1 bytes
+            const uint32_t len = ctrl + 1u;
+            valid = ((len <= (size - ip)) && (len <= (destSize - op))) ? PGL_TRUE : PGL_FALSE;
+            if (valid)
+            {
+                memcpy(dest + op, src + ip, len);
+                ip += len;
+                op += len;
+            }
+        }
+        if (!valid)
+        {
+            // corrupt data
+        }
+        else if (ip < size)
+        {
+            ctrl = src[ip++];
+        }
+        else
+        {
+            done = PGL_TRUE;
+        }
+    }
+    return valid ? op : 0u;
+}
+
+uint32_t pgl_image_bytes(uint32_t width, uint32_t height, uint32_t bpp)
+{
+    const uint64_t bytes = (uint64_t)width * height * bpp;
+    return (bytes < UINT32_MAX) ? (uint32_t)bytes : UINT32_MAX;
+}
+
+PGLBoolean pgl_decode(uint8_t *dest, uint32_t destSize, uint32_t width, uint32_t height, uint32_t bpp, PGLEncoding encoding, const void *src, uint32_t size)
+{
+    // the decoders write width * height * bpp bytes, a size which wraps around would pass the check
+    const uint32_t bytes = pgl_image_bytes(width, height, bpp);
+    PGLBoolean ret = PGL_FALSE;
+    if ((bytes != UINT32_MAX) && (bytes <= destSize) && (src != NULL))
+    {
+        switch (encoding)
+        {
+        case PGL_ENCODING_RAW:
+            if (size >= bytes)
+            {
+                memcpy(dest, src, bytes);
+                ret = PGL_TRUE;
+            }
+            break;
+        case PGL_ENCODING_RLE:
+        case PGL_ENCODING_RLE2:
+            ret = pgl_rle_decode(dest, width, height, bpp, (encoding == PGL_ENCODING_RLE2) ? PGL_TRUE : PGL_FALSE, (const uint8_t *)src, size);
+            break;
+        case PGL_ENCODING_FLZ:
+            ret = (pgl_flz_decode(dest, bytes, (const uint8_t *)src, size) == bytes) ? PGL_TRUE : PGL_FALSE;
+            break;
+        default:
+            break;
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,87 @@
+#ifndef PGL_DECODE_H
+#define PGL_DECODE_H
+
+/******************************************************************************
+**
+**   File:        pgl_decode.h
+**   Description: Decoders of compressed texture data (PGLEncoding), shared by the pgl implementations
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include "pgl.h"
+
+// RLE packets: a header byte with the number of pixels - 1 in the lower 7 bits.
+// If PGL_RLE_RUN is set one pixel follows, which is repeated, otherwise the pixels follow one after the other.
+// Every row is encoded separately, a packet never continues in the next row.
+#define PGL_RLE_RUN 0x80u
+#define PGL_RLE_COUNT 0x7fu
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Returns the size of an image in bytes, calculated with 64 bits
+ * @return UINT32_MAX if the size doesn't fit into 32 bits (it exceeds every buffer)
+ */
+uint32_t pgl_image_bytes(uint32_t width, uint32_t height, uint32_t bpp);
+
+/**
+ * Returns the number of pixels of the RLE packet at p, 0 if the packet is not complete
+ * @param end end of the encoded data
+ * @param bpp bytes per pixel
+ * @param size receives the size of the packet in bytes (header and pixels)
+ */
+uint32_t pgl_rle_packet(const uint8_t *p, const uint8_t *end, uint32_t bpp, uint32_t *size);
+
+/**
+ * Copies pixels and reverses the bytes of each one (PGL_ENCODING_RLE2)
+ */
+void pgl_swap_pixels(uint8_t *dest, const uint8_t *src, uint32_t pixels, uint32_t bpp);
+
+/**
+ * Decodes PGL_ENCODING_RLE / PGL_ENCODING_RLE2 data
+ * @param dest receives width * height pixels, rows without padding
+ * @param swapped PGL_TRUE for PGL_ENCODING_RLE2 (the bytes of each pixel are reversed)
+ * @return PGL_FALSE if the data doesn't contain exactly width * height pixels
+ */
+PGLBoolean pgl_rle_decode(uint8_t *dest, uint32_t width, uint32_t height, uint32_t bpp, PGLBoolean swapped, const uint8_t *src, uint32_t size);
+
+/**
+ * Decodes PGL_ENCODING_FLZ data (FastLZ level 1)
+ * @param destSize capacity of dest in bytes
+ * @return the number of decoded bytes, 0 if the data is invalid or exceeds destSize
+ */
+uint32_t pgl_flz_decode(uint8_t *dest, uint32_t destSize, const uint8_t *src, uint32_t size);
+
+/**
+ * Decodes the data of any encoding into width * height pixels (see pglLoadTextureEncoded)
+ * @param destSize capacity of dest in bytes, at least width * height * bpp
+ * @return PGL_FALSE if the data is invalid
+ */
+PGLBoolean pgl_decode(uint8_t *dest, uint32_t destSize, uint32_t width, uint32_t height, uint32_t bpp, PGLEncoding encoding, const void *src, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PGL_DECODE_H
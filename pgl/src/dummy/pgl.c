@@ -1,7 +1,7 @@
 /******************************************************************************
 **
 **   File:        pgl.c
-**   Description:
+**   Description: pgl stand-in without rendering: logs the calls and verifies the drawn textures by their CRC
 **
 **   Copyright (C) 2017 Luxoft GmbH
 **
@@ -27,21 +27,103 @@
 #include <pgl.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "crc32.h"
 
+// 0 removes all logging code (e.g. for engine benchmarks), otherwise PGL_DUMMY_LOG selects the output at runtime (see pglInit)
+#ifndef PGL_DUMMY_LOG
+#define PGL_DUMMY_LOG 1
+#endif
+
+// Blits which can be verified per context (the last ones are dropped if there are more). Has to be a power of 2.
+#ifndef PGL_DUMMY_MAX_BLITS
+#define PGL_DUMMY_MAX_BLITS 1024
+#endif
+#if (PGL_DUMMY_MAX_BLITS & (PGL_DUMMY_MAX_BLITS - 1)) != 0
+#error "PGL_DUMMY_MAX_BLITS has to be a power of 2"
+#endif
+#define BLIT_SLOTS (2 * PGL_DUMMY_MAX_BLITS) // the hash table is at most half full
+
+// A drawn texture, the destination rect is the key of the hash table
 typedef struct
 {
-    int32_t x;
-    int32_t y;
+    int32_t x1;
+    int32_t y1;
+    int32_t x2;
+    int32_t y2;
     uint32_t crc;
+    uint32_t generation; // the slot is empty if it differs from the generation of the context
 } Blit;
 
+typedef enum
+{
+    LOG_MODE_NONE,
+    LOG_MODE_TEXT,  ///< one line per call on stdout
+    LOG_MODE_BINARY ///< one record per call in the trace file (see trace)
+} LogMode;
+
+// Identifies the function of a binary trace record
+typedef enum
+{
+    TRACE_INIT = 1,
+    TRACE_CREATE_WINDOW,
+    TRACE_CREATE_CONTEXT,
+    TRACE_SET_SURFACE,
+    TRACE_SET_COLOR,
+    TRACE_SET_BLENDING,
+    TRACE_SET_FILTER,
+    TRACE_CREATE_TEXTURE,
+    TRACE_LOAD_TEXTURE,
+    TRACE_BIND_TEXTURE,
+    TRACE_SET_CLIP,
+    TRACE_CLEAR,
+    TRACE_DRAW_AREA,
+    TRACE_DRAW_QUAD,
+    TRACE_CREATE_LIST,
+    TRACE_BEGIN_LIST,
+    TRACE_END_LIST,
+    TRACE_SUBMIT,
+    TRACE_SWAP_BUFFERS,
+    TRACE_SWAP_BUFFERS_REGION,
+    TRACE_VERIFY,
+    TRACE_GET_ERROR,
+    TRACE_HANDLE_WINDOW_EVENTS,
+    TRACE_LOAD_TEXTURE_ENCODED,
+    TRACE_LOAD_TEXTURE_PALETTE,
+    TRACE_IS_BUFFER_PRESERVED
+} TraceCall;
+
+typedef enum
+{
+    CMD_CLEAR,
+    CMD_AREA,
+    CMD_QUAD
+} CommandType;
+
+typedef struct
+{
+    CommandType type;
+    PGLTexture texture;
+    int32_t coords[8];
+} Command;
+
+typedef struct pgl_list_t
+{
+    int id;
+    Command commands[64];
+    uint8_t nCommands;
+    PGLBoolean complete;
+} pgl_list_t;
+
 typedef struct pgl_context_t
 {
     int id;
     PGLTexture texture;
-    Blit blits[255];
-    uint8_t nBlits;
+    Blit blits[BLIT_SLOTS]; // open addressing with linear probing
+    uint32_t liveSlots[PGL_DUMMY_MAX_BLITS]; // slots of the nBlits blits of the current generation
+    uint32_t nBlits;
+    uint32_t generation; // incremented by pglClear, which empties all slots at once
+    PGLList recording; // list between pglBeginList and pglEndList
 } pgl_context_t;
 
 typedef struct pgl_surface_t
@@ -59,20 +141,175 @@ typedef struct pgl_texture_t
 
 #define MAX_CONTEXTS 1
 #define MAX_WINDOWS 1
-#define MAX_TEXTURES 10
+#define MAX_TEXTURES 64
+#define MAX_LISTS 2
 static pgl_context_t g_contexts[MAX_CONTEXTS];
 static pgl_surface_t g_windows[MAX_WINDOWS];
 static pgl_texture_t g_textures[MAX_TEXTURES];
+static pgl_list_t g_lists[MAX_LISTS];
 static size_t g_usedContexts;
 static size_t g_usedWindows;
 static size_t g_usedTextures;
+static size_t g_usedLists;
+static Blit g_keptBlits[PGL_DUMMY_MAX_BLITS]; // blits which are not overdrawn by pglDrawArea
+static LogMode g_logMode = LOG_MODE_TEXT;
+static FILE* g_trace = NULL;
+
+#if PGL_DUMMY_LOG
+#define LOG_TEXT(args) do { if (g_logMode == LOG_MODE_TEXT) { fprintf args; } } while (0)
+#define LOG_TRACE(call, ...) do { if (g_logMode == LOG_MODE_BINARY) { const int32_t traceArgs[] = { __VA_ARGS__ }; \
+    trace(call, traceArgs, sizeof(traceArgs) / sizeof(traceArgs[0])); } } while (0)
+
+/**
+ * Appends a record to the binary trace: the TraceCall (1 byte), the number of arguments (1 byte) and the arguments
+ * as 32 bit little endian values. The arguments are the ones of the text log in the same order (ids for handles,
+ * 28.4 fixed point coordinates), followed by the return value.
+ */
+static void trace(TraceCall call, const int32_t* args, size_t count)
+{
+    uint8_t record[2 + 4 * 16];
+    size_t size = 0;
+    record[size++] = (uint8_t)call;
+    record[size++] = (uint8_t)count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint32_t value = (uint32_t)args[i];
+        record[size++] = (uint8_t)value;
+        record[size++] = (uint8_t)(value >> 8);
+        record[size++] = (uint8_t)(value >> 16);
+        record[size++] = (uint8_t)(value >> 24);
+    }
+    fwrite(record, 1, size, g_trace);
+}
+#else
+#define LOG_TEXT(args)
+#define LOG_TRACE(call, ...)
+#endif
+
+static uint32_t hashRect(int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    uint32_t h = (uint32_t)x1 * 0x9E3779B1u;
+    h = (h ^ (uint32_t)y1) * 0x85EBCA77u;
+    h = (h ^ (uint32_t)x2) * 0xC2B2AE3Du;
+    h = (h ^ (uint32_t)y2) * 0x27D4EB2Fu;
+    return h ^ (h >> 15);
+}
+
+// Returns the slot of the blit with the given destination rect, or the empty slot where it has to be inserted
+static Blit* findBlit(PGLContext ctx, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    uint32_t slot = hashRect(x1, y1, x2, y2) & (BLIT_SLOTS - 1);
+    Blit* b = &ctx->blits[slot];
+    while ((b->generation == ctx->generation) && ((b->x1 != x1) || (b->y1 != y1) || (b->x2 != x2) || (b->y2 != y2)))
+    {
+        slot = (slot + 1) & (BLIT_SLOTS - 1); // terminates: at least half of the slots are empty
+        b = &ctx->blits[slot];
+    }
+    return b;
+}
+
+// Stores a blit, a previous one with the same destination rect is replaced
+static void insertBlit(PGLContext ctx, const Blit* blit)
+{
+    Blit* b = findBlit(ctx, blit->x1, blit->y1, blit->x2, blit->y2);
+    if ((b->generation == ctx->generation) || (ctx->nBlits < PGL_DUMMY_MAX_BLITS))
+    {
+        if (b->generation != ctx->generation)
+        {
+            ctx->liveSlots[ctx->nBlits++] = (uint32_t)(b - ctx->blits);
+        }
+        *b = *blit;
+        b->generation = ctx->generation;
+    }
+}
 
+// Appends a drawing command to the list which is recorded, returns PGL_FALSE if the context draws directly
+static PGLBoolean record(PGLContext ctx, CommandType type, const int32_t* coords, size_t count)
+{
+    PGLList list = ctx->recording;
+    if (list && (list->nCommands < sizeof(list->commands) / sizeof(list->commands[0])))
+    {
+        Command* cmd = &list->commands[list->nCommands++];
+        cmd->type = type;
+        cmd->texture = ctx->texture;
+        for (size_t i = 0; i < count; ++i)
+        {
+            cmd->coords[i] = coords[i];
+        }
+    }
+    else if (list)
+    {
+        list->complete = PGL_FALSE;
+    }
+    return list ? PGL_TRUE : PGL_FALSE;
+}
+
+// The drawing commands without logging, used directly and for the replay of lists
+
+static void clear(PGLContext ctx)
+{
+    ctx->nBlits = 0;
+    ++ctx->generation;
+}
+
+static void drawArea(PGLContext ctx, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    // blits which start inside the area are overdrawn (partial clear), the others are inserted again
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < ctx->nBlits; ++i)
+    {
+        const Blit* b = &ctx->blits[ctx->liveSlots[i]];
+        if ((b->x1 < x1) || (b->x1 > x2) || (b->y1 < y1) || (b->y1 > y2))
+        {
+            g_keptBlits[kept++] = *b;
+        }
+    }
+    if (kept < ctx->nBlits)
+    {
+        clear(ctx);
+        for (uint32_t i = 0; i < kept; ++i)
+        {
+            insertBlit(ctx, &g_keptBlits[i]);
+        }
+    }
+}
+
+static void drawQuad(PGLContext ctx, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    const Blit blit = { x1, y1, x2, y2, ctx->texture->crc, 0 };
+    insertBlit(ctx, &blit);
+}
+
+/**
+ * The environment variable PGL_DUMMY_LOG selects the log output: "text" (default), "binary" or "none".
+ * The binary trace is written to the file PGL_DUMMY_TRACE (default: pgl_trace.bin).
+ */
 void pglInit()
 {
-    fprintf(stdout, "pglInit()\n");
+    const char* mode = getenv("PGL_DUMMY_LOG");
+    const char* path = getenv("PGL_DUMMY_TRACE");
+    if (g_trace)
+    {
+        fclose(g_trace);
+        g_trace = NULL;
+    }
+    g_logMode = LOG_MODE_TEXT;
+    if (mode && (strcmp(mode, "none") == 0))
+    {
+        g_logMode = LOG_MODE_NONE;
+    }
+    else if (mode && (strcmp(mode, "binary") == 0))
+    {
+        g_trace = fopen((path && path[0]) ? path : "pgl_trace.bin", "wb");
+        g_logMode = g_trace ? LOG_MODE_BINARY : LOG_MODE_TEXT;
+    }
+    LOG_TEXT((stdout, "pglInit()\n"));
+    LOG_TRACE(TRACE_INIT, (int32_t)g_logMode);
+    initCrc32();
     g_usedWindows = 0;
     g_usedContexts = 0;
     g_usedTextures = 0;
+    g_usedLists = 0;
 }
 
 PGLSurface pglCreateWindow(uint8_t window, int32_t x, int32_t y, int32_t w, int32_t h)
@@ -83,33 +320,57 @@ PGLSurface pglCreateWindow(uint8_t window, int32_t x, int32_t y, int32_t w, int3
         win = &g_windows[g_usedWindows++];
         win->id = g_usedWindows;
     }
-    fprintf(stdout, "pglCreateWindow(%d, %d, %d, %d, %d) ret:%d\n", window, x, y, w, h, win ? win->id : 0);
+    LOG_TEXT((stdout, "pglCreateWindow(%d, %d, %d, %d, %d) ret:%d\n", window, x, y, w, h, win ? win->id : 0));
+    LOG_TRACE(TRACE_CREATE_WINDOW, window, x, y, w, h, win ? win->id : 0);
     return win;
 }
 
-PGLContext pglCreateContext(void)
+PGLContext pglCreateContext(const PGLContextConfig* config)
 {
     PGLContext ctx = NULL;
     if (g_usedContexts < MAX_CONTEXTS)
     {
         ctx = &g_contexts[g_usedContexts++];
         ctx->id = g_usedContexts;
+        ctx->recording = NULL;
+        ctx->texture = NULL;
+        ctx->nBlits = 0;
+        ++ctx->generation; // the blits of a previous pglInit are outdated
     }
-    fprintf(stdout, "pglCreateContext() ret :%d\n", ctx ? ctx->id : 0);
+    LOG_TEXT((stdout, "pglCreateContext(%u, %d) ret :%d\n", config ? (unsigned)config->threads : 0u, config ? (int)config->verification : 0, ctx ? ctx->id : 0));
+    LOG_TRACE(TRACE_CREATE_CONTEXT, config ? (int32_t)config->threads : 0, config ? (int32_t)config->verification : 0, ctx ? ctx->id : 0);
     return ctx;
 }
 
 PGLBoolean pglSetSurface(PGLContext context, PGLSurface surface)
 {
     PGLBoolean ret = PGL_TRUE;
-    fprintf(stdout, "pglSetSurface(%d, %d) ret :%d\n", context ? context->id : 0, surface ? surface->id : 0, ret);
+    LOG_TEXT((stdout, "pglSetSurface(%d, %d) ret :%d\n", context ? context->id : 0, surface ? surface->id : 0, ret));
+    LOG_TRACE(TRACE_SET_SURFACE, context ? context->id : 0, surface ? surface->id : 0, ret);
     return ret;
 }
 
 PGLBoolean pglSetColor(PGLContext context, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha)
 {
     PGLBoolean ret = PGL_TRUE;
-    fprintf(stdout, "pglSetColor(%d, %d, %d, %d, %d) ret :%d\n", context ? context->id : 0, red, green, blue, alpha, ret);
+    LOG_TEXT((stdout, "pglSetColor(%d, %d, %d, %d, %d) ret :%d\n", context ? context->id : 0, red, green, blue, alpha, ret));
+    LOG_TRACE(TRACE_SET_COLOR, context ? context->id : 0, red, green, blue, alpha, ret);
+    return ret;
+}
+
+PGLBoolean pglSetBlending(PGLContext context, PGLBoolean enable)
+{
+    PGLBoolean ret = PGL_TRUE;
+    LOG_TEXT((stdout, "pglSetBlending(%d, %d) ret :%d\n", context ? context->id : 0, enable, ret));
+    LOG_TRACE(TRACE_SET_BLENDING, context ? context->id : 0, enable, ret);
+    return ret;
+}
+
+PGLBoolean pglSetFilter(PGLContext context, PGLFilter filter)
+{
+    PGLBoolean ret = PGL_TRUE;
+    LOG_TEXT((stdout, "pglSetFilter(%d, %d) ret :%d\n", context ? context->id : 0, filter, ret));
+    LOG_TRACE(TRACE_SET_FILTER, context ? context->id : 0, filter, ret);
     return ret;
 }
 
@@ -121,7 +382,8 @@ PGLTexture pglCreateTexture(PGLContext context)
         tx = &g_textures[g_usedTextures++];
         tx->id = g_usedTextures;
     }
-    fprintf(stdout, "pglCreateTexture(%d) ret :%d\n", context ? context->id : 0, tx ? tx->id : 0);
+    LOG_TEXT((stdout, "pglCreateTexture(%d) ret :%d\n", context ? context->id : 0, tx ? tx->id : 0));
+    LOG_TRACE(TRACE_CREATE_TEXTURE, context ? context->id : 0, tx ? tx->id : 0);
     return tx;
 }
 
@@ -146,7 +408,52 @@ PGLBoolean pglLoadTexture(PGLTexture t, uint32_t width, uint32_t height, PGLForm
         pixelSize = 4;
     }
     const uint32_t crc = calcCrc32Complete(data, width*height * pixelSize);
-    fprintf(stdout, "pglLoadTexture(%d, %d, %d, %d, %d, 0x%X) ret :%d\n", t ? t->id : 0, width, height, format, copy, crc, ret);
+    LOG_TEXT((stdout, "pglLoadTexture(%d, %d, %d, %d, %d, 0x%X) ret :%d\n", t ? t->id : 0, width, height, format, copy, crc, ret));
+    LOG_TRACE(TRACE_LOAD_TEXTURE, t ? t->id : 0, (int32_t)width, (int32_t)height, format, copy, (int32_t)crc, ret);
+    t->crc = crc;
+    t->width = width;
+    t->height = height;
+    return ret;
+}
+
+PGLBoolean pglLoadTextureEncoded(PGLTexture t, uint32_t width, uint32_t height, PGLFormat format, PGLEncoding encoding, uint32_t size, const void* data)
+{
+    // the encoded data identifies the texture as well as the pixels
+    const PGLBoolean ret = (encoding <= PGL_ENCODING_FLZ) ? PGL_TRUE : PGL_FALSE;
+    const uint32_t crc = calcCrc32Complete(data, size);
+    LOG_TEXT((stdout, "pglLoadTextureEncoded(%d, %d, %d, %d, %d, %d, 0x%X) ret :%d\n", t ? t->id : 0, width, height, format, encoding, size, crc, ret));
+    LOG_TRACE(TRACE_LOAD_TEXTURE_ENCODED, t ? t->id : 0, (int32_t)width, (int32_t)height, format, encoding, (int32_t)size, (int32_t)crc, ret);
+    t->crc = crc;
+    t->width = width;
+    t->height = height;
+    return ret;
+}
+
+PGLBoolean pglLoadTexturePalette(PGLTexture t, uint32_t width, uint32_t height, PGLFormat format, PGLBoolean copy, const void* data, uint32_t colors, const void* palette)
+{
+    uint32_t colorSize = 0;
+    switch (format)
+    {
+    case PGL_FORMAT_P_8_ARGB_8888:
+    case PGL_FORMAT_P_8_BGRA_8888:
+    case PGL_FORMAT_P_8_RGBA_8888:
+        colorSize = 4;
+        break;
+    case PGL_FORMAT_P_8_RGB_888:
+        colorSize = 3;
+        break;
+    case PGL_FORMAT_P_8_RGB_565:
+        colorSize = 2;
+        break;
+    default:
+        break;
+    }
+    const PGLBoolean ret = ((colorSize > 0) && (colors <= 256)) ? PGL_TRUE : PGL_FALSE;
+    // the checksum covers the indices and the colors
+    uint32_t crc = updateCrc32(0xFFFFFFFFu, (const uint8_t*)data, width * height);
+    crc = ~updateCrc32(crc, (const uint8_t*)palette, ret ? colors * colorSize : 0);
+    LOG_TEXT((stdout, "pglLoadTexturePalette(%d, %d, %d, %d, %d, %d, 0x%X) ret :%d\n", t ? t->id : 0, width, height, format, copy, colors, crc, ret));
+    LOG_TRACE(TRACE_LOAD_TEXTURE_PALETTE, t ? t->id : 0, (int32_t)width, (int32_t)height, format, copy, (int32_t)colors, (int32_t)crc, ret);
     t->crc = crc;
     t->width = width;
     t->height = height;
@@ -155,73 +462,187 @@ PGLBoolean pglLoadTexture(PGLTexture t, uint32_t width, uint32_t height, PGLForm
 
 void pglBindTexture(PGLContext context, PGLTexture t)
 {
-    fprintf(stdout, "pglBindTexture(%d, %d)\n", context ? context->id : 0, t ? t->id : 0);
+    LOG_TEXT((stdout, "pglBindTexture(%d, %d)\n", context ? context->id : 0, t ? t->id : 0));
+    LOG_TRACE(TRACE_BIND_TEXTURE, context ? context->id : 0, t ? t->id : 0);
     context->texture = t;
 }
 
 PGLBoolean pglSetClip(PGLContext context, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
 {
-    PGLBoolean ret = PGL_TRUE;
-    fprintf(stdout, "pglSetClip(%d, %d, %d, %d, %d) ret :%d\n", context ? context->id : 0, x1, x2, y1, y2, ret);
+    PGLBoolean ret = ((x1 <= x2) && (y1 <= y2)) ? PGL_TRUE : PGL_FALSE;
+    LOG_TEXT((stdout, "pglSetClip(%d, %d, %d, %d, %d) ret :%d\n", context ? context->id : 0, x1, y1, x2, y2, ret));
+    LOG_TRACE(TRACE_SET_CLIP, context ? context->id : 0, x1, y1, x2, y2, ret);
     return ret;
 }
 
 void pglClear(PGLContext context)
 {
-    fprintf(stdout, "pglClear(%d)\n", context ? context->id : 0);
-    context->nBlits = 0;
+    LOG_TEXT((stdout, "pglClear(%d)\n", context ? context->id : 0));
+    LOG_TRACE(TRACE_CLEAR, context ? context->id : 0);
+    if (!record(context, CMD_CLEAR, NULL, 0))
+    {
+        clear(context);
+    }
 }
 
 void pglDrawArea(PGLContext ctx, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
 {
-    fprintf(stdout, "pglDrawArea(%d, %0.1f, %0.1f, %0.1f, %0.1f)\n", ctx ? ctx->id : 0, x1 / 16., y1 / 16., x2 / 16., y2 / 16.);
+    LOG_TEXT((stdout, "pglDrawArea(%d, %0.1f, %0.1f, %0.1f, %0.1f)\n", ctx ? ctx->id : 0, x1 / 16., y1 / 16., x2 / 16., y2 / 16.));
+    LOG_TRACE(TRACE_DRAW_AREA, ctx ? ctx->id : 0, x1, y1, x2, y2);
+    const int32_t coords[] = { x1, y1, x2, y2 };
+    if (!record(ctx, CMD_AREA, coords, 4))
+    {
+        drawArea(ctx, x1, y1, x2, y2);
+    }
 }
 
 void pglDrawQuad(PGLContext ctx, int32_t x1, int32_t y1, int32_t u1, int32_t v1, int32_t x2, int32_t y2, int32_t u2, int32_t v2)
 {
-    fprintf(stdout, "pglDrawQuad(%d, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f)\n",
+    LOG_TEXT((stdout, "pglDrawQuad(%d, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f)\n",
         ctx ? ctx->id : 0,
         x1 / 16., y1 / 16., u1 / 16., v1 / 16.,
-        x2 / 16., y2 / 16., u2 / 16., v2 / 16.);
-    Blit blit = { x1, y1, ctx->texture->crc };
-    ctx->blits[ctx->nBlits++] = blit;
+        x2 / 16., y2 / 16., u2 / 16., v2 / 16.));
+    LOG_TRACE(TRACE_DRAW_QUAD, ctx ? ctx->id : 0, x1, y1, u1, v1, x2, y2, u2, v2);
+    const int32_t coords[] = { x1, y1, u1, v1, x2, y2, u2, v2 };
+    if (!record(ctx, CMD_QUAD, coords, 8))
+    {
+        drawQuad(ctx, x1, y1, x2, y2);
+    }
 }
 
-PGLBoolean pglSwapBuffers(PGLSurface surface)
+PGLList pglCreateList(PGLContext context)
 {
-    fprintf(stdout, "pglSwapBuffers(%d)\n", surface ? surface->id : 0);
-    return PGL_TRUE;
+    PGLList list = NULL;
+    if (g_usedLists < MAX_LISTS)
+    {
+        list = &g_lists[g_usedLists++];
+        list->id = g_usedLists;
+        list->nCommands = 0;
+        list->complete = PGL_FALSE;
+    }
+    LOG_TEXT((stdout, "pglCreateList(%d) ret :%d\n", context ? context->id : 0, list ? list->id : 0));
+    LOG_TRACE(TRACE_CREATE_LIST, context ? context->id : 0, list ? list->id : 0);
+    return list;
 }
 
-PGLBoolean pglVerify(PGLContext ctx, int32_t x1, int32_t y1, int32_t u1, int32_t v1, int32_t x2, int32_t y2, int32_t u2, int32_t v2)
+PGLBoolean pglBeginList(PGLContext context, PGLList list)
 {
-    PGLBoolean ret = PGL_FALSE;
-    for (uint8_t i = 0; i < ctx->nBlits; ++i)
+    PGLBoolean ret = (context && list && !context->recording) ? PGL_TRUE : PGL_FALSE;
+    if (ret)
     {
-        if ((ctx->blits[i].crc == ctx->texture->crc) && (ctx->blits[i].x == x1) && (ctx->blits[i].y == y1))
+        list->nCommands = 0;
+        list->complete = PGL_TRUE;
+        context->recording = list;
+    }
+    LOG_TEXT((stdout, "pglBeginList(%d, %d) ret :%d\n", context ? context->id : 0, list ? list->id : 0, ret));
+    LOG_TRACE(TRACE_BEGIN_LIST, context ? context->id : 0, list ? list->id : 0, ret);
+    return ret;
+}
+
+PGLBoolean pglEndList(PGLContext context)
+{
+    PGLBoolean ret = (context && context->recording) ? context->recording->complete : PGL_FALSE;
+    LOG_TEXT((stdout, "pglEndList(%d) ret :%d\n", context ? context->id : 0, ret));
+    LOG_TRACE(TRACE_END_LIST, context ? context->id : 0, ret);
+    if (context)
+    {
+        context->recording = NULL;
+    }
+    return ret;
+}
+
+PGLBoolean pglSubmit(PGLContext context, PGLList list)
+{
+    PGLBoolean ret = (context && list && list->complete && !context->recording) ? PGL_TRUE : PGL_FALSE;
+    LOG_TEXT((stdout, "pglSubmit(%d, %d) ret :%d\n", context ? context->id : 0, list ? list->id : 0, ret));
+    LOG_TRACE(TRACE_SUBMIT, context ? context->id : 0, list ? list->id : 0, ret);
+    if (ret)
+    {
+        // the commands are replayed in order without logging them again, the bound texture is restored afterwards
+        PGLTexture texture = context->texture;
+        for (uint8_t i = 0; i < list->nCommands; ++i)
         {
-            ret = PGL_TRUE;
-            break;
+            const Command* cmd = &list->commands[i];
+            const int32_t* c = cmd->coords;
+            context->texture = cmd->texture;
+            if (cmd->type == CMD_CLEAR)
+            {
+                clear(context);
+            }
+            else if (cmd->type == CMD_AREA)
+            {
+                drawArea(context, c[0], c[1], c[2], c[3]);
+            }
+            else
+            {
+                drawQuad(context, c[0], c[1], c[4], c[5]);
+            }
         }
+        context->texture = texture;
+    }
+    return ret;
+}
+
+PGLBoolean pglSwapBuffers(PGLSurface surface)
+{
+    LOG_TEXT((stdout, "pglSwapBuffers(%d)\n", surface ? surface->id : 0));
+    LOG_TRACE(TRACE_SWAP_BUFFERS, surface ? surface->id : 0);
+    if (g_trace)
+    {
+        fflush(g_trace); // complete frames are in the file
+    }
+    return PGL_TRUE;
+}
+
+PGLBoolean pglSwapBuffersRegion(PGLSurface surface, const PGLRect* rects, uint32_t count)
+{
+    LOG_TEXT((stdout, "pglSwapBuffersRegion(%d, %u)", surface ? surface->id : 0, count));
+    LOG_TRACE(TRACE_SWAP_BUFFERS_REGION, surface ? surface->id : 0, (int32_t)count);
+    for (uint32_t i = 0; rects && (i < count); ++i)
+    {
+        LOG_TEXT((stdout, " [%0.1f, %0.1f, %0.1f, %0.1f]", rects[i].x1 / 16., rects[i].y1 / 16., rects[i].x2 / 16., rects[i].y2 / 16.));
+    }
+    LOG_TEXT((stdout, "\n"));
+    if (g_trace)
+    {
+        fflush(g_trace);
     }
-    fprintf(stdout, "pglVerify(%d, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f) ret:%d\n",
+    return PGL_TRUE;
+}
+
+PGLBoolean pglIsBufferPreserved(PGLSurface surface)
+{
+    PGLBoolean ret = surface ? PGL_TRUE : PGL_FALSE;
+    LOG_TEXT((stdout, "pglIsBufferPreserved(%d) ret:%d\n", surface ? surface->id : 0, ret));
+    LOG_TRACE(TRACE_IS_BUFFER_PRESERVED, surface ? surface->id : 0, ret);
+    return ret;
+}
+
+PGLBoolean pglVerify(PGLContext ctx, int32_t x1, int32_t y1, int32_t u1, int32_t v1, int32_t x2, int32_t y2, int32_t u2, int32_t v2)
+{
+    const Blit* b = findBlit(ctx, x1, y1, x2, y2);
+    const PGLBoolean ret = ((b->generation == ctx->generation) && ctx->texture && (b->crc == ctx->texture->crc)) ? PGL_TRUE : PGL_FALSE;
+    LOG_TEXT((stdout, "pglVerify(%d, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f, %0.1f) ret:%d\n",
         ctx ? ctx->id : 0,
         x1 / 16., y1 / 16., u1 / 16., v1 / 16.,
         x2 / 16., y2 / 16., u2 / 16., v2 / 16.,
-        ret);
+        ret));
+    LOG_TRACE(TRACE_VERIFY, ctx ? ctx->id : 0, x1, y1, u1, v1, x2, y2, u2, v2, ret);
     return ret;
 }
 
 PGLError pglGetError(PGLContext context)
 {
     PGLError ret = PGL_NO_ERROR;
-    fprintf(stdout, "pglGetError(%d) ret:%d\n", context ? context->id : 0, ret);
+    LOG_TEXT((stdout, "pglGetError(%d) ret:%d\n", context ? context->id : 0, ret));
+    LOG_TRACE(TRACE_GET_ERROR, context ? context->id : 0, ret);
     return ret;
 }
 
 PGLBoolean pglHandleWindowEvents(PGLContext context)
 {
     PGLBoolean ret = PGL_FALSE;
-    fprintf(stdout, "pglHandleWindowEvents(%d) ret:%d\n", context ? context->id : 0, ret);
+    LOG_TEXT((stdout, "pglHandleWindowEvents(%d) ret:%d\n", context ? context->id : 0, ret));
+    LOG_TRACE(TRACE_HANDLE_WINDOW_EVENTS, context ? context->id : 0, ret);
     return ret;
 }
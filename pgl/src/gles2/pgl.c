@@ -25,11 +25,17 @@
 ******************************************************************************/
 
 #include <pgl.h>
+#include "pgl_decode.h"
+#include "pgl_gles2.h"
+#include "pgl_sw_renderer.h"
+#include "crc32.h"
 #include <stdlib.h>
 //GLSC2 only supports binary shaders, which is not suitable for testing on desktop systems
 //#include <GLSC2/glsc2.h>
 #include <GLES3/gl3.h>
+#include <GLES2/gl2ext.h>
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
@@ -52,6 +58,13 @@ void dbg_printf(const char *fmt, ...)
 const GLuint a_position = 0;
 const GLuint a_texCoord = 1;
 
+#define PGL_MAX_TEXTURES 64
+#define PGL_MAX_BATCH_QUADS 256 // quads which are drawn with one glDrawElements call
+#define PGL_VERTEX_FLOATS 4 // x, y, s, t
+#define PGL_QUAD_FLOATS (4 * PGL_VERTEX_FLOATS)
+#define PGL_MAX_READBACKS 64 // regions which pglVerify reads back asynchronously
+#define PGL_MAX_PALETTES 16 // colors of the indexed textures which pglVerify compares, each palette takes 1 KB
+
 const char vColorShaderStr[] =
     "attribute vec4 a_position;                  \n"
     "uniform mat4 mvp_matrix;                    \n"
@@ -92,6 +105,15 @@ const char fTexShaderStr[] =
     "  gl_FragColor = texture2D(s_texture, v_texCoord ); \n"
     "}                                                   \n";
 
+#define PGL_PROGRAMS 2 // color and texture program
+#define PGL_PROGRAM_CACHE_MAGIC 0x50474c50u // "PGLP"
+
+static const char* const m_programSources[PGL_PROGRAMS][2] =
+{
+    { vColorShaderStr, fColorShaderStr },
+    { vTexShaderStr, fTexShaderStr }
+};
+
 typedef struct
 {
     union
@@ -112,8 +134,41 @@ typedef struct pgl_surface_t
     EGLSurface egl;
     int32_t width;
     int32_t height;
+    EGLBoolean initialized; // the buffer is cleared when the surface is used for the first time
 } pgl_surface_t;
 
+#define PGL_MAX_DAMAGE_RECTS 16
+#define PGL_MAX_LISTS 4
+#define PGL_MAX_LIST_COMMANDS 64
+
+typedef enum
+{
+    PGL_COMMAND_CLEAR,
+    PGL_COMMAND_AREA,
+    PGL_COMMAND_QUAD
+} pgl_command_type_t;
+
+// A recorded drawing command with the state which is needed to replay it
+typedef struct pgl_command_t
+{
+    pgl_command_type_t type;
+    struct pgl_texture_t* texture;
+    GLboolean blending;
+    GLint filter;
+    GLfloat color[4];
+    GLboolean clipEnabled;
+    GLint clip[4]; // x, y, width, height
+    int32_t coords[8]; // pglDrawArea: x1, y1, x2, y2, pglDrawQuad: x1, y1, u1, v1, x2, y2, u2, v2
+} pgl_command_t;
+
+typedef struct pgl_list_t
+{
+    pgl_command_t commands[PGL_MAX_LIST_COMMANDS];
+    uint32_t count;
+    struct pgl_surface_t* surface;
+    GLboolean complete;
+} pgl_list_t;
+
 typedef struct pgl_context_t
 {
     EGLContext egl;
@@ -131,17 +186,85 @@ typedef struct pgl_context_t
     GLfloat alpha;
     // model view matrix
     ESMatrix mvpMatrix;
+    // texture filter of pglDrawQuad (GL_NEAREST or GL_LINEAR)
+    GLint filter;
+    // clip area in pixels (top-left origin), applied as scissor rectangle
+    pgl_surface_t* surface;
+    GLboolean clipEnabled;
+    GLint clipX;
+    GLint clipY;
+    GLsizei clipWidth;
+    GLsizei clipHeight;
+    // state which is not queried from GL while recording display lists
+    struct pgl_texture_t* texture;
+    GLboolean blending;
+    pgl_list_t* recording;
+    // program in use, glUseProgram is only called if it changes
+    GLuint program;
+    // quads of the bound texture which have not been drawn yet (see flushQuads)
+    GLuint vertexBuffer;
+    GLuint indexBuffer;
+    uint32_t batchQuads;
+    // number of glDraw* calls since the context has been created
+    uint32_t drawCalls;
+    // OpenGL ES 3.0: pglVerify reads pixels into pixel buffer objects (otherwise synchronously), program binaries
+    GLboolean gles3;
+    // number of pglVerify calls which had to wait for the GPU
+    uint32_t readbackStalls;
 } pgl_context_t;
 
 struct pgl_texture_t
 {
+    GLuint name;
+    GLsizei width;
+    GLsizei height;
+    GLint filter; // current GL_TEXTURE_MIN_FILTER / GL_TEXTURE_MAG_FILTER
+    PGLFormat format; // PGL_FORMAT_P_8_* for indexed textures, which are uploaded as BGRA_8888
+    // data of a texture which can be verified, otherwise NULL: pixels (pglLoadTexture without copy, RGB formats),
+    // RLE data (pglLoadTextureEncoded) or indices (pglLoadTexturePalette without copy)
+    const uint8_t* data;
+    uint32_t size; // bytes of data
+    PGLEncoding encoding; // PGL_ENCODING_RAW or PGL_ENCODING_RLE(2)
+    PGL_SW_Palette* palette; // colors of the indexed textures, taken from m_palettes at the first load
 };
 
+// A region which pglVerify has read into a pixel buffer. The pixels are compared when the region is verified
+// the next time (usually in the next frame), then the GPU has long finished the copy and mapping the buffer doesn't stall.
+typedef struct pgl_readback_t
+{
+    GLuint buffer;
+    GLsizeiptr size; // allocated bytes of buffer
+    GLboolean pending; // buffer contains the pixels of the region
+    uint32_t frame; // frame of the last use, a region which has been used in the current frame isn't replaced
+    // the verified region: texture, arguments and blending of pglVerify, dest and source rect after clipping
+    struct pgl_texture_t* texture;
+    int32_t coords[8];
+    GLboolean blending;
+    PGL_SW_Surface dest;
+    PGL_SW_Surface source;
+} pgl_readback_t;
+
 
 static EGLConfig m_config = 0;
 static pgl_display_t m_display = {EGL_NO_DISPLAY, 0};
 static pgl_context_t m_context = { EGL_NO_CONTEXT, 0, 0};
-static pgl_surface_t m_window = { EGL_NO_SURFACE, 0, 0};
+static pgl_surface_t m_window = { EGL_NO_SURFACE, 0, 0, EGL_FALSE};
+static EGLint m_alphaSize = 0; // alpha bits of the surfaces, without alpha pglVerify only compares the colors
+static EGLBoolean m_preserved = EGL_FALSE; // buffer content is kept after eglSwapBuffers (needed for partial redraw)
+static PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC m_swapBuffersWithDamage = NULL;
+static pgl_list_t m_lists[PGL_MAX_LISTS];
+static uint32_t m_usedLists = 0;
+static struct pgl_texture_t m_textures[PGL_MAX_TEXTURES];
+static uint32_t m_usedTextures = 0;
+static PGL_SW_Palette m_palettes[PGL_MAX_PALETTES];
+static uint32_t m_usedPalettes = 0;
+static pgl_readback_t m_readbacks[PGL_MAX_READBACKS];
+static uint32_t m_frame = 0; // number of swaps
+// client copy of the vertex buffer: the quads of the batch followed by the quad of pglDrawArea
+static GLfloat m_vertices[(PGL_MAX_BATCH_QUADS + 1) * PGL_QUAD_FLOATS];
+static GLboolean m_bgra = GL_FALSE; // GL_EXT_texture_format_BGRA8888: BGRA textures are uploaded without conversion
+static uint8_t m_converted[64 * 1024]; // rows of a texture which GL can't use in its format, converted to RGBA_8888
+static uint8_t m_decoded[1024 * 1024 * 4]; // encoded and indexed textures are expanded here before they are uploaded (up to 1024x1024 RGBA)
 
 static void loadIdentity(ESMatrix* m)
 {
@@ -169,6 +292,29 @@ static void loadOrtho(ESMatrix* m, float left, float right, float bottom, float
     }
 }
 
+#ifdef PGL_EGL_HEADLESS
+// Without a display server the windows are pbuffers of the Mesa surfaceless platform (e.g. rendered by llvmpipe)
+static EGLDisplay getDisplay(void)
+{
+    EGLDisplay dsp = EGL_NO_DISPLAY;
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = NULL;
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (clientExtensions && strstr(clientExtensions, "EGL_EXT_platform_base") && strstr(clientExtensions, "EGL_MESA_platform_surfaceless"))
+    {
+        getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    }
+    if (getPlatformDisplay)
+    {
+        dsp = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    }
+    else
+    {
+        LOG_WARN(("EGL_MESA_platform_surfaceless is not supported - using the default display"));
+        dsp = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    return dsp;
+}
+#else
 static NativeDisplayType getNativeDisplay()
 {
     NativeDisplayType dsp = XOpenDisplay(NULL);
@@ -227,6 +373,13 @@ static NativeWindowType getNativeWindow(NativeDisplayType dsp, int32_t width, in
     return wnd;
 }
 
+static EGLDisplay getDisplay(void)
+{
+    m_display.native = getNativeDisplay();
+    return eglGetDisplay(m_display.native);
+}
+#endif
+
 static GLuint checkCompileStatus(GLuint shader)
 {
     GLint compiled;
@@ -254,7 +407,8 @@ static GLuint compileShader( GLuint shader )
     return checkCompileStatus(shader);
 }
 
-static GLuint loadProgramSource(const char* vertexShaderSrc, const char* fragmentShaderSrc)
+// retrievable: the binary of the program is stored in the program cache
+static GLuint loadProgramSource(const char* vertexShaderSrc, const char* fragmentShaderSrc, GLboolean retrievable)
 {
     GLuint vertexShader;
     GLuint fragmentShader;
@@ -300,6 +454,13 @@ static GLuint loadProgramSource(const char* vertexShaderSrc, const char* fragmen
 
     glAttachShader ( programObject, vertexShader );
     glAttachShader ( programObject, fragmentShader );
+    // all programs share the layout of the vertex buffer, the locations must be bound before linking
+    glBindAttribLocation ( programObject, a_position, "a_position" );
+    glBindAttribLocation ( programObject, a_texCoord, "a_texCoord" );
+    if (retrievable)
+    {
+        glProgramParameteri ( programObject, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE );
+    }
 
     // Link the program
     glLinkProgram ( programObject );
@@ -327,11 +488,135 @@ static GLuint loadProgramSource(const char* vertexShaderSrc, const char* fragmen
     return programObject;
 }
 
+// Identifies the program binaries: they are only valid for the same driver and the same shader sources
+static uint32_t getProgramCacheKey(void)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    const char* strings[2] = { (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION) };
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        crc = (strings[i] != NULL) ? updateCrc32(crc, (const uint8_t*)strings[i], (uint32_t)strlen(strings[i])) : crc;
+    }
+    for (uint32_t i = 0; i < PGL_PROGRAMS; ++i)
+    {
+        crc = updateCrc32(crc, (const uint8_t*)m_programSources[i][0], (uint32_t)strlen(m_programSources[i][0]));
+        crc = updateCrc32(crc, (const uint8_t*)m_programSources[i][1], (uint32_t)strlen(m_programSources[i][1]));
+    }
+    return ~crc;
+}
+
+// Cache file: magic, key and number of programs, then the binary format, the length and the binary of every program.
+// Returns GL_FALSE if the file is missing, outdated or the driver rejects a binary.
+static GLboolean loadProgramCache(const char* path, uint32_t key, GLuint* programs)
+{
+    GLboolean loaded = GL_FALSE;
+    FILE* f = fopen(path, "rb");
+    if (f != NULL)
+    {
+        // the file is read before any texture is loaded, m_decoded is not used yet
+        const size_t size = fread(m_decoded, 1, sizeof(m_decoded), f);
+        fclose(f);
+        uint32_t header[3];
+        size_t offset = sizeof(header);
+        loaded = (size >= sizeof(header)) ? GL_TRUE : GL_FALSE;
+        if (loaded)
+        {
+            memcpy(header, m_decoded, sizeof(header));
+            loaded = ((header[0] == PGL_PROGRAM_CACHE_MAGIC) && (header[1] == key) && (header[2] == PGL_PROGRAMS)) ? GL_TRUE : GL_FALSE;
+        }
+        for (uint32_t i = 0; loaded && (i < PGL_PROGRAMS); ++i)
+        {
+            uint32_t entry[2]; // binary format, length
+            loaded = ((size - offset) >= sizeof(entry)) ? GL_TRUE : GL_FALSE;
+            if (loaded)
+            {
+                memcpy(entry, &m_decoded[offset], sizeof(entry));
+                offset += sizeof(entry);
+                loaded = (entry[1] <= (size - offset)) ? GL_TRUE : GL_FALSE;
+            }
+            if (loaded)
+            {
+                GLint linked = GL_FALSE;
+                programs[i] = glCreateProgram();
+                glProgramBinary(programs[i], (GLenum)entry[0], &m_decoded[offset], (GLsizei)entry[1]);
+                glGetProgramiv(programs[i], GL_LINK_STATUS, &linked);
+                offset += entry[1];
+                loaded = linked ? GL_TRUE : GL_FALSE;
+            }
+        }
+        if (!loaded)
+        {
+            LOG_WARN(("The program cache %s is outdated or invalid - compiling the shaders", path));
+            for (uint32_t i = 0; i < PGL_PROGRAMS; ++i)
+            {
+                glDeleteProgram(programs[i]);
+                programs[i] = 0;
+            }
+        }
+    }
+    return loaded;
+}
+
+static void saveProgramCache(const char* path, uint32_t key, const GLuint* programs)
+{
+    const uint32_t header[3] = { PGL_PROGRAM_CACHE_MAGIC, key, PGL_PROGRAMS };
+    size_t size = sizeof(header);
+    GLboolean valid = GL_TRUE;
+    memcpy(m_decoded, header, sizeof(header));
+    for (uint32_t i = 0; valid && (i < PGL_PROGRAMS); ++i)
+    {
+        uint32_t entry[2] = { 0, 0 };
+        GLint length = 0;
+        glGetProgramiv(programs[i], GL_PROGRAM_BINARY_LENGTH, &length);
+        valid = ((length > 0) && ((size_t)length <= (sizeof(m_decoded) - size - sizeof(entry)))) ? GL_TRUE : GL_FALSE;
+        if (valid)
+        {
+            GLsizei written = 0;
+            GLenum format = 0;
+            glGetProgramBinary(programs[i], length, &written, &format, &m_decoded[size + sizeof(entry)]);
+            entry[0] = (uint32_t)format;
+            entry[1] = (uint32_t)written;
+            memcpy(&m_decoded[size], entry, sizeof(entry));
+            size += sizeof(entry) + (size_t)written;
+            valid = (written > 0) ? GL_TRUE : GL_FALSE;
+        }
+    }
+    FILE* f = valid ? fopen(path, "wb") : NULL;
+    if (f != NULL)
+    {
+        valid = (fwrite(m_decoded, 1, size, f) == size) ? GL_TRUE : GL_FALSE;
+        fclose(f);
+    }
+    if (!valid || (f == NULL))
+    {
+        LOG_WARN(("The program binaries can't be written to %s", path));
+    }
+}
+
+// The programs are created from the binaries of the cache file PGL_GLES_PROGRAM_CACHE if it is set (GLSC2 only accepts binaries).
+// Without a valid cache file the shaders are compiled and the cache file is written.
+static void loadPrograms(GLboolean binaries, GLuint* programs)
+{
+    const char* path = getenv(PGL_GLES_PROGRAM_CACHE);
+    const GLboolean cache = ((path != NULL) && (path[0] != '\0') && binaries) ? GL_TRUE : GL_FALSE;
+    const uint32_t key = cache ? getProgramCacheKey() : 0u;
+    if (!cache || !loadProgramCache(path, key, programs))
+    {
+        for (uint32_t i = 0; i < PGL_PROGRAMS; ++i)
+        {
+            programs[i] = loadProgramSource(m_programSources[i][0], m_programSources[i][1], cache);
+        }
+        if (cache)
+        {
+            saveProgramCache(path, key, programs);
+        }
+    }
+}
+
 void pglInit(void)
 {
     // EGLDisplay
-    m_display.native = getNativeDisplay();
-    m_display.egl = eglGetDisplay(m_display.native);
+    m_display.egl = getDisplay();
     if(m_display.egl == EGL_NO_DISPLAY)
     {
         LOG_ERR(("EGL_NO_DISPLAY"));
@@ -367,15 +652,48 @@ void pglInit(void)
     };
 
     EGLint iConfigs;
+    const int surfaceTypeValue = 13; // index of the EGL_SURFACE_TYPE value in conflist
+#ifdef PGL_EGL_HEADLESS
+    // a pbuffer is never swapped, its content is always preserved
+    conflist[surfaceTypeValue] = EGL_PBUFFER_BIT;
+    EGLBoolean ecc = eglChooseConfig(m_display.egl, conflist, &m_config, 1, &iConfigs);
+    m_preserved = EGL_TRUE;
+#else
+    // prefer a config which can preserve the buffer content - only the changed parts of a frame are redrawn
+    conflist[surfaceTypeValue] = EGL_WINDOW_BIT | EGL_SWAP_BEHAVIOR_PRESERVED_BIT;
     EGLBoolean ecc = eglChooseConfig(m_display.egl, conflist, &m_config, 1, &iConfigs);
+    m_preserved = (ecc && (iConfigs == 1)) ? EGL_TRUE : EGL_FALSE;
+    if (!m_preserved)
+    {
+        LOG_WARN(("No EGL config with preserved swap behavior - partial redraw is not supported"));
+        conflist[surfaceTypeValue] = EGL_WINDOW_BIT;
+        ecc = eglChooseConfig(m_display.egl, conflist, &m_config, 1, &iConfigs);
+    }
+#endif
     if ((!ecc) || (iConfigs != 1))
     {
         LOG_ERR(("OpenGLWindowES::Initialize, Failed to choose a EGL config."));
     }
+    else
+    {
+        eglGetConfigAttrib(m_display.egl, m_config, EGL_ALPHA_SIZE, &m_alphaSize);
+    }
+
+#ifndef PGL_EGL_HEADLESS
+    const char* extensions = eglQueryString(m_display.egl, EGL_EXTENSIONS);
+    if (extensions && strstr(extensions, "EGL_KHR_swap_buffers_with_damage"))
+    {
+        m_swapBuffersWithDamage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)eglGetProcAddress("eglSwapBuffersWithDamageKHR");
+    }
+#endif
 }
 
 PGLSurface pglCreateWindow(uint8_t window, int32_t x, int32_t y, int32_t w, int32_t h)
 {
+#ifdef PGL_EGL_HEADLESS
+    const EGLint pbufferAttr[] = { EGL_WIDTH, w, EGL_HEIGHT, h, EGL_NONE };
+    m_window.egl = eglCreatePbufferSurface(m_display.egl, m_config, pbufferAttr);
+#else
     NativeWindowType wnd = getNativeWindow(m_display.native, w, h);
     struct
     {
@@ -384,8 +702,15 @@ PGLSurface pglCreateWindow(uint8_t window, int32_t x, int32_t y, int32_t w, int3
     } egl_surf_attr = {{ EGL_RENDER_BUFFER, EGL_BACK_BUFFER },EGL_NONE }; //EGL_BACK_BUFFER should be default anyway
 
     m_window.egl = eglCreateWindowSurface(m_display.egl, m_config, wnd, (EGLint*)&egl_surf_attr);
+    if (m_preserved)
+    {
+        // without the attribute the buffer content is undefined after a swap
+        m_preserved = eglSurfaceAttrib(m_display.egl, m_window.egl, EGL_SWAP_BEHAVIOR, EGL_BUFFER_PRESERVED);
+    }
+#endif
     m_window.width = w;
     m_window.height = h;
+    m_window.initialized = EGL_FALSE;
 
     if(m_window.egl == EGL_NO_SURFACE)
     {
@@ -394,14 +719,22 @@ PGLSurface pglCreateWindow(uint8_t window, int32_t x, int32_t y, int32_t w, int3
     return &m_window;
 }
 
-// TODO: if multiple configs should be supported, we need to add a configuration parameter for pglCreateContext
-PGLContext pglCreateContext(void)
+// TODO: if multiple EGL configs should be supported, they need to be selected via PGLContextConfig
+PGLContext pglCreateContext(const PGLContextConfig* config)
 {
+    (void)config; // the GPU rasterizes in parallel - config->threads is not needed
+    m_context.texture = 0;
+    m_context.blending = GL_FALSE;
+    m_context.recording = NULL;
+    m_context.clipEnabled = GL_FALSE;
+    // the pixel buffers of the readbacks belong to the previous context
+    memset(m_readbacks, 0, sizeof(m_readbacks));
     const EGLint contextAttribList[] =
     {
         EGL_CONTEXT_CLIENT_VERSION, 2,
         EGL_NONE
     };
+    m_context.filter = GL_NEAREST;
     m_context.egl = eglCreateContext(m_display.egl, m_config, EGL_NO_CONTEXT, contextAttribList);
 
     if(m_context.egl == EGL_NO_CONTEXT)
@@ -421,17 +754,63 @@ PGLContext pglCreateContext(void)
     LOG_VERB(("GL_VERSION:%s", glGetString(GL_VERSION)));
     LOG_VERB(("GL_EXTENSIONS:%s", glGetString(GL_EXTENSIONS)));
 
-    m_context.colorShader = loadProgramSource(vColorShaderStr, fColorShaderStr);
-    m_context.textureShader = loadProgramSource(vTexShaderStr, fTexShaderStr);
+    // pixel buffer objects (pglVerify) and program binaries need OpenGL ES 3.0 (the version string starts with "OpenGL ES 3.")
+    const char* version = (const char*)glGetString(GL_VERSION);
+    const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+    GLint binaryFormats = 0;
+    m_context.gles3 = ((version != NULL) && (strncmp(version, "OpenGL ES 3.", 12) == 0)) ? GL_TRUE : GL_FALSE;
+    if (m_context.gles3)
+    {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormats);
+    }
+    m_bgra = ((extensions != NULL) && (strstr(extensions, "GL_EXT_texture_format_BGRA8888") != NULL)) ? GL_TRUE : GL_FALSE;
+
+    GLuint programs[PGL_PROGRAMS] = { 0, 0 };
+    loadPrograms((binaryFormats > 0) ? GL_TRUE : GL_FALSE, programs);
+    m_context.colorShader = programs[0];
+    m_context.textureShader = programs[1];
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-    glBindAttribLocation(m_context.colorShader, a_position, "a_position");
-    glBindAttribLocation(m_context.textureShader, a_position, "a_position");
-    glBindAttribLocation(m_context.textureShader, a_texCoord, "a_texCoord");
     m_context.colorShader_color = glGetUniformLocation(m_context.colorShader, "color");
     m_context.colorShader_mvpMatrix = glGetUniformLocation(m_context.colorShader, "mvp_matrix");
     m_context.textureShader_texture = glGetUniformLocation(m_context.textureShader, "s_texture");
     m_context.textureShader_mvpMatrix = glGetUniformLocation(m_context.textureShader, "mvp_matrix");
 
+    // the vertex buffer is allocated once, every flush only updates the vertices of its quads
+    GLushort indices[PGL_MAX_BATCH_QUADS * 6];
+    for (uint32_t i = 0; i < PGL_MAX_BATCH_QUADS; ++i)
+    {
+        // two triangles per quad: top left, top right, bottom left and bottom left, top right, bottom right
+        const GLushort v = (GLushort)(i * 4);
+        GLushort* index = &indices[i * 6];
+        index[0] = v;
+        index[1] = (GLushort)(v + 1);
+        index[2] = (GLushort)(v + 2);
+        index[3] = (GLushort)(v + 2);
+        index[4] = (GLushort)(v + 1);
+        index[5] = (GLushort)(v + 3);
+    }
+    glGenBuffers(1, &m_context.vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_context.vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(m_vertices), NULL, GL_DYNAMIC_DRAW);
+    glGenBuffers(1, &m_context.indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_context.indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    glVertexAttribPointer(a_position, 2, GL_FLOAT, GL_FALSE, PGL_VERTEX_FLOATS * sizeof(GLfloat), (const void*)0);
+    glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, PGL_VERTEX_FLOATS * sizeof(GLfloat), (const void*)(2 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(a_position);
+    glEnableVertexAttribArray(a_texCoord);
+    m_context.batchQuads = 0;
+    m_context.drawCalls = 0;
+
+    m_context.readbackStalls = 0;
+
+    // rows of textures with 1 or 3 bytes per pixel are not padded
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glActiveTexture(GL_TEXTURE0);
+    glUseProgram(m_context.textureShader);
+    glUniform1i(m_context.textureShader_texture, 0);
+    m_context.program = m_context.textureShader;
+
     GLenum err = glGetError();
     if(err != GL_NO_ERROR)
     {
@@ -441,6 +820,51 @@ PGLContext pglCreateContext(void)
     return &m_context;
 }
 
+static void useProgram(pgl_context_t* context, GLuint program)
+{
+    if (context->program != program)
+    {
+        glUseProgram(program);
+        context->program = program;
+    }
+}
+
+// Draws the collected quads with one draw call. They all use the bound texture and the current state,
+// so this has to be called before the state or the texture is changed and before anything else is drawn.
+static void flushQuads(pgl_context_t* context)
+{
+    if (context->batchQuads > 0)
+    {
+        struct pgl_texture_t* t = context->texture;
+        if (t->filter != context->filter)
+        {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, context->filter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, context->filter);
+            t->filter = context->filter;
+        }
+        useProgram(context, context->textureShader);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, context->batchQuads * PGL_QUAD_FLOATS * sizeof(GLfloat), m_vertices);
+        glDrawElements(GL_TRIANGLES, (GLsizei)(context->batchQuads * 6), GL_UNSIGNED_SHORT, NULL);
+        ++context->drawCalls;
+        context->batchQuads = 0;
+    }
+}
+
+// GL window coordinates start at the lower left corner
+static void applyClip(pgl_context_t* context)
+{
+    flushQuads(context);
+    if (context->clipEnabled && (context->surface != NULL))
+    {
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(context->clipX, context->surface->height - context->clipY - context->clipHeight, context->clipWidth, context->clipHeight);
+    }
+    else
+    {
+        glDisable(GL_SCISSOR_TEST);
+    }
+}
+
 PGLBoolean pglSetSurface(PGLContext context, PGLSurface surface)
 {
     PGLBoolean ret = PGL_FALSE;
@@ -450,10 +874,25 @@ PGLBoolean pglSetSurface(PGLContext context, PGLSurface surface)
     }
     else
     {
+        flushQuads(context);
         ret =  eglMakeCurrent(m_display.egl, surface->egl, surface->egl, context->egl);
         glViewport(0, 0, surface->width, surface->height);
         loadOrtho(&context->mvpMatrix, 0.0f, surface->width, surface->height, 0.0f, 500.0f, -500.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+        // the projection only changes with the surface, it is not set again for every draw call
+        glUseProgram(context->colorShader);
+        glUniformMatrix4fv(context->colorShader_mvpMatrix, 1, GL_FALSE, context->mvpMatrix.f);
+        glUseProgram(context->textureShader);
+        glUniformMatrix4fv(context->textureShader_mvpMatrix, 1, GL_FALSE, context->mvpMatrix.f);
+        context->program = context->textureShader;
+        context->surface = surface;
+        if (!surface->initialized)
+        {
+            // later calls must not destroy the content of the previous frame
+            glDisable(GL_SCISSOR_TEST);
+            glClear(GL_COLOR_BUFFER_BIT);
+            surface->initialized = EGL_TRUE;
+        }
+        applyClip(context);
     }
     return ret;
 }
@@ -468,81 +907,750 @@ PGLBoolean pglSetColor(PGLContext context, uint8_t red, uint8_t green, uint8_t b
     return PGL_TRUE;
 }
 
+PGLBoolean pglSetBlending(PGLContext context, PGLBoolean enable)
+{
+    if ((enable ? GL_TRUE : GL_FALSE) != context->blending)
+    {
+        flushQuads(context);
+    }
+    context->blending = enable ? GL_TRUE : GL_FALSE;
+    if (enable)
+    {
+        // the texture format is not known here - premultiplied textures are blended like straight alpha textures
+        glEnable(GL_BLEND);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    }
+    else
+    {
+        glDisable(GL_BLEND);
+    }
+    return PGL_TRUE;
+}
+
+PGLBoolean pglSetFilter(PGLContext context, PGLFilter filter)
+{
+    const GLint glFilter = (filter == PGL_FILTER_LINEAR) ? GL_LINEAR : GL_NEAREST;
+    if (glFilter != context->filter)
+    {
+        flushQuads(context);
+        context->filter = glFilter;
+    }
+    return PGL_TRUE;
+}
+
+PGLBoolean pglSetClip(PGLContext context, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if ((context != NULL) && (x1 <= x2) && (y1 <= y2))
+    {
+        // same pixel coverage as the SW renderer: x2 / y2 is the last pixel inside the clip area
+        context->clipX = x1 >> 4;
+        context->clipY = y1 >> 4;
+        context->clipWidth = (x2 >> 4) - context->clipX + 1;
+        context->clipHeight = (y2 >> 4) - context->clipY + 1;
+        context->clipEnabled = GL_TRUE;
+        applyClip(context);
+        ret = PGL_TRUE;
+    }
+    return ret;
+}
+
 PGLTexture pglCreateTexture(PGLContext context)
 {
-    GLuint texture;
-    glGenTextures(1, &texture);
-    return (PGLTexture)(uintptr_t)texture;
+    struct pgl_texture_t* t = NULL;
+    if (m_usedTextures < PGL_MAX_TEXTURES)
+    {
+        t = &m_textures[m_usedTextures++];
+        glGenTextures(1, &t->name);
+        t->width = 0;
+        t->height = 0;
+        t->filter = GL_NEAREST;
+        t->format = PGL_FORMAT_INVALID;
+        t->data = NULL;
+        t->size = 0u;
+        t->encoding = PGL_ENCODING_RAW;
+        t->palette = NULL;
+    }
+    return t;
+}
+
+// GL format and type of the textures which GL can use as they are, returns GL_FALSE for the other formats
+static GLboolean getTextureFormat(PGLFormat format, GLenum* glFormat, GLenum* glType)
+{
+    GLboolean native = GL_TRUE;
+    *glType = GL_UNSIGNED_BYTE;
+    switch (format)
+    {
+    case PGL_FORMAT_A_8:
+        *glFormat = GL_ALPHA;
+        break;
+    case PGL_FORMAT_RGB_565:
+        *glFormat = GL_RGB;
+        *glType = GL_UNSIGNED_SHORT_5_6_5;
+        break;
+    case PGL_FORMAT_RGB_888:
+        *glFormat = GL_RGB;
+        break;
+    case PGL_FORMAT_RGBA_8888:
+    case PGL_FORMAT_RGBA_8888_PRE:
+        *glFormat = GL_RGBA;
+        break;
+    case PGL_FORMAT_BGRA_8888:
+    case PGL_FORMAT_BGRA_8888_PRE:
+        *glFormat = GL_BGRA_EXT;
+        native = m_bgra;
+        break;
+    default:
+        native = GL_FALSE;
+        break;
+    }
+    return native;
+}
+
+// Uploads a texture which GL can't use in its format: the rows are converted to RGBA_8888 by the SW renderer in chunks
+static void uploadConverted(uint32_t width, uint32_t height, PGLFormat format, const void* data)
+{
+    const int32_t bpp = pgl_helper_getbpp(format);
+    const int32_t rowBytes = (int32_t)width * 4;
+    const int32_t rows = (rowBytes > 0) ? ((int32_t)sizeof(m_converted) / rowBytes) : 0;
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (GLsizei)width, (GLsizei)height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    for (int32_t y = 0; (rows > 0) && (y < (int32_t)height); y += rows)
+    {
+        const int32_t h = (((int32_t)height - y) < rows) ? ((int32_t)height - y) : rows;
+        PGL_SW_Surface dest = { m_converted, 0, 0, (int32_t)width, h, rowBytes, (int32_t)sizeof(m_converted) };
+        PGL_SW_Surface source = { (PGL_SW_Pointer)data, 0, y, (int32_t)width, h, (int32_t)width * bpp, (int32_t)(width * height) * bpp };
+        pgl_sw_bitblit_convert(&dest, PGL_FORMAT_RGBA_8888, &source, format, PGL_FALSE);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, (GLsizei)width, h, GL_RGBA, GL_UNSIGNED_BYTE, m_converted);
+    }
+    if (rows == 0)
+    {
+        LOG_ERR(("pglLoadTexture: the texture is too wide for the conversion (%u)", width));
+    }
 }
 
 PGLBoolean pglLoadTexture(PGLTexture t, uint32_t width, uint32_t height, PGLFormat format, PGLBoolean copy, const void* data)
 {
-    GLint glType = GL_UNSIGNED_BYTE;
-    GLint glFormat = GL_RGBA;
-    // TODO: check format and return false if not supported
-    glBindTexture(GL_TEXTURE_2D, (uintptr_t) t);
-    glTexImage2D(GL_TEXTURE_2D, 0, glFormat, width, height, 0, glFormat, glType, data);
-    glTexParameteri ( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
-    glTexParameteri ( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
-    return PGL_TRUE;
+    GLenum glFormat = GL_RGBA;
+    GLenum glType = GL_UNSIGNED_BYTE;
+    const GLboolean native = getTextureFormat(format, &glFormat, &glType);
+    const PGLBoolean ret = ((t != NULL) && (data != NULL) && (native || pgl_helper_isconvertible(format))) ? PGL_TRUE : PGL_FALSE;
+    if (ret)
+    {
+        // the quads which have not been drawn yet may use the texture
+        flushQuads(&m_context);
+        glBindTexture(GL_TEXTURE_2D, t->name);
+        if (native)
+        {
+            glTexImage2D(GL_TEXTURE_2D, 0, (GLint)glFormat, (GLsizei)width, (GLsizei)height, 0, glFormat, glType, data);
+        }
+        else
+        {
+            uploadConverted(width, height, format, data);
+        }
+        // quads address texels of atlases, neighbouring images must not be sampled at the edges
+        glTexParameteri ( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+        glTexParameteri ( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+        glTexParameteri ( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+        glTexParameteri ( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+        t->width = (GLsizei)width;
+        t->height = (GLsizei)height;
+        t->filter = GL_NEAREST;
+        t->format = format;
+        // pglVerify compares the pixels with the data the caller keeps (like the SW renderer)
+        t->data = (!copy && pgl_helper_isconvertible(format)) ? (const uint8_t*)data : NULL;
+        t->size = pgl_image_bytes(width, height, pgl_helper_getbpp(format));
+        t->encoding = PGL_ENCODING_RAW;
+        for (uint32_t i = 0; i < PGL_MAX_READBACKS; ++i)
+        {
+            if (m_readbacks[i].texture == t)
+            {
+                // the pixels have been drawn with the previous content
+                m_readbacks[i].pending = GL_FALSE;
+            }
+        }
+        glBindTexture(GL_TEXTURE_2D, (m_context.texture != NULL) ? m_context.texture->name : 0);
+    }
+    else
+    {
+        LOG_ERR(("pglLoadTexture: invalid texture or unsupported format %d", (int)format));
+    }
+    return ret;
+}
+
+PGLBoolean pglLoadTextureEncoded(PGLTexture t, uint32_t width, uint32_t height, PGLFormat format, PGLEncoding encoding, uint32_t size, const void* data)
+{
+    // GL has no use for the encoded data, the texture is decoded and uploaded (pglLoadTexture copies it to GL memory)
+    const uint32_t bpp = (format < PGL_FORMAT_1_BPP) ? 1u : ((format < PGL_FORMAT_2_BPP) ? 2u : ((format < PGL_FORMAT_3_BPP) ? 3u : 4u));
+    PGLBoolean ret = PGL_FALSE;
+    if (pgl_decode(m_decoded, sizeof(m_decoded), width, height, bpp, encoding, data, size))
+    {
+        ret = pglLoadTexture(t, width, height, format, PGL_TRUE, m_decoded);
+        if (ret && ((encoding == PGL_ENCODING_RLE) || (encoding == PGL_ENCODING_RLE2)) && pgl_helper_isconvertible(format))
+        {
+            // pglVerify decodes the RLE data while comparing (like the SW renderer), the decompressed pixels of
+            // the other encodings are only in GL memory: their quads can't be verified
+            t->data = (const uint8_t*)data;
+            t->size = size;
+            t->encoding = encoding;
+        }
+    }
+    else
+    {
+        LOG_ERR(("pglLoadTextureEncoded: invalid data or the texture is too large (%u x %u)", width, height));
+    }
+    return ret;
+}
+
+PGLBoolean pglLoadTexturePalette(PGLTexture t, uint32_t width, uint32_t height, PGLFormat format, PGLBoolean copy, const void* data, uint32_t colors, const void* palette)
+{
+    // GL has no indexed formats, the texture is expanded to BGRA with the colors of the SW renderer
+    PGL_SW_Palette unverified; // no palette left: the texture is drawn, but its quads can't be verified
+    PGL_SW_Palette* colorTable = &unverified;
+    PGLBoolean ret = PGL_FALSE;
+    if ((t != NULL) && (t->palette == NULL) && (m_usedPalettes < PGL_MAX_PALETTES))
+    {
+        // a reloaded texture keeps its palette
+        t->palette = &m_palettes[m_usedPalettes++];
+    }
+    if ((t != NULL) && (t->palette != NULL))
+    {
+        colorTable = t->palette;
+    }
+    if ((t == NULL) || (data == NULL) || !pgl_helper_ispalette(format) || (colors > PGL_SW_PALETTE_COLORS) || (palette == NULL)
+        || !pgl_sw_palette_init(colorTable, format, palette, colors))
+    {
+        LOG_ERR(("pglLoadTexturePalette: invalid texture, palette or format %d", (int)format));
+    }
+    // calculated with 64 bits, a wrapped size would pass the check
+    else if (pgl_image_bytes(width, height, 4u) <= sizeof(m_decoded))
+    {
+        const uint8_t* indices = (const uint8_t*)data;
+        for (uint32_t i = 0; i < width * height; ++i)
+        {
+            memcpy(&m_decoded[i * 4], &colorTable->colors[indices[i] * 4], 4);
+        }
+        ret = pglLoadTexture(t, width, height, PGL_FORMAT_BGRA_8888, PGL_TRUE, m_decoded);
+        if (ret)
+        {
+            // pglVerify looks up the indices
+            t->format = format;
+            t->data = (!copy && (colorTable == t->palette)) ? indices : NULL;
+            t->size = width * height;
+        }
+    }
+    else
+    {
+        LOG_ERR(("pglLoadTexturePalette: the texture is too large (%u x %u)", width, height));
+    }
+    return ret;
 }
 
 void pglBindTexture(PGLContext context, PGLTexture t)
 {
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, (uintptr_t) t);
+    if (t != context->texture)
+    {
+        flushQuads(context);
+        context->texture = t;
+    }
+    glBindTexture(GL_TEXTURE_2D, (t != NULL) ? t->name : 0);
 }
 
-void pglClear(PGLContext ctx)
+// Stores the vertices of a quad in the order top left, top right, bottom left, bottom right (also a triangle strip)
+static void setQuadVertices(GLfloat* v, GLfloat x1, GLfloat y1, GLfloat x2, GLfloat y2, GLfloat s1, GLfloat t1, GLfloat s2, GLfloat t2)
 {
+    const GLfloat quad[PGL_QUAD_FLOATS] = { x1, y1, s1, t1, x2, y1, s2, t1, x1, y2, s1, t2, x2, y2, s2, t2 };
+    memcpy(v, quad, sizeof(quad));
+}
+
+static void drawClear(PGLContext ctx)
+{
+    flushQuads(ctx);
+    glClearColor(ctx->red, ctx->green, ctx->blue, ctx->alpha);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 }
 
-void pglDrawArea(PGLContext ctx, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+// Same pixel coverage as the SW renderer: x2 / y2 is the last pixel inside the area
+static void drawArea(PGLContext ctx, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
 {
-    GLfloat arrayBuffer[] = {x1/16.0f, y1/16.0f, x2/16.0f, y1/16.0f, x1/16.0f, y2/16.0f, x2/16.0f, y2/16.0f };
-    glUseProgram(ctx->colorShader);
-    glEnableVertexAttribArray(a_position);
-    glVertexAttribPointer(a_position, 2, GL_FLOAT, GL_FALSE, 0, arrayBuffer);
+    GLfloat* v = &m_vertices[PGL_MAX_BATCH_QUADS * PGL_QUAD_FLOATS];
+    flushQuads(ctx);
+    setQuadVertices(v, x1 / 16.0f, y1 / 16.0f, (x2 + 16) / 16.0f, (y2 + 16) / 16.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+    useProgram(ctx, ctx->colorShader);
     glUniform4f(ctx->colorShader_color, ctx->red, ctx->green, ctx->blue, ctx->alpha);
-    glUniformMatrix4fv(ctx->colorShader_mvpMatrix, 1, GL_FALSE, ctx->mvpMatrix.f);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBufferSubData(GL_ARRAY_BUFFER, PGL_MAX_BATCH_QUADS * PGL_QUAD_FLOATS * sizeof(GLfloat), PGL_QUAD_FLOATS * sizeof(GLfloat), v);
+    glDrawArrays(GL_TRIANGLE_STRIP, PGL_MAX_BATCH_QUADS * 4, 4);
+    ++ctx->drawCalls;
+}
+
+// The quad is added to the batch of the bound texture, which is drawn by flushQuads.
+// Same texel mapping as the SW renderer: u2 / v2 is the last texel which is mapped to x2 / y2.
+static void drawQuad(PGLContext ctx, int32_t x1, int32_t y1, int32_t u1, int32_t v1, int32_t x2, int32_t y2, int32_t u2, int32_t v2)
+{
+    const struct pgl_texture_t* t = ctx->texture;
+    if ((t != NULL) && (t->width > 0) && (t->height > 0))
+    {
+        if (ctx->batchQuads == PGL_MAX_BATCH_QUADS)
+        {
+            flushQuads(ctx);
+        }
+        const GLfloat w = 16.0f * t->width;
+        const GLfloat h = 16.0f * t->height;
+        setQuadVertices(&m_vertices[ctx->batchQuads * PGL_QUAD_FLOATS], x1 / 16.0f, y1 / 16.0f, (x2 + 16) / 16.0f, (y2 + 16) / 16.0f,
+            u1 / w, v1 / h, (u2 + 16) / w, (v2 + 16) / h);
+        ++ctx->batchQuads;
+    }
+}
+
+// Appends a drawing command to the list which is recorded, returns PGL_FALSE if the context draws directly
+static PGLBoolean record(PGLContext ctx, pgl_command_type_t type, const int32_t* coords, uint32_t count)
+{
+    pgl_list_t* list = ctx->recording;
+    if ((list != NULL) && (list->count < PGL_MAX_LIST_COMMANDS))
+    {
+        pgl_command_t* cmd = &list->commands[list->count++];
+        cmd->type = type;
+        cmd->texture = ctx->texture;
+        cmd->blending = ctx->blending;
+        cmd->filter = ctx->filter;
+        cmd->color[0] = ctx->red;
+        cmd->color[1] = ctx->green;
+        cmd->color[2] = ctx->blue;
+        cmd->color[3] = ctx->alpha;
+        cmd->clipEnabled = ctx->clipEnabled;
+        cmd->clip[0] = ctx->clipX;
+        cmd->clip[1] = ctx->clipY;
+        cmd->clip[2] = ctx->clipWidth;
+        cmd->clip[3] = ctx->clipHeight;
+        memcpy(cmd->coords, coords, count * sizeof(int32_t));
+    }
+    else if (list != NULL)
+    {
+        list->complete = GL_FALSE;
+    }
+    return (list != NULL) ? PGL_TRUE : PGL_FALSE;
+}
+
+void pglClear(PGLContext ctx)
+{
+    if (!record(ctx, PGL_COMMAND_CLEAR, NULL, 0))
+    {
+        drawClear(ctx);
+    }
+}
+
+void pglDrawArea(PGLContext ctx, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    const int32_t coords[] = { x1, y1, x2, y2 };
+    if (!record(ctx, PGL_COMMAND_AREA, coords, 4))
+    {
+        drawArea(ctx, x1, y1, x2, y2);
+    }
 }
 
 void pglDrawQuad(PGLContext ctx, int32_t x1, int32_t y1, int32_t u1, int32_t v1, int32_t x2, int32_t y2, int32_t u2, int32_t v2)
 {
-    GLfloat arrayBuffer[] = {x1/16.0f, y1/16.0f, x2/16.0f, y1/16.0f, x1/16.0f, y2/16.0f, x2/16.0f, y2/16.0f };
-    GLfloat textureBuffer[] = {0,0, 1,0, 0,1, 1, 1};
-    glUseProgram(ctx->textureShader);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glUniform1i(ctx->textureShader_texture, 0);
-    glEnableVertexAttribArray(a_position);
-    glEnableVertexAttribArray(a_texCoord);
-    glVertexAttribPointer(a_position, 2, GL_FLOAT, GL_FALSE, 0, arrayBuffer);
-    glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, textureBuffer);
-    glUniformMatrix4fv(ctx->textureShader_mvpMatrix, 1, GL_FALSE, ctx->mvpMatrix.f);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    const int32_t coords[] = { x1, y1, u1, v1, x2, y2, u2, v2 };
+    if (!record(ctx, PGL_COMMAND_QUAD, coords, 8))
+    {
+        drawQuad(ctx, x1, y1, u1, v1, x2, y2, u2, v2);
+    }
+}
+
+// Two commands may touch the same pixels (a clear touches all of them)
+static GLboolean isOverlapping(const pgl_command_t* a, const pgl_command_t* b)
+{
+    const int32_t* ca = a->coords;
+    const int32_t* cb = b->coords;
+    const int32_t ax2 = (a->type == PGL_COMMAND_QUAD) ? ca[4] : ca[2];
+    const int32_t ay2 = (a->type == PGL_COMMAND_QUAD) ? ca[5] : ca[3];
+    const int32_t bx2 = (b->type == PGL_COMMAND_QUAD) ? cb[4] : cb[2];
+    const int32_t by2 = (b->type == PGL_COMMAND_QUAD) ? cb[5] : cb[3];
+    return (a->type == PGL_COMMAND_CLEAR) || (b->type == PGL_COMMAND_CLEAR)
+        || ((ca[0] <= bx2) && (cb[0] <= ax2) && (ca[1] <= by2) && (cb[1] <= ay2));
+}
+
+PGLList pglCreateList(PGLContext context)
+{
+    pgl_list_t* list = NULL;
+    if (m_usedLists < PGL_MAX_LISTS)
+    {
+        list = &m_lists[m_usedLists++];
+        list->count = 0;
+        list->surface = NULL;
+        list->complete = GL_FALSE;
+    }
+    return list;
+}
+
+PGLBoolean pglBeginList(PGLContext context, PGLList list)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if ((context != NULL) && (list != NULL) && (context->recording == NULL))
+    {
+        list->count = 0;
+        list->surface = context->surface;
+        list->complete = GL_TRUE;
+        context->recording = list;
+        ret = PGL_TRUE;
+    }
+    return ret;
+}
+
+PGLBoolean pglEndList(PGLContext context)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if ((context != NULL) && (context->recording != NULL))
+    {
+        // group the quads of one texture to save texture binds: a command is moved up behind the previous
+        // command with the same texture if it doesn't overlap the commands in between
+        pgl_list_t* list = context->recording;
+        for (uint32_t i = 0; (i + 1) < list->count; ++i)
+        {
+            if (list->commands[i].type == PGL_COMMAND_QUAD)
+            {
+                uint32_t j = i + 1;
+                while ((j < list->count) && ((list->commands[j].type != PGL_COMMAND_QUAD) || (list->commands[j].texture != list->commands[i].texture)))
+                {
+                    ++j;
+                }
+                uint32_t k = i + 1;
+                while ((j < list->count) && (k < j) && !isOverlapping(&list->commands[k], &list->commands[j]))
+                {
+                    ++k;
+                }
+                if ((j < list->count) && (j > i + 1) && (k == j))
+                {
+                    const pgl_command_t cmd = list->commands[j];
+                    memmove(&list->commands[i + 2], &list->commands[i + 1], (j - i - 1) * sizeof(pgl_command_t));
+                    list->commands[i + 1] = cmd;
+                }
+            }
+        }
+        ret = list->complete ? PGL_TRUE : PGL_FALSE;
+        context->recording = NULL;
+    }
+    return ret;
+}
+
+PGLBoolean pglSubmit(PGLContext context, PGLList list)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if ((context != NULL) && (list != NULL) && list->complete && (context->recording == NULL) && pglSetSurface(context, list->surface))
+    {
+        // the state of the context is restored after the replay
+        pgl_context_t saved = *context;
+        for (uint32_t i = 0; i < list->count; ++i)
+        {
+            const pgl_command_t* cmd = &list->commands[i];
+            const int32_t* c = cmd->coords;
+            // only the state which differs from the previous command is changed
+            if ((i == 0) || (cmd->texture != context->texture))
+            {
+                pglBindTexture(context, cmd->texture);
+            }
+            if ((i == 0) || (cmd->blending != context->blending))
+            {
+                pglSetBlending(context, cmd->blending);
+            }
+            if (cmd->filter != context->filter)
+            {
+                flushQuads(context);
+                context->filter = cmd->filter;
+            }
+            context->red = cmd->color[0];
+            context->green = cmd->color[1];
+            context->blue = cmd->color[2];
+            context->alpha = cmd->color[3];
+            if ((i == 0) || (cmd->clipEnabled != context->clipEnabled) || (cmd->clip[0] != context->clipX) || (cmd->clip[1] != context->clipY)
+                || (cmd->clip[2] != context->clipWidth) || (cmd->clip[3] != context->clipHeight))
+            {
+                context->clipEnabled = cmd->clipEnabled;
+                context->clipX = cmd->clip[0];
+                context->clipY = cmd->clip[1];
+                context->clipWidth = cmd->clip[2];
+                context->clipHeight = cmd->clip[3];
+                applyClip(context);
+            }
+            if (cmd->type == PGL_COMMAND_CLEAR)
+            {
+                drawClear(context);
+            }
+            else if (cmd->type == PGL_COMMAND_AREA)
+            {
+                drawArea(context, c[0], c[1], c[2], c[3]);
+            }
+            else
+            {
+                drawQuad(context, c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7]);
+            }
+        }
+        flushQuads(context);
+        pglBindTexture(context, saved.texture);
+        pglSetBlending(context, saved.blending);
+        saved.program = context->program;
+        saved.drawCalls = context->drawCalls;
+        *context = saved;
+        applyClip(context);
+        ret = PGL_TRUE;
+    }
+    return ret;
 }
 
+static GLboolean isSameRegion(const pgl_readback_t* a, const pgl_readback_t* b)
+{
+    return (a->texture == b->texture) && (memcmp(a->coords, b->coords, sizeof(a->coords)) == 0) && (a->blending == b->blending)
+        && (a->dest.x == b->dest.x) && (a->dest.y == b->dest.y) && (a->dest.w == b->dest.w) && (a->dest.h == b->dest.h)
+        && (a->source.x == b->source.x) && (a->source.y == b->source.y);
+}
+
+// Returns the entry of the region or the least recently used entry, NULL if all entries are used in this frame
+static pgl_readback_t* findReadback(const pgl_readback_t* region)
+{
+    pgl_readback_t* found = NULL;
+    for (uint32_t i = 0; (i < PGL_MAX_READBACKS) && ((found == NULL) || !isSameRegion(found, region)); ++i)
+    {
+        pgl_readback_t* r = &m_readbacks[i];
+        const GLboolean replaceable = (!r->pending || (r->frame != m_frame)) ? GL_TRUE : GL_FALSE;
+        if (isSameRegion(r, region) || (replaceable && ((found == NULL) || (r->frame < found->frame))))
+        {
+            found = r;
+        }
+    }
+    return found;
+}
+
+// Reverses the order of the rows (GL rows start at the bottom)
+static void flipRows(uint8_t* p, int32_t rowBytes, int32_t rows)
+{
+    uint8_t tmp[64];
+    for (int32_t y = 0; y < (rows / 2); ++y)
+    {
+        uint8_t* top = p + y * rowBytes;
+        uint8_t* bottom = p + (rows - 1 - y) * rowBytes;
+        for (int32_t i = 0; i < rowBytes; i += (int32_t)sizeof(tmp))
+        {
+            const size_t bytes = ((rowBytes - i) < (int32_t)sizeof(tmp)) ? (size_t)(rowBytes - i) : sizeof(tmp);
+            memcpy(tmp, top + i, bytes);
+            memcpy(top + i, bottom + i, bytes);
+            memcpy(bottom + i, tmp, bytes);
+        }
+    }
+}
+
+// Compares the pixels of the region (top down RGBA rows in m_decoded) with the texture, same kernels as the SW renderer
+static PGLBoolean compareRegion(const pgl_readback_t* region)
+{
+    PGLBoolean ret = PGL_FALSE;
+    const int32_t pixels = region->dest.w * region->dest.h;
+    const struct pgl_texture_t* t = region->texture;
+    PGLFormat destFormat = PGL_FORMAT_RGBA_8888;
+    int32_t bpp = 4;
+    if (m_alphaSize == 0)
+    {
+        // the surface has no alpha channel (read back as 255), only the colors are compared
+        for (int32_t i = 0; i < pixels; ++i)
+        {
+            memmove(&m_decoded[i * 3], &m_decoded[i * 4], 3);
+        }
+        destFormat = PGL_FORMAT_RGB_888;
+        bpp = 3;
+    }
+    const PGL_SW_Surface dest = { m_decoded, 0, 0, region->dest.w, region->dest.h, region->dest.w * bpp, pixels * bpp };
+    if (pgl_helper_ispalette(t->format))
+    {
+        ret = pgl_sw_equal_palette(&dest, destFormat, &region->source, t->palette, region->blending);
+    }
+    else if (t->encoding != PGL_ENCODING_RAW)
+    {
+        ret = pgl_sw_equal_rle(&dest, destFormat, &region->source, t->format, (t->encoding == PGL_ENCODING_RLE2) ? PGL_TRUE : PGL_FALSE, region->blending);
+    }
+    else if ((m_alphaSize == 0) || (t->format != PGL_FORMAT_RGBA_8888))
+    {
+        ret = pgl_sw_equal_convert(&dest, destFormat, &region->source, t->format, region->blending);
+    }
+    else if (region->blending)
+    {
+        ret = pgl_sw_equal_opaque(&dest, &region->source, t->format);
+    }
+    else
+    {
+        ret = pgl_sw_equal(&dest, &region->source, t->format);
+    }
+    return ret;
+}
+
+// Compares the pixels of the previous readback of the region if there is one, otherwise they are read synchronously.
+// Afterwards the current pixels are copied into a pixel buffer, which is compared by the next call for the region.
+static PGLBoolean verifyRegion(pgl_context_t* ctx, const pgl_readback_t* region)
+{
+    PGLBoolean verified = PGL_FALSE;
+    pgl_readback_t* r = findReadback(region);
+    const GLint x = region->dest.x;
+    const GLint y = ctx->surface->height - region->dest.y - region->dest.h;
+    const int32_t rowBytes = region->dest.w * 4;
+    const GLsizeiptr size = (GLsizeiptr)rowBytes * region->dest.h;
+    if ((r != NULL) && r->pending && isSameRegion(r, region))
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, r->buffer);
+        const uint8_t* pixels = (const uint8_t*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+        if (pixels != NULL)
+        {
+            for (int32_t row = 0; row < region->dest.h; ++row)
+            {
+                memcpy(&m_decoded[row * rowBytes], pixels + (region->dest.h - 1 - row) * rowBytes, (size_t)rowBytes);
+            }
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            verified = compareRegion(region);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+    else
+    {
+        // the region is verified for the first time: waits until the GPU has drawn it
+        glReadPixels(x, y, region->dest.w, region->dest.h, GL_RGBA, GL_UNSIGNED_BYTE, m_decoded);
+        flipRows(m_decoded, rowBytes, region->dest.h);
+        verified = compareRegion(region);
+        ++ctx->readbackStalls;
+    }
+
+    if (ctx->gles3 && (r != NULL))
+    {
+        if (r->buffer == 0)
+        {
+            glGenBuffers(1, &r->buffer);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, r->buffer);
+        if (r->size < size)
+        {
+            glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+            r->size = size;
+        }
+        // returns immediately, the GPU copies the pixels after it has drawn them
+        glReadPixels(x, y, region->dest.w, region->dest.h, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        const GLuint buffer = r->buffer;
+        const GLsizeiptr allocated = r->size;
+        *r = *region;
+        r->buffer = buffer;
+        r->size = allocated;
+        r->pending = GL_TRUE;
+        r->frame = m_frame;
+    }
+    return verified;
+}
+
+// Verification is one frame late: the result is the comparison of the pixels which have been read back
+// when the same region has been verified before, only the first verification of a region reads them synchronously.
 PGLBoolean pglVerify(PGLContext ctx, int32_t x1, int32_t y1, int32_t u1, int32_t v1, int32_t x2, int32_t y2, int32_t u2, int32_t v2)
 {
-    return PGL_FALSE;
+    PGLBoolean verified = PGL_FALSE;
+    struct pgl_texture_t* t = (ctx != NULL) ? ctx->texture : NULL;
+    if ((t != NULL) && (t->data != NULL) && (ctx->surface != NULL))
+    {
+        pgl_readback_t region;
+        memset(&region, 0, sizeof(region));
+        region.texture = t;
+        region.coords[0] = x1;
+        region.coords[1] = y1;
+        region.coords[2] = u1;
+        region.coords[3] = v1;
+        region.coords[4] = x2;
+        region.coords[5] = y2;
+        region.coords[6] = u2;
+        region.coords[7] = v2;
+        region.blending = ctx->blending;
+        region.dest.x = x1 >> 4;
+        region.dest.y = y1 >> 4;
+        region.dest.w = ((x2 - x1) >> 4) + 1;
+        region.dest.h = ((y2 - y1) >> 4) + 1;
+        const int32_t bpp = pgl_helper_getbpp(t->format);
+        const PGL_SW_Surface source = { (PGL_SW_Pointer)t->data, u1 >> 4, v1 >> 4, ((u2 - u1) >> 4) + 1, ((v2 - v1) >> 4) + 1, t->width * bpp, (int32_t)t->size };
+        region.source = source;
+        // only the pixels inside the clip area and the surface have been drawn
+        int32_t clip[4] = { 0, 0, ctx->surface->width, ctx->surface->height };
+        if (ctx->clipEnabled)
+        {
+            clip[0] = (ctx->clipX > clip[0]) ? ctx->clipX : clip[0];
+            clip[1] = (ctx->clipY > clip[1]) ? ctx->clipY : clip[1];
+            clip[2] = ((ctx->clipX + ctx->clipWidth) < clip[2]) ? (ctx->clipX + ctx->clipWidth) : clip[2];
+            clip[3] = ((ctx->clipY + ctx->clipHeight) < clip[3]) ? (ctx->clipY + ctx->clipHeight) : clip[3];
+        }
+        flushQuads(ctx);
+        if ((region.dest.w != region.source.w) || (region.dest.h != region.source.h))
+        {
+            // scaled quads are not verified, GL samples the texture differently than the SW renderer
+        }
+        else if (!pgl_sw_clip(&region.dest, &region.source, clip[0], clip[1], clip[2], clip[3]))
+        {
+            // completely clipped: no pixel has been compared, so nothing is verified
+        }
+        else if ((region.dest.w * region.dest.h * 4) > (int32_t)sizeof(m_decoded))
+        {
+            LOG_ERR(("pglVerify: the region is too large (%d x %d)", region.dest.w, region.dest.h));
+        }
+        else
+        {
+            verified = verifyRegion(ctx, &region);
+        }
+    }
+    return verified;
 }
 
 PGLBoolean pglSwapBuffers(PGLSurface surface)
 {
+    // the surface is only drawn by m_context
+    flushQuads(&m_context);
+    ++m_frame;
     GLenum err = glGetError();
     if(err != GL_NO_ERROR)
     {
         LOG_ERR(("pglSwapBuffers(): GlError detected, err:%x", err));
     }
+#ifdef PGL_EGL_HEADLESS
+    // a pbuffer is not presented (eglSwapBuffers has no effect), the frame is complete when the rasterizer has finished
+    glFinish();
+#endif
     return eglSwapBuffers(m_display.egl, surface->egl);
 }
 
+PGLBoolean pglSwapBuffersRegion(PGLSurface surface, const PGLRect* rects, uint32_t count)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if (m_swapBuffersWithDamage && rects && (count > 0u) && (count <= PGL_MAX_DAMAGE_RECTS))
+    {
+        // EGL rectangles: x, y, width, height with the origin in the lower left corner
+        EGLint damage[4 * PGL_MAX_DAMAGE_RECTS];
+        flushQuads(&m_context);
+        ++m_frame;
+        for (uint32_t i = 0u; i < count; ++i)
+        {
+            const EGLint x1 = rects[i].x1 >> 4;
+            const EGLint y1 = rects[i].y1 >> 4;
+            const EGLint x2 = rects[i].x2 >> 4;
+            const EGLint y2 = rects[i].y2 >> 4;
+            damage[4 * i + 0] = x1;
+            damage[4 * i + 1] = surface->height - y2 - 1;
+            damage[4 * i + 2] = x2 - x1 + 1;
+            damage[4 * i + 3] = y2 - y1 + 1;
+        }
+        ret = m_swapBuffersWithDamage(m_display.egl, surface->egl, damage, (EGLint)count);
+    }
+    else
+    {
+        ret = pglSwapBuffers(surface);
+    }
+    return ret;
+}
+
+PGLBoolean pglIsBufferPreserved(PGLSurface surface)
+{
+    return (surface && m_preserved) ? PGL_TRUE : PGL_FALSE;
+}
+
 PGLError pglGetError(PGLContext context)
 {
     PGLError ret = PGL_NO_ERROR;
+    flushQuads(context); // errors of the pending quads are reported now
     EGLint eglErr = eglGetError();
     if (EGL_SUCCESS != eglErr)
     {
@@ -559,3 +1667,13 @@ PGLBoolean pglHandleWindowEvents(PGLContext context)
 {
     return PGL_FALSE;
 }
+
+uint32_t pglGetDrawCallCount(PGLContext context)
+{
+    return (context != NULL) ? context->drawCalls : 0u;
+}
+
+uint32_t pglGetReadbackStallCount(PGLContext context)
+{
+    return (context != NULL) ? context->readbackStalls : 0u;
+}
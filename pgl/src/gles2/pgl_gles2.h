@@ -0,0 +1,61 @@
+#ifndef PGL_GLES2_H
+#define PGL_GLES2_H
+
+/******************************************************************************
+**
+**   File:        pgl_gles2.h
+**   Description: Statistics of the GLES2 renderer
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include "pgl.h"
+
+// Environment variable with the path of the program binary cache. If it is set, pglCreateContext creates the shader programs
+// from the binaries in the file (glProgramBinary, OpenGL ES 3.0) instead of compiling the shaders. The file is (re)written
+// when it is missing or the binaries don't match the driver or the shaders.
+#define PGL_GLES_PROGRAM_CACHE "PGL_GLES_PROGRAM_CACHE"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Returns the number of GL draw calls the context has issued since it has been created.
+ * Quads of the same texture are collected and drawn with one call when the texture or the state changes,
+ * a surface is swapped or pglGetError is called, so the value is only complete after one of these.
+ * Can be used by tests and benchmarks to check the batching.
+ */
+uint32_t pglGetDrawCallCount(PGLContext context);
+
+/**
+ * Returns the number of pglVerify calls which had to wait for the GPU to read the pixels (synchronous glReadPixels).
+ * pglVerify reads a region into a pixel buffer and compares it when the same region is verified again, so only the first
+ * verification of a region stalls (every verification without OpenGL ES 3.0 pixel buffers).
+ */
+uint32_t pglGetReadbackStallCount(PGLContext context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PGL_GLES2_H
@@ -0,0 +1,234 @@
+/******************************************************************************
+**
+**   File:        pgl_linux.c
+**   Description: Offscreen (headless) window surfaces for the SW renderer
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Render.
+**
+**   Safe Render is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Render is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Render.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+// --> We have a SW bitblitting library (platform independent)
+// --> This file provides the memory pointers - render targets (platform dependent)
+// There is no window system: the surfaces are plain framebuffers in RAM which can be dumped to files on swap.
+
+#include "pgl_linux.h"
+#include "pgl_sw_renderer_glue.h"
+#include "pgl_sw_renderer.h"
+#include "pgl_sw_swapchain.h"
+#include "pgl_assert.h"
+#include "crc32.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum
+{
+    PGL_DUMP_NONE,
+    PGL_DUMP_PPM,
+    PGL_DUMP_RAW
+} pgl_dump_t;
+
+typedef struct pgl_surface_t
+{
+    uint8_t * mBitmapMemory; // all buffers of the chain
+    PGL_SW_Swapchain mSwapchain;
+    uint32_t mSize; // Size in memory in bytes (of one buffer)
+    int32_t mWidth;
+    int32_t mHeight;
+    uint8_t mWindow;
+    uint32_t mSwapCount;
+    PGLFormat mFormat;
+    PGLBoolean mValid;
+} pgl_surface_t;
+
+static pgl_surface_t gsSurfaces[PGL_MAX_SURFACES] = { { 0 } };
+static pgl_dump_t gsDump = PGL_DUMP_NONE;
+static const char * gsDumpPath = ".";
+static uint32_t gsBuffers = 1u;
+
+// Writes the front buffer
+static void dumpSurface(const pgl_surface_t * s)
+{
+    const uint8_t * memory = pgl_sw_swapchain_front(&s->mSwapchain);
+    char fileName[256];
+    const char * ext = (gsDump == PGL_DUMP_PPM) ? "ppm" : "raw";
+    snprintf(fileName, sizeof(fileName), "%s/pgl_window%u_%05u.%s", gsDumpPath, (unsigned)s->mWindow, (unsigned)s->mSwapCount, ext);
+    FILE * f = fopen(fileName, "wb");
+    if (f)
+    {
+        if (gsDump == PGL_DUMP_PPM)
+        {
+            // surface memory is BGRA_8888 - P6 expects RGB triples
+            uint8_t line[3 * 1024];
+            const int32_t pixelsPerChunk = (int32_t)(sizeof(line) / 3u);
+            fprintf(f, "P6\n%d %d\n255\n", s->mWidth, s->mHeight);
+            for (int32_t y = 0; y < s->mHeight; ++y)
+            {
+                const uint8_t * ps = memory + y * s->mWidth * 4;
+                for (int32_t x = 0; x < s->mWidth; x += pixelsPerChunk)
+                {
+                    const int32_t n = ((s->mWidth - x) < pixelsPerChunk) ? (s->mWidth - x) : pixelsPerChunk;
+                    for (int32_t i = 0; i < n; ++i)
+                    {
+                        line[3 * i + 0] = ps[2];
+                        line[3 * i + 1] = ps[1];
+                        line[3 * i + 2] = ps[0];
+                        ps += 4;
+                    }
+                    fwrite(line, 3u, (size_t)n, f);
+                }
+            }
+        }
+        else
+        {
+            fwrite(memory, 1u, s->mSize, f);
+        }
+        fclose(f);
+    }
+}
+
+void pglInit(void)
+{
+    const char * dump = getenv("PGL_SW_DUMP");
+    const char * path = getenv("PGL_SW_DUMP_PATH");
+    const char * buffers = getenv("PGL_SW_BUFFERS");
+    gsDump = PGL_DUMP_NONE;
+    if (dump && (strcmp(dump, "ppm") == 0))
+    {
+        gsDump = PGL_DUMP_PPM;
+    }
+    else if (dump && (strcmp(dump, "raw") == 0))
+    {
+        gsDump = PGL_DUMP_RAW;
+    }
+    gsDumpPath = (path && path[0]) ? path : ".";
+    gsBuffers = buffers ? (uint32_t)strtoul(buffers, NULL, 10) : 1u;
+    gsBuffers = ((gsBuffers > 0u) && (gsBuffers <= PGL_SW_MAX_BUFFERS)) ? gsBuffers : 1u;
+    initCrc32(); // selects the CRC instructions of the CPU (PGL_VERIFY_TILE_CRC)
+}
+
+PGLSurface pglCreateWindow(uint8_t window, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    PGLSurface retVal = NULL;
+
+    if (PGL_REQUIRE(window < PGL_MAX_SURFACES) && PGL_REQUIRE(x >= 0) && PGL_REQUIRE(y >= 0) && PGL_REQUIRE(w > 0) && PGL_REQUIRE(h > 0) && PGL_REQUIRE(gsSurfaces[window].mValid == PGL_FALSE))
+    {
+        retVal = &gsSurfaces[window];
+        retVal->mFormat = PGL_FORMAT_BGRA_8888; // same layout as the win32 DIB section
+        retVal->mSize = (uint32_t)(w * h) * sizeof(uint32_t);
+        retVal->mWidth = w;
+        retVal->mHeight = h;
+        retVal->mWindow = window;
+        retVal->mSwapCount = 0u;
+        retVal->mBitmapMemory = calloc(retVal->mSize, gsBuffers); // deterministic initial content for dumps and tests
+        retVal->mValid = (retVal->mBitmapMemory != NULL) ? PGL_TRUE : PGL_FALSE;
+        if (PGL_REQUIRE(retVal->mValid))
+        {
+            PGL_SW_Pointer buffers[PGL_SW_MAX_BUFFERS];
+            for (uint32_t i = 0u; i < gsBuffers; ++i)
+            {
+                buffers[i] = retVal->mBitmapMemory + i * retVal->mSize;
+            }
+            pgl_sw_swapchain_init(&retVal->mSwapchain, buffers, gsBuffers, w, h, pgl_helper_getbpp(retVal->mFormat));
+        }
+        else
+        {
+            retVal = NULL;
+        }
+    }
+
+    return retVal;
+}
+
+PGLBoolean pglIsValidSurface(PGLSurface surface, PGLBoolean check4content)
+{
+    return PGL_REQUIRE(surface) // check if context is valid - additional check to see if surface is special NULL pointer
+        && (!check4content || PGL_REQUIRE(surface->mValid)) // valid flag set?
+        && PGL_REQUIRE(surface >= &gsSurfaces[0]) // check if surface points to valid memory
+        && PGL_REQUIRE(surface < &gsSurfaces[PGL_MAX_SURFACES]);
+}
+
+PGLBoolean pglSwapBuffers(PGLSurface surface)
+{
+    return pglSwapBuffersRegion(surface, NULL, 0u);
+}
+
+PGLBoolean pglSwapBuffersRegion(PGLSurface surface, const PGLRect* rects, uint32_t count)
+{
+    PGLBoolean retVal = pglIsValidSurface(surface, PGL_TRUE);
+    if (retVal && surface)
+    {
+        pglFlushSurface(surface); // the tiles of threaded contexts have to be finished before the frame is presented
+        // the rects only limit the copy into the next back buffer - the dump always contains the whole frame
+        pgl_sw_swapchain_swap(&surface->mSwapchain, rects, count);
+        if (gsDump != PGL_DUMP_NONE)
+        {
+            dumpSurface(surface);
+        }
+        ++surface->mSwapCount;
+    }
+    return retVal;
+}
+
+PGLBoolean pglIsBufferPreserved(PGLSurface surface)
+{
+    // the swap chain copies the changed parts into the next back buffer
+    return pglIsValidSurface(surface, PGL_TRUE);
+}
+
+uint32_t pglGetSwapCount(PGLSurface surface)
+{
+    return pglIsValidSurface(surface, PGL_TRUE) ? surface->mSwapCount : 0u;
+}
+
+uint32_t pglGetSwapCopyBytes(PGLSurface surface)
+{
+    return pglIsValidSurface(surface, PGL_TRUE) ? surface->mSwapchain.mCopiedBytes : 0u;
+}
+
+PGLBoolean pglHandleWindowEvents(PGLContext context)
+{
+    // no window manager - an offscreen window can't be closed
+    return PGL_FALSE;
+}
+
+PGLBoolean pglSurfaceToSWSurface(PGLSurface s, PGL_SW_Surface * swsurface, PGLFormat * format)
+{
+    PGLBoolean bRet = swsurface && pglIsValidSurface(s, PGL_TRUE);
+
+    if (swsurface)
+    {
+        swsurface->alignment = bRet ? pgl_helper_getbpp(s->mFormat) * s->mWidth : 0;
+        swsurface->bytes = bRet ? (int32_t)s->mSize : 0;
+        swsurface->x = 0;
+        swsurface->y = 0;
+        swsurface->w = bRet ? s->mWidth : 0;
+        swsurface->h = bRet ? s->mHeight : 0;
+        swsurface->p = bRet ? pgl_sw_swapchain_back(&s->mSwapchain) : NULL; // changes with every swap if there are several buffers
+    }
+
+    if (format)
+    {
+        *format = bRet ? s->mFormat : PGL_FORMAT_INVALID;
+    }
+
+    return bRet;
+}
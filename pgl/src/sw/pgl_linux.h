@@ -0,0 +1,91 @@
+#ifndef PGL_LINUX_H
+#define PGL_LINUX_H
+
+/******************************************************************************
+**
+**   File:        pgl_linux.h
+**   Description: Offscreen (headless) window surfaces for the SW renderer
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include "pgl.h"
+#include "pgl_sw_renderer.h"
+
+#define PGL_MAX_SURFACES 4
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Initializes the offscreen window system.
+ *
+ * The environment variable PGL_SW_DUMP enables dumping of the window content on every pglSwapBuffers call:
+ * - "ppm": the frame is written as binary portable pixmap (P6)
+ * - "raw": the surface memory is written as is (BGRA_8888, no header)
+ * PGL_SW_DUMP_PATH optionally specifies the output directory (default: current working directory).
+ * PGL_SW_BUFFERS sets the number of framebuffers of the windows which are created afterwards (1 ... PGL_SW_MAX_BUFFERS,
+ * default: 1). With more than one buffer pglSwapBuffers flips the buffers and the pointer of pglSurfaceToSWSurface changes.
+ */
+void pglInit(void);
+PGLSurface pglCreateWindow(uint8_t window, int32_t x, int32_t y, int32_t w, int32_t h);
+PGLBoolean pglSwapBuffers(PGLSurface surface);
+PGLBoolean pglSwapBuffersRegion(PGLSurface surface, const PGLRect* rects, uint32_t count);
+PGLBoolean pglIsBufferPreserved(PGLSurface surface);
+
+/**
+ * Checks if the passed in surface is valid
+ * @param surface the surface which to check for validity
+ * @param check4content if PGL_TRUE pixel data needs to be included to have a positive result
+ * @return returns PGL_TRUE if the rendertarget is valid
+ */
+PGLBoolean pglIsValidSurface(PGLSurface surface, PGLBoolean check4content);
+
+/**
+* stores the data of a surface in a SW surface struct which is returned
+* The pixels drawn by threaded contexts are only complete after pglSwapBuffers, pglVerify or pglFlushSurface.
+* @param surface the surface which to check for validity
+* @param swsurface returns the specifics of a surface in a SWSurface struct (width, height, ...)
+* @param format returns the format of the surface. Pointer is allowed to be 0
+* @return returns PGL_TRUE if the returned SW surface is valid and contains Pixeldata
+*/
+PGLBoolean pglSurfaceToSWSurface(PGLSurface surface, PGL_SW_Surface * swsurface, PGLFormat * format);
+
+/**
+ * Returns the number of pglSwapBuffers calls for the given surface
+ * Can be used by tests and benchmarks to check that frames have been presented.
+ */
+uint32_t pglGetSwapCount(PGLSurface surface);
+
+/**
+ * Returns the number of bytes which the last swap has copied to bring the next back buffer up to date
+ * Always 0 for a window with a single buffer.
+ */
+uint32_t pglGetSwapCopyBytes(PGLSurface surface);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // PGL_LINUX_H
@@ -26,33 +26,56 @@
 
 #include "pgl_sw_renderer.h"
 #include "pgl_assert.h"
+#include "crc32.h"
+#include "pgl_decode.h"
+#include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PGL_SW_SSE2 1
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define PGL_SW_SSSE3 1 // byte shuffles (palette lookup)
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PGL_SW_NEON 1
+#endif
 
-static void checkPreconditions(const PGL_SW_Surface *dest, const PGL_SW_Surface *source, const uint8_t bpp)
+#define PGL_SW_CHUNK 16 // bytes compared at once - a multiple of 1, 2 and 4 bpp (3 bpp formats use 3 chunks)
+
+typedef struct
 {
-    PGL_ASSERT((bpp == 1u) || (bpp == 2u) || (bpp == 4u)); // we support only 1, 2 and 4 bytes per pixel
+    PGL_SW_Pointer pd; // first destination pixel of the clipped area
+    PGL_SW_Pointer ps; // first source pixel of the clipped area
+    int32_t columns; // pixels per row which are inside both surfaces
+    int32_t rows; // rows which are inside both surfaces
+} pgl_sw_span_t;
 
-    PGL_ASSERT(dest);
-    //PGL_ASSERT(dest->x >= 0); // beginning could be negative?
-    //PGL_ASSERT(dest->y >= 0);
-    PGL_ASSERT(dest->w >= 0);
-    PGL_ASSERT(dest->h >= 0);
-    PGL_ASSERT((dest->y+dest->h-1)*dest->alignment+(dest->x+dest->w)*bpp <= dest->bytes); // is rect maximum inside memory boundaries
-
-    PGL_ASSERT(source);
-    //PGL_ASSERT(source->x >= 0);
-    //PGL_ASSERT(source->y >= 0);
-    PGL_ASSERT(source->w >= 0);
-    PGL_ASSERT(source->h >= 0);
-    PGL_ASSERT((source->y+source->h-1)*source->alignment+(source->x+source->w)*bpp <= source->bytes); // is rect maximum inside memory boundaries
-
-    // check for correct start memory alignment
-    PGL_ASSERT( ((bpp == 2u) && (((uint32_t)dest->p & 1) == 0)) || ((bpp == 4u) && (((uint32_t)dest->p & 3) == 0)) );
-    PGL_ASSERT( ((bpp == 2u) && (((uint32_t)source->p & 1) == 0)) || ((bpp == 4u) && (((uint32_t)source->p & 3) == 0)));
+
+static void checkSurface(const PGL_SW_Surface *surface, const uint8_t bpp, const PGLBoolean isSource)
+{
+    PGL_ASSERT((bpp == 1u) || (bpp == 2u) || (bpp == 3u) || (bpp == 4u)); // we support only 1, 2, 3 and 4 bytes per pixel
+
+    PGL_ASSERT(surface);
+    //PGL_ASSERT(surface->x >= 0); // beginning could be negative?
+    //PGL_ASSERT(surface->y >= 0);
+    PGL_ASSERT(surface->w >= 0);
+    PGL_ASSERT(surface->h >= 0);
+    // the dest rect may exceed the surface memory - it is clipped by the kernels
+    PGL_ASSERT(!isSource || ((surface->y+surface->h-1)*surface->alignment+(surface->x+surface->w)*bpp <= surface->bytes)); // is rect maximum inside memory boundaries
+
+    // check for correct start memory alignment (3 bpp formats are accessed bytewise)
+    PGL_ASSERT( (bpp == 1u) || (bpp == 3u) || ((bpp == 2u) && (((uintptr_t)surface->p & 1) == 0)) || ((bpp == 4u) && (((uintptr_t)surface->p & 3) == 0)) );
 
     // check for correct alignment of columns
-    PGL_ASSERT( ((bpp == 2u) && (((uint32_t)dest->alignment & 1) == 0)) || ((bpp == 4u) && (((uint32_t)dest->alignment & 3) == 0)) );
-    PGL_ASSERT( ((bpp == 2u) && (((uint32_t)source->alignment & 1) == 0)) || ((bpp == 4u) && (((uint32_t)source->alignment & 3) == 0)) );
+    PGL_ASSERT( (bpp == 1u) || (bpp == 3u) || ((bpp == 2u) && (((uint32_t)surface->alignment & 1) == 0)) || ((bpp == 4u) && (((uint32_t)surface->alignment & 3) == 0)) );
+}
+
+static void checkPreconditions(const PGL_SW_Surface *dest, const PGL_SW_Surface *source, const uint8_t bpp)
+{
+    checkSurface(dest, bpp, PGL_FALSE);
+    checkSurface(source, bpp, PGL_TRUE);
 }
 
 // To do: Which functions are independent / and wich are dependent?
@@ -72,7 +95,7 @@ uint8_t pgl_helper_getbpp(PGLFormat format)
     else if (format < PGL_FORMAT_2_BPP)
         bpp = 2u;
     else if (format < PGL_FORMAT_3_BPP)
-        PGL_ASSERT(PGL_FALSE); // we do not support 3 bpp format
+        bpp = 3u;
     else if (format < PGL_FORMAT_4_BPP)
         bpp = 4u;
 
@@ -84,103 +107,1523 @@ uint8_t pgl_helper_getbpp(PGLFormat format)
 // SW renderer needs src - memory pointer , x & y, width & height and alignment
 // SW renderer can handle all format by simply copying content (no alpha blending in one render target support / bitblit over bitblit)
 
+// Clips one axis of a blit: d is the destination start, s the source start and n the extent.
+// After the call [d, d+n) lies inside [0, dLimit) and [s, s+n) inside [0, sLimit). n <= 0 means nothing is left.
+static void clipAxis(int32_t *d, int32_t *s, int32_t *n, const int32_t dLimit, const int32_t sLimit)
+{
+    if (*d < 0)
+    {
+        *s -= *d;
+        *n += *d;
+        *d = 0;
+    }
+    if (*s < 0)
+    {
+        *d -= *s;
+        *n += *s;
+        *s = 0;
+    }
+    if ((*d + *n) > dLimit)
+    {
+        *n = dLimit - *d;
+    }
+    if ((*s + *n) > sLimit)
+    {
+        *n = sLimit - *s;
+    }
+}
+
+/**
+ * Computes the part of a blit which is inside the memory of both surfaces.
+ * The limits are derived from alignment and bytes, so every row of the returned span is safe to access as a whole
+ * (this is at least as strict as checking every single pixel pointer against the memory boundaries).
+ * @return PGL_TRUE if at least one pixel has to be processed
+ */
+static PGLBoolean clipSpan(const PGL_SW_Surface *dest, const uint8_t destBpp, const PGL_SW_Surface *source, const uint8_t sourceBpp, pgl_sw_span_t *span)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if ((destBpp > 0u) && (sourceBpp > 0u) && (dest->alignment > 0) && (source->alignment > 0))
+    {
+        int32_t dx = dest->x;
+        int32_t dy = dest->y;
+        int32_t sx = source->x;
+        int32_t sy = source->y;
+        int32_t w = source->w;
+        int32_t h = source->h;
+        clipAxis(&dx, &sx, &w, dest->alignment / destBpp, source->alignment / sourceBpp);
+        clipAxis(&dy, &sy, &h, dest->bytes / dest->alignment, source->bytes / source->alignment);
+        if ((w > 0) && (h > 0))
+        {
+            span->pd = dest->p + dy * dest->alignment + dx * destBpp;
+            span->ps = source->p + sy * source->alignment + sx * sourceBpp;
+            span->columns = w;
+            span->rows = h;
+            ret = PGL_TRUE;
+        }
+    }
+    return ret;
+}
+
+/**
+ * Computes the part of the rect (x, y, w, h of dest) which is inside the surface memory. Used by the kernels without a source rect.
+ * @return PGL_TRUE if at least one pixel has to be processed
+ */
+static PGLBoolean clipRect(const PGL_SW_Surface *dest, const uint8_t bpp, int32_t *x, int32_t *y, int32_t *w, int32_t *h)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if ((bpp > 0u) && (dest->alignment > 0))
+    {
+        int32_t sx = 0; // there is no source - clip against the rect itself
+        int32_t sy = 0;
+        *x = dest->x;
+        *y = dest->y;
+        *w = dest->w;
+        *h = dest->h;
+        clipAxis(x, &sx, w, dest->alignment / bpp, dest->w);
+        clipAxis(y, &sy, h, dest->bytes / dest->alignment, dest->h);
+        ret = ((*w > 0) && (*h > 0)) ? PGL_TRUE : PGL_FALSE;
+    }
+    return ret;
+}
+
+PGLBoolean pgl_sw_clip(PGL_SW_Surface *dest, PGL_SW_Surface *source, int32_t left, int32_t top, int32_t right, int32_t bottom)
+{
+    PGL_ASSERT(dest);
+    const int32_t w0 = source ? source->w : dest->w;
+    const int32_t h0 = source ? source->h : dest->h;
+    // clip in coordinates relative to the clip rectangle, the offsets into the extent are tracked in sx / sy
+    int32_t dx = dest->x - left;
+    int32_t dy = dest->y - top;
+    int32_t sx = 0;
+    int32_t sy = 0;
+    int32_t w = w0;
+    int32_t h = h0;
+    clipAxis(&dx, &sx, &w, right - left, w0);
+    clipAxis(&dy, &sy, &h, bottom - top, h0);
+    w = (w > 0) ? w : 0;
+    h = (h > 0) ? h : 0;
+
+    dest->x = dx + left;
+    dest->y = dy + top;
+    dest->w = w;
+    dest->h = h;
+    if (source)
+    {
+        source->x += sx;
+        source->y += sy;
+        source->w = w;
+        source->h = h;
+    }
+    return ((w > 0) && (h > 0)) ? PGL_TRUE : PGL_FALSE;
+}
+
 void pgl_sw_bitblit_copy(PGL_SW_Surface *dest, PGL_SW_Surface *source, PGLFormat format)
 {
     // check that format is supported
     const uint8_t bpp =pgl_helper_getbpp(format);
     checkPreconditions(dest, source, bpp);
 
-    PGL_SW_Pointer ps = source->p + source->y*source->alignment + source->x*bpp; // calculate start position of source memory pointer
-    PGL_SW_Pointer pd = dest->p + dest->y*dest->alignment + dest->x*bpp; // calculate start position of dest memory pointer
-    int32_t offsets = source->alignment - source->w*bpp; // calculate how many bytes need to be added to source when switching to the next column
-    int32_t offsetd = dest->alignment - source->w*bpp; // attention: width of destination is only for informational purpose. No scaling applied. Currently ignored
-    const PGL_SW_Pointer psBegin = source->p;
-    const PGL_SW_Pointer psEnd = psBegin + source->bytes;
-    const PGL_SW_Pointer pdBegin = dest->p;
-    const PGL_SW_Pointer pdEnd = pdBegin + dest->bytes;
-    for (int32_t y = 0; y < source->h; ++y)
-    {
-        for (int32_t x = 0; x < source->w; ++x)
-        {
-            // to make it safe check if pointers are inside valid boundaries
-            // as negative values are acceptable --> we do have the following assertions active
-            //PGL_ASSERT((ps >= psBegin) && (ps < psEnd));
-            //PGL_ASSERT((pd >= pdBegin) && (pd < pdEnd));
-            if ((ps >= psBegin) && (ps < psEnd) && (pd >= pdBegin) && (pd < pdEnd))
-            {
-                switch (bpp)
-                {
-                    case 1u:
-                        *pd = *ps;
-                        break;
-                    case 2u:
-                        *((uint16_t*)(pd)) = *((uint16_t*)(ps));
-                        break;
-                    case 4u:
-                        *((uint32_t*)(pd)) = *((uint32_t*)(ps));
-                        break;
-                }
+    // the clipping is done once per blit - afterwards every row is a plain memory copy (libc uses the widest vector unit available)
+    pgl_sw_span_t span;
+    if (clipSpan(dest, bpp, source, bpp, &span))
+    {
+        const size_t rowBytes = (size_t)span.columns * bpp;
+        for (int32_t y = 0; y < span.rows; ++y)
+        {
+            memcpy(span.pd, span.ps, rowBytes);
+            span.ps += source->alignment;
+            span.pd += dest->alignment;
+        }
+    }
+}
+
+// Exact (rounded) division by 255 for values up to 255 * 255
+#define PGL_SW_DIV255(x) ((((x) + 128u) + (((x) + 128u) >> 8u)) >> 8u)
+
+// alpha is the 4th byte in memory for all blendable formats (RGBA / BGRA, straight and premultiplied)
+#define PGL_SW_ALPHA_BYTE 3
+
+PGLBoolean pgl_helper_isblendable(PGLFormat format)
+{
+    return ((format == PGL_FORMAT_BGRA_8888) || (format == PGL_FORMAT_RGBA_8888)
+        || (format == PGL_FORMAT_BGRA_8888_PRE) || (format == PGL_FORMAT_RGBA_8888_PRE)) ? PGL_TRUE : PGL_FALSE;
+}
+
+PGLBoolean pgl_helper_ispremultiplied(PGLFormat format)
+{
+    return ((format == PGL_FORMAT_BGRA_8888_PRE) || (format == PGL_FORMAT_RGBA_8888_PRE)) ? PGL_TRUE : PGL_FALSE;
+}
+
+/**
+ * Blends pixels with the reference formulas. The SIMD implementation yields bit identical results.
+ * straight:      c = (s * a + d * (255 - a)) / 255, alpha = a + d_alpha * (255 - a) / 255
+ * premultiplied: c = s + d * (255 - a) / 255 (saturated)
+ */
+static void blendPixels(uint8_t *pd, const uint8_t *ps, const int32_t pixels, const PGLBoolean premultiplied)
+{
+    for (int32_t x = 0; x < pixels; ++x)
+    {
+        const uint32_t a = ps[PGL_SW_ALPHA_BYTE];
+        const uint32_t ia = 255u - a;
+        if (a == 255u)
+        {
+            memcpy(pd, ps, 4u);
+        }
+        else if (premultiplied)
+        {
+            for (int32_t c = 0; c < 4; ++c)
+            {
+                const uint32_t v = ps[c] + PGL_SW_DIV255(pd[c] * ia);
+                pd[c] = (uint8_t)((v > 255u) ? 255u : v);
+            }
+        }
+        else if (a != 0u)
+        {
+            for (int32_t c = 0; c < 3; ++c)
+            {
+                pd[c] = (uint8_t)PGL_SW_DIV255(ps[c] * a + pd[c] * ia);
             }
-            ps += bpp;
-            pd += bpp;
+            pd[PGL_SW_ALPHA_BYTE] = (uint8_t)(a + PGL_SW_DIV255(pd[PGL_SW_ALPHA_BYTE] * ia));
+        }
+        else
+        {
+            // fully transparent - keep the destination
         }
-        ps += offsets;
-        pd += offsetd;
+        pd += 4;
+        ps += 4;
     }
 }
 
-uint32_t pgl_sw_compare(const PGL_SW_Surface *dest, const PGL_SW_Surface *source, PGLFormat format)
+#if defined(PGL_SW_SSE2)
+static __m128i div255Epi16(const __m128i x)
+{
+    const __m128i t = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+// blends 2 pixels which are unpacked to 16 bit lanes
+static __m128i blend2Pixels(const __m128i s, const __m128i d, const PGLBoolean premultiplied)
+{
+    const __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128i ia = _mm_sub_epi16(_mm_set1_epi16(255), a);
+    __m128i ret;
+    if (premultiplied)
+    {
+        ret = _mm_add_epi16(s, div255Epi16(_mm_mullo_epi16(d, ia)));
+    }
+    else
+    {
+        // the alpha lane is multiplied with 255 instead of a: a * 255 + d * (255 - a) == (a + d * (255 - a) / 255) * 255
+        const __m128i fa = _mm_or_si128(a, _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0));
+        ret = div255Epi16(_mm_add_epi16(_mm_mullo_epi16(s, fa), _mm_mullo_epi16(d, ia)));
+    }
+    return ret;
+}
+
+// blends as many pixels as possible in groups of 4 and returns the number of processed pixels
+static int32_t blendPixelsSimd(uint8_t *pd, const uint8_t *ps, const int32_t pixels, const PGLBoolean premultiplied)
+{
+    const __m128i alphaMask = _mm_set1_epi32((int)0xff000000u);
+    const __m128i zero = _mm_setzero_si128();
+    int32_t x = 0;
+    for (; (x + 4) <= pixels; x += 4)
+    {
+        const __m128i s = _mm_loadu_si128((const __m128i*)(ps + x * 4));
+        const __m128i sa = _mm_and_si128(s, alphaMask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(sa, alphaMask)) == 0xffff)
+        {
+            _mm_storeu_si128((__m128i*)(pd + x * 4), s); // all opaque
+        }
+        else if (_mm_movemask_epi8(_mm_cmpeq_epi32(premultiplied ? s : sa, zero)) == 0xffff)
+        {
+            // all fully transparent - keep the destination
+        }
+        else
+        {
+            const __m128i d = _mm_loadu_si128((const __m128i*)(pd + x * 4));
+            const __m128i lo = blend2Pixels(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), premultiplied);
+            const __m128i hi = blend2Pixels(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), premultiplied);
+            _mm_storeu_si128((__m128i*)(pd + x * 4), _mm_packus_epi16(lo, hi));
+        }
+    }
+    return x;
+}
+#endif
+
+void pgl_sw_bitblit_blend(PGL_SW_Surface *dest, PGL_SW_Surface *source, PGLFormat format)
+{
+    if (PGL_REQUIRE(pgl_helper_isblendable(format)))
+    {
+        const uint8_t bpp = pgl_helper_getbpp(format);
+        const PGLBoolean premultiplied = pgl_helper_ispremultiplied(format);
+        checkPreconditions(dest, source, bpp);
+
+        pgl_sw_span_t span;
+        if (clipSpan(dest, bpp, source, bpp, &span))
+        {
+            for (int32_t y = 0; y < span.rows; ++y)
+            {
+                int32_t x = 0;
+#if defined(PGL_SW_SSE2)
+                x = blendPixelsSimd(span.pd, span.ps, span.columns, premultiplied);
+#endif
+                blendPixels(span.pd + x * 4, span.ps + x * 4, span.columns - x, premultiplied);
+                span.ps += source->alignment;
+                span.pd += dest->alignment;
+            }
+        }
+    }
+}
+
+// Returns PGL_TRUE if the PGL_SW_CHUNK bytes at pd and ps differ
+static PGLBoolean chunkDiffers(const uint8_t *pd, const uint8_t *ps)
+{
+#if defined(PGL_SW_SSE2)
+    const __m128i d = _mm_loadu_si128((const __m128i*)pd);
+    const __m128i s = _mm_loadu_si128((const __m128i*)ps);
+    return (_mm_movemask_epi8(_mm_cmpeq_epi8(d, s)) != 0xffff) ? PGL_TRUE : PGL_FALSE;
+#elif defined(PGL_SW_NEON)
+    const uint32x4_t x = vreinterpretq_u32_u8(veorq_u8(vld1q_u8(pd), vld1q_u8(ps)));
+    const uint32x2_t r = vorr_u32(vget_low_u32(x), vget_high_u32(x));
+    return ((vget_lane_u32(r, 0) | vget_lane_u32(r, 1)) != 0u) ? PGL_TRUE : PGL_FALSE;
+#else
+    return (memcmp(pd, ps, PGL_SW_CHUNK) != 0) ? PGL_TRUE : PGL_FALSE;
+#endif
+}
+
+// Returns PGL_TRUE if the bytes at pd and ps differ. bytes has to be a multiple of PGL_SW_CHUNK.
+static PGLBoolean blockDiffers(const uint8_t *pd, const uint8_t *ps, const int32_t bytes)
+{
+    PGLBoolean differs = PGL_FALSE;
+    for (int32_t i = 0; (i < bytes) && !differs; i += PGL_SW_CHUNK)
+    {
+        differs = chunkDiffers(pd + i, ps + i);
+    }
+    return differs;
+}
+
+// opaqueOnly: only pixels with a source alpha of 255 are taken into account (4 bpp formats)
+static uint32_t countPixelMismatches(const uint8_t *pd, const uint8_t *ps, const int32_t pixels, const uint8_t bpp, const PGLBoolean opaqueOnly)
+{
+    uint32_t failures = 0u;
+    for (int32_t x = 0; x < pixels; ++x)
+    {
+        if ((!opaqueOnly || (ps[PGL_SW_ALPHA_BYTE] == 255u)) && (memcmp(pd, ps, bpp) != 0))
+        {
+            ++failures;
+        }
+        pd += bpp;
+        ps += bpp;
+    }
+    return failures;
+}
+
+/**
+ * Compares the clipped area row by row. Whole chunks are compared with SIMD instructions (if available),
+ * only chunks which differ are inspected pixel by pixel to count the failures.
+ * Pixels of the requested area which are outside of one of the surfaces are failures.
+ * @param stopAtFirst if PGL_TRUE the function returns as soon as one failure is detected (returns 1 in that case)
+ * @param opaqueOnly if PGL_TRUE source pixels which are not fully opaque are skipped (their result depends on the blended background)
+ */
+static uint32_t compareSpans(const PGL_SW_Surface *dest, const PGL_SW_Surface *source, const PGLFormat format, const PGLBoolean stopAtFirst, const PGLBoolean opaqueOnly)
 {
     // check that format is supported
     const uint8_t bpp =pgl_helper_getbpp(format);
     checkPreconditions(dest, source, bpp);
 
-    PGL_SW_Pointer ps = source->p + source->y*source->alignment + source->x*bpp; // calculate start position of source memory pointer
-    PGL_SW_Pointer pd = dest->p + dest->y*dest->alignment + dest->x*bpp; // calculate start position of dest memory pointer
-    int32_t offsets = source->alignment - source->w*bpp; // calculate how many bytes need to be added to source when switching to the next column
-    int32_t offsetd = dest->alignment - source->w*bpp; // attention: width of destination is only for informational purpose. No scaling applied. Currently ignored
-    const PGL_SW_Pointer psBegin = source->p;
-    const PGL_SW_Pointer psEnd = psBegin + source->bytes;
-    const PGL_SW_Pointer pdBegin = dest->p;
-    const PGL_SW_Pointer pdEnd = pdBegin + dest->bytes;
-    uint32_t failures = 0;
-    for (int32_t y = 0; y < source->h; ++y)
+    const uint32_t requested = ((source->w > 0) && (source->h > 0)) ? (uint32_t)source->w * (uint32_t)source->h : 0u;
+    uint32_t failures = requested;
+    pgl_sw_span_t span;
+    if (clipSpan(dest, bpp, source, bpp, &span))
     {
-        for (int32_t x = 0; x < source->w; ++x)
+        const int32_t rowBytes = span.columns * bpp;
+        const int32_t blockBytes = PGL_SW_CHUNK * ((bpp == 3u) ? 3 : 1); // whole pixels only
+        failures = requested - (uint32_t)span.columns * (uint32_t)span.rows; // not accessible pixels can't be verified
+        for (int32_t y = 0; (y < span.rows) && ((failures == 0u) || !stopAtFirst); ++y)
         {
-            if ((ps >= psBegin) && (ps < psEnd) && (pd >= pdBegin) && (pd < pdEnd))
+            int32_t i = 0;
+            for (; ((i + blockBytes) <= rowBytes) && ((failures == 0u) || !stopAtFirst); i += blockBytes)
             {
-                switch (bpp)
+                if (blockDiffers(span.pd + i, span.ps + i, blockBytes))
                 {
-                    case 1u:
-                        if (*pd != *ps)
-                        {
-                            ++failures;
-                        }
-                        break;
-                    case 2u:
-                        if (*((uint16_t*)(pd)) != *((uint16_t*)(ps)))
-                        {
-                            ++failures;
-                        }
-                        break;
-                    case 4u:
-                        if (*((uint32_t*)(pd)) != *((uint32_t*)(ps)))
-                        {
-                            ++failures;
-                        }
-                        break;
+                    failures += countPixelMismatches(span.pd + i, span.ps + i, blockBytes / bpp, bpp, opaqueOnly);
                 }
             }
-            else
+            if ((failures == 0u) || !stopAtFirst)
             {
-                ++failures;
+                failures += countPixelMismatches(span.pd + i, span.ps + i, (rowBytes - i) / bpp, bpp, opaqueOnly);
             }
-            ps += bpp;
-            pd += bpp;
+            span.ps += source->alignment;
+            span.pd += dest->alignment;
         }
-        ps += offsets;
-        pd += offsetd;
     }
-    return failures;
+    return (stopAtFirst && (failures > 0u)) ? 1u : failures;
+}
+
+uint32_t pgl_sw_compare(const PGL_SW_Surface *dest, const PGL_SW_Surface *source, PGLFormat format)
+{
+    return compareSpans(dest, source, format, PGL_FALSE, PGL_FALSE);
+}
+
+PGLBoolean pgl_sw_equal(const PGL_SW_Surface *dest, const PGL_SW_Surface *source, PGLFormat format)
+{
+    return (compareSpans(dest, source, format, PGL_TRUE, PGL_FALSE) == 0u) ? PGL_TRUE : PGL_FALSE;
+}
+
+PGLBoolean pgl_sw_equal_opaque(const PGL_SW_Surface *dest, const PGL_SW_Surface *source, PGLFormat format)
+{
+    return PGL_REQUIRE(pgl_helper_isblendable(format))
+        && (compareSpans(dest, source, format, PGL_TRUE, PGL_TRUE) == 0u);
+}
+
+// CRC32C of a rect: rows * rowBytes bytes, consecutive rows start alignment bytes apart.
+// CRC32C is used because SSE4.2 and ARMv8 can calculate it in hardware.
+static uint32_t crcRect(const uint8_t *p, const int32_t alignment, const int32_t rowBytes, const int32_t rows)
+{
+    uint32_t crc = 0u;
+    if (rowBytes == alignment)
+    {
+        crc = calcCrc32cComplete(p, (uint32_t)(rowBytes * rows)); // the rows are contiguous
+    }
+    else
+    {
+        crc = 0xFFFFFFFFu;
+        for (int32_t y = 0; y < rows; ++y)
+        {
+            crc = updateCrc32c(crc, p, (uint32_t)rowBytes);
+            p += alignment;
+        }
+        crc = ~crc;
+    }
+    return crc;
+}
+
+uint32_t pgl_sw_crc32(const PGL_SW_Surface *surface, PGLFormat format)
+{
+    const uint8_t bpp = pgl_helper_getbpp(format);
+    checkSurface(surface, bpp, PGL_TRUE);
+    return crcRect(surface->p + surface->y * surface->alignment + surface->x * bpp, surface->alignment, surface->w * bpp, surface->h);
+}
+
+void pgl_sw_tile_crcs(const PGL_SW_Surface *source, PGLFormat format, int32_t tileSize, uint32_t *crcs)
+{
+    PGL_ASSERT(tileSize > 0);
+    PGL_ASSERT(crcs);
+    for (int32_t ty = 0; ty < source->h; ty += tileSize)
+    {
+        for (int32_t tx = 0; tx < source->w; tx += tileSize)
+        {
+            PGL_SW_Surface tile = *source;
+            tile.x = source->x + tx;
+            tile.y = source->y + ty;
+            tile.w = ((source->w - tx) < tileSize) ? (source->w - tx) : tileSize;
+            tile.h = ((source->h - ty) < tileSize) ? (source->h - ty) : tileSize;
+            *crcs++ = pgl_sw_crc32(&tile, format);
+        }
+    }
+}
+
+PGLBoolean pgl_sw_equal_crc(const PGL_SW_Surface *dest, PGLFormat format, int32_t tileSize, const uint32_t *crcs, int32_t stride)
+{
+    const uint8_t bpp = pgl_helper_getbpp(format);
+    checkSurface(dest, bpp, PGL_FALSE);
+    PGL_ASSERT(tileSize > 0);
+    PGL_ASSERT(crcs);
+
+    // pixels outside of the surface memory can't be verified
+    PGLBoolean equal = (bpp > 0u) && (dest->x >= 0) && (dest->y >= 0) && (dest->w > 0) && (dest->h > 0)
+        && ((dest->x + dest->w) * bpp <= dest->alignment)
+        && ((dest->y + dest->h - 1) * dest->alignment + (dest->x + dest->w) * bpp <= dest->bytes);
+    for (int32_t ty = 0; (ty < dest->h) && equal; ty += tileSize)
+    {
+        const uint32_t *crc = crcs;
+        for (int32_t tx = 0; (tx < dest->w) && equal; tx += tileSize)
+        {
+            const int32_t w = ((dest->w - tx) < tileSize) ? (dest->w - tx) : tileSize;
+            const int32_t h = ((dest->h - ty) < tileSize) ? (dest->h - ty) : tileSize;
+            equal = (crcRect(dest->p + (dest->y + ty) * dest->alignment + (dest->x + tx) * bpp, dest->alignment, w * bpp, h) == *crc++) ? PGL_TRUE : PGL_FALSE;
+        }
+        crcs += stride;
+    }
+    return equal;
+}
+
+// Conversions go through BGRA_8888 (bytes in memory: B, G, R, A) as intermediate format.
+// The intermediate pixels are kept in stack buffers of this size.
+#define PGL_SW_CONVERT_PIXELS 64
+
+// Position of the channels inside a pixel: byte offsets for 24 and 32 bit formats, bit offsets of the 5 bit channels for 16 bit formats.
+// A negative alpha position means the format has no alpha channel (opaque).
+typedef struct
+{
+    uint8_t bpp;
+    int8_t b;
+    int8_t g;
+    int8_t r;
+    int8_t a;
+} pgl_sw_layout_t;
+
+static const pgl_sw_layout_t gsLayoutRgb565 = { 2u, 0, 5, 11, -1 };
+static const pgl_sw_layout_t gsLayoutBgr565 = { 2u, 11, 5, 0, -1 };
+static const pgl_sw_layout_t gsLayoutRgb888 = { 3u, 2, 1, 0, -1 };
+static const pgl_sw_layout_t gsLayoutBgr888 = { 3u, 0, 1, 2, -1 };
+static const pgl_sw_layout_t gsLayoutArgb8888 = { 4u, 3, 2, 1, 0 };
+static const pgl_sw_layout_t gsLayoutBgra8888 = { 4u, 0, 1, 2, 3 };
+static const pgl_sw_layout_t gsLayoutRgba8888 = { 4u, 2, 1, 0, 3 };
+
+// Returns NULL if the format can't be converted
+static const pgl_sw_layout_t * getLayout(const PGLFormat format)
+{
+    const pgl_sw_layout_t * layout = NULL;
+    switch (format)
+    {
+    case PGL_FORMAT_RGB_565:
+        layout = &gsLayoutRgb565;
+        break;
+    case PGL_FORMAT_BGR_565:
+        layout = &gsLayoutBgr565;
+        break;
+    case PGL_FORMAT_RGB_888:
+        layout = &gsLayoutRgb888;
+        break;
+    case PGL_FORMAT_BGR_888:
+        layout = &gsLayoutBgr888;
+        break;
+    case PGL_FORMAT_ARGB_8888:
+        layout = &gsLayoutArgb8888;
+        break;
+    case PGL_FORMAT_BGRA_8888:
+    case PGL_FORMAT_BGRA_8888_PRE:
+        layout = &gsLayoutBgra8888;
+        break;
+    case PGL_FORMAT_RGBA_8888:
+    case PGL_FORMAT_RGBA_8888_PRE:
+        layout = &gsLayoutRgba8888;
+        break;
+    default:
+        break;
+    }
+    return layout;
+}
+
+PGLBoolean pgl_helper_isconvertible(PGLFormat format)
+{
+    return (getLayout(format) != NULL) ? PGL_TRUE : PGL_FALSE;
+}
+
+// BGRA is the intermediate format - no conversion needed
+static PGLBoolean isIntermediate(const PGLFormat format)
+{
+    return ((format == PGL_FORMAT_BGRA_8888) || (format == PGL_FORMAT_BGRA_8888_PRE)) ? PGL_TRUE : PGL_FALSE;
+}
+
+#if defined(PGL_SW_SSE2)
+// RGB_565 -> BGRA_8888 in groups of 8 pixels, returns the number of processed pixels
+static int32_t decodeRgb565Simd(uint8_t *pc, const uint8_t *ps, const int32_t pixels)
+{
+    const __m128i mask5 = _mm_set1_epi16(0x1f);
+    const __m128i mask6 = _mm_set1_epi16(0x3f);
+    const __m128i alpha = _mm_set1_epi16((short)0xff00);
+    int32_t x = 0;
+    for (; (x + 8) <= pixels; x += 8)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(ps + x * 2));
+        const __m128i r5 = _mm_srli_epi16(v, 11);
+        const __m128i g6 = _mm_and_si128(_mm_srli_epi16(v, 5), mask6);
+        const __m128i b5 = _mm_and_si128(v, mask5);
+        const __m128i r = _mm_or_si128(_mm_slli_epi16(r5, 3), _mm_srli_epi16(r5, 2));
+        const __m128i g = _mm_or_si128(_mm_slli_epi16(g6, 2), _mm_srli_epi16(g6, 4));
+        const __m128i b = _mm_or_si128(_mm_slli_epi16(b5, 3), _mm_srli_epi16(b5, 2));
+        const __m128i bg = _mm_or_si128(b, _mm_slli_epi16(g, 8));
+        const __m128i ra = _mm_or_si128(r, alpha);
+        _mm_storeu_si128((__m128i*)(pc + x * 4), _mm_unpacklo_epi16(bg, ra));
+        _mm_storeu_si128((__m128i*)(pc + x * 4 + 16), _mm_unpackhi_epi16(bg, ra));
+    }
+    return x;
+}
+
+static __m128i encodeRgb565Lanes(const __m128i p)
+{
+    const __m128i r = _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0xf800));
+    const __m128i g = _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07e0));
+    const __m128i b = _mm_and_si128(_mm_srli_epi32(p, 3), _mm_set1_epi32(0x001f));
+    // sign extend the lower 16 bits - _mm_packs_epi32 saturates, the values are kept that way
+    return _mm_srai_epi32(_mm_slli_epi32(_mm_or_si128(_mm_or_si128(r, g), b), 16), 16);
+}
+
+// BGRA_8888 -> RGB_565 in groups of 8 pixels, returns the number of processed pixels
+static int32_t encodeRgb565Simd(uint8_t *pd, const uint8_t *pc, const int32_t pixels)
+{
+    int32_t x = 0;
+    for (; (x + 8) <= pixels; x += 8)
+    {
+        const __m128i lo = encodeRgb565Lanes(_mm_loadu_si128((const __m128i*)(pc + x * 4)));
+        const __m128i hi = encodeRgb565Lanes(_mm_loadu_si128((const __m128i*)(pc + x * 4 + 16)));
+        _mm_storeu_si128((__m128i*)(pd + x * 2), _mm_packs_epi32(lo, hi));
+    }
+    return x;
+}
+#endif
+
+// Converts pixels of the given format to the intermediate format (pc)
+static void decodePixels(uint8_t *pc, const uint8_t *ps, const int32_t pixels, const PGLFormat format, const pgl_sw_layout_t *layout)
+{
+    int32_t x = 0;
+    if (isIntermediate(format))
+    {
+        memcpy(pc, ps, (size_t)pixels * 4u);
+    }
+    else if (layout->bpp == 2u)
+    {
+#if defined(PGL_SW_SSE2)
+        if (format == PGL_FORMAT_RGB_565)
+        {
+            x = decodeRgb565Simd(pc, ps, pixels);
+        }
+#endif
+        for (; x < pixels; ++x)
+        {
+            uint16_t v;
+            memcpy(&v, ps + x * 2, 2u);
+            const uint32_t r = (v >> layout->r) & 0x1fu;
+            const uint32_t g = (v >> layout->g) & 0x3fu;
+            const uint32_t b = (v >> layout->b) & 0x1fu;
+            pc[x * 4 + 0] = (uint8_t)((b << 3) | (b >> 2));
+            pc[x * 4 + 1] = (uint8_t)((g << 2) | (g >> 4));
+            pc[x * 4 + 2] = (uint8_t)((r << 3) | (r >> 2));
+            pc[x * 4 + 3] = 255u;
+        }
+    }
+    else
+    {
+        for (; x < pixels; ++x)
+        {
+            const uint8_t *p = ps + x * layout->bpp;
+            pc[x * 4 + 0] = p[layout->b];
+            pc[x * 4 + 1] = p[layout->g];
+            pc[x * 4 + 2] = p[layout->r];
+            pc[x * 4 + 3] = (layout->a >= 0) ? p[layout->a] : 255u;
+        }
+    }
+}
+
+// Converts pixels of the intermediate format (pc) to the given format. Channels are truncated to the target precision.
+static void encodePixels(uint8_t *pd, const uint8_t *pc, const int32_t pixels, const PGLFormat format, const pgl_sw_layout_t *layout)
+{
+    int32_t x = 0;
+    if (isIntermediate(format))
+    {
+        memcpy(pd, pc, (size_t)pixels * 4u);
+    }
+    else if (layout->bpp == 2u)
+    {
+#if defined(PGL_SW_SSE2)
+        if (format == PGL_FORMAT_RGB_565)
+        {
+            x = encodeRgb565Simd(pd, pc, pixels);
+        }
+#endif
+        for (; x < pixels; ++x)
+        {
+            const uint32_t b = (uint32_t)(pc[x * 4 + 0] >> 3) << layout->b;
+            const uint32_t g = (uint32_t)(pc[x * 4 + 1] >> 2) << layout->g;
+            const uint32_t r = (uint32_t)(pc[x * 4 + 2] >> 3) << layout->r;
+            const uint16_t v = (uint16_t)(r | g | b);
+            memcpy(pd + x * 2, &v, 2u);
+        }
+    }
+    else
+    {
+        for (; x < pixels; ++x)
+        {
+            uint8_t *p = pd + x * layout->bpp;
+            p[layout->b] = pc[x * 4 + 0];
+            p[layout->g] = pc[x * 4 + 1];
+            p[layout->r] = pc[x * 4 + 2];
+            if (layout->a >= 0)
+            {
+                p[layout->a] = pc[x * 4 + 3];
+            }
+        }
+    }
+}
+
+static void blendRow(uint8_t *pd, const uint8_t *ps, const int32_t pixels, const PGLBoolean premultiplied)
+{
+    int32_t x = 0;
+#if defined(PGL_SW_SSE2)
+    x = blendPixelsSimd(pd, ps, pixels, premultiplied);
+#endif
+    blendPixels(pd + x * 4, ps + x * 4, pixels - x, premultiplied);
+}
+
+// Writes pixels given in the intermediate format (BGRA_8888) to the destination. dc is scratch memory for the destination pixels.
+static void writePixels(uint8_t *pd, const uint8_t *sc, uint8_t *dc, const int32_t pixels, const PGLFormat destFormat, const pgl_sw_layout_t *dl, const PGLBoolean blend, const PGLBoolean premultiplied)
+{
+    if (!blend)
+    {
+        encodePixels(pd, sc, pixels, destFormat, dl);
+    }
+    else if (isIntermediate(destFormat))
+    {
+        blendRow(pd, sc, pixels, premultiplied);
+    }
+    else
+    {
+        decodePixels(dc, pd, pixels, destFormat, dl);
+        blendRow(dc, sc, pixels, premultiplied);
+        encodePixels(pd, dc, pixels, destFormat, dl);
+    }
+}
+
+// Checks if the destination contains the pixels given in the intermediate format. expected is scratch memory for the encoded pixels.
+static PGLBoolean matchPixels(const uint8_t *pd, const uint8_t *sc, uint8_t *expected, const int32_t pixels, const PGLFormat destFormat, const pgl_sw_layout_t *dl, const PGLBoolean opaqueOnly)
+{
+    PGLBoolean equal = PGL_TRUE;
+    encodePixels(expected, sc, pixels, destFormat, dl);
+    if (memcmp(pd, expected, (size_t)pixels * dl->bpp) != 0)
+    {
+        // only an opaque pixel which differs is a failure
+        for (int32_t i = 0; (i < pixels) && equal; ++i)
+        {
+            equal = ((opaqueOnly && (sc[i * 4 + PGL_SW_ALPHA_BYTE] != 255u))
+                || (memcmp(pd + i * dl->bpp, expected + i * dl->bpp, dl->bpp) == 0)) ? PGL_TRUE : PGL_FALSE;
+        }
+    }
+    return equal;
+}
+
+void pgl_sw_bitblit_convert(PGL_SW_Surface *dest, PGLFormat destFormat, PGL_SW_Surface *source, PGLFormat sourceFormat, PGLBoolean blend)
+{
+    const pgl_sw_layout_t *dl = getLayout(destFormat);
+    const pgl_sw_layout_t *sl = getLayout(sourceFormat);
+    if (PGL_REQUIRE(dl) && PGL_REQUIRE(sl))
+    {
+        const PGLBoolean premultiplied = pgl_helper_ispremultiplied(sourceFormat);
+        checkSurface(dest, dl->bpp, PGL_FALSE);
+        checkSurface(source, sl->bpp, PGL_TRUE);
+
+        pgl_sw_span_t span;
+        if (clipSpan(dest, dl->bpp, source, sl->bpp, &span))
+        {
+            uint8_t sc[PGL_SW_CONVERT_PIXELS * 4];
+            uint8_t dc[PGL_SW_CONVERT_PIXELS * 4];
+            for (int32_t y = 0; y < span.rows; ++y)
+            {
+                for (int32_t x = 0; x < span.columns; x += PGL_SW_CONVERT_PIXELS)
+                {
+                    const int32_t n = ((span.columns - x) < PGL_SW_CONVERT_PIXELS) ? (span.columns - x) : PGL_SW_CONVERT_PIXELS;
+                    decodePixels(sc, span.ps + x * sl->bpp, n, sourceFormat, sl);
+                    writePixels(span.pd + x * dl->bpp, sc, dc, n, destFormat, dl, blend, premultiplied);
+                }
+                span.ps += source->alignment;
+                span.pd += dest->alignment;
+            }
+        }
+    }
+}
+
+PGLBoolean pgl_sw_equal_convert(const PGL_SW_Surface *dest, PGLFormat destFormat, const PGL_SW_Surface *source, PGLFormat sourceFormat, PGLBoolean opaqueOnly)
+{
+    PGLBoolean equal = PGL_FALSE;
+    const pgl_sw_layout_t *dl = getLayout(destFormat);
+    const pgl_sw_layout_t *sl = getLayout(sourceFormat);
+    if (PGL_REQUIRE(dl) && PGL_REQUIRE(sl))
+    {
+        checkSurface(dest, dl->bpp, PGL_FALSE);
+        checkSurface(source, sl->bpp, PGL_TRUE);
+
+        pgl_sw_span_t span;
+        // pixels of the requested area which are outside of one of the surfaces can't be verified
+        if (clipSpan(dest, dl->bpp, source, sl->bpp, &span) && (span.columns == source->w) && (span.rows == source->h))
+        {
+            uint8_t sc[PGL_SW_CONVERT_PIXELS * 4];
+            uint8_t expected[PGL_SW_CONVERT_PIXELS * 4];
+            equal = PGL_TRUE;
+            for (int32_t y = 0; (y < span.rows) && equal; ++y)
+            {
+                for (int32_t x = 0; (x < span.columns) && equal; x += PGL_SW_CONVERT_PIXELS)
+                {
+                    const int32_t n = ((span.columns - x) < PGL_SW_CONVERT_PIXELS) ? (span.columns - x) : PGL_SW_CONVERT_PIXELS;
+                    decodePixels(sc, span.ps + x * sl->bpp, n, sourceFormat, sl);
+                    equal = matchPixels(span.pd + x * dl->bpp, sc, expected, n, destFormat, dl, opaqueOnly);
+                }
+                span.ps += source->alignment;
+                span.pd += dest->alignment;
+            }
+        }
+    }
+    return equal;
+}
+
+// Parameters of an RLE blit or comparison, which are the same for all packets
+typedef struct
+{
+    const pgl_sw_layout_t *dl;
+    const pgl_sw_layout_t *sl;
+    PGLFormat destFormat;
+    PGLFormat sourceFormat;
+    PGLBoolean swapped; // PGL_ENCODING_RLE2
+    PGLBoolean blend; // blend (draw) or check only the opaque pixels (verify)
+    PGLBoolean premultiplied;
+    PGLBoolean verify;
+} pgl_sw_rle_t;
+
+// Converts up to PGL_SW_CONVERT_PIXELS encoded pixels to the intermediate format (sc). raw is scratch memory for swapped pixels.
+static void decodeRlePixels(const pgl_sw_rle_t *rle, uint8_t *sc, uint8_t *raw, const uint8_t *ps, const int32_t pixels)
+{
+    if (rle->swapped)
+    {
+        pgl_swap_pixels(raw, ps, (uint32_t)pixels, rle->sl->bpp);
+        ps = raw;
+    }
+    decodePixels(sc, ps, pixels, rle->sourceFormat, rle->sl);
+}
+
+// Draws (or compares) the pixels [offset, offset + pixels) of the packet at pd
+static PGLBoolean processRlePacket(const pgl_sw_rle_t *rle, uint8_t *pd, const uint8_t *packet, const int32_t offset, const int32_t pixels)
+{
+    uint8_t raw[PGL_SW_CONVERT_PIXELS * 4];
+    uint8_t sc[PGL_SW_CONVERT_PIXELS * 4];
+    uint8_t dc[PGL_SW_CONVERT_PIXELS * 4];
+    const uint8_t bpp = rle->dl->bpp;
+    PGLBoolean equal = PGL_TRUE;
+    if ((packet[0] & PGL_RLE_RUN) != 0u)
+    {
+        // a run is converted once: transparent runs don't change a blended destination, translucent ones aren't verified
+        decodeRlePixels(rle, sc, raw, packet + 1, 1);
+        const uint8_t alpha = sc[PGL_SW_ALPHA_BYTE];
+        const PGLBoolean skip = rle->blend && ((alpha == 0u) || (rle->verify && (alpha != 255u)));
+        const PGLBoolean translucent = rle->blend && (alpha != 255u);
+        const int32_t n = (pixels < PGL_SW_CONVERT_PIXELS) ? pixels : PGL_SW_CONVERT_PIXELS;
+        for (int32_t i = 1; (i < n) && !skip; ++i)
+        {
+            memcpy(sc + i * 4, sc, 4u);
+        }
+        if (!skip && (rle->verify || !translucent))
+        {
+            // written like a fill: the run is encoded once, afterwards whole chunks are copied or compared
+            encodePixels(dc, sc, n, rle->destFormat, rle->dl);
+        }
+        for (int32_t x = 0; (x < pixels) && !skip && equal; x += n)
+        {
+            const int32_t m = ((pixels - x) < n) ? (pixels - x) : n;
+            if (rle->verify)
+            {
+                equal = (memcmp(pd + x * bpp, dc, (size_t)m * bpp) == 0) ? PGL_TRUE : PGL_FALSE;
+            }
+            else if (translucent)
+            {
+                writePixels(pd + x * bpp, sc, dc, m, rle->destFormat, rle->dl, PGL_TRUE, rle->premultiplied);
+            }
+            else
+            {
+                memcpy(pd + x * bpp, dc, (size_t)m * bpp);
+            }
+        }
+    }
+    else
+    {
+        // the literal pixels are converted directly from the encoded data
+        const uint8_t *ps = packet + 1 + offset * rle->sl->bpp;
+        for (int32_t x = 0; (x < pixels) && equal; x += PGL_SW_CONVERT_PIXELS)
+        {
+            const int32_t m = ((pixels - x) < PGL_SW_CONVERT_PIXELS) ? (pixels - x) : PGL_SW_CONVERT_PIXELS;
+            decodeRlePixels(rle, sc, raw, ps + x * rle->sl->bpp, m);
+            if (rle->verify)
+            {
+                equal = matchPixels(pd + x * bpp, sc, dc, m, rle->destFormat, rle->dl, rle->blend);
+            }
+            else
+            {
+                writePixels(pd + x * bpp, sc, dc, m, rle->destFormat, rle->dl, rle->blend, rle->premultiplied);
+            }
+        }
+    }
+    return equal;
+}
+
+// Walks the packets of all rows up to the last row of the source rect and processes the parts which are inside of it.
+// Returns PGL_FALSE if the data ends before the rect or a compared pixel differs.
+static PGLBoolean processRle(const pgl_sw_rle_t *rle, const PGL_SW_Surface *dest, const PGL_SW_Surface *source)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if ((dest->alignment > 0) && (source->alignment > 0))
+    {
+        int32_t dx = dest->x;
+        int32_t dy = dest->y;
+        int32_t sx = source->x;
+        int32_t sy = source->y;
+        int32_t w = source->w;
+        int32_t h = source->h;
+        const int32_t width = source->alignment / rle->sl->bpp;
+        clipAxis(&dx, &sx, &w, dest->alignment / rle->dl->bpp, width);
+        clipAxis(&dy, &sy, &h, dest->bytes / dest->alignment, INT32_MAX); // the number of rows is limited by the data
+        // pixels of the requested area which are outside of the destination can't be verified
+        if ((w > 0) && (h > 0) && (!rle->verify || ((w == source->w) && (h == source->h))))
+        {
+            const uint8_t *p = source->p;
+            const uint8_t *end = p + source->bytes;
+            uint8_t *pd = dest->p + dy * dest->alignment;
+            ret = PGL_TRUE;
+            for (int32_t row = 0; (row < (sy + h)) && ret; ++row)
+            {
+                const PGLBoolean visible = (row >= sy) ? PGL_TRUE : PGL_FALSE;
+                int32_t x = 0;
+                while ((x < width) && ret)
+                {
+                    uint32_t size = 0u;
+                    const int32_t n = (int32_t)pgl_rle_packet(p, end, rle->sl->bpp, &size);
+                    const int32_t first = (x > sx) ? x : sx;
+                    const int32_t last = ((x + n) < (sx + w)) ? (x + n) : (sx + w);
+                    ret = ((n > 0) && (n <= (width - x))) ? PGL_TRUE : PGL_FALSE;
+                    if (ret && visible && (first < last))
+                    {
+                        ret = processRlePacket(rle, pd + (dx + first - sx) * rle->dl->bpp, p, first - x, last - first);
+                    }
+                    p += size;
+                    x += n;
+                }
+                if (visible)
+                {
+                    pd += dest->alignment;
+                }
+            }
+        }
+    }
+    return ret;
+}
+
+static PGLBoolean initRle(pgl_sw_rle_t *rle, const PGL_SW_Surface *dest, const PGLFormat destFormat, const PGLFormat sourceFormat, const PGLBoolean swapped, const PGLBoolean blend, const PGLBoolean verify)
+{
+    rle->dl = getLayout(destFormat);
+    rle->sl = getLayout(sourceFormat);
+    rle->destFormat = destFormat;
+    rle->sourceFormat = sourceFormat;
+    rle->swapped = swapped;
+    rle->blend = blend;
+    rle->premultiplied = pgl_helper_ispremultiplied(sourceFormat);
+    rle->verify = verify;
+    const PGLBoolean ret = PGL_REQUIRE(rle->dl) && PGL_REQUIRE(rle->sl);
+    if (ret)
+    {
+        checkSurface(dest, rle->dl->bpp, PGL_FALSE);
+    }
+    return ret;
+}
+
+void pgl_sw_bitblit_rle(PGL_SW_Surface *dest, PGLFormat destFormat, const PGL_SW_Surface *source, PGLFormat sourceFormat, PGLBoolean swapped, PGLBoolean blend)
+{
+    pgl_sw_rle_t rle;
+    if (initRle(&rle, dest, destFormat, sourceFormat, swapped, blend, PGL_FALSE))
+    {
+        (void)processRle(&rle, dest, source);
+    }
+}
+
+PGLBoolean pgl_sw_equal_rle(const PGL_SW_Surface *dest, PGLFormat destFormat, const PGL_SW_Surface *source, PGLFormat sourceFormat, PGLBoolean swapped, PGLBoolean opaqueOnly)
+{
+    pgl_sw_rle_t rle;
+    return initRle(&rle, dest, destFormat, sourceFormat, swapped, opaqueOnly, PGL_TRUE) ? processRle(&rle, dest, source) : PGL_FALSE;
+}
+
+// Color format of the palette of an indexed format, PGL_FORMAT_INVALID for other formats
+static PGLFormat getPaletteFormat(const PGLFormat format)
+{
+    PGLFormat colorFormat = PGL_FORMAT_INVALID;
+    switch (format)
+    {
+    case PGL_FORMAT_P_8_ARGB_8888:
+        colorFormat = PGL_FORMAT_ARGB_8888;
+        break;
+    case PGL_FORMAT_P_8_BGRA_8888:
+        colorFormat = PGL_FORMAT_BGRA_8888;
+        break;
+    case PGL_FORMAT_P_8_RGBA_8888:
+        colorFormat = PGL_FORMAT_RGBA_8888;
+        break;
+    case PGL_FORMAT_P_8_RGB_888:
+        colorFormat = PGL_FORMAT_RGB_888;
+        break;
+    case PGL_FORMAT_P_8_RGB_565:
+        colorFormat = PGL_FORMAT_RGB_565;
+        break;
+    default:
+        break;
+    }
+    return colorFormat;
+}
+
+PGLBoolean pgl_helper_ispalette(PGLFormat format)
+{
+    return (getPaletteFormat(format) != PGL_FORMAT_INVALID) ? PGL_TRUE : PGL_FALSE;
+}
+
+PGLBoolean pgl_sw_palette_init(PGL_SW_Palette *palette, PGLFormat format, const void *colors, uint32_t count)
+{
+    const PGLFormat colorFormat = getPaletteFormat(format);
+    PGLBoolean ret = PGL_FALSE;
+    memset(palette, 0, sizeof(*palette));
+    if (PGL_REQUIRE(colorFormat != PGL_FORMAT_INVALID) && PGL_REQUIRE(colors) && PGL_REQUIRE(count <= PGL_SW_PALETTE_COLORS))
+    {
+        decodePixels(palette->colors, (const uint8_t *)colors, (int32_t)count, colorFormat, getLayout(colorFormat));
+        palette->count = count;
+        palette->opaque = PGL_TRUE;
+        for (uint32_t i = 0u; i < count; ++i)
+        {
+            if (palette->colors[i * 4u + PGL_SW_ALPHA_BYTE] != 255u)
+            {
+                palette->opaque = PGL_FALSE;
+            }
+        }
+        ret = PGL_TRUE;
+    }
+    return ret;
+}
+
+// Lookup table of a palette blit: the colors in one format, bpp bytes each (all PGL_SW_PALETTE_COLORS entries are valid)
+typedef struct
+{
+    uint8_t colors[PGL_SW_PALETTE_COLORS * 4];
+    uint8_t bpp;
+    PGLBoolean small; // at most 16 colors, all other entries are 0
+#if defined(PGL_SW_SSSE3)
+    __m128i planes[4]; // byte i of the first 16 colors
+#elif defined(PGL_SW_NEON) && defined(__aarch64__)
+    uint8x16_t planes[4];
+#endif
+} pgl_sw_lookup_t;
+
+// Builds the lookup table of the palette colors in the given format, NULL: the intermediate format
+static void initLookup(pgl_sw_lookup_t *lookup, const PGL_SW_Palette *palette, const PGLFormat format, const pgl_sw_layout_t *layout)
+{
+    lookup->bpp = (layout != NULL) ? layout->bpp : 4u;
+    lookup->small = (palette->count <= 16u) ? PGL_TRUE : PGL_FALSE;
+    // the colors without an index are transparent black, which is 0 in all formats
+    memset(lookup->colors, 0, sizeof(lookup->colors));
+    if (layout != NULL)
+    {
+        encodePixels(lookup->colors, palette->colors, (int32_t)palette->count, format, layout);
+    }
+    else
+    {
+        memcpy(lookup->colors, palette->colors, palette->count * 4u);
+    }
+#if defined(PGL_SW_SSSE3) || (defined(PGL_SW_NEON) && defined(__aarch64__))
+    for (uint8_t b = 0u; b < lookup->bpp; ++b)
+    {
+        uint8_t plane[16];
+        for (uint32_t i = 0u; i < 16u; ++i)
+        {
+            plane[i] = lookup->colors[i * lookup->bpp + b];
+        }
+#if defined(PGL_SW_SSSE3)
+        lookup->planes[b] = _mm_loadu_si128((const __m128i*)plane);
+#else
+        lookup->planes[b] = vld1q_u8(plane);
+#endif
+    }
+#endif
+}
+
+#if defined(PGL_SW_SSSE3)
+// Looks up 16 indices at once in a table of up to 16 colors (2 or 4 bpp): one byte shuffle per byte of the color.
+// Returns the number of processed pixels.
+static int32_t lookupPixelsSimd(uint8_t *pd, const uint8_t *ps, const int32_t pixels, const pgl_sw_lookup_t *lookup)
+{
+    const __m128i high = _mm_set1_epi8((char)0xf0);
+    const __m128i zero = _mm_setzero_si128();
+    int32_t x = 0;
+    for (; (x + 16) <= pixels; x += 16)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(ps + x));
+        // indices >= 16 get the upper bit, the shuffle returns 0 for them (the table value)
+        const __m128i i = _mm_or_si128(v, _mm_andnot_si128(_mm_cmpeq_epi8(_mm_and_si128(v, high), zero), _mm_set1_epi8((char)0x80)));
+        const __m128i b0 = _mm_shuffle_epi8(lookup->planes[0], i);
+        const __m128i b1 = _mm_shuffle_epi8(lookup->planes[1], i);
+        if (lookup->bpp == 2u)
+        {
+            _mm_storeu_si128((__m128i*)(pd + x * 2), _mm_unpacklo_epi8(b0, b1));
+            _mm_storeu_si128((__m128i*)(pd + x * 2 + 16), _mm_unpackhi_epi8(b0, b1));
+        }
+        else
+        {
+            const __m128i lo01 = _mm_unpacklo_epi8(b0, b1);
+            const __m128i hi01 = _mm_unpackhi_epi8(b0, b1);
+            const __m128i b2 = _mm_shuffle_epi8(lookup->planes[2], i);
+            const __m128i b3 = _mm_shuffle_epi8(lookup->planes[3], i);
+            const __m128i lo23 = _mm_unpacklo_epi8(b2, b3);
+            const __m128i hi23 = _mm_unpackhi_epi8(b2, b3);
+            _mm_storeu_si128((__m128i*)(pd + x * 4), _mm_unpacklo_epi16(lo01, lo23));
+            _mm_storeu_si128((__m128i*)(pd + x * 4 + 16), _mm_unpackhi_epi16(lo01, lo23));
+            _mm_storeu_si128((__m128i*)(pd + x * 4 + 32), _mm_unpacklo_epi16(hi01, hi23));
+            _mm_storeu_si128((__m128i*)(pd + x * 4 + 48), _mm_unpackhi_epi16(hi01, hi23));
+        }
+    }
+    return x;
+}
+#elif defined(PGL_SW_NEON) && defined(__aarch64__)
+// Looks up 16 indices at once in a table of up to 16 colors (2 or 4 bpp), the table lookup returns 0 for indices >= 16.
+// Returns the number of processed pixels.
+static int32_t lookupPixelsSimd(uint8_t *pd, const uint8_t *ps, const int32_t pixels, const pgl_sw_lookup_t *lookup)
+{
+    int32_t x = 0;
+    for (; (x + 16) <= pixels; x += 16)
+    {
+        const uint8x16_t i = vld1q_u8(ps + x);
+        if (lookup->bpp == 2u)
+        {
+            uint8x16x2_t v;
+            v.val[0] = vqtbl1q_u8(lookup->planes[0], i);
+            v.val[1] = vqtbl1q_u8(lookup->planes[1], i);
+            vst2q_u8(pd + x * 2, v);
+        }
+        else
+        {
+            uint8x16x4_t v;
+            v.val[0] = vqtbl1q_u8(lookup->planes[0], i);
+            v.val[1] = vqtbl1q_u8(lookup->planes[1], i);
+            v.val[2] = vqtbl1q_u8(lookup->planes[2], i);
+            v.val[3] = vqtbl1q_u8(lookup->planes[3], i);
+            vst4q_u8(pd + x * 4, v);
+        }
+    }
+    return x;
+}
+#endif
+
+// Replaces the palette indices by the colors of the lookup table
+static void lookupPixels(uint8_t *pd, const uint8_t *ps, const int32_t pixels, const pgl_sw_lookup_t *lookup)
+{
+    int32_t x = 0;
+#if defined(PGL_SW_SSSE3) || (defined(PGL_SW_NEON) && defined(__aarch64__))
+    if (lookup->small && (lookup->bpp != 3u))
+    {
+        x = lookupPixelsSimd(pd, ps, pixels, lookup);
+    }
+#endif
+    // the fixed size copies are compiled to single loads and stores
+    if (lookup->bpp == 4u)
+    {
+        for (; x < pixels; ++x)
+        {
+            memcpy(pd + x * 4, lookup->colors + ps[x] * 4u, 4u);
+        }
+    }
+    else if (lookup->bpp == 2u)
+    {
+        for (; x < pixels; ++x)
+        {
+            memcpy(pd + x * 2, lookup->colors + ps[x] * 2u, 2u);
+        }
+    }
+    else
+    {
+        for (; x < pixels; ++x)
+        {
+            memcpy(pd + x * 3, lookup->colors + ps[x] * 3u, 3u);
+        }
+    }
+}
+
+void pgl_sw_bitblit_palette(PGL_SW_Surface *dest, PGLFormat destFormat, PGL_SW_Surface *source, const PGL_SW_Palette *palette, PGLBoolean blend)
+{
+    const pgl_sw_layout_t *dl = getLayout(destFormat);
+    if (PGL_REQUIRE(dl) && PGL_REQUIRE(palette))
+    {
+        checkSurface(dest, dl->bpp, PGL_FALSE);
+        checkSurface(source, 1u, PGL_TRUE);
+
+        pgl_sw_span_t span;
+        if (clipSpan(dest, dl->bpp, source, 1u, &span))
+        {
+            pgl_sw_lookup_t lookup;
+            if (!blend)
+            {
+                // the colors are converted once, the rows are written by the lookup
+                initLookup(&lookup, palette, destFormat, dl);
+                for (int32_t y = 0; y < span.rows; ++y)
+                {
+                    lookupPixels(span.pd, span.ps, span.columns, &lookup);
+                    span.ps += source->alignment;
+                    span.pd += dest->alignment;
+                }
+            }
+            else
+            {
+                uint8_t sc[PGL_SW_CONVERT_PIXELS * 4];
+                uint8_t dc[PGL_SW_CONVERT_PIXELS * 4];
+                initLookup(&lookup, palette, PGL_FORMAT_BGRA_8888, NULL);
+                for (int32_t y = 0; y < span.rows; ++y)
+                {
+                    for (int32_t x = 0; x < span.columns; x += PGL_SW_CONVERT_PIXELS)
+                    {
+                        const int32_t n = ((span.columns - x) < PGL_SW_CONVERT_PIXELS) ? (span.columns - x) : PGL_SW_CONVERT_PIXELS;
+                        lookupPixels(sc, span.ps + x, n, &lookup);
+                        writePixels(span.pd + x * dl->bpp, sc, dc, n, destFormat, dl, PGL_TRUE, PGL_FALSE);
+                    }
+                    span.ps += source->alignment;
+                    span.pd += dest->alignment;
+                }
+            }
+        }
+    }
+}
+
+PGLBoolean pgl_sw_equal_palette(const PGL_SW_Surface *dest, PGLFormat destFormat, const PGL_SW_Surface *source, const PGL_SW_Palette *palette, PGLBoolean opaqueOnly)
+{
+    PGLBoolean equal = PGL_FALSE;
+    const pgl_sw_layout_t *dl = getLayout(destFormat);
+    if (PGL_REQUIRE(dl) && PGL_REQUIRE(palette))
+    {
+        checkSurface(dest, dl->bpp, PGL_FALSE);
+        checkSurface(source, 1u, PGL_TRUE);
+
+        pgl_sw_span_t span;
+        // pixels of the requested area which are outside of one of the surfaces can't be verified
+        if (clipSpan(dest, dl->bpp, source, 1u, &span) && (span.columns == source->w) && (span.rows == source->h))
+        {
+            pgl_sw_lookup_t lookup;
+            uint8_t sc[PGL_SW_CONVERT_PIXELS * 4];
+            uint8_t expected[PGL_SW_CONVERT_PIXELS * 4];
+            initLookup(&lookup, palette, PGL_FORMAT_BGRA_8888, NULL);
+            equal = PGL_TRUE;
+            for (int32_t y = 0; (y < span.rows) && equal; ++y)
+            {
+                for (int32_t x = 0; (x < span.columns) && equal; x += PGL_SW_CONVERT_PIXELS)
+                {
+                    const int32_t n = ((span.columns - x) < PGL_SW_CONVERT_PIXELS) ? (span.columns - x) : PGL_SW_CONVERT_PIXELS;
+                    lookupPixels(sc, span.ps + x, n, &lookup);
+                    equal = matchPixels(span.pd + x * dl->bpp, sc, expected, n, destFormat, dl, opaqueOnly);
+                }
+                span.ps += source->alignment;
+                span.pd += dest->alignment;
+            }
+        }
+    }
+    return equal;
+}
+
+// The fill pattern holds whole pixels for all supported bpp values (multiple of 1, 2, 3 and 4)
+#define PGL_SW_FILL_PATTERN 48
+
+// Fills bytes with the repeated pattern - the fixed size copies are compiled to vector stores
+static void fillBytes(uint8_t *pd, const uint8_t *pattern, const size_t bytes, const PGLBoolean uniform)
+{
+    if (uniform)
+    {
+        memset(pd, pattern[0], bytes);
+    }
+    else
+    {
+        size_t i = 0u;
+        for (; (i + PGL_SW_FILL_PATTERN) <= bytes; i += PGL_SW_FILL_PATTERN)
+        {
+            memcpy(pd + i, pattern, PGL_SW_FILL_PATTERN);
+        }
+        memcpy(pd + i, pattern, bytes - i);
+    }
+}
+
+void pgl_sw_fill(PGL_SW_Surface *dest, PGLFormat format, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha)
+{
+    const uint8_t bpp = pgl_helper_getbpp(format);
+    const pgl_sw_layout_t *layout = getLayout(format);
+    if (PGL_REQUIRE((format == PGL_FORMAT_A_8) || layout))
+    {
+        checkSurface(dest, bpp, PGL_FALSE);
+
+        int32_t x;
+        int32_t y;
+        int32_t w;
+        int32_t h;
+        if (clipRect(dest, bpp, &x, &y, &w, &h))
+        {
+            // the color is encoded once, all rows are filled with the same pattern
+            const uint8_t color[4] = { blue, green, red, alpha };
+            uint8_t pattern[PGL_SW_FILL_PATTERN];
+            if (format == PGL_FORMAT_A_8)
+            {
+                pattern[0] = alpha;
+            }
+            else
+            {
+                encodePixels(pattern, color, 1, format, layout);
+            }
+            PGLBoolean uniform = PGL_TRUE;
+            for (int32_t i = bpp; i < PGL_SW_FILL_PATTERN; ++i)
+            {
+                pattern[i] = pattern[i - bpp];
+                uniform = uniform && (pattern[i] == pattern[0]);
+            }
+
+            PGL_SW_Pointer pd = dest->p + y * dest->alignment + x * bpp;
+            const size_t rowBytes = (size_t)w * bpp;
+            if (rowBytes == (size_t)dest->alignment)
+            {
+                // complete rows without padding are filled at once (e.g. clearing the whole surface)
+                fillBytes(pd, pattern, rowBytes * (size_t)h, uniform);
+            }
+            else
+            {
+                for (int32_t row = 0; row < h; ++row)
+                {
+                    fillBytes(pd, pattern, rowBytes, uniform);
+                    pd += dest->alignment;
+                }
+            }
+        }
+    }
+}
+
+// Scaled blits: every destination pixel is mapped to a source position (16.16 fixed point). The sampled pixels are
+// decoded to the intermediate format in chunks and written with the same code as pgl_sw_bitblit_convert.
+
+#define PGL_SW_HALF_TEXEL 0x8000
+
+typedef struct
+{
+    int32_t x0[PGL_SW_CONVERT_PIXELS]; // left (nearest) texel column of each destination pixel
+    int32_t x1[PGL_SW_CONVERT_PIXELS]; // right texel column (bilinear)
+    uint8_t fx[PGL_SW_CONVERT_PIXELS]; // weight of the right texel in 1/256 (bilinear)
+    uint8_t raw[PGL_SW_CONVERT_PIXELS * 4]; // gathered source pixels
+    uint8_t texels[4][PGL_SW_CONVERT_PIXELS * 4]; // decoded neighbours: top left, top right, bottom left, bottom right
+} pgl_sw_scale_buffer_t;
+
+// The 16.16 source positions of all destination pixels (and the position after the last one) have to fit into int32_t,
+// linear filtering subtracts half a texel from them
+static PGLBoolean isScaleInRange(const int64_t first, const int64_t step, const int32_t pixels)
+{
+    const int64_t end = first + step * pixels;
+    const int64_t low = (int64_t)INT32_MIN + PGL_SW_HALF_TEXEL;
+    return ((first >= low) && (first <= INT32_MAX) && (end >= low) && (end <= INT32_MAX)) ? PGL_TRUE : PGL_FALSE;
+}
+
+PGLBoolean pgl_sw_scale_init(PGL_SW_Scale *scale, int32_t x1, int32_t y1, int32_t u1, int32_t v1, int32_t x2, int32_t y2, int32_t u2, int32_t v2)
+{
+    // same pixel coverage as pglDrawQuad: x2 / y2 and u2 / v2 are the last pixels inside the rectangles
+    const int32_t w = ((x2 - x1) >> 4u) + 1;
+    const int32_t h = ((y2 - y1) >> 4u) + 1;
+    // 28.4 -> 16.16, calculated with 64 bits because large source coordinates overflow 32 bits
+    const int64_t du = (w > 0) ? ((((int64_t)u2 - u1 + 16) * 4096) / w) : 0;
+    const int64_t dv = (h > 0) ? ((((int64_t)v2 - v1 + 16) * 4096) / h) : 0;
+    // the sub pixel part of u1 / v1 is kept, the first sample is taken at the center of the first destination pixel
+    const int64_t u = (int64_t)u1 * 4096 + du / 2;
+    const int64_t v = (int64_t)v1 * 4096 + dv / 2;
+    const PGLBoolean ret = isScaleInRange(u, du, (w > 0) ? w : 0) && isScaleInRange(v, dv, (h > 0) ? h : 0);
+    scale->x = x1 >> 4u;
+    scale->y = y1 >> 4u;
+    scale->du = ret ? (int32_t)du : 0;
+    scale->dv = ret ? (int32_t)dv : 0;
+    scale->u = ret ? (int32_t)u : 0;
+    scale->v = ret ? (int32_t)v : 0;
+    return ret;
+}
+
+// Texels outside of the source rect are replaced by the nearest edge texel
+static int32_t clampTexel(const int32_t i, const int32_t first, const int32_t last)
+{
+    return (i < first) ? first : ((i > last) ? last : i);
+}
+
+// Source position of a destination pixel. The product alone may exceed 32 bits, the sum is inside the range checked by pgl_sw_scale_init.
+static int32_t scalePosition(const int32_t first, const int32_t step, const int32_t pixels)
+{
+    return (int32_t)((int64_t)first + ((int64_t)pixels * step));
+}
+
+static void sampleColumns(pgl_sw_scale_buffer_t *b, const int32_t x, const int32_t pixels, const PGL_SW_Surface *source, const PGL_SW_Scale *scale, const PGLFilter filter)
+{
+    const int32_t first = source->x;
+    const int32_t last = source->x + source->w - 1;
+    int32_t pos = scalePosition(scale->u, scale->du, x - scale->x);
+    for (int32_t i = 0; i < pixels; ++i)
+    {
+        if (filter == PGL_FILTER_LINEAR)
+        {
+            const int32_t p = pos - PGL_SW_HALF_TEXEL; // the texel centers are the interpolation points
+            b->x0[i] = clampTexel(p >> 16, first, last);
+            b->x1[i] = clampTexel((p >> 16) + 1, first, last);
+            b->fx[i] = (uint8_t)(p >> 8);
+        }
+        else
+        {
+            b->x0[i] = clampTexel(pos >> 16, first, last);
+        }
+        pos += scale->du;
+    }
+}
+
+static void gatherPixels(uint8_t *pd, const uint8_t *row, const int32_t *columns, const int32_t pixels, const uint8_t bpp)
+{
+    if (bpp == 4u)
+    {
+        for (int32_t i = 0; i < pixels; ++i)
+        {
+            memcpy(pd + i * 4, row + columns[i] * 4, 4u);
+        }
+    }
+    else
+    {
+        for (int32_t i = 0; i < pixels; ++i)
+        {
+            memcpy(pd + i * bpp, row + columns[i] * bpp, bpp);
+        }
+    }
+}
+
+// Linear interpolation with 8 bit weights, the rounded result of (a * (256 - f) + b * f) fits into 16 bits
+static uint8_t lerp8(const uint32_t a, const uint32_t b, const uint32_t f)
+{
+    return (uint8_t)((a * (256u - f) + b * f + 128u) >> 8u);
+}
+
+#if defined(PGL_SW_SSE2)
+static __m128i lerpEpi16(const __m128i a, const __m128i b, const __m128i f)
+{
+    const __m128i f0 = _mm_sub_epi16(_mm_set1_epi16(256), f);
+    const __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(a, f0), _mm_mullo_epi16(b, f)), _mm_set1_epi16(128));
+    return _mm_srli_epi16(sum, 8);
+}
+
+// Interpolates two pixels per step with the same rounding as lerp8
+static int32_t bilinearPixelsSimd(uint8_t *pc, const pgl_sw_scale_buffer_t *b, const int32_t pixels, const uint32_t fy)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i wy = _mm_set1_epi16((short)fy);
+    int32_t x = 0;
+    for (; (x + 2) <= pixels; x += 2)
+    {
+        const short f0 = (short)b->fx[x];
+        const short f1 = (short)b->fx[x + 1];
+        const __m128i wx = _mm_set_epi16(f1, f1, f1, f1, f0, f0, f0, f0);
+        const __m128i tl = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(b->texels[0] + x * 4)), zero);
+        const __m128i tr = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(b->texels[1] + x * 4)), zero);
+        const __m128i bl = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(b->texels[2] + x * 4)), zero);
+        const __m128i br = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(b->texels[3] + x * 4)), zero);
+        const __m128i r = lerpEpi16(lerpEpi16(tl, tr, wx), lerpEpi16(bl, br, wx), wy);
+        _mm_storel_epi64((__m128i *)(pc + x * 4), _mm_packus_epi16(r, r));
+    }
+    return x;
+}
+#endif
+
+static void bilinearPixels(uint8_t *pc, const pgl_sw_scale_buffer_t *b, const int32_t pixels, const uint32_t fy)
+{
+    int32_t x = 0;
+#if defined(PGL_SW_SSE2)
+    x = bilinearPixelsSimd(pc, b, pixels, fy);
+#endif
+    for (; x < pixels; ++x)
+    {
+        for (int32_t c = 0; c < 4; ++c)
+        {
+            const int32_t i = x * 4 + c;
+            const uint8_t top = lerp8(b->texels[0][i], b->texels[1][i], b->fx[x]);
+            const uint8_t bottom = lerp8(b->texels[2][i], b->texels[3][i], b->fx[x]);
+            pc[i] = lerp8(top, bottom, fy);
+        }
+    }
+}
+
+// Samples the source for the destination pixels [x, x + pixels) of row y, the result is in the intermediate format
+static void samplePixels(uint8_t *pc, pgl_sw_scale_buffer_t *b, const int32_t x, const int32_t y, const int32_t pixels,
+    const PGL_SW_Surface *source, const PGLFormat format, const pgl_sw_layout_t *layout, const PGL_SW_Scale *scale, const PGLFilter filter)
+{
+    const int32_t top = source->y;
+    const int32_t bottom = source->y + source->h - 1;
+    const int32_t pos = scalePosition(scale->v, scale->dv, y - scale->y);
+    sampleColumns(b, x, pixels, source, scale, filter);
+    if (filter == PGL_FILTER_LINEAR)
+    {
+        const int32_t p = pos - PGL_SW_HALF_TEXEL;
+        const uint8_t *row0 = source->p + clampTexel(p >> 16, top, bottom) * source->alignment;
+        const uint8_t *row1 = source->p + clampTexel((p >> 16) + 1, top, bottom) * source->alignment;
+        gatherPixels(b->raw, row0, b->x0, pixels, layout->bpp);
+        decodePixels(b->texels[0], b->raw, pixels, format, layout);
+        gatherPixels(b->raw, row0, b->x1, pixels, layout->bpp);
+        decodePixels(b->texels[1], b->raw, pixels, format, layout);
+        gatherPixels(b->raw, row1, b->x0, pixels, layout->bpp);
+        decodePixels(b->texels[2], b->raw, pixels, format, layout);
+        gatherPixels(b->raw, row1, b->x1, pixels, layout->bpp);
+        decodePixels(b->texels[3], b->raw, pixels, format, layout);
+        bilinearPixels(pc, b, pixels, (uint32_t)(p >> 8) & 0xffu);
+    }
+    else
+    {
+        const uint8_t *row = source->p + clampTexel(pos >> 16, top, bottom) * source->alignment;
+        gatherPixels(b->raw, row, b->x0, pixels, layout->bpp);
+        decodePixels(pc, b->raw, pixels, format, layout);
+    }
+}
+
+void pgl_sw_bitblit_scale(PGL_SW_Surface *dest, PGLFormat destFormat, const PGL_SW_Surface *source, PGLFormat sourceFormat, const PGL_SW_Scale *scale, PGLFilter filter, PGLBoolean blend)
+{
+    const pgl_sw_layout_t *dl = getLayout(destFormat);
+    const pgl_sw_layout_t *sl = getLayout(sourceFormat);
+    if (PGL_REQUIRE(dl) && PGL_REQUIRE(sl) && PGL_REQUIRE((source->w > 0) && (source->h > 0)))
+    {
+        const PGLBoolean premultiplied = pgl_helper_ispremultiplied(sourceFormat);
+        checkSurface(dest, dl->bpp, PGL_FALSE);
+        checkSurface(source, sl->bpp, PGL_TRUE);
+
+        int32_t x;
+        int32_t y;
+        int32_t w;
+        int32_t h;
+        if (clipRect(dest, dl->bpp, &x, &y, &w, &h))
+        {
+            pgl_sw_scale_buffer_t b;
+            uint8_t sc[PGL_SW_CONVERT_PIXELS * 4];
+            uint8_t dc[PGL_SW_CONVERT_PIXELS * 4];
+            PGL_SW_Pointer pd = dest->p + y * dest->alignment + x * dl->bpp;
+            for (int32_t row = 0; row < h; ++row)
+            {
+                for (int32_t i = 0; i < w; i += PGL_SW_CONVERT_PIXELS)
+                {
+                    const int32_t n = ((w - i) < PGL_SW_CONVERT_PIXELS) ? (w - i) : PGL_SW_CONVERT_PIXELS;
+                    samplePixels(sc, &b, x + i, y + row, n, source, sourceFormat, sl, scale, filter);
+                    writePixels(pd + i * dl->bpp, sc, dc, n, destFormat, dl, blend, premultiplied);
+                }
+                pd += dest->alignment;
+            }
+        }
+    }
+}
+
+PGLBoolean pgl_sw_equal_scale(const PGL_SW_Surface *dest, PGLFormat destFormat, const PGL_SW_Surface *source, PGLFormat sourceFormat, const PGL_SW_Scale *scale, PGLFilter filter, PGLBoolean opaqueOnly)
+{
+    PGLBoolean equal = PGL_FALSE;
+    const pgl_sw_layout_t *dl = getLayout(destFormat);
+    const pgl_sw_layout_t *sl = getLayout(sourceFormat);
+    if (PGL_REQUIRE(dl) && PGL_REQUIRE(sl) && PGL_REQUIRE((source->w > 0) && (source->h > 0)))
+    {
+        checkSurface(dest, dl->bpp, PGL_FALSE);
+        checkSurface(source, sl->bpp, PGL_TRUE);
+
+        int32_t x;
+        int32_t y;
+        int32_t w;
+        int32_t h;
+        // pixels of the requested area which are outside of the surface can't be verified
+        if (clipRect(dest, dl->bpp, &x, &y, &w, &h) && (w == dest->w) && (h == dest->h))
+        {
+            pgl_sw_scale_buffer_t b;
+            uint8_t sc[PGL_SW_CONVERT_PIXELS * 4];
+            uint8_t expected[PGL_SW_CONVERT_PIXELS * 4];
+            const uint8_t *pd = dest->p + y * dest->alignment + x * dl->bpp;
+            equal = PGL_TRUE;
+            for (int32_t row = 0; (row < h) && equal; ++row)
+            {
+                for (int32_t i = 0; (i < w) && equal; i += PGL_SW_CONVERT_PIXELS)
+                {
+                    const int32_t n = ((w - i) < PGL_SW_CONVERT_PIXELS) ? (w - i) : PGL_SW_CONVERT_PIXELS;
+                    samplePixels(sc, &b, x + i, y + row, n, source, sourceFormat, sl, scale, filter);
+                    equal = matchPixels(pd + i * dl->bpp, sc, expected, n, destFormat, dl, opaqueOnly);
+                }
+                pd += dest->alignment;
+            }
+        }
+    }
+    return equal;
 }
@@ -45,6 +45,18 @@ typedef struct
     int32_t bytes; // memory ends at p + bytes  - to allow additional checks for being sure to keep inside boundaries
 } PGL_SW_Surface;
 
+#define PGL_SW_PALETTE_COLORS 256
+
+/**
+ * The colors of an indexed texture (PGL_FORMAT_P_8_*), converted to BGRA_8888 once when the palette is loaded
+ */
+typedef struct
+{
+    uint8_t colors[PGL_SW_PALETTE_COLORS * 4]; // BGRA_8888, the indices without a color are transparent black
+    uint32_t count; // number of colors
+    PGLBoolean opaque; // all colors have alpha 255 (blending is not needed)
+} PGL_SW_Palette;
+
 /**
  * Gets the amount of bytes which one pixel occupies
  * @param format the format for which to determine the bpp value
@@ -52,24 +64,200 @@ typedef struct
  */
 uint8_t pgl_helper_getbpp(PGLFormat format);
 
+/**
+ * Checks if pgl_sw_bitblit_blend supports the given format (32 bit formats with the alpha channel in the 4th byte)
+ */
+PGLBoolean pgl_helper_isblendable(PGLFormat format);
+
+/**
+ * Checks if the format stores colors with premultiplied alpha
+ */
+PGLBoolean pgl_helper_ispremultiplied(PGLFormat format);
+
+/**
+ * Checks if pgl_sw_bitblit_convert supports the given format (16, 24 and 32 bit RGB formats)
+ */
+PGLBoolean pgl_helper_isconvertible(PGLFormat format);
+
 
 /**
- * Does a copy bitblit (no alpha blending). Simply pixel values are copied. Can handle 1,2 and 4 bytes per pixel. Destination and Source surface have the same format.
- * Source and dest rectangles are part of the input structures describing the surfaces. Scaling is not supported. Several checks are applied to prevent out of boundary accesses at any circumstance.
+ * Checks if the format is an indexed format with a palette which is supported by pgl_sw_bitblit_palette (PGL_FORMAT_P_8_*)
+ */
+PGLBoolean pgl_helper_ispalette(PGLFormat format);
+
+/**
+ * Restricts a blit or fill to a clip rectangle [left, right) x [top, bottom) in pixels of the destination.
+ * Called once per drawing command before the kernel: the dest position and the source rect (x, y, w, h) are moved and
+ * shrunk to the visible part, so the kernels only touch pixels inside the clip rectangle.
+ * @param dest the destination surface, x / y / w / h are adjusted
+ * @param source the source surface of a blit, NULL for a fill (the extent is given by w / h of dest)
+ * @return PGL_TRUE if at least one pixel is inside the clip rectangle
+ */
+PGLBoolean pgl_sw_clip(PGL_SW_Surface *dest, PGL_SW_Surface *source, int32_t left, int32_t top, int32_t right, int32_t bottom);
+
+/**
+ * Does a copy bitblit (no alpha blending). Simply pixel values are copied. Can handle 1, 2, 3 and 4 bytes per pixel. Destination and Source surface have the same format.
+ * Source and dest rectangles are part of the input structures describing the surfaces. Scaling is not supported. The blit is clipped once against the memory of both surfaces
+ * (columns: alignment / bpp, rows: bytes / alignment) to prevent out of boundary accesses at any circumstance. Each remaining row is copied as a whole.
  * @param dest the destination surface in which to copy (bitblit) an area out of the source surface. w and h parameter of dest are used for validity checks. Scaling is not applied. x, y is the position
  *        inside the dest to which the source surface is copied.
  * @param source the source surface. It is valid to just copy a portion (x,y / w,h) out of the source surface to the destination.
- * @param format the format in which source and dest are structured. Currently 1, 2 and 4 byte surface formats are supported
+ * @param format the format in which source and dest are structured. Currently 1, 2, 3 and 4 byte surface formats are supported
  * @return returns the bytes per pixel value
  */
 void pgl_sw_bitblit_copy(PGL_SW_Surface *dest, PGL_SW_Surface *source, PGLFormat format);
 
 /**
- * Checks if both surfaces contain the same content
+ * Does an alpha blending bitblit ("source over"). Same clipping rules as pgl_sw_bitblit_copy.
+ * Fully opaque source pixels are copied, fully transparent ones leave the destination untouched.
+ * @param format format of the source. RGBA_8888 / BGRA_8888 (straight alpha) and their _PRE variants (premultiplied alpha) are supported.
+ *        The destination has to use the same channel order.
+ */
+void pgl_sw_bitblit_blend(PGL_SW_Surface *dest, PGL_SW_Surface *source, PGLFormat format);
+
+/**
+ * Checks if both surfaces contain the same content. Every pixel is inspected (diagnostic mode).
+ * Pixels of the source area which are outside of the memory of one of the surfaces count as different.
  * @return the number of different pixels
  */
 uint32_t pgl_sw_compare(const PGL_SW_Surface *dest, const PGL_SW_Surface *source, PGLFormat format);
 
+/**
+ * Checks if both surfaces contain the same content. Same rules as pgl_sw_compare, but the comparison stops at the first difference.
+ * @return PGL_TRUE if all pixels are identical
+ */
+PGLBoolean pgl_sw_equal(const PGL_SW_Surface *dest, const PGL_SW_Surface *source, PGLFormat format);
+
+/**
+ * Checks if the opaque pixels (alpha 255) of the source are contained in dest. Used to verify blended blits:
+ * transparent and translucent pixels depend on the background and are not checked.
+ * @param format a format which is supported by pgl_sw_bitblit_blend
+ * @return PGL_TRUE if all opaque pixels are identical
+ */
+PGLBoolean pgl_sw_equal_opaque(const PGL_SW_Surface *dest, const PGL_SW_Surface *source, PGLFormat format);
+
+/**
+ * Calculates the CRC32C of the pixels of the rect (x, y, w, h), row by row (w * bpp bytes of each row).
+ * The rect has to be inside of the surface memory.
+ */
+uint32_t pgl_sw_crc32(const PGL_SW_Surface *surface, PGLFormat format);
+
+/**
+ * Splits the rect (x, y, w, h) into tiles of tileSize x tileSize pixels (the tiles of the last column and row may be smaller)
+ * and calculates the CRC32C of every tile (see pgl_sw_crc32). The rect has to be inside of the surface memory.
+ * @param crcs receives the CRCs row by row, ceil(w / tileSize) * ceil(h / tileSize) values
+ */
+void pgl_sw_tile_crcs(const PGL_SW_Surface *source, PGLFormat format, int32_t tileSize, uint32_t *crcs);
+
+/**
+ * Checks if dest contains an image with known tile CRCs (see pgl_sw_tile_crcs) instead of comparing it pixel by pixel:
+ * only the destination is read and one CRC per tile is compared. The comparison stops at the first different tile.
+ * @param crcs CRC of the top left tile of the rect
+ * @param stride distance between the CRCs of two tile rows (the source image may have more tiles than the rect)
+ * @return PGL_TRUE if all tile CRCs match, PGL_FALSE if a part of the rect is outside of the surface memory
+ */
+PGLBoolean pgl_sw_equal_crc(const PGL_SW_Surface *dest, PGLFormat format, int32_t tileSize, const uint32_t *crcs, int32_t stride);
+
+/**
+ * Does a bitblit between surfaces of different formats. Same clipping rules as pgl_sw_bitblit_copy.
+ * The pixels are converted via BGRA_8888: channels are expanded by replicating the upper bits (e.g. 5 bit -> 8 bit)
+ * and truncated when the destination has less precision. Formats without alpha channel are opaque.
+ * @param blend if PGL_TRUE the source is blended onto the destination (see pgl_sw_bitblit_blend), otherwise it is copied
+ */
+void pgl_sw_bitblit_convert(PGL_SW_Surface *dest, PGLFormat destFormat, PGL_SW_Surface *source, PGLFormat sourceFormat, PGLBoolean blend);
+
+/**
+ * Checks if dest contains the source converted to the destination format (see pgl_sw_bitblit_convert).
+ * The comparison stops at the first difference, pixels outside of the memory of one of the surfaces count as different.
+ * @param opaqueOnly if PGL_TRUE only the source pixels with alpha 255 are checked (see pgl_sw_equal_opaque)
+ * @return PGL_TRUE if all checked pixels are identical
+ */
+PGLBoolean pgl_sw_equal_convert(const PGL_SW_Surface *dest, PGLFormat destFormat, const PGL_SW_Surface *source, PGLFormat sourceFormat, PGLBoolean opaqueOnly);
+
+/**
+ * Does a bitblit from run length encoded pixels (PGL_ENCODING_RLE / PGL_ENCODING_RLE2) without decompressing them into memory.
+ * Formats and blending are handled like in pgl_sw_bitblit_convert. The pixel of a run is converted once: with blending
+ * transparent runs are skipped, opaque runs are written like fills. Scaling is not supported.
+ * @param dest x, y is the position of the source rect, which is clipped against the surface memory
+ * @param source p / bytes is the encoded data of the whole image, alignment the size of one decoded row (width * bpp).
+ *        x, y, w, h is the source rect. Rows which are not contained in the data (invalid data) are not drawn.
+ * @param swapped PGL_TRUE for PGL_ENCODING_RLE2
+ */
+void pgl_sw_bitblit_rle(PGL_SW_Surface *dest, PGLFormat destFormat, const PGL_SW_Surface *source, PGLFormat sourceFormat, PGLBoolean swapped, PGLBoolean blend);
+
+/**
+ * Checks if dest contains the result of pgl_sw_bitblit_rle with the same parameters. The comparison stops at the first difference.
+ * @param opaqueOnly if PGL_TRUE only the source pixels with alpha 255 are checked (see pgl_sw_equal_opaque)
+ * @return PGL_TRUE if all checked pixels are identical, PGL_FALSE if a part of dest is outside of the surface memory or the data is invalid
+ */
+PGLBoolean pgl_sw_equal_rle(const PGL_SW_Surface *dest, PGLFormat destFormat, const PGL_SW_Surface *source, PGLFormat sourceFormat, PGLBoolean swapped, PGLBoolean opaqueOnly);
+
+/**
+ * Converts the colors of a palette to BGRA_8888 (see PGL_SW_Palette)
+ * @param format indexed format of the texture, e.g. colors are RGB_565 for PGL_FORMAT_P_8_RGB_565
+ * @param count number of colors, at most PGL_SW_PALETTE_COLORS
+ * @return PGL_FALSE if the format is not supported
+ */
+PGLBoolean pgl_sw_palette_init(PGL_SW_Palette *palette, PGLFormat format, const void *colors, uint32_t count);
+
+/**
+ * Does a bitblit from an indexed texture (one byte per pixel) to a surface of a format supported by pgl_sw_bitblit_convert.
+ * Same clipping rules as pgl_sw_bitblit_copy. Without blending the palette is converted to the destination format once and the
+ * rows are written by table lookups (16 pixels at once for palettes with up to 16 colors, if the CPU supports byte shuffles).
+ * @param blend if PGL_TRUE the colors are blended onto the destination (straight alpha, see pgl_sw_bitblit_blend)
+ */
+void pgl_sw_bitblit_palette(PGL_SW_Surface *dest, PGLFormat destFormat, PGL_SW_Surface *source, const PGL_SW_Palette *palette, PGLBoolean blend);
+
+/**
+ * Checks if dest contains the result of pgl_sw_bitblit_palette. The comparison stops at the first difference,
+ * pixels outside of the memory of one of the surfaces count as different.
+ * @param opaqueOnly if PGL_TRUE only the pixels with an opaque color are checked (see pgl_sw_equal_opaque)
+ * @return PGL_TRUE if all checked pixels are identical
+ */
+PGLBoolean pgl_sw_equal_palette(const PGL_SW_Surface *dest, PGLFormat destFormat, const PGL_SW_Surface *source, const PGL_SW_Palette *palette, PGLBoolean opaqueOnly);
+
+/**
+ * Fills a rectangle with a solid color. The rectangle (x, y, w, h of dest) is clipped against the memory of the surface.
+ * The color is converted to the surface format once, afterwards whole rows are written.
+ * @param format format of the surface: A_8 (only alpha is used) or a format supported by pgl_sw_bitblit_convert
+ */
+void pgl_sw_fill(PGL_SW_Surface *dest, PGLFormat format, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha);
+
+/**
+ * Maps the destination pixels of a scaled blit to source positions (see pgl_sw_scale_init)
+ */
+typedef struct
+{
+    int32_t x; // top left pixel of the whole (unclipped) destination rect
+    int32_t y;
+    int32_t u; // source position of the center of the top left destination pixel, 16.16 fixed point
+    int32_t v;
+    int32_t du; // source distance between two destination pixels, 16.16 fixed point
+    int32_t dv;
+} PGL_SW_Scale;
+
+/**
+ * Computes the mapping for a scaled blit from pglDrawQuad coordinates (28.4 fixed point, x2 / y2 and u2 / v2 are inclusive).
+ * @return PGL_FALSE if the source positions don't fit into 16.16 fixed point (the mapping is zeroed then)
+ */
+PGLBoolean pgl_sw_scale_init(PGL_SW_Scale *scale, int32_t x1, int32_t y1, int32_t u1, int32_t v1, int32_t x2, int32_t y2, int32_t u2, int32_t v2);
+
+/**
+ * Does a scaled bitblit. Formats and blending are handled like in pgl_sw_bitblit_convert.
+ * @param dest x, y, w, h is the part of the destination rect which is drawn (e.g. after pgl_sw_clip with a NULL source). It is clipped against the surface memory.
+ * @param source x, y, w, h is the source rect, samples outside of it use the nearest edge pixel (no access outside of the rect)
+ * @param scale the mapping of the whole destination rect, see pgl_sw_scale_init
+ * @param filter PGL_FILTER_NEAREST picks one source pixel, PGL_FILTER_LINEAR interpolates the four neighbours (8 bit weights)
+ */
+void pgl_sw_bitblit_scale(PGL_SW_Surface *dest, PGLFormat destFormat, const PGL_SW_Surface *source, PGLFormat sourceFormat, const PGL_SW_Scale *scale, PGLFilter filter, PGLBoolean blend);
+
+/**
+ * Checks if dest contains the result of pgl_sw_bitblit_scale with the same parameters. The pixels are recomputed bit exactly.
+ * @param opaqueOnly if PGL_TRUE only the sampled pixels with alpha 255 are checked (see pgl_sw_equal_opaque)
+ * @return PGL_TRUE if all checked pixels are identical, PGL_FALSE if a part of dest is outside of the surface memory
+ */
+PGLBoolean pgl_sw_equal_scale(const PGL_SW_Surface *dest, PGLFormat destFormat, const PGL_SW_Surface *source, PGLFormat sourceFormat, const PGL_SW_Scale *scale, PGLFilter filter, PGLBoolean opaqueOnly);
+
 #ifdef __cplusplus
 }
 #endif
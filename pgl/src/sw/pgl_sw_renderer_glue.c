@@ -31,7 +31,9 @@
 
 #include "pgl_sw_renderer_glue.h"
 #include "pgl_sw_renderer.h"
+#include "pgl_sw_threads.h"
 #include "pgl_assert.h"
+#include "pgl_decode.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -42,14 +44,71 @@ typedef struct pgl_texture_t
     PGLFormat mFormat;
     const void * mData;
     uint32_t mSize; // Size in memory in bytes
+    PGLEncoding mEncoding; // PGL_ENCODING_RAW or PGL_ENCODING_RLE(2), other encodings are decompressed by pglLoadTextureEncoded
     PGLBoolean mAllocated;
+    uint32_t * mMemory; // decompressed pixels, a block of gsTextureMemory
+    uint32_t mMemoryCapacity; // in bytes
+    PGLBoolean mExpanded; // mMemory holds the decoded pixels of an RLE or indexed texture for scaled quads
+    PGL_SW_Palette * mPalette; // colors of PGL_FORMAT_P_8_* textures, taken from gsPalettes at the first load
+    uint32_t * mTileCrcs; // CRCs of the PGL_SW_CRC_TILE tiles (PGL_VERIFY_TILE_CRC), a block of gsTileCrcs
+    uint32_t mTileCrcCapacity;
+    PGLBoolean mTileCrcsValid; // the CRCs belong to the current pixel data
+    PGLVerification mVerification; // of the context which created the texture, PGL_VERIFY_TILE_CRC: the CRCs are calculated when the texture is loaded
     PGLBoolean mValid;
 } pgl_texture_t;
 
+typedef enum
+{
+    PGL_COMMAND_FILL,
+    PGL_COMMAND_COPY,
+    PGL_COMMAND_BLEND,
+    PGL_COMMAND_CONVERT,
+    PGL_COMMAND_SCALE,
+    PGL_COMMAND_RLE,
+    PGL_COMMAND_PALETTE
+} pgl_command_type_t;
+
+// A drawing command with the context state which is needed to execute it later (threaded contexts)
+typedef struct pgl_command_t
+{
+    pgl_command_type_t mType;
+    PGL_SW_Surface mDest; // destination rect on the surface (not clipped)
+    PGLFormat mDestFormat;
+    PGL_SW_Surface mSource; // texture rect, not used by fills
+    PGLFormat mSourceFormat;
+    PGL_SW_Scale mScale;
+    PGLFilter mFilter;
+    PGLBoolean mBlend;
+    PGLBoolean mSwapped; // PGL_COMMAND_RLE of a PGL_ENCODING_RLE2 texture
+    const PGL_SW_Palette * mPalette; // PGL_COMMAND_PALETTE, NULL for other commands
+    uint8_t mColor[4]; // red, green, blue, alpha of fills
+    int32_t mBounds[4]; // left, top, right, bottom of the modified pixels (inside the clip area and the surface)
+    int32_t mTiles[4]; // first column, first row, last column, last row of the tiles which intersect mBounds
+} pgl_command_t;
+
+typedef struct pgl_list_t
+{
+    pgl_command_t mCommands[PGL_MAX_LIST_COMMANDS];
+    uint32_t mCount;
+    PGLSurface mSurface; // current surface of pglBeginList
+    PGLBoolean mComplete; // all commands since pglBeginList fit into the list
+    PGLBoolean mValid;
+} pgl_list_t;
+
 typedef struct pgl_context_t
 {
     PGLSurface mSurface;
     pgl_texture_t * mTexture;
+    PGLBoolean mBlending;
+    PGLFilter mFilter;
+    uint8_t mColor[4]; // red, green, blue, alpha
+    int32_t mClip[4]; // left, top, right, bottom in pixels (right / bottom exclusive)
+    PGL_SW_Pool * mPool; // NULL: the commands are executed immediately
+    pgl_command_t mCommands[PGL_MAX_COMMANDS]; // recorded commands of mSurface
+    uint32_t mCommandCount;
+    int32_t mTiles[4]; // tiles which contain at least one recorded command (same layout as pgl_command_t::mTiles)
+    pgl_list_t * mList; // display list between pglBeginList and pglEndList
+    PGLVerification mVerification;
     PGLBoolean mValid;
 } pgl_context_t;
 
@@ -59,6 +118,19 @@ static uint8_t gsCurrentTexture = 0u;
 static pgl_context_t gsContexts[PGL_MAX_CONTEXTS] = { 0 };
 static uint8_t gsCurrentContext = 0u;
 
+static pgl_list_t gsLists[PGL_MAX_LISTS] = { 0 };
+static uint8_t gsCurrentList = 0u;
+
+// the blocks of the textures in these pools are allocated first fit, a reloaded texture releases its block if it's too small
+static uint32_t gsTileCrcs[PGL_MAX_TILE_CRCS] = { 0 };
+static uint32_t gsTextureMemory[PGL_SW_TEXTURE_MEMORY / 4u] = { 0 }; // 32 bit words keep the pixels aligned
+
+static PGL_SW_Palette gsPalettes[PGL_MAX_PALETTES];
+static uint32_t gsCurrentPalette = 0u;
+
+static void flushCommands(pgl_context_t * ctx);
+static void loadTileCrcs(pgl_texture_t * t);
+
 PGLBoolean pglIsValidContext(PGLContext context)
 {
     return PGL_REQUIRE(context) // check if context is valid - additional check to see if context is special NULL pointer
@@ -75,7 +147,15 @@ PGLBoolean pglIsValidTexture(PGLTexture texture, PGLBoolean check4content)
         && PGL_REQUIRE(texture < &gsTextures[PGL_MAX_TEXTURES]);
 }
 
-PGLContext pglCreateContext(void)
+PGLBoolean pglIsValidList(PGLList list)
+{
+    return PGL_REQUIRE(list) // check if list is valid
+        && PGL_REQUIRE((list)->mValid) // valid flag set?
+        && PGL_REQUIRE(list >= &gsLists[0]) // check if list points to valid memory
+        && PGL_REQUIRE(list < &gsLists[PGL_MAX_LISTS]);
+}
+
+PGLContext pglCreateContext(const PGLContextConfig* config)
 {
     PGLContext retVal = NULL;
 
@@ -85,6 +165,19 @@ PGLContext pglCreateContext(void)
         retVal->mValid = PGL_TRUE;
         retVal->mSurface = NULL;
         retVal->mTexture = NULL;
+        retVal->mBlending = PGL_FALSE;
+        retVal->mFilter = PGL_FILTER_NEAREST;
+        memset(retVal->mColor, 0, sizeof(retVal->mColor));
+        // no clipping - the kernels clip against the surface memory
+        retVal->mClip[0] = 0;
+        retVal->mClip[1] = 0;
+        retVal->mClip[2] = INT32_MAX;
+        retVal->mClip[3] = INT32_MAX;
+        // the commands of a single threaded context are executed immediately
+        retVal->mPool = pgl_sw_pool_create(config ? config->threads : 1u);
+        retVal->mCommandCount = 0u;
+        retVal->mList = NULL;
+        retVal->mVerification = config ? config->verification : PGL_VERIFY_PIXELS;
     }
 
     return retVal;
@@ -96,8 +189,13 @@ PGLBoolean pglSetSurface(PGLContext context, PGLSurface surface)
 {
     PGLBoolean ret = PGL_FALSE;
     if (pglIsValidContext(context) // check if context is valid
-        && pglIsValidSurface(surface, PGL_TRUE)) // check if surface is valid
+        && pglIsValidSurface(surface, PGL_TRUE) // check if surface is valid
+        && PGL_REQUIRE((context->mList == NULL) || (context->mSurface == surface))) // a display list draws into one surface
     {
+        if (context->mSurface != surface)
+        {
+            flushCommands(context); // the recorded commands belong to the previous surface
+        }
         context->mSurface = surface;
         ret = PGL_TRUE;
     }
@@ -118,7 +216,16 @@ PGLTexture pglCreateTexture(PGLContext context)
         retVal->mData = NULL;
         retVal->mFormat = PGL_FORMAT_RGBA_8888;
         retVal->mSize = 0u;
+        retVal->mEncoding = PGL_ENCODING_RAW;
         retVal->mAllocated = PGL_FALSE;
+        retVal->mMemory = NULL;
+        retVal->mMemoryCapacity = 0u;
+        retVal->mExpanded = PGL_FALSE;
+        retVal->mPalette = NULL;
+        retVal->mTileCrcs = NULL;
+        retVal->mTileCrcCapacity = 0u;
+        retVal->mTileCrcsValid = PGL_FALSE;
+        retVal->mVerification = (context != NULL) ? context->mVerification : PGL_VERIFY_PIXELS;
     }
 
     return retVal;
@@ -126,11 +233,58 @@ PGLTexture pglCreateTexture(PGLContext context)
 
 PGLBoolean pglSetColor(PGLContext context, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha)
 {
-    // TODO
-    return PGL_TRUE;
+    PGLBoolean ret = PGL_FALSE;
+    if (pglIsValidContext(context))
+    {
+        context->mColor[0] = red;
+        context->mColor[1] = green;
+        context->mColor[2] = blue;
+        context->mColor[3] = alpha;
+        ret = PGL_TRUE;
+    }
+    return ret;
 }
 
-PGLBoolean pglLoadTexture(PGLTexture tex, uint32_t width, uint32_t height, PGLFormat format, PGLBoolean copy, const void* data)
+PGLBoolean pglSetBlending(PGLContext context, PGLBoolean enable)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if (pglIsValidContext(context))
+    {
+        context->mBlending = enable ? PGL_TRUE : PGL_FALSE;
+        ret = PGL_TRUE;
+    }
+    return ret;
+}
+
+PGLBoolean pglSetFilter(PGLContext context, PGLFilter filter)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if (pglIsValidContext(context) && PGL_REQUIRE((filter == PGL_FILTER_NEAREST) || (filter == PGL_FILTER_LINEAR)))
+    {
+        context->mFilter = filter;
+        ret = PGL_TRUE;
+    }
+    return ret;
+}
+
+PGLBoolean pglSetClip(PGLContext context, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    PGLBoolean ret = PGL_FALSE;
+    // an inverted rect is rejected (no assertion, it's a documented PGL_FALSE result)
+    if (pglIsValidContext(context) && (x1 <= x2) && (y1 <= y2))
+    {
+        // same pixel coverage as pglDrawArea: x2 / y2 is the last pixel inside the clip area
+        context->mClip[0] = x1 >> 4u;
+        context->mClip[1] = y1 >> 4u;
+        context->mClip[2] = (x2 >> 4u) + 1;
+        context->mClip[3] = (y2 >> 4u) + 1;
+        ret = PGL_TRUE;
+    }
+    return ret;
+}
+
+// Takes the pixels of the texture, the encoded textures adjust the encoding afterwards
+static PGLBoolean loadTexture(PGLTexture tex, uint32_t width, uint32_t height, PGLFormat format, PGLBoolean copy, const void* data)
 {
     PGLBoolean ret = PGL_FALSE;
     if (pglIsValidTexture(tex,PGL_FALSE) // check if texture is valid
@@ -139,7 +293,7 @@ PGLBoolean pglLoadTexture(PGLTexture tex, uint32_t width, uint32_t height, PGLFo
         )
     {
         const uint8_t bpp = pgl_helper_getbpp(format);
-        const uint32_t bufSize = width*height*bpp;
+        const uint32_t bufSize = pgl_image_bytes(width, height, bpp);
 
         // check if texture already includes allocated memory... If yes free
         //if (tex->mAllocated && PGL_REQUIRE(tex->mData) && PGL_REQUIRE(tex->mValid)) // if it is allocated it should also be a valid pointer
@@ -164,12 +318,138 @@ PGLBoolean pglLoadTexture(PGLTexture tex, uint32_t width, uint32_t height, PGLFo
         //else
         //{
         tex->mData = data;
+        tex->mEncoding = PGL_ENCODING_RAW;
+        tex->mExpanded = PGL_FALSE;
+        tex->mTileCrcsValid = PGL_FALSE;
         ret = PGL_TRUE;
     }
 
     return ret;
 }
 
+PGLBoolean pglLoadTexture(PGLTexture tex, uint32_t width, uint32_t height, PGLFormat format, PGLBoolean copy, const void* data)
+{
+    const PGLBoolean ret = loadTexture(tex, width, height, format, copy, data);
+    if (ret)
+    {
+        loadTileCrcs(tex);
+    }
+    return ret;
+}
+
+// Block of the texture in gsTextureMemory (memory) or gsTileCrcs: offset and size in 32 bit words, size 0 if there is none
+static void getBlock(const pgl_texture_t * t, const PGLBoolean memory, uint32_t * offset, uint32_t * words)
+{
+    if (memory)
+    {
+        *offset = (t->mMemory != NULL) ? (uint32_t)(t->mMemory - gsTextureMemory) : 0u;
+        *words = (t->mMemory != NULL) ? (t->mMemoryCapacity / 4u) : 0u;
+    }
+    else
+    {
+        *offset = (t->mTileCrcs != NULL) ? (uint32_t)(t->mTileCrcs - gsTileCrcs) : 0u;
+        *words = (t->mTileCrcs != NULL) ? t->mTileCrcCapacity : 0u;
+    }
+}
+
+// Returns the offset of the first gap of the given size between the blocks of the other textures, poolWords if there is none
+static uint32_t findFreeBlock(const pgl_texture_t * t, const PGLBoolean memory, const uint32_t words, const uint32_t poolWords)
+{
+    uint32_t candidate = 0u;
+    PGLBoolean moved = PGL_TRUE;
+    while (moved && (words <= poolWords) && (candidate <= (poolWords - words)))
+    {
+        moved = PGL_FALSE;
+        for (uint8_t i = 0u; i < gsCurrentTexture; ++i)
+        {
+            uint32_t offset = 0u;
+            uint32_t size = 0u;
+            getBlock(&gsTextures[i], memory, &offset, &size);
+            if ((&gsTextures[i] != t) && (size > 0u) && (offset < (candidate + words)) && (candidate < (offset + size)))
+            {
+                // behind the overlapping block
+                candidate = offset + size;
+                moved = PGL_TRUE;
+            }
+        }
+    }
+    return ((words <= poolWords) && (candidate <= (poolWords - words))) ? candidate : poolWords;
+}
+
+// Returns memory for the decompressed pixels of the texture, NULL if there is no room left
+static uint32_t * getTextureMemory(pgl_texture_t * t, const uint32_t bytes)
+{
+    const uint32_t words = (bytes + 3u) / 4u;
+    if (t->mMemoryCapacity < bytes)
+    {
+        // a reloaded texture keeps its memory if the pixels still fit, otherwise the block is released
+        t->mMemory = NULL;
+        t->mMemoryCapacity = 0u;
+        const uint32_t offset = findFreeBlock(t, PGL_TRUE, words, PGL_SW_TEXTURE_MEMORY / 4u);
+        if (offset < (PGL_SW_TEXTURE_MEMORY / 4u))
+        {
+            t->mMemory = &gsTextureMemory[offset];
+            t->mMemoryCapacity = words * 4u;
+        }
+    }
+    return (t->mMemoryCapacity >= bytes) ? t->mMemory : NULL;
+}
+
+PGLBoolean pglLoadTextureEncoded(PGLTexture tex, uint32_t width, uint32_t height, PGLFormat format, PGLEncoding encoding, uint32_t size, const void* data)
+{
+    PGLBoolean ret = PGL_FALSE;
+    // UINT32_MAX for sizes beyond 32 bits, no texture memory is that large
+    const uint32_t bytes = pgl_image_bytes(width, height, pgl_helper_getbpp(format));
+    if (encoding == PGL_ENCODING_RAW)
+    {
+        ret = PGL_REQUIRE(size >= bytes) && loadTexture(tex, width, height, format, PGL_FALSE, data);
+    }
+    else if ((encoding == PGL_ENCODING_RLE) || (encoding == PGL_ENCODING_RLE2))
+    {
+        // drawn directly from the encoded data, the pixels are converted while drawing (pgl_sw_bitblit_rle)
+        ret = loadTexture(tex, width, height, format, PGL_FALSE, data)
+            && PGL_REQUIRE(pgl_helper_isconvertible(format));
+        if (ret)
+        {
+            tex->mSize = size;
+            tex->mEncoding = encoding;
+        }
+    }
+    else if (pglIsValidTexture(tex, PGL_FALSE) && PGL_REQUIRE(data))
+    {
+        uint32_t * memory = getTextureMemory(tex, bytes);
+        ret = PGL_REQUIRE(memory)
+            && PGL_REQUIRE(pgl_decode((uint8_t *)memory, tex->mMemoryCapacity, width, height, pgl_helper_getbpp(format), encoding, data, size))
+            && loadTexture(tex, width, height, format, PGL_FALSE, memory);
+    }
+    else
+    {
+        // invalid texture
+    }
+    if (ret)
+    {
+        loadTileCrcs(tex);
+    }
+    return ret;
+}
+
+PGLBoolean pglLoadTexturePalette(PGLTexture tex, uint32_t width, uint32_t height, PGLFormat format, PGLBoolean copy, const void* data, uint32_t colors, const void* palette)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if (pglIsValidTexture(tex, PGL_FALSE) && PGL_REQUIRE(pgl_helper_ispalette(format)))
+    {
+        // a reloaded texture keeps its palette
+        if ((tex->mPalette == NULL) && (gsCurrentPalette < PGL_MAX_PALETTES))
+        {
+            tex->mPalette = &gsPalettes[gsCurrentPalette++];
+        }
+        ret = PGL_REQUIRE(tex->mPalette)
+            && pgl_sw_palette_init(tex->mPalette, format, palette, colors)
+            && loadTexture(tex, width, height, format, copy, data);
+    }
+    return ret;
+}
+
 void pglBindTexture(PGLContext context, PGLTexture t)
 {
     if (pglIsValidContext(context)
@@ -181,21 +461,355 @@ void pglBindTexture(PGLContext context, PGLTexture t)
 
 PGLBoolean pglSurfaceToSWSurface(PGLSurface surface, PGL_SW_Surface * swsurface, PGLFormat * format); // Implementation Platform dependend (e.g. in pgl_win32, ...)
 
+// A premultiplied texture has the same memory layout as its straight counterpart
+static PGLBoolean isCompatibleFormat(const PGLFormat textureFormat, const PGLFormat surfaceFormat)
+{
+    return (textureFormat == surfaceFormat)
+        || ((textureFormat == PGL_FORMAT_BGRA_8888_PRE) && (surfaceFormat == PGL_FORMAT_BGRA_8888))
+        || ((textureFormat == PGL_FORMAT_RGBA_8888_PRE) && (surfaceFormat == PGL_FORMAT_RGBA_8888));
+}
+
+// Textures which don't match the surface are converted while drawing
+static PGLBoolean needsConversion(const PGLFormat textureFormat, const PGLFormat surfaceFormat)
+{
+    return !isCompatibleFormat(textureFormat, surfaceFormat)
+        && pgl_helper_isconvertible(textureFormat) && pgl_helper_isconvertible(surfaceFormat);
+}
+
+// The texture contains palette indices, which are replaced by the colors while drawing
+static PGLBoolean usesPalette(const pgl_texture_t * t)
+{
+    return pgl_helper_ispalette(t->mFormat) && (t->mPalette != NULL);
+}
+
+// The texture can be drawn onto a surface of the given format, directly or converted
+static PGLBoolean isDrawable(const pgl_texture_t * t, const PGLFormat surfaceFormat)
+{
+    return isCompatibleFormat(t->mFormat, surfaceFormat) || needsConversion(t->mFormat, surfaceFormat)
+        || (usesPalette(t) && pgl_helper_isconvertible(surfaceFormat));
+}
+
+// Blending is only applied if the texture has an alpha channel (or a palette with translucent colors), all other textures are copied
+static PGLBoolean useBlending(const pgl_context_t * ctx, const pgl_texture_t * t)
+{
+    return ctx->mBlending && (usesPalette(t) ? !t->mPalette->opaque : pgl_helper_isblendable(t->mFormat));
+}
+
+// The destination and the texture rect have different sizes (the quad is zoomed)
+static PGLBoolean isScaled(const PGL_SW_Surface * dest, const PGL_SW_Surface * src)
+{
+    return ((dest->w != src->w) || (dest->h != src->h)) ? PGL_TRUE : PGL_FALSE;
+}
+
+// Looks up the BGRA_8888 colors of the indices, memory has room for width * height pixels
+static void expandPalette(const pgl_texture_t * t, uint32_t * memory)
+{
+    const uint8_t * indices = (const uint8_t *)t->mData;
+    const uint32_t count = t->mWidth * t->mHeight;
+    for (uint32_t i = 0u; i < count; ++i)
+    {
+        memcpy(&memory[i], &t->mPalette->colors[indices[i] * 4u], 4u);
+    }
+}
+
+// Points the texture rect of a scaled quad to raw pixels. The scaler can't read RLE data or indices, so these textures
+// are expanded into the texture memory at their first scaled quad (like the FLZ textures while loading): RLE textures
+// keep their format, indexed textures become BGRA_8888. PGL_FALSE if there is no room left.
+static PGLBoolean initScaleSource(pgl_texture_t * t, PGL_SW_Surface * src, PGLFormat * format)
+{
+    PGLBoolean ret = PGL_TRUE;
+    const PGLBoolean indexed = usesPalette(t);
+    if ((t->mEncoding != PGL_ENCODING_RAW) || indexed)
+    {
+        const PGLFormat expandedFormat = indexed ? PGL_FORMAT_BGRA_8888 : t->mFormat;
+        const uint8_t bpp = pgl_helper_getbpp(expandedFormat);
+        const uint32_t bytes = pgl_image_bytes(t->mWidth, t->mHeight, bpp);
+        if (!t->mExpanded)
+        {
+            uint32_t * memory = getTextureMemory(t, bytes);
+            if (!PGL_REQUIRE(memory))
+            {
+                // no room left, the quad isn't drawn
+            }
+            else if (indexed)
+            {
+                expandPalette(t, memory);
+                t->mExpanded = PGL_TRUE;
+            }
+            else
+            {
+                t->mExpanded = PGL_REQUIRE(pgl_decode((uint8_t *)memory, t->mMemoryCapacity, t->mWidth, t->mHeight, bpp, t->mEncoding, t->mData, t->mSize));
+            }
+        }
+        ret = t->mExpanded;
+        if (ret)
+        {
+            src->p = (PGL_SW_Pointer)t->mMemory;
+            src->alignment = (int32_t)(bpp * t->mWidth);
+            src->bytes = (int32_t)bytes;
+            *format = expandedFormat;
+        }
+    }
+    return ret;
+}
+
+// Number of PGL_SW_CRC_TILE tiles which cover the given number of pixels
+static uint32_t countCrcTiles(const uint32_t pixels)
+{
+    return (pixels + PGL_SW_CRC_TILE - 1u) / PGL_SW_CRC_TILE;
+}
+
+// Returns the tile CRCs of the texture (calculated at the first use if the texture hasn't done it while loading), NULL if there is no room left for them
+static const uint32_t * getTileCrcs(pgl_texture_t * t)
+{
+    if (!t->mTileCrcsValid)
+    {
+        const uint32_t count = countCrcTiles(t->mWidth) * countCrcTiles(t->mHeight);
+        if (t->mTileCrcCapacity < count)
+        {
+            // a reloaded texture keeps its CRCs if they still fit, otherwise the block is released
+            t->mTileCrcs = NULL;
+            t->mTileCrcCapacity = 0u;
+            const uint32_t offset = findFreeBlock(t, PGL_FALSE, count, PGL_MAX_TILE_CRCS);
+            if (offset < PGL_MAX_TILE_CRCS)
+            {
+                t->mTileCrcs = &gsTileCrcs[offset];
+                t->mTileCrcCapacity = count;
+            }
+        }
+        if (t->mTileCrcCapacity >= count)
+        {
+            const int32_t alignment = (int32_t)(pgl_helper_getbpp(t->mFormat) * t->mWidth);
+            PGL_SW_Surface src = { (void*)t->mData, 0, 0, (int32_t)t->mWidth, (int32_t)t->mHeight, alignment, (int32_t)t->mSize };
+            pgl_sw_tile_crcs(&src, t->mFormat, PGL_SW_CRC_TILE, t->mTileCrcs);
+            t->mTileCrcsValid = PGL_TRUE;
+        }
+    }
+    return t->mTileCrcsValid ? t->mTileCrcs : NULL;
+}
+
+// PGL_VERIFY_TILE_CRC: the tile CRCs of a raw texture are calculated when it is loaded, not by the first pglVerify.
+// Textures with palettes or RLE data are compared by pixels.
+static void loadTileCrcs(pgl_texture_t * t)
+{
+    if ((t->mVerification == PGL_VERIFY_TILE_CRC) && (t->mEncoding == PGL_ENCODING_RAW) && !pgl_helper_ispalette(t->mFormat))
+    {
+        // no room left for the CRCs: pglVerify compares the pixels
+        (void)getTileCrcs(t);
+    }
+}
+
+// Returns the CRC of the top left tile if pglVerify can compare tile CRCs instead of pixels, otherwise NULL.
+// The texture has to be copied 1:1 without clipping and the texture rect has to start and end at tile borders.
+static const uint32_t * findTileCrcs(const pgl_context_t * ctx, pgl_texture_t * t, const PGL_SW_Surface * dest, const PGL_SW_Surface * src, const PGLFormat destFormat)
+{
+    const uint32_t * crcs = NULL;
+    const int32_t right = src->x + src->w;
+    const int32_t bottom = src->y + src->h;
+    if ((ctx->mVerification == PGL_VERIFY_TILE_CRC) && (t->mEncoding == PGL_ENCODING_RAW) && isCompatibleFormat(t->mFormat, destFormat) && !useBlending(ctx, t) && !isScaled(dest, src)
+        && (dest->x >= ctx->mClip[0]) && (dest->y >= ctx->mClip[1]) && ((dest->x + dest->w) <= ctx->mClip[2]) && ((dest->y + dest->h) <= ctx->mClip[3])
+        && (src->x >= 0) && (src->y >= 0) && (src->w > 0) && (src->h > 0) && (right <= (int32_t)t->mWidth) && (bottom <= (int32_t)t->mHeight)
+        && ((src->x % PGL_SW_CRC_TILE) == 0) && ((src->y % PGL_SW_CRC_TILE) == 0)
+        && (((right % PGL_SW_CRC_TILE) == 0) || (right == (int32_t)t->mWidth)) && (((bottom % PGL_SW_CRC_TILE) == 0) || (bottom == (int32_t)t->mHeight)))
+    {
+        crcs = getTileCrcs(t);
+        if (crcs)
+        {
+            crcs += countCrcTiles(t->mWidth) * (uint32_t)(src->y / PGL_SW_CRC_TILE) + (uint32_t)(src->x / PGL_SW_CRC_TILE);
+        }
+    }
+    return crcs;
+}
+
+// Executes a command for the pixels inside [left, right) x [top, bottom)
+static void executeCommand(const pgl_command_t * cmd, const int32_t left, const int32_t top, const int32_t right, const int32_t bottom)
+{
+    PGL_SW_Surface dest = cmd->mDest;
+    PGL_SW_Surface src = cmd->mSource;
+    if (cmd->mType == PGL_COMMAND_FILL)
+    {
+        if (pgl_sw_clip(&dest, NULL, left, top, right, bottom))
+        {
+            pgl_sw_fill(&dest, cmd->mDestFormat, cmd->mColor[0], cmd->mColor[1], cmd->mColor[2], cmd->mColor[3]);
+        }
+    }
+    else if (cmd->mType == PGL_COMMAND_SCALE)
+    {
+        // the mapping refers to the whole destination rect, only the drawn part is clipped
+        if (pgl_sw_clip(&dest, NULL, left, top, right, bottom))
+        {
+            pgl_sw_bitblit_scale(&dest, cmd->mDestFormat, &src, cmd->mSourceFormat, &cmd->mScale, cmd->mFilter, cmd->mBlend);
+        }
+    }
+    else if (!pgl_sw_clip(&dest, &src, left, top, right, bottom))
+    {
+        // completely outside of the clip area
+    }
+    else if (cmd->mType == PGL_COMMAND_RLE)
+    {
+        pgl_sw_bitblit_rle(&dest, cmd->mDestFormat, &src, cmd->mSourceFormat, cmd->mSwapped, cmd->mBlend);
+    }
+    else if (cmd->mType == PGL_COMMAND_PALETTE)
+    {
+        pgl_sw_bitblit_palette(&dest, cmd->mDestFormat, &src, cmd->mPalette, cmd->mBlend);
+    }
+    else if (cmd->mType == PGL_COMMAND_CONVERT)
+    {
+        pgl_sw_bitblit_convert(&dest, cmd->mDestFormat, &src, cmd->mSourceFormat, cmd->mBlend);
+    }
+    else if (cmd->mType == PGL_COMMAND_BLEND)
+    {
+        pgl_sw_bitblit_blend(&dest, &src, cmd->mSourceFormat);
+    }
+    else
+    {
+        pgl_sw_bitblit_copy(&dest, &src, cmd->mSourceFormat);
+    }
+}
+
+// Executes the recorded commands which intersect one tile, in the order in which they have been recorded
+static void renderTile(void * user, uint32_t job)
+{
+    const pgl_context_t * ctx = (const pgl_context_t *)user;
+    const int32_t columns = ctx->mTiles[2] - ctx->mTiles[0] + 1;
+    const int32_t column = ctx->mTiles[0] + (int32_t)job % columns;
+    const int32_t row = ctx->mTiles[1] + (int32_t)job / columns;
+    const int32_t left = column * PGL_SW_TILE_WIDTH;
+    const int32_t top = row * PGL_SW_TILE_HEIGHT;
+    const int32_t right = left + PGL_SW_TILE_WIDTH;
+    const int32_t bottom = top + PGL_SW_TILE_HEIGHT;
+    for (uint32_t i = 0u; i < ctx->mCommandCount; ++i)
+    {
+        const pgl_command_t * cmd = &ctx->mCommands[i];
+        if ((column >= cmd->mTiles[0]) && (column <= cmd->mTiles[2]) && (row >= cmd->mTiles[1]) && (row <= cmd->mTiles[3]))
+        {
+            executeCommand(cmd,
+                (cmd->mBounds[0] > left) ? cmd->mBounds[0] : left,
+                (cmd->mBounds[1] > top) ? cmd->mBounds[1] : top,
+                (cmd->mBounds[2] < right) ? cmd->mBounds[2] : right,
+                (cmd->mBounds[3] < bottom) ? cmd->mBounds[3] : bottom);
+        }
+    }
+}
+
+// Rasterizes the tiles of the recorded commands with the worker pool and waits until all are done
+static void flushCommands(pgl_context_t * ctx)
+{
+    if (ctx->mCommandCount > 0u)
+    {
+        const uint32_t tiles = (uint32_t)(ctx->mTiles[2] - ctx->mTiles[0] + 1) * (uint32_t)(ctx->mTiles[3] - ctx->mTiles[1] + 1);
+        pgl_sw_pool_run(ctx->mPool, tiles, renderTile, ctx);
+        ctx->mCommandCount = 0u;
+    }
+}
+
+// Executes a command or records it for the tiles of a threaded context. The bounds of the command have to be set.
+static void queueCommand(pgl_context_t * ctx, const pgl_command_t * cmd)
+{
+    if (ctx->mPool == NULL)
+    {
+        executeCommand(cmd, cmd->mBounds[0], cmd->mBounds[1], cmd->mBounds[2], cmd->mBounds[3]);
+    }
+    else
+    {
+        if (ctx->mCommandCount == PGL_MAX_COMMANDS)
+        {
+            flushCommands(ctx);
+        }
+        pgl_command_t * entry = &ctx->mCommands[ctx->mCommandCount++];
+        *entry = *cmd;
+        // binning: the tiles which intersect the bounds
+        entry->mTiles[0] = entry->mBounds[0] / PGL_SW_TILE_WIDTH;
+        entry->mTiles[1] = entry->mBounds[1] / PGL_SW_TILE_HEIGHT;
+        entry->mTiles[2] = (entry->mBounds[2] - 1) / PGL_SW_TILE_WIDTH;
+        entry->mTiles[3] = (entry->mBounds[3] - 1) / PGL_SW_TILE_HEIGHT;
+        if (ctx->mCommandCount == 1u)
+        {
+            memcpy(ctx->mTiles, entry->mTiles, sizeof(ctx->mTiles));
+        }
+        else
+        {
+            ctx->mTiles[0] = (entry->mTiles[0] < ctx->mTiles[0]) ? entry->mTiles[0] : ctx->mTiles[0];
+            ctx->mTiles[1] = (entry->mTiles[1] < ctx->mTiles[1]) ? entry->mTiles[1] : ctx->mTiles[1];
+            ctx->mTiles[2] = (entry->mTiles[2] > ctx->mTiles[2]) ? entry->mTiles[2] : ctx->mTiles[2];
+            ctx->mTiles[3] = (entry->mTiles[3] > ctx->mTiles[3]) ? entry->mTiles[3] : ctx->mTiles[3];
+        }
+    }
+}
+
+// Computes the pixels which are modified by a command (clip area and surface) and draws it or appends it to the recorded list
+static void submitCommand(pgl_context_t * ctx, pgl_command_t * cmd, const int32_t surfaceWidth, const int32_t surfaceHeight)
+{
+    PGL_SW_Surface bounds = cmd->mDest;
+    const int32_t left = (ctx->mClip[0] > 0) ? ctx->mClip[0] : 0;
+    const int32_t top = (ctx->mClip[1] > 0) ? ctx->mClip[1] : 0;
+    const int32_t right = (ctx->mClip[2] < surfaceWidth) ? ctx->mClip[2] : surfaceWidth;
+    const int32_t bottom = (ctx->mClip[3] < surfaceHeight) ? ctx->mClip[3] : surfaceHeight;
+    if ((bounds.w > 0) && (bounds.h > 0) && (left < right) && (top < bottom) && pgl_sw_clip(&bounds, NULL, left, top, right, bottom))
+    {
+        cmd->mBounds[0] = bounds.x;
+        cmd->mBounds[1] = bounds.y;
+        cmd->mBounds[2] = bounds.x + bounds.w;
+        cmd->mBounds[3] = bounds.y + bounds.h;
+        if (ctx->mList == NULL)
+        {
+            queueCommand(ctx, cmd);
+        }
+        else if (ctx->mList->mCount < PGL_MAX_LIST_COMMANDS)
+        {
+            ctx->mList->mCommands[ctx->mList->mCount++] = *cmd;
+        }
+        else
+        {
+            ctx->mList->mComplete = PGL_FALSE; // reported by pglEndList
+        }
+    }
+}
+
+// Prepares a fill of the current surface with the context color, returns PGL_FALSE if there is no valid surface
+static PGLBoolean initFill(const pgl_context_t * ctx, pgl_command_t * cmd, int32_t * surfaceWidth, int32_t * surfaceHeight)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if (PGL_REQUIRE(pglSurfaceToSWSurface(ctx->mSurface, &cmd->mDest, &cmd->mDestFormat)))
+    {
+        *surfaceWidth = cmd->mDest.w;
+        *surfaceHeight = cmd->mDest.h;
+        cmd->mType = PGL_COMMAND_FILL;
+        memcpy(cmd->mColor, ctx->mColor, sizeof(cmd->mColor));
+        ret = PGL_TRUE;
+    }
+    return ret;
+}
+
 void pglDrawArea(PGLContext ctx, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
 {
-    // TODO
+    if (pglIsValidContext(ctx) && pglIsValidSurface(ctx->mSurface, PGL_TRUE))
+    {
+        pgl_command_t cmd;
+        int32_t surfaceWidth;
+        int32_t surfaceHeight;
+        if (initFill(ctx, &cmd, &surfaceWidth, &surfaceHeight))
+        {
+            // same pixel coverage as pglDrawQuad: x2 / y2 is the last pixel inside the area
+            cmd.mDest.x = x1 >> 4u;
+            cmd.mDest.y = y1 >> 4u;
+            cmd.mDest.w = (x2 >> 4u) - cmd.mDest.x + 1;
+            cmd.mDest.h = (y2 >> 4u) - cmd.mDest.y + 1;
+            submitCommand(ctx, &cmd, surfaceWidth, surfaceHeight);
+        }
+    }
 }
 
 void pglClear(PGLContext ctx)
 {
     if (pglIsValidContext(ctx))
     {
-        PGL_SW_Surface dest;
-        PGLFormat destFormat;
-        if (PGL_REQUIRE(pglSurfaceToSWSurface(ctx->mSurface, &dest, &destFormat)))
+        pgl_command_t cmd;
+        int32_t surfaceWidth;
+        int32_t surfaceHeight;
+        if (initFill(ctx, &cmd, &surfaceWidth, &surfaceHeight))
         {
-            // TODO: use color from context
-            memset(dest.p, 0, dest.bytes);
+            submitCommand(ctx, &cmd, surfaceWidth, surfaceHeight);
         }
     }
 }
@@ -204,29 +818,278 @@ void pglDrawQuad(PGLContext ctx, int32_t x1, int32_t y1, int32_t u1, int32_t v1,
 {
     if (pglIsValidContext(ctx))
     {
-        // To do: Add clipping support options
         if (pglIsValidSurface(ctx->mSurface,PGL_TRUE) && pglIsValidTexture(ctx->mTexture, PGL_TRUE)) // we can only draw if we have a surfaqce and a source texture
         {
-            //pgl_surface_t * rt = (pgl_surface_t*)context->mSurface;
-            //PGLSurface s = context->mSurface;
-            PGL_SW_Surface dest;
-            PGLFormat destFormat;
+            pgl_command_t cmd;
             PGLTexture t = ctx->mTexture;
-            if (PGL_REQUIRE(pglSurfaceToSWSurface(ctx->mSurface,&dest,&destFormat) && t && (t->mData))//PGL_REQUIRE(rt && t && (t->mData)) // check for valid pointers
-                && PGL_REQUIRE(t->mFormat == destFormat)) // ensure that we have the same format
+            if (PGL_REQUIRE(pglSurfaceToSWSurface(ctx->mSurface, &cmd.mDest, &cmd.mDestFormat) && t && (t->mData)) // check for valid pointers
+                && PGL_REQUIRE(isDrawable(t, cmd.mDestFormat))) // ensure that we have the same format or can convert it
             {
+                const int32_t surfaceWidth = cmd.mDest.w;
+                const int32_t surfaceHeight = cmd.mDest.h;
                 const int32_t width = ((u2 - u1) >> 4u) + 1;
                 const int32_t height = ((v2 - v1) >> 4u) + 1;
-                dest.x = x1 >> 4u;
-                dest.y = y1 >> 4u;
-                dest.w = width; // we do not support zooming --> use source width
-                dest.h = height; // we do not support zooming --> use source width
-                //PGL_SW_Surface dest = { s->mData, x1 >> 4u, y1 >> 4u, pglSurfaceGetWidth(s), pglSurfaceGetHeight(s),  pglSurfaceGetBPP(s) * pglSurfaceGetWidth(s), pglSurfaceGetMemorySize(s) };
+                cmd.mDest.x = x1 >> 4u;
+                cmd.mDest.y = y1 >> 4u;
+                cmd.mDest.w = ((x2 - x1) >> 4u) + 1;
+                cmd.mDest.h = ((y2 - y1) >> 4u) + 1;
                 PGL_SW_Surface src = { (void*)t->mData, u1 >> 4u, v1 >> 4u,  width, height, pgl_helper_getbpp(t->mFormat) * t->mWidth, t->mSize };
+                cmd.mSource = src;
+                cmd.mSourceFormat = t->mFormat;
+                cmd.mFilter = ctx->mFilter;
+                cmd.mBlend = useBlending(ctx, t);
+                cmd.mSwapped = (t->mEncoding == PGL_ENCODING_RLE2) ? PGL_TRUE : PGL_FALSE;
+                cmd.mPalette = usesPalette(t) ? t->mPalette : NULL;
+
+                if (isScaled(&cmd.mDest, &src))
+                {
+                    cmd.mType = PGL_COMMAND_SCALE;
+                    cmd.mPalette = NULL;
+                    // source coordinates beyond the 16.16 range of the scaler are not drawn
+                    if (initScaleSource(t, &cmd.mSource, &cmd.mSourceFormat) && pgl_sw_scale_init(&cmd.mScale, x1, y1, u1, v1, x2, y2, u2, v2) && (width > 0) && (height > 0))
+                    {
+                        submitCommand(ctx, &cmd, surfaceWidth, surfaceHeight);
+                    }
+                }
+                else if (t->mEncoding != PGL_ENCODING_RAW)
+                {
+                    // RLE rows are decoded while drawing
+                    cmd.mType = PGL_COMMAND_RLE;
+                    submitCommand(ctx, &cmd, surfaceWidth, surfaceHeight);
+                }
+                else if (cmd.mPalette != NULL)
+                {
+                    // the indices are looked up while drawing
+                    cmd.mType = PGL_COMMAND_PALETTE;
+                    submitCommand(ctx, &cmd, surfaceWidth, surfaceHeight);
+                }
+                else
+                {
+                    cmd.mType = needsConversion(t->mFormat, cmd.mDestFormat) ? PGL_COMMAND_CONVERT : (cmd.mBlend ? PGL_COMMAND_BLEND : PGL_COMMAND_COPY);
+                    submitCommand(ctx, &cmd, surfaceWidth, surfaceHeight);
+                }
+            }
+        }
+    }
+}
+
+// The command replaces every pixel inside its bounds, the previous content of the surface doesn't matter
+static PGLBoolean isOpaque(const pgl_command_t * cmd)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if (cmd->mType == PGL_COMMAND_FILL)
+    {
+        ret = PGL_TRUE;
+    }
+    else if (cmd->mType == PGL_COMMAND_RLE)
+    {
+        // the number of rows depends on the encoded data
+    }
+    else if (!cmd->mBlend)
+    {
+        // the kernels skip the pixels of a texture rect which are outside of the texture memory
+        const PGL_SW_Surface * src = &cmd->mSource;
+        const int32_t bpp = pgl_helper_getbpp(cmd->mSourceFormat);
+        ret = ((src->x >= 0) && (src->y >= 0) && ((src->x + src->w) * bpp <= src->alignment) && ((src->y + src->h) * src->alignment <= src->bytes)) ? PGL_TRUE : PGL_FALSE;
+    }
+    else
+    {
+        // blended
+    }
+    return ret;
+}
+
+// The later command 'above' replaces all pixels of 'below'
+static PGLBoolean isOverdrawn(const pgl_command_t * below, const pgl_command_t * above)
+{
+    return (above->mDest.p == below->mDest.p)
+        && (above->mBounds[0] <= below->mBounds[0]) && (above->mBounds[1] <= below->mBounds[1])
+        && (above->mBounds[2] >= below->mBounds[2]) && (above->mBounds[3] >= below->mBounds[3])
+        && isOpaque(above);
+}
+
+// Both commands read the same texture (fills have none)
+static PGLBoolean isSameTexture(const pgl_command_t * a, const pgl_command_t * b)
+{
+    return (a->mType != PGL_COMMAND_FILL) && (b->mType != PGL_COMMAND_FILL) && (a->mSource.p == b->mSource.p) && (a->mPalette == b->mPalette);
+}
+
+// The pixels modified by the commands intersect, so their order matters
+static PGLBoolean isOverlapping(const pgl_command_t * a, const pgl_command_t * b)
+{
+    return (a->mBounds[0] < b->mBounds[2]) && (b->mBounds[0] < a->mBounds[2]) && (a->mBounds[1] < b->mBounds[3]) && (b->mBounds[1] < a->mBounds[3]);
+}
+
+// The destination rect is not clipped (e.g. by the clip area), so it can be extended
+static PGLBoolean isUnclipped(const pgl_command_t * cmd)
+{
+    return (cmd->mDest.x == cmd->mBounds[0]) && (cmd->mDest.y == cmd->mBounds[1])
+        && ((cmd->mDest.x + cmd->mDest.w) == cmd->mBounds[2]) && ((cmd->mDest.y + cmd->mDest.h) == cmd->mBounds[3]);
+}
+
+// Appends 'next' to 'cmd' if both draw the same content into neighbouring rects, which form a rectangle together
+static PGLBoolean mergeCommands(pgl_command_t * cmd, const pgl_command_t * next)
+{
+    const int32_t * a = cmd->mBounds;
+    const int32_t * b = next->mBounds;
+    const PGLBoolean horizontal = (a[1] == b[1]) && (a[3] == b[3]) && (a[2] == b[0]);
+    const PGLBoolean vertical = (a[0] == b[0]) && (a[2] == b[2]) && (a[3] == b[1]);
+    PGLBoolean ret = PGL_FALSE;
+    if ((horizontal || vertical) && (cmd->mType == next->mType) && (cmd->mDest.p == next->mDest.p) && (cmd->mDestFormat == next->mDestFormat))
+    {
+        if (cmd->mType == PGL_COMMAND_FILL)
+        {
+            ret = (memcmp(cmd->mColor, next->mColor, sizeof(cmd->mColor)) == 0) ? PGL_TRUE : PGL_FALSE;
+        }
+        else if (cmd->mType != PGL_COMMAND_SCALE)
+        {
+            // the texture continues at the same offset
+            ret = (cmd->mSource.p == next->mSource.p) && (cmd->mSource.alignment == next->mSource.alignment)
+                && (cmd->mSourceFormat == next->mSourceFormat) && (cmd->mBlend == next->mBlend) && (cmd->mPalette == next->mPalette)
+                && isUnclipped(cmd) && isUnclipped(next)
+                && ((next->mSource.x - cmd->mSource.x) == (b[0] - a[0])) && ((next->mSource.y - cmd->mSource.y) == (b[1] - a[1]));
+        }
+        else
+        {
+            // the mapping of scaled quads depends on the whole rect
+        }
+    }
+    if (ret)
+    {
+        cmd->mBounds[2] = b[2];
+        cmd->mBounds[3] = b[3];
+        cmd->mDest.w = cmd->mBounds[2] - cmd->mDest.x;
+        cmd->mDest.h = cmd->mBounds[3] - cmd->mDest.y;
+        cmd->mSource.w = cmd->mDest.w;
+        cmd->mSource.h = cmd->mDest.h;
+    }
+    return ret;
+}
+
+PGLList pglCreateList(PGLContext context)
+{
+    PGLList retVal = NULL;
+
+    if (pglIsValidContext(context) && PGL_REQUIRE(gsCurrentList < PGL_MAX_LISTS)) // do we run out of lists?
+    {
+        retVal = &gsLists[gsCurrentList++];
+        retVal->mValid = PGL_TRUE;
+        retVal->mCount = 0u;
+        retVal->mSurface = NULL;
+        retVal->mComplete = PGL_FALSE;
+    }
+
+    return retVal;
+}
 
-                pgl_sw_bitblit_copy(&dest, &src, t->mFormat);
+PGLBoolean pglBeginList(PGLContext context, PGLList list)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if (pglIsValidContext(context) && pglIsValidList(list) && PGL_REQUIRE(context->mList == NULL) && pglIsValidSurface(context->mSurface, PGL_TRUE))
+    {
+        list->mCount = 0u;
+        list->mSurface = context->mSurface;
+        list->mComplete = PGL_TRUE;
+        context->mList = list;
+        ret = PGL_TRUE;
+    }
+    return ret;
+}
+
+PGLBoolean pglEndList(PGLContext context)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if (pglIsValidContext(context) && PGL_REQUIRE(context->mList != NULL))
+    {
+        pgl_list_t * list = context->mList;
+        pgl_command_t * cmds = list->mCommands;
+        uint32_t count = 0u;
+        // drop the commands which are completely overdrawn by a later one (e.g. a clear below a fullscreen background)
+        for (uint32_t i = 0u; i < list->mCount; ++i)
+        {
+            PGLBoolean visible = PGL_TRUE;
+            for (uint32_t j = i + 1u; visible && (j < list->mCount); ++j)
+            {
+                visible = !isOverdrawn(&cmds[i], &cmds[j]);
+            }
+            if (visible)
+            {
+                cmds[count++] = cmds[i];
+            }
+        }
+        list->mCount = count;
+        // group the commands of one texture (like the GLES2 lists): a command is moved up behind the previous command
+        // with the same texture if it doesn't overlap the commands in between, the texture stays in the cache and more commands can be merged
+        for (uint32_t i = 0u; (i + 1u) < list->mCount; ++i)
+        {
+            uint32_t j = i + 1u;
+            while ((j < list->mCount) && !isSameTexture(&cmds[i], &cmds[j]))
+            {
+                ++j;
+            }
+            uint32_t k = i + 1u;
+            while ((j < list->mCount) && (k < j) && !isOverlapping(&cmds[k], &cmds[j]))
+            {
+                ++k;
+            }
+            if ((j < list->mCount) && (j > (i + 1u)) && (k == j))
+            {
+                const pgl_command_t cmd = cmds[j];
+                memmove(&cmds[i + 2u], &cmds[i + 1u], (j - i - 1u) * sizeof(pgl_command_t));
+                cmds[i + 1u] = cmd;
             }
         }
+        // merge neighbouring commands with the same content (e.g. tiles of one texture or stripes of one color)
+        count = 0u;
+        for (uint32_t i = 0u; i < list->mCount; ++i)
+        {
+            if ((count == 0u) || !mergeCommands(&cmds[count - 1u], &cmds[i]))
+            {
+                cmds[count++] = cmds[i];
+            }
+        }
+        list->mCount = count;
+        context->mList = NULL;
+        ret = list->mComplete;
+    }
+    return ret;
+}
+
+PGLBoolean pglSubmit(PGLContext context, PGLList list)
+{
+    PGLBoolean ret = PGL_FALSE;
+    if (pglIsValidContext(context) && pglIsValidList(list) && PGL_REQUIRE(context->mList == NULL) && PGL_REQUIRE(list->mComplete)
+        && pglSetSurface(context, list->mSurface))
+    {
+        PGL_SW_Surface surface;
+        if (PGL_REQUIRE(pglSurfaceToSWSurface(list->mSurface, &surface, NULL)))
+        {
+            for (uint32_t i = 0u; i < list->mCount; ++i)
+            {
+                // the commands draw into the current back buffer, which differs from the one at recording after a buffer flip
+                pgl_command_t cmd = list->mCommands[i];
+                cmd.mDest.p = surface.p;
+                queueCommand(context, &cmd);
+            }
+            ret = PGL_TRUE;
+        }
+    }
+    return ret;
+}
+
+uint32_t pglGetListCount(PGLList list)
+{
+    return pglIsValidList(list) ? list->mCount : 0u;
+}
+
+void pglFlushSurface(PGLSurface surface)
+{
+    for (uint8_t i = 0u; i < gsCurrentContext; ++i)
+    {
+        if (gsContexts[i].mValid && (gsContexts[i].mSurface == surface))
+        {
+            flushCommands(&gsContexts[i]);
+        }
     }
 }
 
@@ -235,7 +1098,7 @@ PGLBoolean pglVerify(PGLContext ctx, int32_t x1, int32_t y1, int32_t u1, int32_t
     PGLBoolean verified = PGL_FALSE;
     if (pglIsValidContext(ctx))
     {
-        // To do: Add clipping support options
+        pglFlushSurface(ctx->mSurface); // the drawing commands of threaded contexts have to be finished
         if (pglIsValidSurface(ctx->mSurface,PGL_TRUE) && pglIsValidTexture(ctx->mTexture, PGL_TRUE)) // we can only draw if we have a surfaqce and a source texture
         {
             //pgl_surface_t * rt = (pgl_surface_t*)context->mSurface;
@@ -243,17 +1106,60 @@ PGLBoolean pglVerify(PGLContext ctx, int32_t x1, int32_t y1, int32_t u1, int32_t
             PGL_SW_Surface dest;
             PGLFormat destFormat;
             PGLTexture t = ctx->mTexture;
-            if (pglSurfaceToSWSurface(ctx->mSurface,&dest,&destFormat) && t && (t->mData) && (t->mFormat == destFormat)) // ensure that we have the same format
+            if (pglSurfaceToSWSurface(ctx->mSurface,&dest,&destFormat) && t && (t->mData) && isDrawable(t, destFormat)) // ensure that we have the same format or can convert it
             {
                 const int32_t width = ((u2 - u1) >> 4u) + 1;
                 const int32_t height = ((v2 - v1) >> 4u) + 1;
                 dest.x = x1 >> 4u;
                 dest.y = y1 >> 4u;
-                dest.w = width; // we do not support zooming --> use source width
-                dest.h = height; // we do not support zooming --> use source width
+                dest.w = ((x2 - x1) >> 4u) + 1;
+                dest.h = ((y2 - y1) >> 4u) + 1;
                 PGL_SW_Surface src = { (void*)t->mData, u1 >> 4u, v1 >> 4u,  width, height, pgl_helper_getbpp(t->mFormat) * t->mWidth, t->mSize };
 
-                verified = (pgl_sw_compare(&dest, &src, t->mFormat) > 0) ? PGL_FALSE : PGL_TRUE;
+                const uint32_t * crcs = findTileCrcs(ctx, t, &dest, &src, destFormat);
+                if (crcs)
+                {
+                    // the surface is hashed, the texture pixels aren't read
+                    verified = pgl_sw_equal_crc(&dest, destFormat, PGL_SW_CRC_TILE, crcs, (int32_t)countCrcTiles(t->mWidth));
+                }
+                else if (isScaled(&dest, &src))
+                {
+                    PGL_SW_Scale scale;
+                    PGLFormat format = t->mFormat;
+                    if (!initScaleSource(t, &src, &format) || !pgl_sw_scale_init(&scale, x1, y1, u1, v1, x2, y2, u2, v2) || (width <= 0) || (height <= 0))
+                    {
+                        // nothing has been drawn
+                    }
+                    else if (!pgl_sw_clip(&dest, NULL, ctx->mClip[0], ctx->mClip[1], ctx->mClip[2], ctx->mClip[3]))
+                    {
+                        // completely clipped: no pixel has been compared, so nothing is verified
+                    }
+                    else
+                    {
+                        verified = pgl_sw_equal_scale(&dest, destFormat, &src, format, &scale, ctx->mFilter, useBlending(ctx, t));
+                    }
+                }
+                // only the pixels inside the clip area have been drawn
+                else if (!pgl_sw_clip(&dest, &src, ctx->mClip[0], ctx->mClip[1], ctx->mClip[2], ctx->mClip[3]))
+                {
+                    // completely clipped: no pixel has been compared, so nothing is verified
+                }
+                else if (usesPalette(t))
+                {
+                    verified = pgl_sw_equal_palette(&dest, destFormat, &src, t->mPalette, useBlending(ctx, t));
+                }
+                else if (t->mEncoding != PGL_ENCODING_RAW)
+                {
+                    verified = pgl_sw_equal_rle(&dest, destFormat, &src, t->mFormat, (t->mEncoding == PGL_ENCODING_RLE2) ? PGL_TRUE : PGL_FALSE, useBlending(ctx, t));
+                }
+                else if (needsConversion(t->mFormat, destFormat))
+                {
+                    verified = pgl_sw_equal_convert(&dest, destFormat, &src, t->mFormat, useBlending(ctx, t));
+                }
+                else
+                {
+                    verified = useBlending(ctx, t) ? pgl_sw_equal_opaque(&dest, &src, t->mFormat) : pgl_sw_equal(&dest, &src, t->mFormat);
+                }
             }
         }
     }
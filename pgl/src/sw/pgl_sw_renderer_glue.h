@@ -31,6 +31,15 @@
 
 #define PGL_MAX_CONTEXTS 4
 #define PGL_MAX_TEXTURES 64
+#define PGL_MAX_COMMANDS 128 // recorded drawing commands per threaded context, a full list is executed immediately
+#define PGL_SW_TILE_WIDTH 128 // tile size in pixels of threaded contexts
+#define PGL_SW_TILE_HEIGHT 32
+#define PGL_MAX_LISTS 4
+#define PGL_MAX_LIST_COMMANDS 64 // drawing commands of one display list (after pglEndList fewer may remain)
+#define PGL_SW_CRC_TILE 16 // tile size in pixels of PGL_VERIFY_TILE_CRC
+#define PGL_MAX_TILE_CRCS 4096 // tile CRCs of all textures, textures without room are verified pixel by pixel
+#define PGL_SW_TEXTURE_MEMORY (512u * 1024u) // bytes of all decompressed textures (PGL_ENCODING_FLZ), RLE textures are drawn from the encoded data
+#define PGL_MAX_PALETTES 16 // indexed textures (PGL_FORMAT_P_8_*), each palette takes 1 KB
 
 
 #ifdef __cplusplus
@@ -52,8 +61,29 @@ PGLBoolean pglIsValidContext(PGLContext context);
 */
 PGLBoolean pglIsValidTexture(PGLTexture texture, PGLBoolean check4content);
 
-PGLContext pglCreateContext(void);
+/**
+* Checks if the passed in display list is valid
+* @param list the list which to check for validity
+* @return returns PGL_TRUE if the list is valid
+*/
+PGLBoolean pglIsValidList(PGLList list);
+
+/**
+* Returns the number of commands of a display list, which remain after the optimization in pglEndList
+* Can be used by tests to check that overdrawn commands have been dropped and neighbouring ones merged.
+*/
+uint32_t pglGetListCount(PGLList list);
+
+PGLContext pglCreateContext(const PGLContextConfig* config);
 PGLBoolean pglSetSurface(PGLContext context, PGLSurface surface);
+
+/**
+* Executes the recorded drawing commands of all threaded contexts which render into the surface and waits until they are done.
+* Called by the platform before the surface content is presented.
+* @param surface the surface which is about to be read
+*/
+void pglFlushSurface(PGLSurface surface);
+
 PGLTexture pglCreateTexture(PGLContext context);
 PGLBoolean pglLoadTexture(PGLTexture texture, uint32_t width, uint32_t height, PGLFormat format, PGLBoolean copy, const void* data);
 void pglBindTexture(PGLContext context, PGLTexture t);
@@ -0,0 +1,133 @@
+/******************************************************************************
+**
+**   File:        pgl_sw_swapchain.c
+**   Description: Framebuffers of a SW window which are rotated by pglSwapBuffers
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Render.
+**
+**   Safe Render is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Render is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Render.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include "pgl_sw_swapchain.h"
+#include "pgl_assert.h"
+
+#include <string.h>
+
+static int32_t clampValue(int32_t value, int32_t max)
+{
+    return (value < 0) ? 0 : ((value > max) ? max : value);
+}
+
+// Stores the changed rects of a frame in pixels, limited to the buffer
+static void setDamage(const PGL_SW_Swapchain *chain, PGL_SW_Damage *damage, const PGLRect *rects, uint32_t count)
+{
+    damage->mFull = ((rects == NULL) || (count == 0u) || (count > PGL_SW_MAX_DAMAGE_RECTS)) ? PGL_TRUE : PGL_FALSE;
+    damage->mCount = 0u;
+    for (uint32_t i = 0u; !damage->mFull && (i < count); ++i)
+    {
+        int32_t * r = damage->mRects[damage->mCount];
+        r[0] = clampValue(rects[i].x1 >> 4, chain->mWidth);
+        r[1] = clampValue(rects[i].y1 >> 4, chain->mHeight);
+        r[2] = clampValue((rects[i].x2 >> 4) + 1, chain->mWidth);
+        r[3] = clampValue((rects[i].y2 >> 4) + 1, chain->mHeight);
+        if ((r[0] < r[2]) && (r[1] < r[3]))
+        {
+            ++damage->mCount;
+        }
+    }
+}
+
+// Copies the pixels inside [left, right) x [top, bottom), returns the number of copied bytes
+static uint32_t copyRect(const PGL_SW_Swapchain *chain, PGL_SW_Pointer dest, const uint8_t *src, const int32_t *r)
+{
+    const size_t offset = (size_t)(r[1] * chain->mAlignment + r[0] * chain->mBpp);
+    const size_t bytes = (size_t)((r[2] - r[0]) * chain->mBpp);
+    for (int32_t y = r[1]; y < r[3]; ++y)
+    {
+        const size_t line = offset + (size_t)((y - r[1]) * chain->mAlignment);
+        memcpy(dest + line, src + line, bytes);
+    }
+    return (uint32_t)bytes * (uint32_t)(r[3] - r[1]);
+}
+
+void pgl_sw_swapchain_init(PGL_SW_Swapchain *chain, const PGL_SW_Pointer *buffers, uint32_t count, int32_t width, int32_t height, int32_t bpp)
+{
+    memset(chain, 0, sizeof(*chain));
+    chain->mCount = (count < PGL_SW_MAX_BUFFERS) ? count : PGL_SW_MAX_BUFFERS;
+    for (uint32_t i = 0u; i < chain->mCount; ++i)
+    {
+        chain->mBuffers[i] = buffers[i];
+    }
+    chain->mWidth = width;
+    chain->mHeight = height;
+    chain->mBpp = bpp;
+    chain->mAlignment = width * bpp;
+}
+
+PGL_SW_Pointer pgl_sw_swapchain_back(const PGL_SW_Swapchain *chain)
+{
+    return (chain->mCount > 0u) ? chain->mBuffers[chain->mBack] : NULL;
+}
+
+PGL_SW_Pointer pgl_sw_swapchain_front(const PGL_SW_Swapchain *chain)
+{
+    return (chain->mCount > 0u) ? chain->mBuffers[(chain->mBack + chain->mCount - 1u) % chain->mCount] : NULL;
+}
+
+void pgl_sw_swapchain_swap(PGL_SW_Swapchain *chain, const PGLRect *rects, uint32_t count)
+{
+    chain->mCopiedBytes = 0u;
+    if (PGL_REQUIRE(chain->mCount > 0u))
+    {
+        const uint32_t frame = ++chain->mFrame;
+        const PGL_SW_Pointer front = chain->mBuffers[chain->mBack];
+        setDamage(chain, &chain->mDamage[frame % PGL_SW_MAX_BUFFERS], rects, count);
+        chain->mContent[chain->mBack] = frame;
+        chain->mBack = (chain->mBack + 1u) % chain->mCount;
+
+        if (chain->mCount > 1u)
+        {
+            // the new back buffer misses the frames after its content, at most mCount - 1 (all of them are in mDamage)
+            const PGL_SW_Pointer back = chain->mBuffers[chain->mBack];
+            const uint32_t missing = frame - chain->mContent[chain->mBack];
+            PGLBoolean full = (missing >= PGL_SW_MAX_BUFFERS) ? PGL_TRUE : PGL_FALSE;
+            for (uint32_t f = frame - missing + 1u; !full && (f <= frame); ++f)
+            {
+                full = chain->mDamage[f % PGL_SW_MAX_BUFFERS].mFull;
+            }
+            if (full)
+            {
+                const int32_t all[4] = { 0, 0, chain->mWidth, chain->mHeight };
+                chain->mCopiedBytes = copyRect(chain, back, front, all);
+            }
+            else
+            {
+                for (uint32_t f = frame - missing + 1u; f <= frame; ++f)
+                {
+                    const PGL_SW_Damage * damage = &chain->mDamage[f % PGL_SW_MAX_BUFFERS];
+                    for (uint32_t i = 0u; i < damage->mCount; ++i)
+                    {
+                        chain->mCopiedBytes += copyRect(chain, back, front, damage->mRects[i]);
+                    }
+                }
+            }
+            chain->mContent[chain->mBack] = frame;
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef PGL_SW_SWAPCHAIN_H
+#define PGL_SW_SWAPCHAIN_H
+
+/******************************************************************************
+**
+**   File:        pgl_sw_swapchain.h
+**   Description: Framebuffers of a SW window which are rotated by pglSwapBuffers
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include "pgl.h"
+#include "pgl_sw_renderer.h"
+
+#define PGL_SW_MAX_BUFFERS 3 // triple buffering
+#define PGL_SW_MAX_DAMAGE_RECTS 16 // changed rects per frame, a frame with more is copied completely
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The pixels which have changed in one frame
+typedef struct
+{
+    PGLBoolean mFull; // the whole buffer, mRects is not used
+    uint32_t mCount;
+    int32_t mRects[PGL_SW_MAX_DAMAGE_RECTS][4]; // left, top, right, bottom in pixels (right and bottom are excluded)
+} PGL_SW_Damage;
+
+/**
+ * The window content is rendered into the back buffer, the front buffer is presented. A swap makes the back buffer the
+ * front buffer (pointer flip) and the next buffer of the chain the new back buffer. As the callers only redraw the
+ * changed parts of a frame (pglSwapBuffersRegion), the new back buffer is brought up to date by copying the rects which
+ * changed since its content was presented from the front buffer, instead of the whole frame.
+ */
+typedef struct
+{
+    PGL_SW_Pointer mBuffers[PGL_SW_MAX_BUFFERS];
+    uint32_t mCount;
+    uint32_t mBack;
+    uint32_t mFrame; // number of swaps
+    uint32_t mContent[PGL_SW_MAX_BUFFERS]; // the frame which is contained in each buffer
+    PGL_SW_Damage mDamage[PGL_SW_MAX_BUFFERS]; // of the last frames, the frame f is at f % PGL_SW_MAX_BUFFERS
+    int32_t mWidth;
+    int32_t mHeight;
+    int32_t mAlignment; // bytes per line
+    int32_t mBpp;
+    uint32_t mCopiedBytes; // by the last swap
+} PGL_SW_Swapchain;
+
+/**
+ * Initializes a chain of buffers with identical content (e.g. all cleared)
+ * @param buffers count pointers to width * height pixels, the memory is owned by the caller
+ * @param count number of buffers, 1 renders directly into the presented buffer (limited to PGL_SW_MAX_BUFFERS)
+ */
+void pgl_sw_swapchain_init(PGL_SW_Swapchain *chain, const PGL_SW_Pointer *buffers, uint32_t count, int32_t width, int32_t height, int32_t bpp);
+
+/**
+ * Returns the buffer which is rendered
+ */
+PGL_SW_Pointer pgl_sw_swapchain_back(const PGL_SW_Swapchain *chain);
+
+/**
+ * Returns the buffer which has been presented by the last swap (the back buffer if there is only one)
+ */
+PGL_SW_Pointer pgl_sw_swapchain_front(const PGL_SW_Swapchain *chain);
+
+/**
+ * Presents the back buffer and rotates the buffers
+ * @param rects the changed parts of the presented frame (28.4 fixed point, x2 / y2 included), NULL if everything changed
+ * @param count number of rectangles, 0 if everything changed
+ */
+void pgl_sw_swapchain_swap(PGL_SW_Swapchain *chain, const PGLRect *rects, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PGL_SW_SWAPCHAIN_H
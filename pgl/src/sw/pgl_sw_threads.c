@@ -0,0 +1,185 @@
+/******************************************************************************
+**
+**   File:        pgl_sw_threads.c
+**   Description: Fixed worker thread pools for the tiled SW renderer
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Render.
+**
+**   Safe Render is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Render is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Render.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include "pgl_sw_threads.h"
+#include "pgl_assert.h"
+
+#include <stddef.h>
+
+#ifdef PGL_SW_THREADS
+
+#include <pthread.h>
+
+struct pgl_sw_pool_t
+{
+    pthread_t mWorkers[PGL_SW_MAX_THREADS - 1];
+    uint32_t mThreads; // workers + calling thread
+    pthread_mutex_t mLock; // protects all members below
+    pthread_cond_t mStart; // signaled when a new batch of jobs is available
+    pthread_cond_t mDone; // signaled when the last worker has finished the batch
+    uint32_t mBatch; // incremented for every pgl_sw_pool_run call
+    uint32_t mBusy; // number of workers which haven't finished the current batch
+    uint32_t mNext; // next job to hand out
+    uint32_t mCount;
+    PGL_SW_Job mJob;
+    void * mUser;
+};
+
+static struct pgl_sw_pool_t gsPools[PGL_SW_MAX_POOLS];
+static uint32_t gsCurrentPool = 0u;
+
+// Hands out the jobs of the current batch until none are left
+static void runJobs(struct pgl_sw_pool_t *pool)
+{
+    pthread_mutex_lock(&pool->mLock);
+    while (pool->mNext < pool->mCount)
+    {
+        const uint32_t job = pool->mNext++;
+        pthread_mutex_unlock(&pool->mLock);
+        pool->mJob(pool->mUser, job);
+        pthread_mutex_lock(&pool->mLock);
+    }
+    pthread_mutex_unlock(&pool->mLock);
+}
+
+static void * workerMain(void *arg)
+{
+    struct pgl_sw_pool_t * pool = (struct pgl_sw_pool_t *)arg;
+    uint32_t batch = 0u;
+    for (;;)
+    {
+        pthread_mutex_lock(&pool->mLock);
+        while (pool->mBatch == batch)
+        {
+            pthread_cond_wait(&pool->mStart, &pool->mLock);
+        }
+        batch = pool->mBatch;
+        pthread_mutex_unlock(&pool->mLock);
+
+        runJobs(pool);
+
+        pthread_mutex_lock(&pool->mLock);
+        if (--pool->mBusy == 0u)
+        {
+            pthread_cond_signal(&pool->mDone);
+        }
+        pthread_mutex_unlock(&pool->mLock);
+    }
+    return NULL;
+}
+
+PGL_SW_Pool * pgl_sw_pool_create(uint32_t threads)
+{
+    PGL_SW_Pool * retVal = NULL;
+    threads = (threads < PGL_SW_MAX_THREADS) ? threads : PGL_SW_MAX_THREADS;
+    if ((threads > 1u) && PGL_REQUIRE(gsCurrentPool < PGL_SW_MAX_POOLS)) // do we run out of pools?
+    {
+        retVal = &gsPools[gsCurrentPool++];
+        retVal->mThreads = 1u;
+        retVal->mBatch = 0u;
+        retVal->mBusy = 0u;
+        retVal->mNext = 0u;
+        retVal->mCount = 0u;
+        retVal->mJob = NULL;
+        retVal->mUser = NULL;
+        pthread_mutex_init(&retVal->mLock, NULL);
+        pthread_cond_init(&retVal->mStart, NULL);
+        pthread_cond_init(&retVal->mDone, NULL);
+        // a worker which can't be started reduces the parallelism, the jobs are still executed by the calling thread
+        while ((retVal->mThreads < threads) && (pthread_create(&retVal->mWorkers[retVal->mThreads - 1u], NULL, workerMain, retVal) == 0))
+        {
+            ++retVal->mThreads;
+        }
+    }
+    return retVal;
+}
+
+uint32_t pgl_sw_pool_threads(const PGL_SW_Pool *pool)
+{
+    return pool ? pool->mThreads : 1u;
+}
+
+void pgl_sw_pool_run(PGL_SW_Pool *pool, uint32_t count, PGL_SW_Job job, void *user)
+{
+    PGL_ASSERT(job);
+    if (pool && (pool->mThreads > 1u) && (count > 1u))
+    {
+        pthread_mutex_lock(&pool->mLock);
+        pool->mJob = job;
+        pool->mUser = user;
+        pool->mNext = 0u;
+        pool->mCount = count;
+        pool->mBusy = pool->mThreads - 1u;
+        ++pool->mBatch;
+        pthread_cond_broadcast(&pool->mStart);
+        pthread_mutex_unlock(&pool->mLock);
+
+        runJobs(pool);
+
+        // join: the results of all jobs are visible after the workers released the lock
+        pthread_mutex_lock(&pool->mLock);
+        while (pool->mBusy > 0u)
+        {
+            pthread_cond_wait(&pool->mDone, &pool->mLock);
+        }
+        pthread_mutex_unlock(&pool->mLock);
+    }
+    else
+    {
+        for (uint32_t i = 0u; i < count; ++i)
+        {
+            job(user, i);
+        }
+    }
+}
+
+#else // PGL_SW_THREADS
+
+// No threading support on this platform: every context renders on the calling thread
+
+PGL_SW_Pool * pgl_sw_pool_create(uint32_t threads)
+{
+    (void)threads;
+    return NULL;
+}
+
+uint32_t pgl_sw_pool_threads(const PGL_SW_Pool *pool)
+{
+    (void)pool;
+    return 1u;
+}
+
+void pgl_sw_pool_run(PGL_SW_Pool *pool, uint32_t count, PGL_SW_Job job, void *user)
+{
+    PGL_ASSERT(job);
+    (void)pool;
+    for (uint32_t i = 0u; i < count; ++i)
+    {
+        job(user, i);
+    }
+}
+
+#endif // PGL_SW_THREADS
@@ -0,0 +1,70 @@
+#ifndef PGL_SW_THREADS_H
+#define PGL_SW_THREADS_H
+
+/******************************************************************************
+**
+**   File:        pgl_sw_threads.h
+**   Description: Fixed worker thread pools for the tiled SW renderer
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include "pgl.h"
+
+#define PGL_SW_MAX_THREADS 8 // including the thread which submits the jobs
+#define PGL_SW_MAX_POOLS 4
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct pgl_sw_pool_t PGL_SW_Pool;
+
+/**
+ * Processes one job of pgl_sw_pool_run, called concurrently for different jobs
+ */
+typedef void (*PGL_SW_Job)(void *user, uint32_t job);
+
+/**
+ * Starts a pool of worker threads. The threads are never stopped, pools are taken from a static array.
+ * Only available if the library is built with PGL_SW_THREADS (pthreads).
+ * @param threads number of threads which process the jobs of pgl_sw_pool_run, including the calling thread (limited to PGL_SW_MAX_THREADS)
+ * @return NULL if threads < 2, threading is not supported or all pools are in use
+ */
+PGL_SW_Pool * pgl_sw_pool_create(uint32_t threads);
+
+/**
+ * Returns the number of threads of the pool (including the calling thread), 1 for a NULL pool
+ */
+uint32_t pgl_sw_pool_threads(const PGL_SW_Pool *pool);
+
+/**
+ * Executes the jobs 0 ... count - 1 on the calling thread and the workers of the pool and returns when all jobs are done.
+ * The jobs are handed out one by one, so slow jobs don't stall the other threads. A NULL pool executes the jobs in order on the calling thread.
+ * Must not be called concurrently for the same pool.
+ */
+void pgl_sw_pool_run(PGL_SW_Pool *pool, uint32_t count, PGL_SW_Job job, void *user);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PGL_SW_THREADS_H
@@ -30,8 +30,11 @@
 // --> We have functions to get memory pointers - render targets (platform dependent)
 
 #include "pgl_win32.h"
+#include "pgl_sw_renderer_glue.h"
 #include "pgl_sw_renderer.h"
+#include "pgl_sw_swapchain.h"
 #include "pgl_assert.h"
+#include "crc32.h"
 
 /*  Trim fat from windows*/
 #define WIN32_LEAN_AND_MEAN
@@ -42,12 +45,18 @@
 #include <stdlib.h>
 #include <malloc.h>
 
+// the window paints the front buffer while the next frame is rendered into the back buffer
+#ifndef PGL_WIN32_BUFFERS
+#define PGL_WIN32_BUFFERS 2
+#endif
+
 typedef struct pgl_surface_t
 {
     HWND mHWND;
     BITMAPINFO mBitmapInfo;
-    uint8_t * mBitmapMemory;
-    uint32_t mSize; // Size in memory in bytes
+    uint8_t * mBitmapMemory; // all buffers of the chain
+    PGL_SW_Swapchain mSwapchain;
+    uint32_t mSize; // Size in memory in bytes (of one buffer)
     PGLFormat mFormat;
     PGLBoolean mValid;
 } pgl_surface_t;
@@ -68,8 +77,7 @@ static PGLBoolean   windowClassTypeRegistered = PGL_FALSE;              //flag s
 static pgl_surface_t gsSurfaces[PGL_MAX_SURFACES] = { 0 };
 
 /*  Windows Procedure Event Handler*/
-// As we have no synchronisation or double buffering between the threads we may get tearing artifacts visible in the window
-// As we do not do animations and fast updates this problem can't happen
+// The front buffer is painted, it isn't modified until the next swap (with PGL_WIN32_BUFFERS > 1)
 LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
     PAINTSTRUCT paintStruct;
@@ -105,7 +113,7 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
                 0,
                 0,
                 -rt->mBitmapInfo.bmiHeader.biHeight,
-                rt->mBitmapMemory,
+                pgl_sw_swapchain_front(&rt->mSwapchain),
                 (const BITMAPINFO*)&rt->mBitmapInfo,
                 DIB_RGB_COLORS
             );
@@ -127,6 +135,7 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
 
 void pglInit(void)
 {
+    initCrc32(); // selects the CRC instructions of the CPU (PGL_VERIFY_TILE_CRC)
     // Under windows this is used to register the window class type and checks are performed that the method is only called once!
     if (PGL_REQUIRE(!windowClassTypeRegistered)) // Ensure that it is not called twice
     {
@@ -206,7 +215,16 @@ PGLSurface pglCreateWindow(uint8_t window, int32_t x, int32_t y, int32_t w, int3
             retVal->mValid = PGL_FALSE;
             retVal->mSize = w*h * sizeof(uint32_t);
             retVal->mFormat = PGL_FORMAT_BGRA_8888;
-            retVal->mBitmapMemory = malloc(retVal->mSize); // for simplicity under windows always 4 bpp (32 bits) are allocated (as being the maximum format)
+            retVal->mBitmapMemory = calloc(retVal->mSize, PGL_WIN32_BUFFERS); // for simplicity under windows always 4 bpp (32 bits) are allocated (as being the maximum format)
+            if (retVal->mBitmapMemory)
+            {
+                PGL_SW_Pointer buffers[PGL_WIN32_BUFFERS];
+                for (uint32_t i = 0u; i < PGL_WIN32_BUFFERS; ++i)
+                {
+                    buffers[i] = retVal->mBitmapMemory + i * retVal->mSize;
+                }
+                pgl_sw_swapchain_init(&retVal->mSwapchain, buffers, PGL_WIN32_BUFFERS, w, h, pgl_helper_getbpp(retVal->mFormat));
+            }
             bmi = &retVal->mBitmapInfo;
             bmi->bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
             bmi->bmiHeader.biWidth = w;
@@ -241,12 +259,43 @@ PGLBoolean pglSwapBuffers(PGLSurface surface)
     PGLBoolean retVal = pglIsValidSurface(surface,PGL_TRUE);
     if (retVal && surface)
     {
+        pglFlushSurface(surface);
+        pgl_sw_swapchain_swap(&surface->mSwapchain, NULL, 0u);
         InvalidateRect(surface->mHWND, NULL, TRUE);
-        // As it is for manual debugging only (windows output) we take seldom tearing artifacts in account and it is OK (just in case of heavy drawing operations and single buffering)
     }
     return retVal;
 }
 
+PGLBoolean pglSwapBuffersRegion(PGLSurface surface, const PGLRect* rects, uint32_t count)
+{
+    PGLBoolean retVal = pglIsValidSurface(surface,PGL_TRUE);
+    if (retVal && surface)
+    {
+        pglFlushSurface(surface);
+        pgl_sw_swapchain_swap(&surface->mSwapchain, rects, count); // only the rects are copied into the next back buffer
+        if ((rects == NULL) || (count == 0u))
+        {
+            InvalidateRect(surface->mHWND, NULL, TRUE);
+        }
+        else
+        {
+            for (uint32_t i = 0u; i < count; ++i)
+            {
+                // RECT excludes right and bottom
+                RECT r = { rects[i].x1 >> 4, rects[i].y1 >> 4, (rects[i].x2 >> 4) + 1, (rects[i].y2 >> 4) + 1 };
+                InvalidateRect(surface->mHWND, &r, TRUE);
+            }
+        }
+    }
+    return retVal;
+}
+
+PGLBoolean pglIsBufferPreserved(PGLSurface surface)
+{
+    // the swap chain copies the changed parts into the next back buffer
+    return pglIsValidSurface(surface, PGL_TRUE);
+}
+
 PGLBoolean pglHandleWindowEvents(PGLContext context)
 {
     MSG msg;
@@ -279,7 +328,7 @@ PGLBoolean pglSurfaceToSWSurface(PGLSurface s, PGL_SW_Surface * swsurface, PGLFo
         swsurface->y = 0;
         swsurface->w = bRet ? s->mBitmapInfo.bmiHeader.biWidth : 0;
         swsurface->h = bRet ? (-s->mBitmapInfo.bmiHeader.biHeight) : 0;
-        swsurface->p = bRet ? s->mBitmapMemory : NULL;
+        swsurface->p = bRet ? pgl_sw_swapchain_back(&s->mSwapchain) : NULL;
     }
 
     if (format)
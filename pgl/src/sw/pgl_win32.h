@@ -40,6 +40,8 @@ extern "C"
 void pglInit(void);
 PGLSurface pglCreateWindow(uint8_t window, int32_t x, int32_t y, int32_t w, int32_t h);
 PGLBoolean pglSwapBuffers(PGLSurface surface);
+PGLBoolean pglSwapBuffersRegion(PGLSurface surface, const PGLRect* rects, uint32_t count);
+PGLBoolean pglIsBufferPreserved(PGLSurface surface);
 
 /**
  * Checks if the passed in surface is valid
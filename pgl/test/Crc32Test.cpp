@@ -0,0 +1,95 @@
+/******************************************************************************
+**
+**   File:        Crc32Test.cpp
+**   Description: Tests the CRC32 / CRC32C implementations
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "crc32.h"
+
+#include <vector>
+
+namespace
+{
+const uint8_t* digits()
+{
+    return reinterpret_cast<const uint8_t*>("123456789");
+}
+}
+
+TEST(crc32, checkValues)
+{
+    EXPECT_EQ(0xcbf43926U, calcCrc32Complete(digits(), 9U));
+    EXPECT_EQ(0xe3069283U, calcCrc32cComplete(digits(), 9U));
+    EXPECT_EQ(0U, calcCrc32Complete(digits(), 0U));
+
+    // the calculation can be split at any byte
+    const uint32_t crc = updateCrc32(0xffffffffU, digits(), 4U);
+    EXPECT_EQ(0xcbf43926U, ~updateCrc32(crc, digits() + 4, 5U));
+    const uint32_t crcc = updateCrc32c(0xffffffffU, digits(), 5U);
+    EXPECT_EQ(0xe3069283U, ~updateCrc32c(crcc, digits() + 5, 4U));
+}
+
+TEST(crc32, allImplementationsAgree)
+{
+    std::vector<uint8_t> data(1000U);
+    uint32_t seed = 1U;
+    for (size_t i = 0U; i < data.size(); ++i)
+    {
+        seed = seed * 1103515245U + 12345U;
+        data[i] = static_cast<uint8_t>(seed >> 16);
+    }
+
+    EXPECT_EQ(0xcbf43926U, ~getCrc32Function(CRC32_IEEE, CRC32_SLICING_BY_8)(0xffffffffU, digits(), 9U));
+    EXPECT_EQ(0xe3069283U, ~getCrc32Function(CRC32_CASTAGNOLI, CRC32_SLICING_BY_8)(0xffffffffU, digits(), 9U));
+
+    const Crc32Polynomial polynomials[] = { CRC32_IEEE, CRC32_CASTAGNOLI };
+    for (size_t p = 0U; p < 2U; ++p)
+    {
+        const Crc32Function reference = getCrc32Function(polynomials[p], CRC32_BYTEWISE);
+        ASSERT_TRUE(reference != NULL);
+        ASSERT_TRUE(getCrc32Function(polynomials[p], CRC32_SLICING_BY_8) != NULL);
+
+        // unaligned starts and lengths which are no multiple of 8 (the remaining bytes are processed one by one)
+        const Crc32Implementation implementations[] = { CRC32_SLICING_BY_8, CRC32_HARDWARE };
+        for (size_t i = 0U; i < 2U; ++i)
+        {
+            const Crc32Function function = getCrc32Function(polynomials[p], implementations[i]);
+            if (function != NULL) // hardware support depends on the CPU
+            {
+                for (uint32_t offset = 0U; offset < 8U; ++offset)
+                {
+                    for (uint32_t size = 0U; size < 40U; size += 3U)
+                    {
+                        EXPECT_EQ(reference(0xffffffffU, &data[offset], size), function(0xffffffffU, &data[offset], size));
+                    }
+                }
+                EXPECT_EQ(reference(0x12345678U, &data[3], 997U), function(0x12345678U, &data[3], 997U));
+            }
+        }
+    }
+    // the selected implementations
+    EXPECT_EQ(getCrc32Function(CRC32_IEEE, CRC32_BYTEWISE)(0xffffffffU, &data[0], 1000U), updateCrc32(0xffffffffU, &data[0], 1000U));
+    EXPECT_EQ(getCrc32Function(CRC32_CASTAGNOLI, CRC32_BYTEWISE)(0xffffffffU, &data[0], 1000U), updateCrc32c(0xffffffffU, &data[0], 1000U));
+}
@@ -0,0 +1,135 @@
+/******************************************************************************
+**
+**   File:        PglDecodeTest.cpp
+**   Description: Tests the RLE and FastLZ decoders of compressed textures
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "pgl_decode.h"
+#include "RleEncoder.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+const int32_t WIDTH = 7;
+const int32_t HEIGHT = 3;
+
+// transparent and opaque runs, a long run and single pixels
+std::vector<uint32_t> createImage()
+{
+    std::vector<uint32_t> image(WIDTH * HEIGHT, 0U);
+    image[2] = 0xff102030U;
+    image[3] = 0xff102030U;
+    image[4] = 0x80405060U;
+    for (int32_t x = 0; x < WIDTH; ++x)
+    {
+        image[WIDTH + x] = 0xffa0b0c0U;
+        image[2 * WIDTH + x] = 0xff000000U | static_cast<uint32_t>(x);
+    }
+    return image;
+}
+}
+
+TEST(pglDecode, rle)
+{
+    const std::vector<uint32_t> image = createImage();
+    const std::vector<uint8_t> data = encodeRle(&image[0], WIDTH, HEIGHT, 4);
+    EXPECT_GT(image.size() * 4U, data.size());
+    std::vector<uint32_t> decoded(image.size(), 0xdeadbeefU);
+    EXPECT_EQ(PGL_TRUE, pgl_rle_decode(reinterpret_cast<uint8_t*>(&decoded[0]), WIDTH, HEIGHT, 4U, PGL_FALSE, &data[0], static_cast<uint32_t>(data.size())));
+    EXPECT_EQ(image, decoded);
+
+    // the bytes of each pixel are reversed
+    const std::vector<uint8_t> swapped = encodeRle(&image[0], WIDTH, HEIGHT, 4, true);
+    EXPECT_EQ(PGL_TRUE, pgl_decode(reinterpret_cast<uint8_t*>(&decoded[0]), static_cast<uint32_t>(decoded.size() * 4U), WIDTH, HEIGHT, 4U,
+        PGL_ENCODING_RLE2, &swapped[0], static_cast<uint32_t>(swapped.size())));
+    EXPECT_EQ(image, decoded);
+}
+
+TEST(pglDecode, invalidRle)
+{
+    std::vector<uint8_t> decoded(16U);
+    // a run of 4 pixels in rows of 3 pixels
+    const uint8_t crossing[] = { 0x83, 1, 2 };
+    EXPECT_EQ(PGL_FALSE, pgl_rle_decode(&decoded[0], 3U, 2U, 2U, PGL_FALSE, crossing, sizeof(crossing)));
+    // missing pixels of a literal packet
+    const uint8_t truncated[] = { 0x02, 1, 2, 3, 4 };
+    EXPECT_EQ(PGL_FALSE, pgl_rle_decode(&decoded[0], 3U, 1U, 2U, PGL_FALSE, truncated, sizeof(truncated)));
+    // data after the last row
+    const uint8_t trailing[] = { 0x82, 1, 2, 0x00, 3, 4 };
+    EXPECT_EQ(PGL_FALSE, pgl_rle_decode(&decoded[0], 3U, 1U, 2U, PGL_FALSE, trailing, sizeof(trailing)));
+    EXPECT_EQ(PGL_TRUE, pgl_rle_decode(&decoded[0], 3U, 1U, 2U, PGL_FALSE, trailing, 3U));
+    EXPECT_EQ(0x0201U, *reinterpret_cast<uint16_t*>(&decoded[4]));
+}
+
+TEST(pglDecode, imageSize)
+{
+    EXPECT_EQ(24U, pgl_image_bytes(3U, 2U, 4U));
+    // 0x10000 * 0x10000 * 4 wraps around to 0 in 32 bits
+    EXPECT_EQ(UINT32_MAX, pgl_image_bytes(0x10000U, 0x10000U, 4U));
+    EXPECT_EQ(UINT32_MAX, pgl_image_bytes(UINT32_MAX, 1U, 1U));
+
+    // the decoders are not called with a wrapped size
+    std::vector<uint8_t> decoded(16U, 0U);
+    const uint8_t raw[] = { 1, 2, 3, 4 };
+    EXPECT_EQ(PGL_FALSE, pgl_decode(&decoded[0], 16U, 0x10000U, 0x10000U, 4U, PGL_ENCODING_RAW, raw, sizeof(raw)));
+    const uint8_t run[] = { 0x83, 1 };
+    EXPECT_EQ(PGL_FALSE, pgl_decode(&decoded[0], 16U, 0x40000001U, 4U, 1U, PGL_ENCODING_RLE, run, sizeof(run)));
+}
+
+TEST(pglDecode, flz)
+{
+    // 3 literal bytes, a match of 6 bytes at distance 3
+    const uint8_t short_match[] = { 0x02, 'a', 'b', 'c', 0x80, 0x02 };
+    std::vector<uint8_t> decoded(32U, 0U);
+    ASSERT_EQ(9U, pgl_flz_decode(&decoded[0], static_cast<uint32_t>(decoded.size()), short_match, sizeof(short_match)));
+    EXPECT_EQ(0, memcmp(&decoded[0], "abcabcabc", 9U));
+
+    // 1 literal byte, a match of 20 bytes at distance 1 (9 + an extra length byte of 11), 2 literal bytes
+    const uint8_t long_match[] = { 0x00, 'x', 0xe0, 11, 0x00, 0x01, 'y', 'z' };
+    ASSERT_EQ(23U, pgl_flz_decode(&decoded[0], static_cast<uint32_t>(decoded.size()), long_match, sizeof(long_match)));
+    EXPECT_EQ(std::string(21U, 'x') + "yz", std::string(decoded.begin(), decoded.begin() + 23));
+
+    EXPECT_EQ(PGL_TRUE, pgl_decode(&decoded[0], 32U, 3U, 3U, 1U, PGL_ENCODING_FLZ, short_match, sizeof(short_match)));
+    EXPECT_EQ(PGL_FALSE, pgl_decode(&decoded[0], 32U, 4U, 3U, 1U, PGL_ENCODING_FLZ, short_match, sizeof(short_match)));
+}
+
+TEST(pglDecode, invalidFlz)
+{
+    std::vector<uint8_t> decoded(8U, 0U);
+    // the match starts before the output
+    const uint8_t distance[] = { 0x00, 'a', 0x20, 0x01 };
+    EXPECT_EQ(0U, pgl_flz_decode(&decoded[0], 8U, distance, sizeof(distance)));
+    // more output than the buffer holds
+    const uint8_t overflow[] = { 0x00, 'a', 0xe0, 0x00, 0x00 };
+    EXPECT_EQ(0U, pgl_flz_decode(&decoded[0], 8U, overflow, sizeof(overflow)));
+    // truncated literal run
+    const uint8_t truncated[] = { 0x03, 'a', 'b' };
+    EXPECT_EQ(0U, pgl_flz_decode(&decoded[0], 8U, truncated, sizeof(truncated)));
+    // compression level 2
+    const uint8_t level2[] = { 0x20, 'a' };
+    EXPECT_EQ(0U, pgl_flz_decode(&decoded[0], 8U, level2, sizeof(level2)));
+}
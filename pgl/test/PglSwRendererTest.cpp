@@ -0,0 +1,963 @@
+/******************************************************************************
+**
+**   File:        PglSwRendererTest.cpp
+**   Description: Tests of the platform independent SW renderer kernels
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "pgl_sw_renderer.h"
+#include "RleEncoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+const int32_t DEST_W = 16;
+const int32_t DEST_H = 8;
+
+PGL_SW_Surface makeSurface(std::vector<uint32_t>& mem, int32_t w, int32_t h)
+{
+    PGL_SW_Surface s = { reinterpret_cast<PGL_SW_Pointer>(&mem[0]), 0, 0, w, h, w * 4, w * h * 4 };
+    return s;
+}
+
+std::vector<uint32_t> makeImage(int32_t w, int32_t h)
+{
+    std::vector<uint32_t> img(w * h);
+    for (int32_t i = 0; i < w * h; ++i)
+    {
+        img[i] = 0xff000000U | static_cast<uint32_t>(i + 1);
+    }
+    return img;
+}
+}
+
+TEST(pglSwRenderer, copyInside)
+{
+    std::vector<uint32_t> destMem(DEST_W * DEST_H, 0U);
+    std::vector<uint32_t> srcMem = makeImage(4, 3);
+    PGL_SW_Surface dest = makeSurface(destMem, DEST_W, DEST_H);
+    PGL_SW_Surface src = makeSurface(srcMem, 4, 3);
+    dest.x = 5;
+    dest.y = 2;
+    dest.w = 4;
+    dest.h = 3;
+    pgl_sw_bitblit_copy(&dest, &src, PGL_FORMAT_BGRA_8888);
+
+    for (int32_t y = 0; y < DEST_H; ++y)
+    {
+        for (int32_t x = 0; x < DEST_W; ++x)
+        {
+            const bool inside = (x >= 5) && (x < 9) && (y >= 2) && (y < 5);
+            const uint32_t expected = inside ? srcMem[(y - 2) * 4 + (x - 5)] : 0U;
+            EXPECT_EQ(expected, destMem[y * DEST_W + x]) << x << "/" << y;
+        }
+    }
+}
+
+TEST(pglSwRenderer, copySubRectOfSource)
+{
+    std::vector<uint32_t> destMem(DEST_W * DEST_H, 0U);
+    std::vector<uint32_t> srcMem = makeImage(4, 3);
+    PGL_SW_Surface dest = makeSurface(destMem, DEST_W, DEST_H);
+    PGL_SW_Surface src = makeSurface(srcMem, 4, 3);
+    src.x = 1;
+    src.y = 1;
+    src.w = 2;
+    src.h = 2;
+    pgl_sw_bitblit_copy(&dest, &src, PGL_FORMAT_BGRA_8888);
+
+    EXPECT_EQ(srcMem[1 * 4 + 1], destMem[0]);
+    EXPECT_EQ(srcMem[1 * 4 + 2], destMem[1]);
+    EXPECT_EQ(0U, destMem[2]);
+    EXPECT_EQ(srcMem[2 * 4 + 1], destMem[DEST_W]);
+    EXPECT_EQ(srcMem[2 * 4 + 2], destMem[DEST_W + 1]);
+    EXPECT_EQ(0U, destMem[2 * DEST_W]);
+}
+
+TEST(pglSwRenderer, copyClippedAtAllEdges)
+{
+    std::vector<uint32_t> srcMem = makeImage(4, 3);
+    const int32_t positions[][2] = { { -2, -1 }, { DEST_W - 2, DEST_H - 1 }, { -2, DEST_H - 1 }, { DEST_W - 2, -1 } };
+    for (size_t i = 0; i < sizeof(positions) / sizeof(positions[0]); ++i)
+    {
+        // guard elements around the destination memory detect any out of bounds write
+        std::vector<uint32_t> mem(DEST_W * DEST_H + 2 * DEST_W, 0xdeadbeefU);
+        std::vector<uint32_t> destMem(DEST_W * DEST_H, 0U);
+        PGL_SW_Surface dest = { reinterpret_cast<PGL_SW_Pointer>(&mem[DEST_W]), positions[i][0], positions[i][1], 4, 3, DEST_W * 4, DEST_W * DEST_H * 4 };
+        PGL_SW_Surface src = makeSurface(srcMem, 4, 3);
+        for (int32_t j = 0; j < DEST_W * DEST_H; ++j)
+        {
+            mem[DEST_W + j] = 0U;
+        }
+        pgl_sw_bitblit_copy(&dest, &src, PGL_FORMAT_BGRA_8888);
+
+        for (int32_t j = 0; j < DEST_W; ++j)
+        {
+            EXPECT_EQ(0xdeadbeefU, mem[j]);
+            EXPECT_EQ(0xdeadbeefU, mem[DEST_W + DEST_W * DEST_H + j]);
+        }
+        for (int32_t y = 0; y < DEST_H; ++y)
+        {
+            for (int32_t x = 0; x < DEST_W; ++x)
+            {
+                const int32_t sx = x - positions[i][0];
+                const int32_t sy = y - positions[i][1];
+                const bool inside = (sx >= 0) && (sx < 4) && (sy >= 0) && (sy < 3);
+                const uint32_t expected = inside ? srcMem[sy * 4 + sx] : 0U;
+                // no wrap around into the neighbouring row
+                EXPECT_EQ(expected, mem[DEST_W + y * DEST_W + x]) << i << ": " << x << "/" << y;
+            }
+        }
+    }
+}
+
+TEST(pglSwRenderer, copyClippedToClipRect)
+{
+    std::vector<uint32_t> destMem(DEST_W * DEST_H, 0U);
+    std::vector<uint32_t> srcMem = makeImage(4, 3);
+    PGL_SW_Surface dest = makeSurface(destMem, DEST_W, DEST_H);
+    PGL_SW_Surface src = makeSurface(srcMem, 4, 3);
+    dest.x = 5;
+    dest.y = 2;
+    dest.w = 4;
+    dest.h = 3;
+    // clip the left column and the bottom row
+    EXPECT_EQ(PGL_TRUE, pgl_sw_clip(&dest, &src, 6, 0, DEST_W, 4));
+    EXPECT_EQ(6, dest.x);
+    EXPECT_EQ(1, src.x);
+    EXPECT_EQ(3, src.w);
+    EXPECT_EQ(2, src.h);
+    pgl_sw_bitblit_copy(&dest, &src, PGL_FORMAT_BGRA_8888);
+
+    for (int32_t y = 0; y < DEST_H; ++y)
+    {
+        for (int32_t x = 0; x < DEST_W; ++x)
+        {
+            const bool inside = (x >= 6) && (x < 9) && (y >= 2) && (y < 4);
+            const uint32_t expected = inside ? srcMem[(y - 2) * 4 + (x - 5)] : 0U;
+            EXPECT_EQ(expected, destMem[y * DEST_W + x]) << x << "/" << y;
+        }
+    }
+    EXPECT_TRUE(pgl_sw_equal(&dest, &src, PGL_FORMAT_BGRA_8888));
+
+    // a fill is clipped against its own rect
+    PGL_SW_Surface fill = makeSurface(destMem, DEST_W, DEST_H);
+    EXPECT_EQ(PGL_TRUE, pgl_sw_clip(&fill, NULL, -4, 1, 2, 3));
+    EXPECT_EQ(0, fill.x);
+    EXPECT_EQ(1, fill.y);
+    EXPECT_EQ(2, fill.w);
+    EXPECT_EQ(2, fill.h);
+
+    fill = makeSurface(destMem, DEST_W, DEST_H);
+    EXPECT_EQ(PGL_FALSE, pgl_sw_clip(&fill, NULL, DEST_W, 0, DEST_W + 4, DEST_H));
+    EXPECT_EQ(0, fill.w);
+}
+
+TEST(pglSwRenderer, copyOutside)
+{
+    std::vector<uint32_t> destMem(DEST_W * DEST_H, 0U);
+    std::vector<uint32_t> srcMem = makeImage(4, 3);
+    PGL_SW_Surface dest = makeSurface(destMem, DEST_W, DEST_H);
+    PGL_SW_Surface src = makeSurface(srcMem, 4, 3);
+    dest.x = DEST_W;
+    pgl_sw_bitblit_copy(&dest, &src, PGL_FORMAT_BGRA_8888);
+    dest.x = -4;
+    pgl_sw_bitblit_copy(&dest, &src, PGL_FORMAT_BGRA_8888);
+    dest.x = 0;
+    dest.y = DEST_H;
+    pgl_sw_bitblit_copy(&dest, &src, PGL_FORMAT_BGRA_8888);
+    for (size_t i = 0; i < destMem.size(); ++i)
+    {
+        EXPECT_EQ(0U, destMem[i]);
+    }
+}
+
+TEST(pglSwRenderer, copy16And8Bit)
+{
+    uint16_t dest16[8 * 2] = { 0 };
+    const uint16_t src16[3] = { 0x1234, 0x5678, 0x9abc };
+    PGL_SW_Surface dest = { reinterpret_cast<PGL_SW_Pointer>(dest16), 6, 1, 3, 1, 8 * 2, sizeof(dest16) };
+    PGL_SW_Surface src = { reinterpret_cast<PGL_SW_Pointer>(const_cast<uint16_t*>(src16)), 0, 0, 3, 1, 3 * 2, sizeof(src16) };
+    pgl_sw_bitblit_copy(&dest, &src, PGL_FORMAT_RGB_565);
+    EXPECT_EQ(0x1234, dest16[8 + 6]);
+    EXPECT_EQ(0x5678, dest16[8 + 7]);
+    EXPECT_EQ(0, dest16[8 + 5]);
+
+    uint8_t dest8[4 * 2] = { 0 };
+    const uint8_t src8[4] = { 1, 2, 3, 4 };
+    PGL_SW_Surface dest2 = { dest8, 1, 0, 2, 2, 4, sizeof(dest8) };
+    PGL_SW_Surface src2 = { const_cast<uint8_t*>(src8), 0, 0, 2, 2, 2, sizeof(src8) };
+    pgl_sw_bitblit_copy(&dest2, &src2, PGL_FORMAT_A_8);
+    const uint8_t expected8[8] = { 0, 1, 2, 0, 0, 3, 4, 0 };
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(expected8[i], dest8[i]);
+    }
+}
+
+TEST(pglSwRenderer, compareIdentical)
+{
+    std::vector<uint32_t> srcMem = makeImage(13, 5);
+    std::vector<uint32_t> destMem(DEST_W * DEST_H, 0U);
+    PGL_SW_Surface dest = makeSurface(destMem, DEST_W, DEST_H);
+    PGL_SW_Surface src = makeSurface(srcMem, 13, 5);
+    dest.x = 2;
+    dest.y = 1;
+    pgl_sw_bitblit_copy(&dest, &src, PGL_FORMAT_BGRA_8888);
+    EXPECT_EQ(0U, pgl_sw_compare(&dest, &src, PGL_FORMAT_BGRA_8888));
+    EXPECT_EQ(PGL_TRUE, pgl_sw_equal(&dest, &src, PGL_FORMAT_BGRA_8888));
+
+    dest.x = 3;
+    EXPECT_NE(0U, pgl_sw_compare(&dest, &src, PGL_FORMAT_BGRA_8888));
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal(&dest, &src, PGL_FORMAT_BGRA_8888));
+}
+
+TEST(pglSwRenderer, compareCountsPixels)
+{
+    // 13 pixels per row: three SIMD chunks and a tail of one pixel
+    std::vector<uint32_t> srcMem = makeImage(13, 5);
+    std::vector<uint32_t> destMem(srcMem);
+    PGL_SW_Surface dest = makeSurface(destMem, 13, 5);
+    PGL_SW_Surface src = makeSurface(srcMem, 13, 5);
+    destMem[0] ^= 1U;
+    destMem[1] ^= 0x100U;
+    destMem[2 * 13 + 6] ^= 0x10000000U;
+    destMem[4 * 13 + 12] ^= 0x80U; // tail pixel
+    EXPECT_EQ(4U, pgl_sw_compare(&dest, &src, PGL_FORMAT_BGRA_8888));
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal(&dest, &src, PGL_FORMAT_BGRA_8888));
+
+    destMem = srcMem;
+    destMem[4 * 13 + 12] ^= 0x80U;
+    EXPECT_EQ(1U, pgl_sw_compare(&dest, &src, PGL_FORMAT_BGRA_8888));
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal(&dest, &src, PGL_FORMAT_BGRA_8888));
+}
+
+TEST(pglSwRenderer, compare16BitCountsPixelsNotBytes)
+{
+    uint16_t destMem[20] = { 0 };
+    uint16_t srcMem[20] = { 0 };
+    PGL_SW_Surface dest = { reinterpret_cast<PGL_SW_Pointer>(destMem), 0, 0, 20, 1, 40, 40 };
+    PGL_SW_Surface src = { reinterpret_cast<PGL_SW_Pointer>(srcMem), 0, 0, 20, 1, 40, 40 };
+    destMem[3] = 0xffff; // both bytes differ
+    destMem[19] = 0x0100;
+    EXPECT_EQ(2U, pgl_sw_compare(&dest, &src, PGL_FORMAT_RGB_565));
+}
+
+TEST(pglSwRenderer, compareOutsideFails)
+{
+    std::vector<uint32_t> srcMem = makeImage(4, 3);
+    std::vector<uint32_t> destMem(DEST_W * DEST_H, 0U);
+    PGL_SW_Surface dest = makeSurface(destMem, DEST_W, DEST_H);
+    PGL_SW_Surface src = makeSurface(srcMem, 4, 3);
+    dest.x = DEST_W - 2;
+    dest.y = 0;
+    pgl_sw_bitblit_copy(&dest, &src, PGL_FORMAT_BGRA_8888);
+    // the visible half matches, the clipped half can't be verified
+    EXPECT_EQ(6U, pgl_sw_compare(&dest, &src, PGL_FORMAT_BGRA_8888));
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal(&dest, &src, PGL_FORMAT_BGRA_8888));
+
+    dest.x = DEST_W;
+    EXPECT_EQ(12U, pgl_sw_compare(&dest, &src, PGL_FORMAT_BGRA_8888));
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal(&dest, &src, PGL_FORMAT_BGRA_8888));
+}
+
+namespace
+{
+uint8_t div255(uint32_t x)
+{
+    return static_cast<uint8_t>((x + 127U) / 255U);
+}
+
+// straight alpha "source over" in floating point precision, rounded
+uint32_t blendStraight(uint32_t s, uint32_t d)
+{
+    const uint32_t a = s >> 24;
+    uint32_t ret = 0U;
+    for (int c = 0; c < 24; c += 8)
+    {
+        const uint32_t sc = (s >> c) & 0xffU;
+        const uint32_t dc = (d >> c) & 0xffU;
+        ret |= static_cast<uint32_t>(div255(sc * a + dc * (255U - a))) << c;
+    }
+    const uint32_t da = d >> 24;
+    ret |= (a + div255(da * (255U - a))) << 24;
+    return ret;
+}
+
+uint32_t blendPremultiplied(uint32_t s, uint32_t d)
+{
+    const uint32_t a = s >> 24;
+    uint32_t ret = 0U;
+    for (int c = 0; c < 32; c += 8)
+    {
+        const uint32_t sc = (s >> c) & 0xffU;
+        const uint32_t dc = (d >> c) & 0xffU;
+        const uint32_t v = sc + div255(dc * (255U - a));
+        ret |= ((v > 255U) ? 255U : v) << c;
+    }
+    return ret;
+}
+}
+
+TEST(pglSwRenderer, blendStraightAlpha)
+{
+    // 7 pixels per row: one SIMD group of 4 pixels and a scalar tail of 3
+    const uint32_t srcPixels[] =
+    {
+        0xff123456U, 0x00abcdefU, 0x80ff0000U, 0x4000ff00U, 0x01ffffffU, 0xfe0000ffU, 0x80808080U,
+        0xff000000U, 0xffffffffU, 0xff00ff00U, 0xff0000ffU, 0x20102030U, 0xc0a0b0c0U, 0x00000000U
+    };
+    std::vector<uint32_t> srcMem(srcPixels, srcPixels + 14);
+    std::vector<uint32_t> destMem(7 * 2);
+    for (size_t i = 0; i < destMem.size(); ++i)
+    {
+        destMem[i] = 0xff000000U | static_cast<uint32_t>(i * 0x00102030U);
+    }
+    const std::vector<uint32_t> background(destMem);
+    PGL_SW_Surface dest = makeSurface(destMem, 7, 2);
+    PGL_SW_Surface src = makeSurface(srcMem, 7, 2);
+    pgl_sw_bitblit_blend(&dest, &src, PGL_FORMAT_BGRA_8888);
+    for (size_t i = 0; i < destMem.size(); ++i)
+    {
+        EXPECT_EQ(blendStraight(srcMem[i], background[i]), destMem[i]) << i;
+    }
+    // opaque pixels are copied, transparent ones keep the background
+    EXPECT_EQ(srcMem[0], destMem[0]);
+    EXPECT_EQ(background[1], destMem[1]);
+}
+
+TEST(pglSwRenderer, blendPremultipliedAlpha)
+{
+    const uint32_t srcPixels[] =
+    {
+        0xff123456U, 0x00000000U, 0x80800000U, 0x40004000U, 0x00202020U, 0xfe0000feU, 0x80404040U
+    };
+    std::vector<uint32_t> srcMem(srcPixels, srcPixels + 7);
+    std::vector<uint32_t> destMem(7, 0xff336699U);
+    const std::vector<uint32_t> background(destMem);
+    PGL_SW_Surface dest = makeSurface(destMem, 7, 1);
+    PGL_SW_Surface src = makeSurface(srcMem, 7, 1);
+    pgl_sw_bitblit_blend(&dest, &src, PGL_FORMAT_RGBA_8888_PRE);
+    for (size_t i = 0; i < destMem.size(); ++i)
+    {
+        EXPECT_EQ(blendPremultiplied(srcMem[i], background[i]), destMem[i]) << i;
+    }
+    // premultiplied pixels with alpha 0 add their color
+    EXPECT_EQ(0xff5386b9U, destMem[4]);
+}
+
+TEST(pglSwRenderer, blendClipped)
+{
+    std::vector<uint32_t> srcMem(4 * 3, 0x80ffffffU);
+    std::vector<uint32_t> destMem(DEST_W * DEST_H, 0xff000000U);
+    PGL_SW_Surface dest = makeSurface(destMem, DEST_W, DEST_H);
+    PGL_SW_Surface src = makeSurface(srcMem, 4, 3);
+    dest.x = DEST_W - 1;
+    dest.y = -2;
+    pgl_sw_bitblit_blend(&dest, &src, PGL_FORMAT_BGRA_8888);
+    for (int32_t i = 0; i < DEST_W * DEST_H; ++i)
+    {
+        EXPECT_EQ((i == DEST_W - 1) ? 0xff808080U : 0xff000000U, destMem[i]) << i;
+    }
+}
+
+TEST(pglSwRenderer, equalOpaque)
+{
+    const uint32_t srcPixels[] = { 0xff112233U, 0x80112233U, 0x00112233U, 0xff445566U, 0xff778899U };
+    std::vector<uint32_t> srcMem(srcPixels, srcPixels + 5);
+    std::vector<uint32_t> destMem(5, 0xff000000U);
+    PGL_SW_Surface dest = makeSurface(destMem, 5, 1);
+    PGL_SW_Surface src = makeSurface(srcMem, 5, 1);
+    pgl_sw_bitblit_blend(&dest, &src, PGL_FORMAT_BGRA_8888);
+    EXPECT_EQ(PGL_TRUE, pgl_sw_equal_opaque(&dest, &src, PGL_FORMAT_BGRA_8888));
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal(&dest, &src, PGL_FORMAT_BGRA_8888));
+
+    destMem[4] ^= 1U;
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal_opaque(&dest, &src, PGL_FORMAT_BGRA_8888));
+    destMem[4] ^= 1U;
+    destMem[1] ^= 1U; // translucent pixels are not checked
+    EXPECT_EQ(PGL_TRUE, pgl_sw_equal_opaque(&dest, &src, PGL_FORMAT_BGRA_8888));
+}
+
+TEST(pglSwRenderer, convertRgb565ToBgra8888)
+{
+    // 19 pixels: SIMD groups and the scalar tail are used
+    const int32_t w = 19;
+    std::vector<uint16_t> srcMem(w);
+    for (int32_t i = 0; i < w; ++i)
+    {
+        srcMem[i] = static_cast<uint16_t>(i * 0x0d37U);
+    }
+    srcMem[0] = 0xffffU;
+    srcMem[1] = 0xf800U; // red
+    srcMem[2] = 0x07e0U; // green
+    srcMem[3] = 0x001fU; // blue
+    srcMem[4] = 0x8410U; // r 16, g 32, b 16
+    std::vector<uint32_t> destMem(w, 0U);
+    PGL_SW_Surface dest = makeSurface(destMem, w, 1);
+    PGL_SW_Surface src = { reinterpret_cast<PGL_SW_Pointer>(&srcMem[0]), 0, 0, w, 1, w * 2, w * 2 };
+    pgl_sw_bitblit_convert(&dest, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_RGB_565, PGL_FALSE);
+
+    EXPECT_EQ(0xffffffffU, destMem[0]);
+    EXPECT_EQ(0xffff0000U, destMem[1]);
+    EXPECT_EQ(0xff00ff00U, destMem[2]);
+    EXPECT_EQ(0xff0000ffU, destMem[3]);
+    EXPECT_EQ(0xff848284U, destMem[4]);
+    for (int32_t i = 5; i < w; ++i)
+    {
+        const uint32_t r = srcMem[i] >> 11;
+        const uint32_t g = (srcMem[i] >> 5) & 0x3fU;
+        const uint32_t b = srcMem[i] & 0x1fU;
+        const uint32_t expected = 0xff000000U | (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+        EXPECT_EQ(expected, destMem[i]) << i;
+    }
+    EXPECT_EQ(PGL_TRUE, pgl_sw_equal_convert(&dest, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_RGB_565, PGL_FALSE));
+    destMem[17] ^= 0x100U;
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal_convert(&dest, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_RGB_565, PGL_FALSE));
+}
+
+TEST(pglSwRenderer, convertBgra8888To565)
+{
+    const int32_t w = 11;
+    std::vector<uint32_t> srcMem = makeImage(w, 1);
+    srcMem[0] = 0xffffffffU;
+    srcMem[1] = 0xff0f1f2fU; // channels are truncated
+    std::vector<uint16_t> destMem(DEST_W, 0U);
+    PGL_SW_Surface dest = { reinterpret_cast<PGL_SW_Pointer>(&destMem[0]), 2, 0, w, 1, DEST_W * 2, DEST_W * 2 };
+    PGL_SW_Surface src = makeSurface(srcMem, w, 1);
+    pgl_sw_bitblit_convert(&dest, PGL_FORMAT_RGB_565, &src, PGL_FORMAT_BGRA_8888, PGL_FALSE);
+
+    EXPECT_EQ(0U, destMem[0]);
+    EXPECT_EQ(0U, destMem[1]);
+    EXPECT_EQ(0xffffU, destMem[2]);
+    EXPECT_EQ((0x0fU >> 3 << 11) | (0x1fU >> 2 << 5) | (0x2fU >> 3), destMem[3]);
+    for (int32_t i = 2; i < w; ++i)
+    {
+        const uint32_t p = srcMem[i];
+        EXPECT_EQ(((p >> 8) & 0xf800U) | ((p >> 5) & 0x07e0U) | ((p >> 3) & 0x1fU), destMem[i + 2]) << i;
+    }
+    EXPECT_EQ(0U, destMem[w + 2]);
+
+    std::vector<uint16_t> bgr(w, 0U);
+    PGL_SW_Surface bgrDest = { reinterpret_cast<PGL_SW_Pointer>(&bgr[0]), 0, 0, w, 1, w * 2, w * 2 };
+    pgl_sw_bitblit_convert(&bgrDest, PGL_FORMAT_BGR_565, &src, PGL_FORMAT_BGRA_8888, PGL_FALSE);
+    EXPECT_EQ((0x2fU >> 3 << 11) | (0x1fU >> 2 << 5) | (0x0fU >> 3), bgr[1]);
+    EXPECT_EQ(PGL_TRUE, pgl_sw_equal_convert(&bgrDest, PGL_FORMAT_BGR_565, &src, PGL_FORMAT_BGRA_8888, PGL_FALSE));
+}
+
+TEST(pglSwRenderer, convert888ClippedToRgba8888)
+{
+    const uint8_t rgb[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    PGL_SW_Surface src = { const_cast<PGL_SW_Pointer>(rgb), 0, 0, 3, 1, 9, 9 };
+    std::vector<uint32_t> destMem(4, 0U);
+    PGL_SW_Surface dest = makeSurface(destMem, 2, 2);
+    dest.x = -1;
+    dest.y = 1;
+    pgl_sw_bitblit_convert(&dest, PGL_FORMAT_RGBA_8888, &src, PGL_FORMAT_RGB_888, PGL_FALSE);
+    EXPECT_EQ(0U, destMem[0]);
+    EXPECT_EQ(0U, destMem[1]);
+    const uint8_t* d = reinterpret_cast<const uint8_t*>(&destMem[2]);
+    const uint8_t expected[] = { 4, 5, 6, 255, 7, 8, 9, 255 };
+    EXPECT_EQ(0, memcmp(expected, d, sizeof(expected)));
+    // partly outside
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal_convert(&dest, PGL_FORMAT_RGBA_8888, &src, PGL_FORMAT_RGB_888, PGL_FALSE));
+
+    PGL_SW_Surface bgr = { const_cast<PGL_SW_Pointer>(rgb), 1, 0, 2, 1, 9, 9 };
+    std::vector<uint32_t> bgra(2, 0U);
+    PGL_SW_Surface bgraDest = makeSurface(bgra, 2, 1);
+    pgl_sw_bitblit_convert(&bgraDest, PGL_FORMAT_BGRA_8888, &bgr, PGL_FORMAT_BGR_888, PGL_FALSE);
+    EXPECT_EQ(0xff060504U, bgra[0]);
+    EXPECT_EQ(0xff090807U, bgra[1]);
+    EXPECT_EQ(PGL_TRUE, pgl_sw_equal_convert(&bgraDest, PGL_FORMAT_BGRA_8888, &bgr, PGL_FORMAT_BGR_888, PGL_FALSE));
+}
+
+TEST(pglSwRenderer, convertBlendOnto565)
+{
+    const uint32_t srcPixels[] = { 0xffffffffU, 0x80ffffffU, 0x00ffffffU };
+    std::vector<uint32_t> srcMem(srcPixels, srcPixels + 3);
+    std::vector<uint16_t> destMem(3, 0x001fU); // blue
+    PGL_SW_Surface dest = { reinterpret_cast<PGL_SW_Pointer>(&destMem[0]), 0, 0, 3, 1, 6, 6 };
+    PGL_SW_Surface src = makeSurface(srcMem, 3, 1);
+    pgl_sw_bitblit_convert(&dest, PGL_FORMAT_RGB_565, &src, PGL_FORMAT_BGRA_8888, PGL_TRUE);
+    EXPECT_EQ(0xffffU, destMem[0]);
+    EXPECT_EQ((0x80U >> 3 << 11) | (0x80U >> 2 << 5) | 0x1fU, destMem[1]);
+    EXPECT_EQ(0x001fU, destMem[2]);
+    EXPECT_EQ(PGL_TRUE, pgl_sw_equal_convert(&dest, PGL_FORMAT_RGB_565, &src, PGL_FORMAT_BGRA_8888, PGL_TRUE));
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal_convert(&dest, PGL_FORMAT_RGB_565, &src, PGL_FORMAT_BGRA_8888, PGL_FALSE));
+}
+
+TEST(pglSwRenderer, copyAndCompare24Bit)
+{
+    // 3 bpp rows are compared in blocks of 48 bytes
+    const int32_t w = 20;
+    std::vector<uint8_t> srcMem(w * 3 * 2);
+    for (size_t i = 0; i < srcMem.size(); ++i)
+    {
+        srcMem[i] = static_cast<uint8_t>(i);
+    }
+    std::vector<uint8_t> destMem(srcMem.size(), 0U);
+    PGL_SW_Surface src = { &srcMem[0], 0, 0, w, 2, w * 3, static_cast<int32_t>(srcMem.size()) };
+    PGL_SW_Surface dest = { &destMem[0], 0, 0, w, 2, w * 3, static_cast<int32_t>(destMem.size()) };
+    pgl_sw_bitblit_copy(&dest, &src, PGL_FORMAT_RGB_888);
+    EXPECT_TRUE(srcMem == destMem);
+    EXPECT_EQ(0U, pgl_sw_compare(&dest, &src, PGL_FORMAT_RGB_888));
+    destMem[3 * 5 + 1] ^= 1U;
+    destMem[w * 3 + 3 * 19 + 2] ^= 1U;
+    EXPECT_EQ(2U, pgl_sw_compare(&dest, &src, PGL_FORMAT_RGB_888));
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal(&dest, &src, PGL_FORMAT_RGB_888));
+}
+
+TEST(pglSwRenderer, tileCrcs)
+{
+    // standard check value of CRC32C
+    const char digits[] = "123456789";
+    PGL_SW_Surface text = { reinterpret_cast<PGL_SW_Pointer>(const_cast<char*>(digits)), 0, 0, 9, 1, 9, 9 };
+    EXPECT_EQ(0xe3069283U, pgl_sw_crc32(&text, PGL_FORMAT_A_8));
+
+    // 10x7 pixels in tiles of 4x4: 3 columns and 2 rows, the last ones are smaller
+    std::vector<uint32_t> srcMem = makeImage(10, 7);
+    PGL_SW_Surface src = makeSurface(srcMem, 10, 7);
+    uint32_t crcs[6] = { 0U };
+    pgl_sw_tile_crcs(&src, PGL_FORMAT_BGRA_8888, 4, crcs);
+    PGL_SW_Surface tile = src;
+    tile.x = 8;
+    tile.y = 4;
+    tile.w = 2;
+    tile.h = 3;
+    EXPECT_EQ(pgl_sw_crc32(&tile, PGL_FORMAT_BGRA_8888), crcs[5]);
+
+    std::vector<uint32_t> destMem(DEST_W * DEST_H, 0U);
+    PGL_SW_Surface dest = makeSurface(destMem, DEST_W, DEST_H);
+    dest.x = 3;
+    dest.y = 1;
+    dest.w = 10;
+    dest.h = 7;
+    pgl_sw_bitblit_copy(&dest, &src, PGL_FORMAT_BGRA_8888);
+    EXPECT_EQ(PGL_TRUE, pgl_sw_equal_crc(&dest, PGL_FORMAT_BGRA_8888, 4, crcs, 3));
+
+    // a part of the image, which starts at a tile border
+    PGL_SW_Surface part = dest;
+    part.x += 4;
+    part.y += 4;
+    part.w = 6;
+    part.h = 3;
+    EXPECT_EQ(PGL_TRUE, pgl_sw_equal_crc(&part, PGL_FORMAT_BGRA_8888, 4, &crcs[4], 3));
+
+    destMem[(1 + 6) * DEST_W + 3 + 9] ^= 0x100U;
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal_crc(&dest, PGL_FORMAT_BGRA_8888, 4, crcs, 3));
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal_crc(&part, PGL_FORMAT_BGRA_8888, 4, &crcs[4], 3));
+
+    // pixels outside of the surface can't be verified
+    dest.x = DEST_W - 9;
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal_crc(&dest, PGL_FORMAT_BGRA_8888, 4, crcs, 3));
+}
+
+TEST(pglSwRenderer, fillClipped)
+{
+    std::vector<uint32_t> destMem(DEST_W * DEST_H, 0U);
+    PGL_SW_Surface dest = makeSurface(destMem, DEST_W, DEST_H);
+    dest.x = DEST_W - 3;
+    dest.y = -1;
+    dest.w = 5;
+    dest.h = 3;
+    pgl_sw_fill(&dest, PGL_FORMAT_BGRA_8888, 0x11, 0x22, 0x33, 0x44);
+    for (int32_t y = 0; y < DEST_H; ++y)
+    {
+        for (int32_t x = 0; x < DEST_W; ++x)
+        {
+            const bool inside = (x >= DEST_W - 3) && (y < 2);
+            EXPECT_EQ(inside ? 0x44112233U : 0U, destMem[y * DEST_W + x]) << x << "/" << y;
+        }
+    }
+
+    dest = makeSurface(destMem, DEST_W, DEST_H);
+    pgl_sw_fill(&dest, PGL_FORMAT_RGBA_8888, 0x11, 0x22, 0x33, 0x44);
+    for (size_t i = 0; i < destMem.size(); ++i)
+    {
+        EXPECT_EQ(0x44332211U, destMem[i]) << i;
+    }
+}
+
+TEST(pglSwRenderer, fillAllBpp)
+{
+    // 50 pixels per row: more than one fill pattern and a tail
+    const int32_t w = 50;
+    std::vector<uint16_t> mem565(w * 2 + 1, 0U);
+    PGL_SW_Surface s565 = { reinterpret_cast<PGL_SW_Pointer>(&mem565[0]), 0, 1, w, 1, w * 2, w * 2 * 2 };
+    pgl_sw_fill(&s565, PGL_FORMAT_RGB_565, 0xff, 0x80, 0x00, 0xff);
+    for (int32_t i = 0; i < w; ++i)
+    {
+        EXPECT_EQ(0U, mem565[i]) << i;
+        EXPECT_EQ(0xfc00U, mem565[w + i]) << i;
+    }
+    EXPECT_EQ(0U, mem565[2 * w]);
+
+    std::vector<uint8_t> mem888(w * 3, 0U);
+    PGL_SW_Surface s888 = { &mem888[0], 1, 0, w - 2, 1, w * 3, w * 3 };
+    pgl_sw_fill(&s888, PGL_FORMAT_RGB_888, 1, 2, 3, 4);
+    EXPECT_EQ(0U, mem888[2]);
+    for (int32_t i = 1; i < w - 1; ++i)
+    {
+        EXPECT_EQ(1U, mem888[i * 3 + 0]) << i;
+        EXPECT_EQ(2U, mem888[i * 3 + 1]) << i;
+        EXPECT_EQ(3U, mem888[i * 3 + 2]) << i;
+    }
+    EXPECT_EQ(0U, mem888[(w - 1) * 3]);
+
+    std::vector<uint8_t> mem8(w * 2, 0U);
+    PGL_SW_Surface s8 = { &mem8[0], 0, 0, w, 2, w, w * 2 };
+    pgl_sw_fill(&s8, PGL_FORMAT_A_8, 1, 2, 3, 0x7f);
+    EXPECT_TRUE(std::vector<uint8_t>(w * 2, 0x7fU) == mem8);
+}
+
+TEST(pglSwRenderer, scaleNearest)
+{
+    // 2x2 -> 4x4: every source pixel becomes a 2x2 block
+    std::vector<uint32_t> srcMem = makeImage(2, 2);
+    std::vector<uint32_t> destMem(DEST_W * DEST_H, 0U);
+    PGL_SW_Surface src = makeSurface(srcMem, 2, 2);
+    PGL_SW_Surface dest = makeSurface(destMem, DEST_W, DEST_H);
+    PGL_SW_Scale scale;
+    pgl_sw_scale_init(&scale, 1 << 4, 2 << 4, 0, 0, 4 << 4, 5 << 4, 1 << 4, 1 << 4);
+    dest.x = 1;
+    dest.y = 2;
+    dest.w = 4;
+    dest.h = 4;
+    pgl_sw_bitblit_scale(&dest, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_BGRA_8888, &scale, PGL_FILTER_NEAREST, PGL_FALSE);
+    for (int32_t y = 0; y < DEST_H; ++y)
+    {
+        for (int32_t x = 0; x < DEST_W; ++x)
+        {
+            const bool inside = (x >= 1) && (x < 5) && (y >= 2) && (y < 6);
+            const uint32_t expected = inside ? srcMem[((y - 2) / 2) * 2 + (x - 1) / 2] : 0U;
+            EXPECT_EQ(expected, destMem[y * DEST_W + x]) << x << "/" << y;
+        }
+    }
+    EXPECT_TRUE(pgl_sw_equal_scale(&dest, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_BGRA_8888, &scale, PGL_FILTER_NEAREST, PGL_FALSE));
+    EXPECT_FALSE(pgl_sw_equal_scale(&dest, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_BGRA_8888, &scale, PGL_FILTER_LINEAR, PGL_FALSE));
+
+    // downscaling 4x4 -> 2x2 picks every second pixel
+    std::vector<uint32_t> bigMem = makeImage(4, 4);
+    std::vector<uint32_t> smallMem(2 * 2, 0U);
+    PGL_SW_Surface big = makeSurface(bigMem, 4, 4);
+    PGL_SW_Surface small = makeSurface(smallMem, 2, 2);
+    pgl_sw_scale_init(&scale, 0, 0, 0, 0, 1 << 4, 1 << 4, 3 << 4, 3 << 4);
+    pgl_sw_bitblit_scale(&small, PGL_FORMAT_BGRA_8888, &big, PGL_FORMAT_BGRA_8888, &scale, PGL_FILTER_NEAREST, PGL_FALSE);
+    EXPECT_EQ(bigMem[1 * 4 + 1], smallMem[0]);
+    EXPECT_EQ(bigMem[1 * 4 + 3], smallMem[1]);
+    EXPECT_EQ(bigMem[3 * 4 + 1], smallMem[2]);
+    EXPECT_EQ(bigMem[3 * 4 + 3], smallMem[3]);
+}
+
+TEST(pglSwRenderer, scaleBilinear)
+{
+    // 2x1 -> 4x1: the inner pixels are interpolated, the outer ones are clamped to the edge texels
+    const uint32_t srcMem[] = { 0xff000000U, 0xff0000ffU };
+    std::vector<uint32_t> destMem(4, 0U);
+    PGL_SW_Surface src = { reinterpret_cast<PGL_SW_Pointer>(const_cast<uint32_t*>(srcMem)), 0, 0, 2, 1, 8, 8 };
+    PGL_SW_Surface dest = makeSurface(destMem, 4, 1);
+    PGL_SW_Scale scale;
+    pgl_sw_scale_init(&scale, 0, 0, 0, 0, 3 << 4, 0, 1 << 4, 0);
+    pgl_sw_bitblit_scale(&dest, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_BGRA_8888, &scale, PGL_FILTER_LINEAR, PGL_FALSE);
+    EXPECT_EQ(0xff000000U, destMem[0]);
+    EXPECT_EQ(0xff000040U, destMem[1]); // 1/4 of the way
+    EXPECT_EQ(0xff0000bfU, destMem[2]); // 3/4 of the way
+    EXPECT_EQ(0xff0000ffU, destMem[3]);
+    EXPECT_TRUE(pgl_sw_equal_scale(&dest, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_BGRA_8888, &scale, PGL_FILTER_LINEAR, PGL_FALSE));
+    destMem[2] ^= 1U;
+    EXPECT_FALSE(pgl_sw_equal_scale(&dest, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_BGRA_8888, &scale, PGL_FILTER_LINEAR, PGL_FALSE));
+
+    // same size: bilinear sampling hits the texel centers and reproduces the image
+    std::vector<uint32_t> imgMem = makeImage(7, 3);
+    std::vector<uint32_t> copyMem(7 * 3, 0U);
+    PGL_SW_Surface img = makeSurface(imgMem, 7, 3);
+    PGL_SW_Surface copy = makeSurface(copyMem, 7, 3);
+    pgl_sw_scale_init(&scale, 0, 0, 0, 0, 6 << 4, 2 << 4, 6 << 4, 2 << 4);
+    pgl_sw_bitblit_scale(&copy, PGL_FORMAT_BGRA_8888, &img, PGL_FORMAT_BGRA_8888, &scale, PGL_FILTER_LINEAR, PGL_FALSE);
+    EXPECT_TRUE(imgMem == copyMem);
+}
+
+TEST(pglSwRenderer, scaleClippedAndConverted)
+{
+    // 2x2 RGB_565 -> 8x8 BGRA_8888 of which only the right half is drawn, the rest is outside of the surface
+    const uint16_t srcMem[] = { 0xf800U, 0x07e0U, 0x001fU, 0xffffU };
+    PGL_SW_Surface src = { reinterpret_cast<PGL_SW_Pointer>(const_cast<uint16_t*>(srcMem)), 0, 0, 2, 2, 4, 8 };
+    std::vector<uint32_t> destMem(DEST_W * DEST_H, 0U);
+    PGL_SW_Surface dest = makeSurface(destMem, DEST_W, DEST_H);
+    PGL_SW_Scale scale;
+    pgl_sw_scale_init(&scale, (DEST_W - 4) << 4, 0, 0, 0, (DEST_W + 3) << 4, 7 << 4, 1 << 4, 1 << 4);
+    dest.x = DEST_W - 4;
+    dest.y = 0;
+    dest.w = 8;
+    dest.h = 8;
+    pgl_sw_bitblit_scale(&dest, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_RGB_565, &scale, PGL_FILTER_NEAREST, PGL_FALSE);
+    EXPECT_EQ(0U, destMem[DEST_W - 5]);
+    EXPECT_EQ(0xffff0000U, destMem[DEST_W - 4]);
+    EXPECT_EQ(0xffff0000U, destMem[DEST_W - 1]);
+    EXPECT_EQ(0xff0000ffU, destMem[4 * DEST_W + DEST_W - 1]);
+    // a part of the destination is outside of the surface - it can't be verified
+    EXPECT_FALSE(pgl_sw_equal_scale(&dest, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_RGB_565, &scale, PGL_FILTER_NEAREST, PGL_FALSE));
+    dest.w = 4;
+    EXPECT_TRUE(pgl_sw_equal_scale(&dest, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_RGB_565, &scale, PGL_FILTER_NEAREST, PGL_FALSE));
+}
+
+TEST(pglSwRenderer, scaleRange)
+{
+    PGL_SW_Scale scale;
+    // the last source pixel which fits into 16.16 fixed point
+    EXPECT_TRUE(pgl_sw_scale_init(&scale, 0, 0, 32760 << 4, 0, 3 << 4, 0, 32766 << 4, 0));
+    EXPECT_EQ(32760 << 16, scale.u - scale.du / 2);
+    // u1 * 4096 overflows 32 bits
+    EXPECT_FALSE(pgl_sw_scale_init(&scale, 0, 0, 40000 << 4, 0, 3 << 4, 0, 40001 << 4, 0));
+    EXPECT_EQ(0, scale.du);
+    EXPECT_FALSE(pgl_sw_scale_init(&scale, 0, 0, 0, -40000 * 16, 0, 3 << 4, 0, 0));
+    // the start fits, but the source positions of the last destination pixels don't
+    EXPECT_FALSE(pgl_sw_scale_init(&scale, 0, 0, 32000 << 4, 0, 3 << 4, 0, 33000 << 4, 0));
+
+    // the whole 16.16 range on 64 pixels: the distance from the first source position exceeds 32 bits,
+    // the left half of the samples is left of the texture, the right half right of it
+    const uint32_t srcMem[] = { 0xff000000U, 0xff0000ffU };
+    PGL_SW_Surface src = { reinterpret_cast<PGL_SW_Pointer>(const_cast<uint32_t*>(srcMem)), 0, 0, 2, 1, 8, 8 };
+    std::vector<uint32_t> destMem(64, 0U);
+    PGL_SW_Surface dest = makeSurface(destMem, 64, 1);
+    EXPECT_TRUE(pgl_sw_scale_init(&scale, 0, 0, -32000 * 16, 0, 63 << 4, 0, 32000 << 4, 0));
+    pgl_sw_bitblit_scale(&dest, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_BGRA_8888, &scale, PGL_FILTER_NEAREST, PGL_FALSE);
+    for (int32_t x = 0; x < 64; ++x)
+    {
+        EXPECT_EQ(srcMem[(x < 32) ? 0 : 1], destMem[x]) << x;
+    }
+    EXPECT_TRUE(pgl_sw_equal_scale(&dest, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_BGRA_8888, &scale, PGL_FILTER_NEAREST, PGL_FALSE));
+}
+
+namespace
+{
+// a telltale: transparent background with an opaque shape, translucent edges and a gradient (long literal packets)
+std::vector<uint32_t> makeTelltale(int32_t w, int32_t h)
+{
+    std::vector<uint32_t> img(w * h, 0U);
+    for (int32_t y = 0; y < h; ++y)
+    {
+        for (int32_t x = 0; x < w; ++x)
+        {
+            uint32_t& p = img[y * w + x];
+            if ((x > 2) && (x < w - 3) && (y > 0))
+            {
+                p = ((x == 3) || (x == w - 4)) ? 0x80ff8000U : 0xffff8000U;
+            }
+            if (y == h - 1)
+            {
+                p = 0xff000000U | static_cast<uint32_t>(x * 0x010203);
+            }
+        }
+    }
+    return img;
+}
+}
+
+TEST(pglSwRenderer, rleMatchesConvert)
+{
+    // 100 pixels per row: the kernel works in chunks, runs are longer than one chunk
+    const int32_t w = 100;
+    const int32_t h = 5;
+    std::vector<uint32_t> img = makeTelltale(w, h);
+    const std::vector<uint8_t> rle = encodeRle(&img[0], w, h, 4);
+    EXPECT_LT(rle.size() * 4U, img.size() * 4U);
+    PGL_SW_Surface raw = makeSurface(img, w, h);
+    const PGL_SW_Surface encoded = { const_cast<PGL_SW_Pointer>(&rle[0]), 0, 0, w, h, w * 4, static_cast<int32_t>(rle.size()) };
+
+    for (int32_t blend = 0; blend < 2; ++blend)
+    {
+        // a sub rect, clipped at the left and bottom edge of a 565 surface
+        std::vector<uint16_t> expectedMem(w * h, 0x1234U);
+        std::vector<uint16_t> destMem(w * h, 0x1234U);
+        PGL_SW_Surface expected = { reinterpret_cast<PGL_SW_Pointer>(&expectedMem[0]), -2, 2, w - 3, h - 1, w * 2, w * h * 2 };
+        PGL_SW_Surface dest = expected;
+        dest.p = reinterpret_cast<PGL_SW_Pointer>(&destMem[0]);
+        PGL_SW_Surface src = raw;
+        src.x = 1;
+        src.y = 1;
+        src.w = w - 3;
+        src.h = h - 1;
+        PGL_SW_Surface source = encoded;
+        source.x = 1;
+        source.y = 1;
+        source.w = w - 3;
+        source.h = h - 1;
+
+        pgl_sw_bitblit_convert(&expected, PGL_FORMAT_RGB_565, &src, PGL_FORMAT_BGRA_8888, blend);
+        pgl_sw_bitblit_rle(&dest, PGL_FORMAT_RGB_565, &source, PGL_FORMAT_BGRA_8888, PGL_FALSE, blend);
+        EXPECT_EQ(expectedMem, destMem) << blend;
+        // a part of the rect is outside of the surface
+        EXPECT_EQ(PGL_FALSE, pgl_sw_equal_rle(&dest, PGL_FORMAT_RGB_565, &source, PGL_FORMAT_BGRA_8888, PGL_FALSE, blend));
+        dest.x = 0;
+        source.x = 3;
+        source.w = w - 5;
+        source.h = 2;
+        EXPECT_EQ(PGL_TRUE, pgl_sw_equal_rle(&dest, PGL_FORMAT_RGB_565, &source, PGL_FORMAT_BGRA_8888, PGL_FALSE, blend)) << blend;
+        destMem[3 * w + 50] ^= 0x20U;
+        EXPECT_EQ(PGL_FALSE, pgl_sw_equal_rle(&dest, PGL_FORMAT_RGB_565, &source, PGL_FORMAT_BGRA_8888, PGL_FALSE, blend)) << blend;
+    }
+}
+
+TEST(pglSwRenderer, rleSkipsTransparentRuns)
+{
+    const int32_t w = 20;
+    const int32_t h = 4;
+    std::vector<uint32_t> img = makeTelltale(w, h);
+    const std::vector<uint8_t> rle = encodeRle(&img[0], w, h, 4);
+    PGL_SW_Surface source = { const_cast<PGL_SW_Pointer>(&rle[0]), 0, 0, w, h, w * 4, static_cast<int32_t>(rle.size()) };
+    std::vector<uint32_t> destMem(w * h, 0xff0000ffU);
+    PGL_SW_Surface dest = makeSurface(destMem, w, h);
+    pgl_sw_bitblit_rle(&dest, PGL_FORMAT_BGRA_8888, &source, PGL_FORMAT_BGRA_8888, PGL_FALSE, PGL_TRUE);
+    EXPECT_EQ(0xff0000ffU, destMem[0]);
+    EXPECT_EQ(0xff0000ffU, destMem[w + 2]);
+    EXPECT_EQ(0xffff8000U, destMem[w + 4]);
+    EXPECT_EQ(blendStraight(0x80ff8000U, 0xff0000ffU), destMem[w + 3]);
+    EXPECT_EQ(img[(h - 1) * w + 7], destMem[(h - 1) * w + 7]);
+    // the translucent pixels are not verified with blending
+    destMem[w + 3] = 0U;
+    EXPECT_EQ(PGL_TRUE, pgl_sw_equal_rle(&dest, PGL_FORMAT_BGRA_8888, &source, PGL_FORMAT_BGRA_8888, PGL_FALSE, PGL_TRUE));
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal_rle(&dest, PGL_FORMAT_BGRA_8888, &source, PGL_FORMAT_BGRA_8888, PGL_FALSE, PGL_FALSE));
+
+    // the data ends before the last row
+    source.bytes -= 1;
+    std::vector<uint32_t> truncatedMem(w * h, 0U);
+    PGL_SW_Surface truncated = makeSurface(truncatedMem, w, h);
+    pgl_sw_bitblit_rle(&truncated, PGL_FORMAT_BGRA_8888, &source, PGL_FORMAT_BGRA_8888, PGL_FALSE, PGL_FALSE);
+    EXPECT_EQ(img[w + 5], truncatedMem[w + 5]);
+    EXPECT_EQ(0U, truncatedMem[(h - 1) * w + w - 1]);
+    EXPECT_EQ(PGL_FALSE, pgl_sw_equal_rle(&truncated, PGL_FORMAT_BGRA_8888, &source, PGL_FORMAT_BGRA_8888, PGL_FALSE, PGL_FALSE));
+}
+
+TEST(pglSwRenderer, rleSwapped565)
+{
+    // big endian 565 pixels (PGL_ENCODING_RLE2)
+    const uint16_t pixels[] = { 0xf800U, 0xf800U, 0xf800U, 0x07e0U, 0x001fU, 0x001fU };
+    const std::vector<uint8_t> rle = encodeRle(pixels, 3, 2, 2, true);
+    EXPECT_EQ(0xf8U, rle[1]);
+    const PGL_SW_Surface source = { const_cast<PGL_SW_Pointer>(&rle[0]), 0, 0, 3, 2, 6, static_cast<int32_t>(rle.size()) };
+    std::vector<uint32_t> destMem(6, 0U);
+    PGL_SW_Surface dest = makeSurface(destMem, 3, 2);
+    pgl_sw_bitblit_rle(&dest, PGL_FORMAT_BGRA_8888, &source, PGL_FORMAT_RGB_565, PGL_TRUE, PGL_FALSE);
+    const uint32_t expected[] = { 0xffff0000U, 0xffff0000U, 0xffff0000U, 0xff00ff00U, 0xff0000ffU, 0xff0000ffU };
+    EXPECT_EQ(std::vector<uint32_t>(expected, expected + 6), destMem);
+    EXPECT_EQ(PGL_TRUE, pgl_sw_equal_rle(&dest, PGL_FORMAT_BGRA_8888, &source, PGL_FORMAT_RGB_565, PGL_TRUE, PGL_FALSE));
+}
+
+namespace
+{
+// Replaces the colors of an image by indices into a palette with all colors of the image
+std::vector<uint8_t> makeIndexed(const std::vector<uint32_t>& img, std::vector<uint32_t>& palette)
+{
+    std::vector<uint8_t> indices(img.size());
+    for (size_t i = 0U; i < img.size(); ++i)
+    {
+        const std::vector<uint32_t>::iterator it = std::find(palette.begin(), palette.end(), img[i]);
+        indices[i] = static_cast<uint8_t>(it - palette.begin());
+        if (it == palette.end())
+        {
+            palette.push_back(img[i]);
+        }
+    }
+    return indices;
+}
+}
+
+TEST(pglSwRenderer, paletteMatchesConvert)
+{
+    // 40 pixels per row: whole groups of 16 indices and a rest
+    const int32_t w = 40;
+    const int32_t h = 6;
+    for (int32_t large = 0; large < 2; ++large)
+    {
+        // the last row of the telltale has a color per pixel, a small palette uses 8 of them
+        std::vector<uint32_t> img = makeTelltale(w, h);
+        for (int32_t x = 0; (x < w) && !large; ++x)
+        {
+            img[(h - 1) * w + x] = 0xff000000U | static_cast<uint32_t>((x % 8) * 0x102030);
+        }
+        std::vector<uint32_t> colors;
+        std::vector<uint8_t> indices = makeIndexed(img, colors);
+        EXPECT_EQ(large != 0, colors.size() > 16U);
+        PGL_SW_Palette palette;
+        EXPECT_EQ(PGL_TRUE, pgl_sw_palette_init(&palette, PGL_FORMAT_P_8_BGRA_8888, &colors[0], static_cast<uint32_t>(colors.size())));
+        EXPECT_EQ(PGL_FALSE, palette.opaque);
+        const PGL_SW_Surface raw = makeSurface(img, w, h);
+        const PGL_SW_Surface indexed = { &indices[0], 0, 0, w, h, w, w * h };
+
+        for (int32_t blend = 0; blend < 2; ++blend)
+        {
+            std::vector<uint32_t> expectedMem(w * h, 0xff2040ffU);
+            std::vector<uint32_t> destMem(w * h, 0xff2040ffU);
+            PGL_SW_Surface expected = makeSurface(expectedMem, w, h);
+            PGL_SW_Surface dest = makeSurface(destMem, w, h);
+            PGL_SW_Surface src = raw;
+            PGL_SW_Surface source = indexed;
+            pgl_sw_bitblit_convert(&expected, PGL_FORMAT_BGRA_8888, &src, PGL_FORMAT_BGRA_8888, blend);
+            pgl_sw_bitblit_palette(&dest, PGL_FORMAT_BGRA_8888, &source, &palette, blend);
+            EXPECT_EQ(expectedMem, destMem) << large << blend;
+            EXPECT_EQ(PGL_TRUE, pgl_sw_equal_palette(&dest, PGL_FORMAT_BGRA_8888, &source, &palette, blend));
+
+            std::vector<uint16_t> expected565(w * h, 0x1234U);
+            std::vector<uint16_t> dest565(w * h, 0x1234U);
+            expected.p = reinterpret_cast<PGL_SW_Pointer>(&expected565[0]);
+            expected.alignment = w * 2;
+            expected.bytes = w * h * 2;
+            dest = expected;
+            dest.p = reinterpret_cast<PGL_SW_Pointer>(&dest565[0]);
+            pgl_sw_bitblit_convert(&expected, PGL_FORMAT_RGB_565, &src, PGL_FORMAT_BGRA_8888, blend);
+            pgl_sw_bitblit_palette(&dest, PGL_FORMAT_RGB_565, &source, &palette, blend);
+            EXPECT_EQ(expected565, dest565) << large << blend;
+            EXPECT_EQ(PGL_TRUE, pgl_sw_equal_palette(&dest, PGL_FORMAT_RGB_565, &source, &palette, blend));
+            dest565[5 * w + 20] ^= 0x20U;
+            EXPECT_EQ(PGL_FALSE, pgl_sw_equal_palette(&dest, PGL_FORMAT_RGB_565, &source, &palette, blend));
+        }
+    }
+}
+
+TEST(pglSwRenderer, paletteIndexWithoutColor)
+{
+    // 565 colors, the index 20 has no color (transparent black)
+    const uint16_t colors[] = { 0xf800U, 0x07e0U, 0x001fU };
+    PGL_SW_Palette palette;
+    EXPECT_EQ(PGL_TRUE, pgl_sw_palette_init(&palette, PGL_FORMAT_P_8_RGB_565, colors, 3U));
+    EXPECT_EQ(PGL_TRUE, palette.opaque);
+    std::vector<uint8_t> indices(32U, 1U);
+    indices[0] = 0U;
+    indices[17] = 20U;
+    indices[31] = 2U;
+    const PGL_SW_Surface source = { &indices[0], 0, 0, 32, 1, 32, 32 };
+    std::vector<uint32_t> destMem(32U, 0x12345678U);
+    PGL_SW_Surface dest = makeSurface(destMem, 32, 1);
+    pgl_sw_bitblit_palette(&dest, PGL_FORMAT_BGRA_8888, const_cast<PGL_SW_Surface*>(&source), &palette, PGL_FALSE);
+    EXPECT_EQ(0xffff0000U, destMem[0]);
+    EXPECT_EQ(0xff00ff00U, destMem[16]);
+    EXPECT_EQ(0U, destMem[17]);
+    EXPECT_EQ(0xff0000ffU, destMem[31]);
+    EXPECT_EQ(PGL_TRUE, pgl_sw_equal_palette(&dest, PGL_FORMAT_BGRA_8888, &source, &palette, PGL_FALSE));
+    EXPECT_EQ(PGL_FALSE, pgl_helper_ispalette(PGL_FORMAT_RGB_565));
+}
@@ -65,7 +65,7 @@ TEST(pgl, drawBitmap)
     pglInit();
     PGLSurface window = pglCreateWindow(0, 0, 0, 800, 480);
     EXPECT_TRUE(window != NULL);
-    PGLContext context = pglCreateContext();
+    PGLContext context = pglCreateContext(NULL);
     EXPECT_TRUE(context != NULL);
     EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
     EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0xff, 0x00, 0xff, 0xff));
@@ -78,13 +78,13 @@ TEST(pgl, drawBitmap)
     int y1 = 30;
     int y2 = y1 + 15 - 1;
     pglDrawQuad(context, x1<<4, y1<<4, 0, 0, x2 << 4, y2 << 4, 40 << 4, 14 << 4);
-    pglDrawQuad(context, (x1*3) << 4, (y1*3) << 4, 0, 0, x2 << 4, y2 << 4, 40 << 4, 14 << 4);
+    pglDrawQuad(context, (x1*3) << 4, (y1*3) << 4, 0, 0, (x2 + x1*2) << 4, (y2 + y1*2) << 4, 40 << 4, 14 << 4);
     EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
     EXPECT_EQ(PGL_NO_ERROR, pglGetError(context));
     pglHandleWindowEvents(context);
     // verify previous render commands
     EXPECT_EQ(PGL_TRUE, pglVerify(context, x1 << 4, y1 << 4, 0, 0, x2 << 4, y2 << 4, 40 << 4, 14 << 4));
-    EXPECT_EQ(PGL_TRUE, pglVerify(context, (x1*3) << 4, (y1*3) << 4, 0, 0, x2 << 4, y2 << 4, 40 << 4, 14 << 4));
+    EXPECT_EQ(PGL_TRUE, pglVerify(context, (x1*3) << 4, (y1*3) << 4, 0, 0, (x2 + x1*2) << 4, (y2 + y1*2) << 4, 40 << 4, 14 << 4));
     // verify at wrong position
     EXPECT_EQ(PGL_FALSE, pglVerify(context, 0, 0, 0, 0, 40 << 4, 14 << 4, 40 << 4, 14 << 4));
     // TODO: image verification
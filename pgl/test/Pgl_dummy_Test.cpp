@@ -0,0 +1,251 @@
+/******************************************************************************
+**
+**   File:        Pgl_dummy_Test.cpp
+**   Description: Tests the blit log and the binary trace of the dummy pgl
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "pgl.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+const uint32_t IMAGE[] = { 0xff0000ffU, 0xff00ff00U, 0xffff0000U, 0xffffffffU };
+
+void setEnvironment(const char* name, const char* value)
+{
+#ifdef WIN32
+    _putenv_s(name, value);
+#else
+    setenv(name, value, 1);
+#endif
+}
+
+// a 2x2 quad at the given grid position
+void drawQuad(PGLContext context, int32_t i)
+{
+    const int32_t x = (i % 100) * 2;
+    const int32_t y = (i / 100) * 2;
+    pglDrawQuad(context, x << 4, y << 4, 0, 0, (x + 1) << 4, (y + 1) << 4, 1 << 4, 1 << 4);
+}
+
+PGLBoolean verifyQuad(PGLContext context, int32_t i)
+{
+    const int32_t x = (i % 100) * 2;
+    const int32_t y = (i / 100) * 2;
+    return pglVerify(context, x << 4, y << 4, 0, 0, (x + 1) << 4, (y + 1) << 4, 1 << 4, 1 << 4);
+}
+
+class PglDummyTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        setEnvironment("PGL_DUMMY_LOG", "none");
+        pglInit();
+        m_context = pglCreateContext(NULL);
+        ASSERT_TRUE(m_context != NULL);
+        m_texture = pglCreateTexture(m_context);
+        m_other = pglCreateTexture(m_context);
+        ASSERT_TRUE(m_texture != NULL);
+        ASSERT_TRUE(m_other != NULL);
+        EXPECT_EQ(PGL_TRUE, pglLoadTexture(m_texture, 2, 2, PGL_FORMAT_BGRA_8888, PGL_FALSE, IMAGE));
+        EXPECT_EQ(PGL_TRUE, pglLoadTexture(m_other, 1, 1, PGL_FORMAT_BGRA_8888, PGL_FALSE, IMAGE));
+        pglBindTexture(m_context, m_texture);
+    }
+
+    virtual void TearDown()
+    {
+        setEnvironment("PGL_DUMMY_LOG", "text");
+    }
+
+    PGLContext m_context;
+    PGLTexture m_texture;
+    PGLTexture m_other;
+};
+}
+
+TEST_F(PglDummyTest, verifiesManyBlits)
+{
+    // more blits than the 255 entries of the former list
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        drawQuad(m_context, i);
+    }
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(PGL_TRUE, verifyQuad(m_context, i)) << i;
+    }
+    // the destination rect has to match, not only the start
+    EXPECT_EQ(PGL_FALSE, pglVerify(m_context, 0, 0, 0, 0, 2 << 4, 1 << 4, 1 << 4, 1 << 4));
+    EXPECT_EQ(PGL_FALSE, verifyQuad(m_context, 1000));
+    // a blit of another texture replaces the one at the same rect
+    pglBindTexture(m_context, m_other);
+    drawQuad(m_context, 5);
+    EXPECT_EQ(PGL_TRUE, verifyQuad(m_context, 5));
+    EXPECT_EQ(PGL_FALSE, verifyQuad(m_context, 6));
+    pglBindTexture(m_context, m_texture);
+    EXPECT_EQ(PGL_FALSE, verifyQuad(m_context, 5));
+}
+
+TEST_F(PglDummyTest, overdrawAndClear)
+{
+    for (int32_t i = 0; i < 300; ++i)
+    {
+        drawQuad(m_context, i);
+    }
+    // the quads 0..9 of the first row start inside the area
+    pglDrawArea(m_context, 0, 0, 19 << 4, 1 << 4);
+    for (int32_t i = 0; i < 300; ++i)
+    {
+        EXPECT_EQ((i < 10) ? PGL_FALSE : PGL_TRUE, verifyQuad(m_context, i)) << i;
+    }
+    drawQuad(m_context, 3);
+    EXPECT_EQ(PGL_TRUE, verifyQuad(m_context, 3));
+
+    pglClear(m_context);
+    for (int32_t i = 0; i < 300; ++i)
+    {
+        EXPECT_EQ(PGL_FALSE, verifyQuad(m_context, i)) << i;
+    }
+    drawQuad(m_context, 299);
+    EXPECT_EQ(PGL_TRUE, verifyQuad(m_context, 299));
+}
+
+TEST_F(PglDummyTest, capacity)
+{
+    // the blits which don't fit into the log can't be verified
+    for (int32_t i = 0; i < PGL_DUMMY_MAX_BLITS + 10; ++i)
+    {
+        drawQuad(m_context, i);
+    }
+    EXPECT_EQ(PGL_TRUE, verifyQuad(m_context, 0));
+    EXPECT_EQ(PGL_TRUE, verifyQuad(m_context, PGL_DUMMY_MAX_BLITS - 1));
+    EXPECT_EQ(PGL_FALSE, verifyQuad(m_context, PGL_DUMMY_MAX_BLITS));
+    // known blits can still be replaced
+    drawQuad(m_context, 0);
+    EXPECT_EQ(PGL_TRUE, verifyQuad(m_context, 0));
+}
+
+TEST_F(PglDummyTest, binaryTrace)
+{
+    const char* path = "pgl_dummy_trace.bin";
+    setEnvironment("PGL_DUMMY_LOG", "binary");
+    setEnvironment("PGL_DUMMY_TRACE", path);
+    pglInit();
+    PGLContext context = pglCreateContext(NULL);
+    ASSERT_TRUE(context != NULL);
+    pglClear(context);
+    pglDrawArea(context, 1 << 4, 2 << 4, 3 << 4, -4 << 4);
+    pglSwapBuffers(NULL);
+
+    FILE* file = fopen(path, "rb");
+    ASSERT_TRUE(file != NULL);
+    std::vector<uint8_t> trace(256U);
+    trace.resize(fread(&trace[0], 1U, trace.size(), file));
+    fclose(file);
+    remove(path);
+
+    const uint8_t expected[] =
+    {
+        1, 1, 2, 0, 0, 0,                      // pglInit(LOG_MODE_BINARY)
+        3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, // pglCreateContext(0, 0) ret: 1
+        12, 1, 1, 0, 0, 0,                     // pglClear(1)
+        13, 5, 1, 0, 0, 0, 16, 0, 0, 0, 32, 0, 0, 0, 48, 0, 0, 0, 0xc0, 0xff, 0xff, 0xff, // pglDrawArea(1, ...)
+        19, 1, 0, 0, 0, 0                      // pglSwapBuffers(0)
+    };
+    ASSERT_EQ(sizeof(expected), trace.size());
+    for (size_t i = 0U; i < sizeof(expected); ++i)
+    {
+        EXPECT_EQ(expected[i], trace[i]) << i;
+    }
+}
+
+TEST_F(PglDummyTest, submitReplaysWithoutTracing)
+{
+    const char* path = "pgl_dummy_submit.bin";
+    setEnvironment("PGL_DUMMY_LOG", "binary");
+    setEnvironment("PGL_DUMMY_TRACE", path);
+    pglInit();
+    PGLContext context = pglCreateContext(NULL);
+    ASSERT_TRUE(context != NULL);
+    PGLList list = pglCreateList(context);
+    ASSERT_TRUE(list != NULL);
+    EXPECT_EQ(PGL_TRUE, pglBeginList(context, list));
+    pglClear(context);
+    pglDrawArea(context, 0, 0, 1 << 4, 1 << 4);
+    EXPECT_EQ(PGL_TRUE, pglEndList(context));
+    EXPECT_EQ(PGL_TRUE, pglSubmit(context, list));
+    pglSwapBuffers(NULL);
+
+    FILE* file = fopen(path, "rb");
+    ASSERT_TRUE(file != NULL);
+    std::vector<uint8_t> trace(256U);
+    trace.resize(fread(&trace[0], 1U, trace.size(), file));
+    fclose(file);
+    remove(path);
+
+    // the recorded commands are traced once, the replay by pglSubmit isn't traced again
+    const uint8_t expected[] =
+    {
+        1, 1, 2, 0, 0, 0,                      // pglInit(LOG_MODE_BINARY)
+        3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, // pglCreateContext(0, 0) ret: 1
+        15, 2, 1, 0, 0, 0, 1, 0, 0, 0,         // pglCreateList(1) ret: 1
+        16, 3, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, // pglBeginList(1, 1) ret: 1
+        12, 1, 1, 0, 0, 0,                     // pglClear(1)
+        13, 5, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16, 0, 0, 0, 16, 0, 0, 0, // pglDrawArea(1, ...)
+        17, 2, 1, 0, 0, 0, 1, 0, 0, 0,         // pglEndList(1) ret: 1
+        18, 3, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, // pglSubmit(1, 1) ret: 1
+        19, 1, 0, 0, 0, 0                      // pglSwapBuffers(0)
+    };
+    ASSERT_EQ(sizeof(expected), trace.size());
+    for (size_t i = 0U; i < sizeof(expected); ++i)
+    {
+        EXPECT_EQ(expected[i], trace[i]) << i;
+    }
+}
+
+TEST_F(PglDummyTest, submittedBlitsAreVerified)
+{
+    PGLList list = pglCreateList(m_context);
+    ASSERT_TRUE(list != NULL);
+    EXPECT_EQ(PGL_TRUE, pglBeginList(m_context, list));
+    for (int32_t i = 0; i < 20; ++i)
+    {
+        drawQuad(m_context, i);
+    }
+    // overdraws the quads 0..4
+    pglDrawArea(m_context, 0, 0, 9 << 4, 1 << 4);
+    EXPECT_EQ(PGL_TRUE, pglEndList(m_context));
+    EXPECT_EQ(PGL_FALSE, verifyQuad(m_context, 10));
+
+    EXPECT_EQ(PGL_TRUE, pglSubmit(m_context, list));
+    for (int32_t i = 0; i < 20; ++i)
+    {
+        EXPECT_EQ((i < 5) ? PGL_FALSE : PGL_TRUE, verifyQuad(m_context, i)) << i;
+    }
+}
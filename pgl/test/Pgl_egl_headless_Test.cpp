@@ -0,0 +1,331 @@
+/******************************************************************************
+**
+**   File:        Pgl_egl_headless_Test.cpp
+**   Description: Tests the GLES2 pgl with pbuffer surfaces (no display server)
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "pgl.h"
+#include "pgl_gles2.h"
+
+#include <GLES3/gl3.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+const int32_t WIDTH = 64;
+const int32_t HEIGHT = 48;
+
+// RGBA of the pixel x, y (top-left origin like pgl)
+uint32_t readPixel(int32_t x, int32_t y)
+{
+    uint8_t rgba[4] = { 0U, 0U, 0U, 0U };
+    glReadPixels(x, HEIGHT - 1 - y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+    return (static_cast<uint32_t>(rgba[0]) << 24) | (static_cast<uint32_t>(rgba[1]) << 16) | (static_cast<uint32_t>(rgba[2]) << 8) | rgba[3];
+}
+
+const uint8_t image2x2[] =
+{
+//    R     G     B     A
+    0x00, 0xff, 0xff, 0xff, // cyan
+    0xff, 0x00, 0xff, 0xff, // magenta
+    0xff, 0xff, 0x00, 0xff, // yellow
+    0xff, 0x00, 0x00, 0xff  // red
+};
+
+// image2x2 in other formats
+const uint8_t image2x2Rgb888[] = { 0x00, 0xff, 0xff, 0xff, 0x00, 0xff, 0xff, 0xff, 0x00, 0xff, 0x00, 0x00 };
+const uint16_t image2x2Rgb565[] = { 0x07ffU, 0xf81fU, 0xffe0U, 0xf800U };
+const uint8_t image2x2Bgra8888[] = { 0xff, 0xff, 0x00, 0xff, 0xff, 0x00, 0xff, 0xff, 0x00, 0xff, 0xff, 0xff, 0x00, 0x00, 0xff, 0xff };
+const uint8_t image2x2Argb8888[] = { 0xff, 0x00, 0xff, 0xff, 0xff, 0xff, 0x00, 0xff, 0xff, 0xff, 0xff, 0x00, 0xff, 0xff, 0x00, 0x00 };
+}
+
+TEST(pglEglHeadless, drawAndReadBack)
+{
+    pglInit();
+    PGLSurface window = pglCreateWindow(0, 0, 0, WIDTH, HEIGHT);
+    ASSERT_TRUE(window != NULL);
+    PGLContext context = pglCreateContext(NULL);
+    ASSERT_TRUE(context != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
+
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0x00, 0x00, 0xff, 0xff));
+    pglClear(context);
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0xff, 0x00, 0x00, 0xff));
+    pglDrawArea(context, 10 << 4, 5 << 4, 19 << 4, 14 << 4);
+    PGLTexture texture = pglCreateTexture(context);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(texture, 2, 2, PGL_FORMAT_RGBA_8888, PGL_TRUE, image2x2));
+    pglBindTexture(context, texture);
+    // the texture is magnified to 8x8 pixels
+    pglDrawQuad(context, 32 << 4, 16 << 4, 0, 0, 39 << 4, 23 << 4, 1 << 4, 1 << 4);
+    EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
+    EXPECT_EQ(PGL_NO_ERROR, pglGetError(context));
+
+    // x2 / y2 is the last pixel inside like in the SW renderer
+    EXPECT_EQ(0x0000ffffU, readPixel(0, 0));
+    EXPECT_EQ(0x0000ffffU, readPixel(9, 5));
+    EXPECT_EQ(0xff0000ffU, readPixel(10, 5));
+    EXPECT_EQ(0xff0000ffU, readPixel(19, 14));
+    EXPECT_EQ(0x0000ffffU, readPixel(20, 14));
+    EXPECT_EQ(0x0000ffffU, readPixel(19, 15));
+    EXPECT_EQ(0x00ffffffU, readPixel(32, 16));
+    EXPECT_EQ(0x00ffffffU, readPixel(35, 19));
+    EXPECT_EQ(0xff00ffffU, readPixel(36, 16));
+    EXPECT_EQ(0xffff00ffU, readPixel(32, 20));
+    EXPECT_EQ(0xff0000ffU, readPixel(39, 23));
+    EXPECT_EQ(0x0000ffffU, readPixel(40, 23));
+    EXPECT_EQ(0x0000ffffU, readPixel(39, 24));
+
+    // the pbuffer keeps the content of the previous frame, only the changed part is redrawn
+    EXPECT_EQ(PGL_TRUE, pglIsBufferPreserved(window));
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0x00, 0xff, 0x00, 0xff));
+    pglDrawArea(context, 0, 0, 4 << 4, 4 << 4);
+    const PGLRect rect = { 0, 0, 4 << 4, 4 << 4 };
+    EXPECT_EQ(PGL_TRUE, pglSwapBuffersRegion(window, &rect, 1U));
+    EXPECT_EQ(0x00ff00ffU, readPixel(1, 1));
+    EXPECT_EQ(0xff0000ffU, readPixel(11, 6));
+    EXPECT_EQ(0xff0000ffU, readPixel(38, 22));
+    EXPECT_EQ(PGL_NO_ERROR, pglGetError(context));
+}
+
+TEST(pglEglHeadless, quadsOfOneTextureAreBatched)
+{
+    pglInit();
+    PGLSurface window = pglCreateWindow(0, 0, 0, WIDTH, HEIGHT);
+    ASSERT_TRUE(window != NULL);
+    PGLContext context = pglCreateContext(NULL);
+    ASSERT_TRUE(context != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
+    PGLTexture atlas = pglCreateTexture(context);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(atlas, 2, 2, PGL_FORMAT_RGBA_8888, PGL_TRUE, image2x2));
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0x00, 0x00, 0x00, 0xff));
+    pglClear(context);
+    const uint32_t calls = pglGetDrawCallCount(context);
+
+    // every texel of the atlas is an image of 4x4 pixels, all of them are drawn with one call
+    pglBindTexture(context, atlas);
+    for (int32_t i = 0; i < 4; ++i)
+    {
+        const int32_t x = 4 + i * 8;
+        pglDrawQuad(context, x << 4, 4 << 4, (i % 2) << 4, (i / 2) << 4, (x + 3) << 4, 7 << 4, (i % 2) << 4, (i / 2) << 4);
+    }
+    EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
+    EXPECT_EQ(calls + 1U, pglGetDrawCallCount(context));
+    EXPECT_EQ(0x00ffffffU, readPixel(4, 4));
+    EXPECT_EQ(0xff00ffffU, readPixel(15, 7));
+    EXPECT_EQ(0xffff00ffU, readPixel(20, 5));
+    EXPECT_EQ(0xff0000ffU, readPixel(31, 7));
+    EXPECT_EQ(0x000000ffU, readPixel(32, 7));
+
+    // a state change draws the quads before it, an area is drawn on top of the quads before it
+    pglDrawQuad(context, 4 << 4, 12 << 4, 0, 0, 11 << 4, 19 << 4, 1 << 4, 1 << 4);
+    pglSetFilter(context, PGL_FILTER_LINEAR);
+    pglDrawQuad(context, 16 << 4, 12 << 4, 0, 0, 23 << 4, 19 << 4, 1 << 4, 1 << 4);
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0xff, 0xff, 0xff, 0xff));
+    pglDrawArea(context, 8 << 4, 8 << 4, 19 << 4, 15 << 4);
+    EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
+    EXPECT_EQ(calls + 4U, pglGetDrawCallCount(context));
+    EXPECT_EQ(0x00ffffffU, readPixel(4, 12));
+    EXPECT_EQ(0xffffffffU, readPixel(8, 12));
+    EXPECT_EQ(0xffffffffU, readPixel(16, 12));
+    EXPECT_EQ(0xff0000ffU, readPixel(23, 19));
+    EXPECT_EQ(PGL_NO_ERROR, pglGetError(context));
+}
+
+TEST(pglEglHeadless, verifyIsOneFrameLate)
+{
+    pglInit();
+    PGLSurface window = pglCreateWindow(0, 0, 0, WIDTH, HEIGHT);
+    ASSERT_TRUE(window != NULL);
+    PGLContext context = pglCreateContext(NULL);
+    ASSERT_TRUE(context != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
+    PGLTexture texture = pglCreateTexture(context);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(texture, 2, 2, PGL_FORMAT_RGBA_8888, PGL_FALSE, image2x2));
+    pglBindTexture(context, texture);
+    pglDrawQuad(context, 8 << 4, 8 << 4, 0, 0, 9 << 4, 9 << 4, 1 << 4, 1 << 4);
+    EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
+
+    // the first verification of a region waits for the pixels
+    const uint32_t stalls = pglGetReadbackStallCount(context);
+    EXPECT_EQ(PGL_TRUE, pglVerify(context, 8 << 4, 8 << 4, 0, 0, 9 << 4, 9 << 4, 1 << 4, 1 << 4));
+    EXPECT_EQ(PGL_FALSE, pglVerify(context, 9 << 4, 8 << 4, 0, 0, 10 << 4, 9 << 4, 1 << 4, 1 << 4));
+    EXPECT_EQ(stalls + 2U, pglGetReadbackStallCount(context));
+    EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
+
+    // afterwards the pixels of the previous verification are compared without waiting, a change is detected one frame later
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0x00, 0x00, 0x00, 0xff));
+    pglDrawArea(context, 9 << 4, 9 << 4, 9 << 4, 9 << 4);
+    EXPECT_EQ(PGL_TRUE, pglVerify(context, 8 << 4, 8 << 4, 0, 0, 9 << 4, 9 << 4, 1 << 4, 1 << 4));
+    EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
+    EXPECT_EQ(PGL_FALSE, pglVerify(context, 8 << 4, 8 << 4, 0, 0, 9 << 4, 9 << 4, 1 << 4, 1 << 4));
+    EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
+    EXPECT_EQ(stalls + 2U, pglGetReadbackStallCount(context));
+
+    // only the pixels inside the clip area have been drawn
+    EXPECT_EQ(PGL_TRUE, pglSetClip(context, 8 << 4, 8 << 4, 9 << 4, 8 << 4));
+    EXPECT_EQ(PGL_TRUE, pglVerify(context, 8 << 4, 8 << 4, 0, 0, 9 << 4, 9 << 4, 1 << 4, 1 << 4));
+    // no pixel of the region is inside the clip area, so it can't be verified
+    EXPECT_EQ(PGL_FALSE, pglVerify(context, 8 << 4, 9 << 4, 0, 0, 9 << 4, 10 << 4, 1 << 4, 1 << 4));
+    EXPECT_EQ(PGL_NO_ERROR, pglGetError(context));
+}
+
+TEST(pglEglHeadless, texturesInAllFormats)
+{
+    pglInit();
+    PGLSurface window = pglCreateWindow(0, 0, 0, WIDTH, HEIGHT);
+    ASSERT_TRUE(window != NULL);
+    PGLContext context = pglCreateContext(NULL);
+    ASSERT_TRUE(context != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0x00, 0x00, 0x00, 0xff));
+    pglClear(context);
+
+    // RGB formats are uploaded as they are (BGRA if the driver supports it), the others are converted
+    const PGLFormat formats[] = { PGL_FORMAT_RGBA_8888, PGL_FORMAT_RGB_888, PGL_FORMAT_RGB_565, PGL_FORMAT_BGRA_8888, PGL_FORMAT_ARGB_8888 };
+    const void* images[] = { image2x2, image2x2Rgb888, image2x2Rgb565, image2x2Bgra8888, image2x2Argb8888 };
+    PGLTexture textures[5];
+    for (int32_t i = 0; i < 5; ++i)
+    {
+        textures[i] = pglCreateTexture(context);
+        EXPECT_EQ(PGL_TRUE, pglLoadTexture(textures[i], 2, 2, formats[i], PGL_FALSE, images[i])) << i;
+        pglBindTexture(context, textures[i]);
+        const int32_t x = i * 4;
+        pglDrawQuad(context, x << 4, 0, 0, 0, (x + 1) << 4, 1 << 4, 1 << 4, 1 << 4);
+    }
+    EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
+    for (int32_t i = 0; i < 5; ++i)
+    {
+        const int32_t x = i * 4;
+        EXPECT_EQ(0x00ffffffU, readPixel(x, 0)) << i;
+        EXPECT_EQ(0xff00ffffU, readPixel(x + 1, 0)) << i;
+        EXPECT_EQ(0xffff00ffU, readPixel(x, 1)) << i;
+        EXPECT_EQ(0xff0000ffU, readPixel(x + 1, 1)) << i;
+        // the pixels are compared in the format of the texture
+        pglBindTexture(context, textures[i]);
+        EXPECT_EQ(PGL_TRUE, pglVerify(context, x << 4, 0, 0, 0, (x + 1) << 4, 1 << 4, 1 << 4, 1 << 4)) << i;
+    }
+    EXPECT_EQ(PGL_FALSE, pglLoadTexture(textures[0], 2, 2, PGL_FORMAT_P_8_RGB_888, PGL_FALSE, image2x2));
+    EXPECT_EQ(PGL_NO_ERROR, pglGetError(context));
+}
+
+TEST(pglEglHeadless, encodedAndIndexedTextures)
+{
+    pglInit();
+    PGLSurface window = pglCreateWindow(0, 0, 0, WIDTH, HEIGHT);
+    ASSERT_TRUE(window != NULL);
+    PGLContext context = pglCreateContext(NULL);
+    ASSERT_TRUE(context != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0x00, 0x00, 0x00, 0xff));
+    pglClear(context);
+
+    // image2x2 as RLE (one literal packet per row), FastLZ (one literal run) and indices of a palette with its colors
+    uint8_t rle[2 * 9];
+    uint8_t flz[17];
+    rle[0] = 0x01;
+    memcpy(&rle[1], &image2x2[0], 8);
+    rle[9] = 0x01;
+    memcpy(&rle[10], &image2x2[8], 8);
+    flz[0] = 0x0f;
+    memcpy(&flz[1], image2x2, 16);
+    const uint8_t indices[] = { 0, 1, 2, 3 };
+    PGLTexture textures[4];
+    for (int32_t i = 0; i < 4; ++i)
+    {
+        textures[i] = pglCreateTexture(context);
+    }
+    EXPECT_EQ(PGL_TRUE, pglLoadTextureEncoded(textures[0], 2, 2, PGL_FORMAT_RGBA_8888, PGL_ENCODING_RLE, sizeof(rle), rle));
+    EXPECT_EQ(PGL_TRUE, pglLoadTexturePalette(textures[1], 2, 2, PGL_FORMAT_P_8_RGBA_8888, PGL_FALSE, indices, 4, image2x2));
+    EXPECT_EQ(PGL_TRUE, pglLoadTextureEncoded(textures[2], 2, 2, PGL_FORMAT_RGBA_8888, PGL_ENCODING_FLZ, sizeof(flz), flz));
+    EXPECT_EQ(PGL_TRUE, pglLoadTexturePalette(textures[3], 2, 2, PGL_FORMAT_P_8_RGBA_8888, PGL_TRUE, indices, 4, image2x2));
+    for (int32_t i = 0; i < 4; ++i)
+    {
+        pglBindTexture(context, textures[i]);
+        const int32_t x = i * 4;
+        pglDrawQuad(context, x << 4, 0, 0, 0, (x + 1) << 4, 1 << 4, 1 << 4, 1 << 4);
+    }
+    EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
+    for (int32_t i = 0; i < 4; ++i)
+    {
+        const int32_t x = i * 4;
+        EXPECT_EQ(0x00ffffffU, readPixel(x, 0)) << i;
+        EXPECT_EQ(0xff0000ffU, readPixel(x + 1, 1)) << i;
+    }
+    // RLE data and indices are compared like in the SW renderer
+    for (int32_t i = 0; i < 2; ++i)
+    {
+        const int32_t x = i * 4;
+        pglBindTexture(context, textures[i]);
+        EXPECT_EQ(PGL_TRUE, pglVerify(context, x << 4, 0, 0, 0, (x + 1) << 4, 1 << 4, 1 << 4, 1 << 4)) << i;
+        EXPECT_EQ(PGL_FALSE, pglVerify(context, (x + 1) << 4, 0, 0, 0, (x + 2) << 4, 1 << 4, 1 << 4, 1 << 4)) << i;
+    }
+    // the pixels of FastLZ textures and copied indices are only in GL memory, their quads can't be verified
+    pglBindTexture(context, textures[2]);
+    EXPECT_EQ(PGL_FALSE, pglVerify(context, 8 << 4, 0, 0, 0, 9 << 4, 1 << 4, 1 << 4, 1 << 4));
+    pglBindTexture(context, textures[3]);
+    EXPECT_EQ(PGL_FALSE, pglVerify(context, 12 << 4, 0, 0, 0, 13 << 4, 1 << 4, 1 << 4, 1 << 4));
+    EXPECT_EQ(PGL_NO_ERROR, pglGetError(context));
+}
+
+TEST(pglEglHeadless, programBinaryCache)
+{
+    const char* const path = "pglProgramCache.bin";
+    std::remove(path);
+    setenv(PGL_GLES_PROGRAM_CACHE, path, 1);
+    for (int32_t run = 0; run < 2; ++run)
+    {
+        // the first context compiles the shaders and writes the binaries, the second one loads them
+        pglInit();
+        PGLSurface window = pglCreateWindow(0, 0, 0, WIDTH, HEIGHT);
+        ASSERT_TRUE(window != NULL);
+        PGLContext context = pglCreateContext(NULL);
+        ASSERT_TRUE(context != NULL);
+        EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
+        GLint binaryFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormats);
+        FILE* f = std::fopen(path, "rb");
+        EXPECT_EQ(binaryFormats > 0, f != NULL) << run;
+        if (f != NULL)
+        {
+            std::fclose(f);
+        }
+
+        EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0x00, 0x00, 0xff, 0xff));
+        pglClear(context);
+        PGLTexture texture = pglCreateTexture(context);
+        EXPECT_EQ(PGL_TRUE, pglLoadTexture(texture, 2, 2, PGL_FORMAT_RGBA_8888, PGL_TRUE, image2x2));
+        pglBindTexture(context, texture);
+        pglDrawQuad(context, 0, 0, 0, 0, 1 << 4, 1 << 4, 1 << 4, 1 << 4);
+        EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
+        EXPECT_EQ(0xff0000ffU, readPixel(1, 1)) << run;
+        EXPECT_EQ(0x0000ffffU, readPixel(2, 2)) << run;
+        EXPECT_EQ(PGL_NO_ERROR, pglGetError(context));
+    }
+    unsetenv(PGL_GLES_PROGRAM_CACHE);
+    std::remove(path);
+}
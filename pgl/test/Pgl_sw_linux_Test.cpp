@@ -0,0 +1,230 @@
+/******************************************************************************
+**
+**   File:        Pgl_sw_linux_Test.cpp
+**   Description:
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "pgl.h"
+#include "pgl_linux.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+const uint32_t image2x2[] =
+{
+    0xff00ffffU, 0xffff00ffU,
+    0xffffff00U, 0xffff0000U
+};
+
+uint32_t pixelAt(PGLSurface s, int32_t x, int32_t y)
+{
+    PGL_SW_Surface sw;
+    EXPECT_EQ(PGL_TRUE, pglSurfaceToSWSurface(s, &sw, NULL));
+    return *reinterpret_cast<const uint32_t*>(sw.p + y * sw.alignment + x * 4);
+}
+}
+
+TEST(pglSwLinux, drawAndVerify)
+{
+    pglInit();
+    PGLSurface window = pglCreateWindow(0, 0, 0, 64, 32);
+    ASSERT_TRUE(window != NULL);
+    PGLContext context = pglCreateContext(NULL);
+    ASSERT_TRUE(context != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
+
+    PGL_SW_Surface sw;
+    PGLFormat format = PGL_FORMAT_INVALID;
+    EXPECT_EQ(PGL_TRUE, pglSurfaceToSWSurface(window, &sw, &format));
+    EXPECT_EQ(PGL_FORMAT_BGRA_8888, format);
+    EXPECT_EQ(64, sw.w);
+    EXPECT_EQ(32, sw.h);
+    EXPECT_EQ(64 * 4, sw.alignment);
+    EXPECT_EQ(64 * 32 * 4, sw.bytes);
+
+    PGLTexture texture = pglCreateTexture(context);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(texture, 2, 2, PGL_FORMAT_BGRA_8888, PGL_FALSE, image2x2));
+    pglBindTexture(context, texture);
+    pglDrawQuad(context, 10 << 4, 5 << 4, 0, 0, 11 << 4, 6 << 4, 1 << 4, 1 << 4);
+
+    EXPECT_EQ(image2x2[0], pixelAt(window, 10, 5));
+    EXPECT_EQ(image2x2[1], pixelAt(window, 11, 5));
+    EXPECT_EQ(image2x2[2], pixelAt(window, 10, 6));
+    EXPECT_EQ(image2x2[3], pixelAt(window, 11, 6));
+    EXPECT_EQ(0U, pixelAt(window, 12, 5));
+    EXPECT_EQ(0U, pixelAt(window, 9, 6));
+
+    EXPECT_EQ(PGL_TRUE, pglVerify(context, 10 << 4, 5 << 4, 0, 0, 11 << 4, 6 << 4, 1 << 4, 1 << 4));
+    EXPECT_EQ(PGL_FALSE, pglVerify(context, 11 << 4, 5 << 4, 0, 0, 12 << 4, 6 << 4, 1 << 4, 1 << 4));
+
+    // pglClear and pglDrawArea use the context color
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0x10, 0x20, 0x30, 0xff));
+    pglClear(context);
+    EXPECT_EQ(0xff102030U, pixelAt(window, 0, 0));
+    EXPECT_EQ(0xff102030U, pixelAt(window, 63, 31));
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0xff, 0x00, 0x00, 0x80));
+    pglDrawArea(context, 2 << 4, 3 << 4, 4 << 4, 3 << 4);
+    EXPECT_EQ(0xff102030U, pixelAt(window, 1, 3));
+    EXPECT_EQ(0x80ff0000U, pixelAt(window, 2, 3));
+    EXPECT_EQ(0x80ff0000U, pixelAt(window, 4, 3));
+    EXPECT_EQ(0xff102030U, pixelAt(window, 5, 3));
+    EXPECT_EQ(0xff102030U, pixelAt(window, 2, 4));
+    pglDrawArea(context, 60 << 4, 30 << 4, 70 << 4, 40 << 4); // clipped at the surface border
+    EXPECT_EQ(0x80ff0000U, pixelAt(window, 63, 31));
+
+    // drawing is restricted to the clip area
+    EXPECT_EQ(PGL_TRUE, pglSetClip(context, 11 << 4, 0, 63 << 4, 5 << 4));
+    pglClear(context);
+    EXPECT_EQ(0x80ff0000U, pixelAt(window, 11, 5));
+    EXPECT_EQ(0xff102030U, pixelAt(window, 10, 5));
+    EXPECT_EQ(0xff102030U, pixelAt(window, 11, 6));
+    pglDrawQuad(context, 10 << 4, 5 << 4, 0, 0, 11 << 4, 6 << 4, 1 << 4, 1 << 4);
+    EXPECT_EQ(image2x2[1], pixelAt(window, 11, 5));
+    EXPECT_EQ(0xff102030U, pixelAt(window, 10, 5));
+    EXPECT_EQ(0xff102030U, pixelAt(window, 11, 6));
+    EXPECT_EQ(PGL_TRUE, pglVerify(context, 10 << 4, 5 << 4, 0, 0, 11 << 4, 6 << 4, 1 << 4, 1 << 4));
+    EXPECT_EQ(PGL_FALSE, pglVerify(context, 11 << 4, 5 << 4, 0, 0, 12 << 4, 6 << 4, 1 << 4, 1 << 4));
+    // no pixel of the region is inside the clip area, so it can't be verified
+    EXPECT_EQ(PGL_FALSE, pglVerify(context, 10 << 4, 6 << 4, 0, 0, 11 << 4, 7 << 4, 1 << 4, 1 << 4));
+    EXPECT_EQ(PGL_FALSE, pglSetClip(context, 2 << 4, 0, 1 << 4, 0));
+    EXPECT_EQ(PGL_TRUE, pglSetClip(context, 0, 0, 63 << 4, 31 << 4));
+
+    EXPECT_EQ(0U, pglGetSwapCount(window));
+    EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
+    EXPECT_EQ(1U, pglGetSwapCount(window));
+    EXPECT_EQ(PGL_FALSE, pglHandleWindowEvents(context));
+}
+
+TEST(pglSwLinux, dumpPpmOnSwap)
+{
+    setenv("PGL_SW_DUMP", "ppm", 1);
+    setenv("PGL_SW_DUMP_PATH", ".", 1);
+    pglInit();
+    PGLSurface window = pglCreateWindow(1, 0, 0, 2, 2);
+    ASSERT_TRUE(window != NULL);
+    PGLContext context = pglCreateContext(NULL);
+    ASSERT_TRUE(context != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
+    PGLTexture texture = pglCreateTexture(context);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(texture, 2, 2, PGL_FORMAT_BGRA_8888, PGL_FALSE, image2x2));
+    pglBindTexture(context, texture);
+    pglDrawQuad(context, 0, 0, 0, 0, 1 << 4, 1 << 4, 1 << 4, 1 << 4);
+    EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
+    unsetenv("PGL_SW_DUMP");
+    pglInit();
+
+    FILE* f = fopen("./pgl_window1_00000.ppm", "rb");
+    ASSERT_TRUE(f != NULL);
+    char magic[3] = { 0 };
+    int w = 0;
+    int h = 0;
+    int maxval = 0;
+    EXPECT_EQ(4, fscanf(f, "%2s %d %d %d", magic, &w, &h, &maxval));
+    fgetc(f); // single whitespace before the pixel data
+    unsigned char rgb[12] = { 0 };
+    EXPECT_EQ(12U, fread(rgb, 1U, sizeof(rgb), f));
+    fclose(f);
+    remove("./pgl_window1_00000.ppm");
+
+    EXPECT_STREQ("P6", magic);
+    EXPECT_EQ(2, w);
+    EXPECT_EQ(2, h);
+    EXPECT_EQ(255, maxval);
+    // first pixel 0xff00ffff in BGRA memory order: B=0xff G=0xff R=0x00
+    EXPECT_EQ(0x00, rgb[0]);
+    EXPECT_EQ(0xff, rgb[1]);
+    EXPECT_EQ(0xff, rgb[2]);
+}
+
+TEST(pglSwLinux, blendAndVerify)
+{
+    static const uint32_t translucent[] =
+    {
+        0xff0000ffU, 0x800000ffU,
+        0x000000ffU, 0xff00ff00U
+    };
+    pglInit();
+    PGLSurface window = pglCreateWindow(2, 0, 0, 8, 8);
+    ASSERT_TRUE(window != NULL);
+    PGLContext context = pglCreateContext(NULL);
+    ASSERT_TRUE(context != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
+    PGLTexture texture = pglCreateTexture(context);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(texture, 2, 2, PGL_FORMAT_BGRA_8888, PGL_FALSE, translucent));
+    pglBindTexture(context, texture);
+
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(context, PGL_TRUE));
+    pglDrawQuad(context, 0, 0, 0, 0, 1 << 4, 1 << 4, 1 << 4, 1 << 4);
+    EXPECT_EQ(0xff0000ffU, pixelAt(window, 0, 0));
+    EXPECT_EQ(0x80000080U, pixelAt(window, 1, 0)); // blended over the black (transparent) background
+    EXPECT_EQ(0U, pixelAt(window, 0, 1));
+    EXPECT_EQ(0xff00ff00U, pixelAt(window, 1, 1));
+    EXPECT_EQ(PGL_TRUE, pglVerify(context, 0, 0, 0, 0, 1 << 4, 1 << 4, 1 << 4, 1 << 4));
+
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(context, PGL_FALSE));
+    EXPECT_EQ(PGL_FALSE, pglVerify(context, 0, 0, 0, 0, 1 << 4, 1 << 4, 1 << 4, 1 << 4));
+    pglDrawQuad(context, 0, 0, 0, 0, 1 << 4, 1 << 4, 1 << 4, 1 << 4);
+    EXPECT_EQ(0x800000ffU, pixelAt(window, 1, 0));
+    EXPECT_EQ(PGL_TRUE, pglVerify(context, 0, 0, 0, 0, 1 << 4, 1 << 4, 1 << 4, 1 << 4));
+}
+
+TEST(pglSwLinux, drawConvertedTexture)
+{
+    static const uint16_t rgb565[] =
+    {
+        0xf800U, 0x07e0U,
+        0x001fU, 0xffffU
+    };
+    pglInit();
+    PGLSurface window = pglCreateWindow(3, 0, 0, 8, 8);
+    ASSERT_TRUE(window != NULL);
+    PGLContext context = pglCreateContext(NULL);
+    ASSERT_TRUE(context != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
+    PGLTexture texture = pglCreateTexture(context);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(texture, 2, 2, PGL_FORMAT_RGB_565, PGL_FALSE, rgb565));
+    pglBindTexture(context, texture);
+
+    pglDrawQuad(context, 3 << 4, 3 << 4, 0, 0, 4 << 4, 4 << 4, 1 << 4, 1 << 4);
+    EXPECT_EQ(0xffff0000U, pixelAt(window, 3, 3));
+    EXPECT_EQ(0xff00ff00U, pixelAt(window, 4, 3));
+    EXPECT_EQ(0xff0000ffU, pixelAt(window, 3, 4));
+    EXPECT_EQ(0xffffffffU, pixelAt(window, 4, 4));
+    EXPECT_EQ(PGL_TRUE, pglVerify(context, 3 << 4, 3 << 4, 0, 0, 4 << 4, 4 << 4, 1 << 4, 1 << 4));
+    EXPECT_EQ(PGL_FALSE, pglVerify(context, 2 << 4, 3 << 4, 0, 0, 3 << 4, 4 << 4, 1 << 4, 1 << 4));
+
+    // zoomed to 3x3 pixels
+    pglDrawQuad(context, 0, 0, 0, 0, 2 << 4, 2 << 4, 1 << 4, 1 << 4);
+    EXPECT_EQ(0xffff0000U, pixelAt(window, 0, 0));
+    EXPECT_EQ(0xffffffffU, pixelAt(window, 2, 2));
+    EXPECT_EQ(PGL_TRUE, pglVerify(context, 0, 0, 0, 0, 2 << 4, 2 << 4, 1 << 4, 1 << 4));
+    EXPECT_EQ(PGL_TRUE, pglSetFilter(context, PGL_FILTER_LINEAR));
+    EXPECT_EQ(PGL_FALSE, pglVerify(context, 0, 0, 0, 0, 2 << 4, 2 << 4, 1 << 4, 1 << 4));
+    pglDrawQuad(context, 0, 0, 0, 0, 2 << 4, 2 << 4, 1 << 4, 1 << 4);
+    EXPECT_EQ(0xffff0000U, pixelAt(window, 0, 0));
+    EXPECT_EQ(PGL_TRUE, pglVerify(context, 0, 0, 0, 0, 2 << 4, 2 << 4, 1 << 4, 1 << 4));
+}
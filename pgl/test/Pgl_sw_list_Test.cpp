@@ -0,0 +1,188 @@
+/******************************************************************************
+**
+**   File:        Pgl_sw_list_Test.cpp
+**   Description: Tests the display lists of the SW renderer
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "pgl.h"
+#include "pgl_linux.h"
+#include "pgl_sw_renderer_glue.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+const int32_t WIDTH = 64;
+const int32_t HEIGHT = 32;
+
+std::vector<uint32_t> createImage(int32_t w, int32_t h, uint32_t alpha)
+{
+    std::vector<uint32_t> image(static_cast<size_t>(w * h));
+    for (size_t i = 0U; i < image.size(); ++i)
+    {
+        image[i] = (alpha << 24) | static_cast<uint32_t>(i * 2654435761U >> 8 & 0x00ffffffU);
+    }
+    return image;
+}
+
+// A frame with a clear and a fill below an opaque background, fill stripes and tiles of one texture and a blended icon
+void drawFrame(PGLContext context, PGLTexture background, PGLTexture icon)
+{
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0x10, 0x20, 0x30, 0xff));
+    pglClear(context);
+    pglDrawArea(context, 3 << 4, 3 << 4, 9 << 4, 9 << 4);
+    pglBindTexture(context, background);
+    pglDrawQuad(context, 0, 0, 0, 0, (WIDTH - 1) << 4, (HEIGHT - 1) << 4, (WIDTH - 1) << 4, (HEIGHT - 1) << 4);
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0xff, 0x00, 0x00, 0xff));
+    pglDrawArea(context, 0, 0, 9 << 4, 1 << 4);
+    pglDrawArea(context, 10 << 4, 0, 19 << 4, 1 << 4);
+    pglDrawQuad(context, 20 << 4, 10 << 4, 0, 0, 29 << 4, 19 << 4, 9 << 4, 9 << 4);
+    pglDrawQuad(context, 30 << 4, 10 << 4, 10 << 4, 0, 39 << 4, 19 << 4, 19 << 4, 9 << 4);
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(context, PGL_TRUE));
+    pglBindTexture(context, icon);
+    pglDrawQuad(context, 40 << 4, 20 << 4, 0, 0, 47 << 4, 27 << 4, 7 << 4, 7 << 4);
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(context, PGL_FALSE));
+}
+
+// Tiles of the background between icons: the second tile can be moved up to the first one, the third overlaps an icon
+void drawInterleavedFrame(PGLContext context, PGLTexture background, PGLTexture icon)
+{
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0x10, 0x20, 0x30, 0xff));
+    pglClear(context);
+    pglBindTexture(context, background);
+    pglDrawQuad(context, 0, 10 << 4, 0, 0, 9 << 4, 19 << 4, 9 << 4, 9 << 4);
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(context, PGL_TRUE));
+    pglBindTexture(context, icon);
+    pglDrawQuad(context, 40 << 4, 20 << 4, 0, 0, 47 << 4, 27 << 4, 7 << 4, 7 << 4);
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(context, PGL_FALSE));
+    pglBindTexture(context, background);
+    pglDrawQuad(context, 10 << 4, 10 << 4, 10 << 4, 0, 19 << 4, 19 << 4, 19 << 4, 9 << 4);
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(context, PGL_TRUE));
+    pglBindTexture(context, icon);
+    pglDrawQuad(context, 22 << 4, 12 << 4, 0, 0, 29 << 4, 19 << 4, 7 << 4, 7 << 4);
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(context, PGL_FALSE));
+    pglBindTexture(context, background);
+    pglDrawQuad(context, 20 << 4, 10 << 4, 20 << 4, 0, 25 << 4, 19 << 4, 25 << 4, 9 << 4);
+}
+}
+
+TEST(pglSwList, recordAndSubmit)
+{
+    pglInit();
+    const std::vector<uint32_t> backgroundImage = createImage(WIDTH, HEIGHT, 0xffU);
+    const std::vector<uint32_t> iconImage = createImage(8, 8, 0x80U);
+    PGLSurface expectedWindow = pglCreateWindow(0, 0, 0, WIDTH, HEIGHT);
+    PGLSurface window = pglCreateWindow(1, 0, 0, WIDTH, HEIGHT);
+    ASSERT_TRUE(expectedWindow != NULL);
+    ASSERT_TRUE(window != NULL);
+    PGLContext context = pglCreateContext(NULL);
+    ASSERT_TRUE(context != NULL);
+    PGLTexture background = pglCreateTexture(context);
+    PGLTexture icon = pglCreateTexture(context);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(background, WIDTH, HEIGHT, PGL_FORMAT_BGRA_8888, PGL_FALSE, &backgroundImage[0]));
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(icon, 8, 8, PGL_FORMAT_BGRA_8888, PGL_FALSE, &iconImage[0]));
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, expectedWindow));
+    drawFrame(context, background, icon);
+
+    PGLList list = pglCreateList(context);
+    ASSERT_TRUE(list != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
+    EXPECT_EQ(PGL_TRUE, pglBeginList(context, list));
+    drawFrame(context, background, icon);
+    EXPECT_EQ(PGL_TRUE, pglEndList(context));
+    // clear and fill are overdrawn, the stripes and the texture tiles are merged
+    EXPECT_EQ(4U, pglGetListCount(list));
+
+    PGL_SW_Surface expected;
+    PGL_SW_Surface actual;
+    EXPECT_EQ(PGL_TRUE, pglSurfaceToSWSurface(expectedWindow, &expected, NULL));
+    EXPECT_EQ(PGL_TRUE, pglSurfaceToSWSurface(window, &actual, NULL));
+    EXPECT_EQ(0U, *reinterpret_cast<const uint32_t*>(actual.p)); // nothing is drawn while recording
+
+    EXPECT_EQ(PGL_TRUE, pglSubmit(context, list));
+    EXPECT_EQ(0, memcmp(expected.p, actual.p, static_cast<size_t>(expected.bytes)));
+
+    // an unchanged frame is repeated without recording it again
+    pglClear(context);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, expectedWindow));
+    EXPECT_EQ(PGL_TRUE, pglSubmit(context, list));
+    EXPECT_EQ(0, memcmp(expected.p, actual.p, static_cast<size_t>(expected.bytes)));
+
+    // the commands of one texture are grouped and merged, unless they overlap a command in between
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, expectedWindow));
+    drawInterleavedFrame(context, background, icon);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
+    EXPECT_EQ(PGL_TRUE, pglBeginList(context, list));
+    drawInterleavedFrame(context, background, icon);
+    EXPECT_EQ(PGL_TRUE, pglEndList(context));
+    EXPECT_EQ(5U, pglGetListCount(list));
+    EXPECT_EQ(PGL_TRUE, pglSubmit(context, list));
+    EXPECT_EQ(0, memcmp(expected.p, actual.p, static_cast<size_t>(expected.bytes)));
+}
+
+TEST(pglSwList, submitToThreadedContext)
+{
+    const std::vector<uint32_t> backgroundImage = createImage(WIDTH, HEIGHT, 0xffU);
+    const std::vector<uint32_t> iconImage = createImage(8, 8, 0x80U);
+    PGLSurface expectedWindow = pglCreateWindow(2, 0, 0, WIDTH, HEIGHT);
+    PGLSurface window = pglCreateWindow(3, 0, 0, WIDTH, HEIGHT);
+    ASSERT_TRUE(expectedWindow != NULL);
+    ASSERT_TRUE(window != NULL);
+    PGLContext context = pglCreateContext(NULL);
+    PGLContextConfig config = { 2U };
+    PGLContext threaded = pglCreateContext(&config);
+    ASSERT_TRUE(context != NULL);
+    ASSERT_TRUE(threaded != NULL);
+    PGLTexture background = pglCreateTexture(context);
+    PGLTexture icon = pglCreateTexture(context);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(background, WIDTH, HEIGHT, PGL_FORMAT_BGRA_8888, PGL_FALSE, &backgroundImage[0]));
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(icon, 8, 8, PGL_FORMAT_BGRA_8888, PGL_FALSE, &iconImage[0]));
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, expectedWindow));
+    drawFrame(context, background, icon);
+
+    PGLList list = pglCreateList(threaded);
+    ASSERT_TRUE(list != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(threaded, window));
+    EXPECT_EQ(PGL_TRUE, pglBeginList(threaded, list));
+    drawFrame(threaded, background, icon);
+    EXPECT_EQ(PGL_TRUE, pglEndList(threaded));
+    EXPECT_EQ(PGL_TRUE, pglSubmit(threaded, list));
+    EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
+
+    PGL_SW_Surface expected;
+    PGL_SW_Surface actual;
+    EXPECT_EQ(PGL_TRUE, pglSurfaceToSWSurface(expectedWindow, &expected, NULL));
+    EXPECT_EQ(PGL_TRUE, pglSurfaceToSWSurface(window, &actual, NULL));
+    EXPECT_EQ(0, memcmp(expected.p, actual.p, static_cast<size_t>(expected.bytes)));
+
+    // a list which is too small can't be submitted
+    EXPECT_EQ(PGL_TRUE, pglBeginList(threaded, list));
+    for (int32_t i = 0; i <= PGL_MAX_LIST_COMMANDS; ++i)
+    {
+        pglDrawArea(threaded, (i % WIDTH) << 4, (i / WIDTH) << 4, (i % WIDTH) << 4, (i / WIDTH) << 4);
+    }
+    EXPECT_EQ(PGL_FALSE, pglEndList(threaded));
+}
@@ -0,0 +1,161 @@
+/******************************************************************************
+**
+**   File:        Pgl_sw_swap_Test.cpp
+**   Description: Tests the buffer flips of the SW renderer windows
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "pgl.h"
+#include "pgl_linux.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+const int32_t WIDTH = 64;
+const int32_t HEIGHT = 48;
+
+PGL_SW_Pointer backBuffer(PGLSurface s)
+{
+    PGL_SW_Surface sw;
+    EXPECT_EQ(PGL_TRUE, pglSurfaceToSWSurface(s, &sw, NULL));
+    return sw.p;
+}
+
+bool sameContent(PGLSurface a, PGLSurface b)
+{
+    return 0 == memcmp(backBuffer(a), backBuffer(b), static_cast<size_t>(WIDTH * HEIGHT * 4));
+}
+
+// A partial redraw: one rect of the given color
+PGLRect drawRect(PGLContext context, int32_t frame)
+{
+    const PGLRect rect = { (frame * 5) << 4, (frame * 3) << 4, (frame * 5 + 9) << 4, (frame * 3 + 7) << 4 };
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, static_cast<uint8_t>(frame * 40), 0x80, static_cast<uint8_t>(255 - frame * 20), 0xff));
+    pglDrawArea(context, rect.x1, rect.y1, rect.x2, rect.y2);
+    return rect;
+}
+}
+
+TEST(pglSwSwap, partialRedrawWithThreeBuffers)
+{
+    pglInit();
+    PGLSurface reference = pglCreateWindow(0, 0, 0, WIDTH, HEIGHT);
+    setenv("PGL_SW_BUFFERS", "3", 1);
+    pglInit();
+    PGLSurface window = pglCreateWindow(1, 0, 0, WIDTH, HEIGHT);
+    unsetenv("PGL_SW_BUFFERS");
+    ASSERT_TRUE(reference != NULL);
+    ASSERT_TRUE(window != NULL);
+    PGLContext context = pglCreateContext(NULL);
+    ASSERT_TRUE(context != NULL);
+
+    // the first frame changes everything
+    const PGLSurface surfaces[] = { reference, window };
+    for (size_t s = 0U; s < 2U; ++s)
+    {
+        EXPECT_EQ(PGL_TRUE, pglSetSurface(context, surfaces[s]));
+        EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0x10, 0x20, 0x30, 0xff));
+        pglClear(context);
+        EXPECT_EQ(PGL_TRUE, pglSwapBuffers(surfaces[s]));
+    }
+    EXPECT_EQ(0U, pglGetSwapCopyBytes(reference));
+    EXPECT_EQ(static_cast<uint32_t>(WIDTH * HEIGHT * 4), pglGetSwapCopyBytes(window));
+    EXPECT_TRUE(sameContent(reference, window));
+
+    // partial redraw is possible, the swap chain keeps the content
+    EXPECT_EQ(PGL_TRUE, pglIsBufferPreserved(window));
+
+    // the back buffer rotates and is brought up to date with the rects of the frames it has missed
+    std::vector<PGL_SW_Pointer> buffers;
+    uint32_t previousBytes = 0U;
+    for (int32_t frame = 1; frame < 8; ++frame)
+    {
+        buffers.push_back(backBuffer(window));
+        PGLRect rect = { 0, 0, 0, 0 };
+        for (size_t s = 0U; s < 2U; ++s)
+        {
+            EXPECT_EQ(PGL_TRUE, pglSetSurface(context, surfaces[s]));
+            rect = drawRect(context, frame);
+            EXPECT_EQ(PGL_TRUE, pglSwapBuffersRegion(surfaces[s], &rect, 1U));
+        }
+        EXPECT_TRUE(sameContent(reference, window)) << frame;
+        const uint32_t bytes = 10U * 8U * 4U; // one rect
+        if (frame > 1)
+        {
+            EXPECT_EQ(previousBytes + bytes, pglGetSwapCopyBytes(window)) << frame; // this frame and the one before
+        }
+        previousBytes = bytes;
+    }
+    EXPECT_TRUE(buffers[0] != buffers[1]);
+    EXPECT_TRUE(buffers[1] != buffers[2]);
+    EXPECT_TRUE(buffers[0] != buffers[2]);
+    EXPECT_TRUE(buffers[0] == buffers[3]);
+    EXPECT_EQ(8U, pglGetSwapCount(window));
+
+    // more rects than a frame can store are copied completely
+    std::vector<PGLRect> rects(20U);
+    for (size_t s = 0U; s < 2U; ++s)
+    {
+        EXPECT_EQ(PGL_TRUE, pglSetSurface(context, surfaces[s]));
+        for (size_t i = 0U; i < rects.size(); ++i)
+        {
+            rects[i] = drawRect(context, static_cast<int32_t>(i % 8U));
+        }
+        EXPECT_EQ(PGL_TRUE, pglSwapBuffersRegion(surfaces[s], &rects[0], static_cast<uint32_t>(rects.size())));
+    }
+    EXPECT_EQ(static_cast<uint32_t>(WIDTH * HEIGHT * 4), pglGetSwapCopyBytes(window));
+    EXPECT_TRUE(sameContent(reference, window));
+}
+
+TEST(pglSwSwap, submitListAfterFlip)
+{
+    setenv("PGL_SW_BUFFERS", "2", 1);
+    pglInit();
+    PGLSurface window = pglCreateWindow(2, 0, 0, WIDTH, HEIGHT);
+    unsetenv("PGL_SW_BUFFERS");
+    ASSERT_TRUE(window != NULL);
+    PGLContext context = pglCreateContext(NULL);
+    ASSERT_TRUE(context != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
+    PGLList list = pglCreateList(context);
+    ASSERT_TRUE(list != NULL);
+    EXPECT_EQ(PGL_TRUE, pglBeginList(context, list));
+    const PGLRect rect = drawRect(context, 2);
+    EXPECT_EQ(PGL_TRUE, pglEndList(context));
+
+    // the list is recorded for the first buffer and drawn into both
+    for (int32_t i = 0; i < 2; ++i)
+    {
+        const PGL_SW_Pointer back = backBuffer(window);
+        memset(back, 0, static_cast<size_t>(WIDTH * HEIGHT * 4));
+        EXPECT_EQ(PGL_TRUE, pglSubmit(context, list));
+        const uint32_t pixel = *reinterpret_cast<const uint32_t*>(back + (rect.y1 >> 4) * WIDTH * 4 + (rect.x1 >> 4) * 4);
+        EXPECT_NE(0U, pixel) << i;
+        EXPECT_EQ(PGL_TRUE, pglSwapBuffers(window));
+        EXPECT_TRUE(back != backBuffer(window));
+    }
+}
@@ -0,0 +1,142 @@
+/******************************************************************************
+**
+**   File:        Pgl_sw_tiled_Test.cpp
+**   Description: Tests threaded (tiled) contexts of the SW renderer
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "pgl.h"
+#include "pgl_linux.h"
+#include "pgl_sw_renderer_glue.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+const int32_t WIDTH = 300; // not a multiple of the tile size
+const int32_t HEIGHT = 100;
+
+std::vector<uint32_t> createImage(int32_t w, int32_t h)
+{
+    std::vector<uint32_t> image(static_cast<size_t>(w * h));
+    for (int32_t y = 0; y < h; ++y)
+    {
+        for (int32_t x = 0; x < w; ++x)
+        {
+            const uint32_t alpha = ((x + y) % 3 == 0) ? 0x80U : 0xffU;
+            image[static_cast<size_t>(y * w + x)] = (alpha << 24) | (static_cast<uint32_t>(x * 6) << 16) | (static_cast<uint32_t>(y * 8) << 8) | static_cast<uint32_t>(x ^ y);
+        }
+    }
+    return image;
+}
+
+// Draws the same frame with every kind of command, which crosses several tile borders
+void drawFrame(PGLContext context, PGLTexture texture)
+{
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0x10, 0x20, 0x30, 0xff));
+    pglClear(context);
+    EXPECT_EQ(PGL_TRUE, pglSetColor(context, 0xff, 0x00, 0x00, 0x80));
+    pglDrawArea(context, 100 << 4, 20 << 4, 200 << 4, 70 << 4);
+    pglBindTexture(context, texture);
+    pglDrawQuad(context, 110 << 4, 15 << 4, 0, 0, 149 << 4, 44 << 4, 39 << 4, 29 << 4);
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(context, PGL_TRUE));
+    pglDrawQuad(context, 240 << 4, 80 << 4, 0, 0, 279 << 4, 109 << 4, 39 << 4, 29 << 4); // clipped at the surface border
+    EXPECT_EQ(PGL_TRUE, pglSetFilter(context, PGL_FILTER_LINEAR));
+    pglDrawQuad(context, 5 << 4, 5 << 4, 0, 0, 124 << 4, 94 << 4, 39 << 4, 29 << 4);
+    EXPECT_EQ(PGL_TRUE, pglSetClip(context, 120 << 4, 30 << 4, 260 << 4, 40 << 4));
+    pglDrawQuad(context, 0, 0, 0, 0, 299 << 4, 99 << 4, 39 << 4, 29 << 4);
+    EXPECT_EQ(PGL_TRUE, pglSetClip(context, 0, 0, (WIDTH - 1) << 4, (HEIGHT - 1) << 4));
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(context, PGL_FALSE));
+    EXPECT_EQ(PGL_TRUE, pglSetFilter(context, PGL_FILTER_NEAREST));
+}
+}
+
+TEST(pglSwTiled, sameResultAsImmediate)
+{
+    pglInit();
+    const std::vector<uint32_t> image = createImage(40, 30);
+    PGLSurface immediateWindow = pglCreateWindow(0, 0, 0, WIDTH, HEIGHT);
+    PGLSurface tiledWindow = pglCreateWindow(1, 0, 0, WIDTH, HEIGHT);
+    ASSERT_TRUE(immediateWindow != NULL);
+    ASSERT_TRUE(tiledWindow != NULL);
+    PGLContext immediate = pglCreateContext(NULL);
+    PGLContextConfig config = { 4U };
+    PGLContext tiled = pglCreateContext(&config);
+    ASSERT_TRUE(immediate != NULL);
+    ASSERT_TRUE(tiled != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(immediate, immediateWindow));
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(tiled, tiledWindow));
+    PGLTexture texture = pglCreateTexture(immediate);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(texture, 40, 30, PGL_FORMAT_BGRA_8888, PGL_FALSE, &image[0]));
+
+    drawFrame(immediate, texture);
+    drawFrame(tiled, texture);
+
+    // the commands are recorded until the frame is finished
+    PGL_SW_Surface expected;
+    PGL_SW_Surface actual;
+    EXPECT_EQ(PGL_TRUE, pglSurfaceToSWSurface(immediateWindow, &expected, NULL));
+    EXPECT_EQ(PGL_TRUE, pglSurfaceToSWSurface(tiledWindow, &actual, NULL));
+    EXPECT_EQ(0U, *reinterpret_cast<const uint32_t*>(actual.p));
+    EXPECT_EQ(PGL_TRUE, pglSwapBuffers(tiledWindow));
+    EXPECT_EQ(0, memcmp(expected.p, actual.p, static_cast<size_t>(expected.bytes)));
+
+    // pglVerify executes the recorded commands first
+    pglBindTexture(tiled, texture);
+    pglDrawQuad(tiled, 10 << 4, 60 << 4, 0, 0, 49 << 4, 89 << 4, 39 << 4, 29 << 4);
+    EXPECT_EQ(PGL_TRUE, pglVerify(tiled, 10 << 4, 60 << 4, 0, 0, 49 << 4, 89 << 4, 39 << 4, 29 << 4));
+    EXPECT_EQ(PGL_FALSE, pglVerify(tiled, 11 << 4, 60 << 4, 0, 0, 50 << 4, 89 << 4, 39 << 4, 29 << 4));
+}
+
+TEST(pglSwTiled, moreCommandsThanTheList)
+{
+    PGLSurface window = pglCreateWindow(2, 0, 0, WIDTH, HEIGHT);
+    PGLSurface other = pglCreateWindow(3, 0, 0, 8, 8);
+    ASSERT_TRUE(window != NULL);
+    ASSERT_TRUE(other != NULL);
+    PGLContextConfig config = { 2U };
+    PGLContext context = pglCreateContext(&config);
+    ASSERT_TRUE(context != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, window));
+
+    // a full list is rasterized and recording continues
+    const int32_t count = 2 * PGL_MAX_COMMANDS + 1;
+    for (int32_t i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(PGL_TRUE, pglSetColor(context, static_cast<uint8_t>(i), 0x40, 0x80, 0xff));
+        pglDrawArea(context, (i % WIDTH) << 4, (i / WIDTH) << 4, (i % WIDTH) << 4, (i / WIDTH) << 4);
+    }
+    // switching the surface rasterizes the commands of the previous one
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(context, other));
+
+    PGL_SW_Surface sw;
+    EXPECT_EQ(PGL_TRUE, pglSurfaceToSWSurface(window, &sw, NULL));
+    const uint32_t * pixels = reinterpret_cast<const uint32_t*>(sw.p);
+    for (int32_t i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(0xff004080U | (static_cast<uint32_t>(i & 0xff) << 16), pixels[i]);
+    }
+    EXPECT_EQ(0U, pixels[count]);
+}
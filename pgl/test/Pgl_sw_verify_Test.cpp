@@ -0,0 +1,301 @@
+/******************************************************************************
+**
+**   File:        Pgl_sw_verify_Test.cpp
+**   Description: Tests the tile CRC verification of the SW renderer
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "pgl.h"
+#include "pgl_linux.h"
+#include "RleEncoder.h"
+
+#include <vector>
+
+namespace
+{
+// not a multiple of the CRC tile size
+const int32_t TEX_W = 40;
+const int32_t TEX_H = 30;
+
+std::vector<uint32_t> createImage(uint32_t seed)
+{
+    std::vector<uint32_t> image(static_cast<size_t>(TEX_W * TEX_H));
+    for (size_t i = 0U; i < image.size(); ++i)
+    {
+        image[i] = 0xff000000U | static_cast<uint32_t>((i + seed) * 2654435761U >> 8 & 0x00ffffffU);
+    }
+    return image;
+}
+
+uint32_t& pixelAt(PGLSurface s, int32_t x, int32_t y)
+{
+    PGL_SW_Surface sw;
+    EXPECT_EQ(PGL_TRUE, pglSurfaceToSWSurface(s, &sw, NULL));
+    return *reinterpret_cast<uint32_t*>(sw.p + y * sw.alignment + x * 4);
+}
+}
+
+TEST(pglSwVerify, tileCrcsAndPixelsAgree)
+{
+    pglInit();
+    const std::vector<uint32_t> image = createImage(0U);
+    PGLSurface window = pglCreateWindow(0, 0, 0, 64, 64);
+    ASSERT_TRUE(window != NULL);
+    PGLContext pixels = pglCreateContext(NULL);
+    PGLContextConfig config = { 1U, PGL_VERIFY_TILE_CRC };
+    PGLContext crcs = pglCreateContext(&config);
+    ASSERT_TRUE(pixels != NULL);
+    ASSERT_TRUE(crcs != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(pixels, window));
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(crcs, window));
+    PGLTexture texture = pglCreateTexture(pixels);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(texture, TEX_W, TEX_H, PGL_FORMAT_BGRA_8888, PGL_FALSE, &image[0]));
+    pglBindTexture(pixels, texture);
+    pglBindTexture(crcs, texture);
+    pglDrawQuad(pixels, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4);
+
+    const PGLContext contexts[] = { pixels, crcs };
+    for (size_t i = 0U; i < 2U; ++i)
+    {
+        PGLContext ctx = contexts[i];
+        EXPECT_EQ(PGL_TRUE, pglVerify(ctx, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+        EXPECT_EQ(PGL_FALSE, pglVerify(ctx, 6 << 4, 7 << 4, 0, 0, 45 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+        // a part which starts at a tile border and a part which doesn't (verified pixel by pixel)
+        EXPECT_EQ(PGL_TRUE, pglVerify(ctx, 21 << 4, 23 << 4, 16 << 4, 16 << 4, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+        EXPECT_EQ(PGL_TRUE, pglVerify(ctx, 6 << 4, 8 << 4, 1 << 4, 1 << 4, 20 << 4, 20 << 4, 15 << 4, 13 << 4));
+    }
+
+    // a single bit in the last (smaller) tile
+    pixelAt(window, 44, 36) ^= 1U;
+    for (size_t i = 0U; i < 2U; ++i)
+    {
+        EXPECT_EQ(PGL_FALSE, pglVerify(contexts[i], 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+        EXPECT_EQ(PGL_TRUE, pglVerify(contexts[i], 5 << 4, 7 << 4, 0, 0, 36 << 4, 28 << 4, 31 << 4, 21 << 4));
+    }
+    pixelAt(window, 44, 36) ^= 1U;
+
+    // the CRCs are recalculated after the pixel data has changed
+    const std::vector<uint32_t> other = createImage(1U);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(texture, TEX_W, TEX_H, PGL_FORMAT_BGRA_8888, PGL_FALSE, &other[0]));
+    EXPECT_EQ(PGL_FALSE, pglVerify(crcs, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+    pglDrawQuad(crcs, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4);
+    EXPECT_EQ(PGL_TRUE, pglVerify(crcs, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+
+    // the CRCs of a texture of the CRC context are calculated when it is loaded: pixels changed afterwards are detected
+    std::vector<uint32_t> loaded = createImage(2U);
+    PGLTexture crcTexture = pglCreateTexture(crcs);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(crcTexture, TEX_W, TEX_H, PGL_FORMAT_BGRA_8888, PGL_FALSE, &loaded[0]));
+    loaded[0] ^= 1U;
+    pglBindTexture(crcs, crcTexture);
+    pglDrawQuad(crcs, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4);
+    EXPECT_EQ(PGL_FALSE, pglVerify(crcs, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+    EXPECT_EQ(PGL_TRUE, pglVerify(crcs, 6 << 4, 8 << 4, 1 << 4, 1 << 4, 20 << 4, 20 << 4, 15 << 4, 13 << 4));
+    pglBindTexture(crcs, texture);
+    pglDrawQuad(crcs, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4);
+
+    // a clipped quad is verified pixel by pixel
+    EXPECT_EQ(PGL_TRUE, pglSetClip(crcs, 0, 0, 20 << 4, 20 << 4));
+    EXPECT_EQ(PGL_TRUE, pglVerify(crcs, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+    pixelAt(window, 30, 30) ^= 1U;
+    EXPECT_EQ(PGL_TRUE, pglVerify(crcs, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+}
+
+TEST(pglSwVerify, encodedTextures)
+{
+    pglInit();
+    std::vector<uint32_t> image = createImage(2U);
+    for (int32_t x = 0; x < TEX_W; ++x)
+    {
+        image[x] = 0U; // a transparent row
+        image[TEX_W + x] = 0xff00ff00U; // an opaque one
+    }
+    const std::vector<uint8_t> rle = encodeRle(&image[0], TEX_W, TEX_H, 4);
+    // FastLZ: 4 literal bytes, a match of the first pixel and 8 literal bytes
+    const uint32_t small[] = { 0xff112233U, 0xff112233U, 0xff445566U, 0xff445566U };
+    const uint8_t flz[] = { 0x03, 0x33, 0x22, 0x11, 0xff, 0x40, 0x03, 0x07, 0x66, 0x55, 0x44, 0xff, 0x66, 0x55, 0x44, 0xff };
+
+    PGLSurface window = pglCreateWindow(1, 0, 0, 64, 64);
+    ASSERT_TRUE(window != NULL);
+    PGLContext ctx = pglCreateContext(NULL);
+    ASSERT_TRUE(ctx != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(ctx, window));
+    PGLTexture encoded = pglCreateTexture(ctx);
+    PGLTexture decoded = pglCreateTexture(ctx);
+    EXPECT_EQ(PGL_TRUE, pglLoadTextureEncoded(encoded, TEX_W, TEX_H, PGL_FORMAT_BGRA_8888, PGL_ENCODING_RLE, static_cast<uint32_t>(rle.size()), &rle[0]));
+    EXPECT_EQ(PGL_TRUE, pglLoadTextureEncoded(decoded, 2U, 2U, PGL_FORMAT_BGRA_8888, PGL_ENCODING_FLZ, sizeof(flz), flz));
+
+    // the RLE texture is blended and verified without decompression
+    EXPECT_EQ(PGL_TRUE, pglSetColor(ctx, 0, 0, 0xff, 0xff));
+    pglClear(ctx);
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(ctx, PGL_TRUE));
+    pglBindTexture(ctx, encoded);
+    pglDrawQuad(ctx, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4);
+    EXPECT_EQ(0xff0000ffU, pixelAt(window, 5, 7));
+    EXPECT_EQ(0xff00ff00U, pixelAt(window, 5, 8));
+    EXPECT_EQ(image[5 * TEX_W + 3], pixelAt(window, 8, 12));
+    EXPECT_EQ(PGL_TRUE, pglVerify(ctx, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+    EXPECT_EQ(PGL_TRUE, pglVerify(ctx, 6 << 4, 8 << 4, 1 << 4, 1 << 4, 20 << 4, 20 << 4, 15 << 4, 13 << 4));
+    pixelAt(window, 30, 30) ^= 1U;
+    EXPECT_EQ(PGL_FALSE, pglVerify(ctx, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+    // scaled quads of RLE textures are decoded at the first use, they look like the ones of the raw texture
+    pglClear(ctx);
+    pglDrawQuad(ctx, 0, 0, 0, 0, 63 << 4, 63 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4);
+    EXPECT_EQ(PGL_TRUE, pglVerify(ctx, 0, 0, 0, 0, 63 << 4, 63 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+    std::vector<uint32_t> scaled;
+    for (int32_t y = 0; y < 64; ++y)
+    {
+        for (int32_t x = 0; x < 64; ++x)
+        {
+            scaled.push_back(pixelAt(window, x, y));
+        }
+    }
+    PGLTexture raw = pglCreateTexture(ctx);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(raw, TEX_W, TEX_H, PGL_FORMAT_BGRA_8888, PGL_FALSE, &image[0]));
+    pglBindTexture(ctx, raw);
+    pglClear(ctx);
+    pglDrawQuad(ctx, 0, 0, 0, 0, 63 << 4, 63 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4);
+    for (int32_t y = 0; y < 64; ++y)
+    {
+        for (int32_t x = 0; x < 64; ++x)
+        {
+            EXPECT_EQ(scaled[y * 64 + x], pixelAt(window, x, y));
+        }
+    }
+    pglBindTexture(ctx, encoded);
+    pixelAt(window, 30, 30) ^= 1U;
+    EXPECT_EQ(PGL_FALSE, pglVerify(ctx, 0, 0, 0, 0, 63 << 4, 63 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+
+    // the FLZ texture is decompressed when it is loaded
+    pglBindTexture(ctx, decoded);
+    pglDrawQuad(ctx, 50 << 4, 50 << 4, 0, 0, 51 << 4, 51 << 4, 1 << 4, 1 << 4);
+    EXPECT_EQ(small[0], pixelAt(window, 50, 50));
+    EXPECT_EQ(small[3], pixelAt(window, 51, 51));
+    EXPECT_EQ(PGL_TRUE, pglVerify(ctx, 50 << 4, 50 << 4, 0, 0, 51 << 4, 51 << 4, 1 << 4, 1 << 4));
+
+    // reloaded textures reuse their memory: 2 textures growing from 50 to 200 KB need more than the texture memory in total,
+    // but they fit at any time
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(ctx, PGL_FALSE));
+    PGLTexture reloaded[] = { pglCreateTexture(ctx), pglCreateTexture(ctx) };
+    const uint32_t w = 128U;
+    for (uint32_t h = 100U; h <= 400U; h += 100U)
+    {
+        for (uint32_t i = 0U; i < 2U; ++i)
+        {
+            std::vector<uint32_t> image(w * h, 0xff000000U | (h + i));
+            // FastLZ literal runs of at most 32 bytes
+            std::vector<uint8_t> flz;
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&image[0]);
+            for (size_t offset = 0U; offset < image.size() * 4U; offset += 32U)
+            {
+                flz.push_back(31U);
+                flz.insert(flz.end(), bytes + offset, bytes + offset + 32U);
+            }
+            EXPECT_EQ(PGL_TRUE, pglLoadTextureEncoded(reloaded[i], w, h, PGL_FORMAT_BGRA_8888, PGL_ENCODING_FLZ, static_cast<uint32_t>(flz.size()), &flz[0]));
+        }
+        for (uint32_t i = 0U; i < 2U; ++i)
+        {
+            pglBindTexture(ctx, reloaded[i]);
+            pglDrawQuad(ctx, 0, 0, 0, 0, 7 << 4, 7 << 4, 7 << 4, 7 << 4);
+            EXPECT_EQ(0xff000000U | (h + i), pixelAt(window, 3, 3));
+        }
+    }
+}
+
+TEST(pglSwVerify, paletteTextures)
+{
+    pglInit();
+    // a telltale with a transparent border, 3 colors
+    const uint32_t colors[] = { 0x00000000U, 0xff20c040U, 0x8020c040U };
+    std::vector<uint8_t> indices(static_cast<size_t>(TEX_W * TEX_H), 0U);
+    for (int32_t y = 2; y < TEX_H - 2; ++y)
+    {
+        for (int32_t x = 2; x < TEX_W - 2; ++x)
+        {
+            indices[y * TEX_W + x] = (x == 2) ? 2U : 1U;
+        }
+    }
+
+    PGLSurface window = pglCreateWindow(2, 0, 0, 64, 64);
+    ASSERT_TRUE(window != NULL);
+    PGLContext ctx = pglCreateContext(NULL);
+    ASSERT_TRUE(ctx != NULL);
+    EXPECT_EQ(PGL_TRUE, pglSetSurface(ctx, window));
+    PGLTexture texture = pglCreateTexture(ctx);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexturePalette(texture, TEX_W, TEX_H, PGL_FORMAT_P_8_BGRA_8888, PGL_FALSE, &indices[0], 3U, colors));
+    EXPECT_EQ(PGL_TRUE, pglSetColor(ctx, 0, 0, 0xff, 0xff));
+    pglClear(ctx);
+    pglBindTexture(ctx, texture);
+
+    // blended: the border keeps the background
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(ctx, PGL_TRUE));
+    pglDrawQuad(ctx, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4);
+    EXPECT_EQ(0xff0000ffU, pixelAt(window, 5, 7));
+    EXPECT_EQ(colors[1], pixelAt(window, 10, 10));
+    EXPECT_EQ(PGL_TRUE, pglVerify(ctx, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+    pixelAt(window, 10, 10) ^= 1U;
+    EXPECT_EQ(PGL_FALSE, pglVerify(ctx, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+
+    // copied
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(ctx, PGL_FALSE));
+    pglDrawQuad(ctx, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4);
+    EXPECT_EQ(0U, pixelAt(window, 5, 7));
+    EXPECT_EQ(PGL_TRUE, pglVerify(ctx, 5 << 4, 7 << 4, 0, 0, 44 << 4, 36 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+    EXPECT_EQ(PGL_TRUE, pglVerify(ctx, 8 << 4, 9 << 4, 3 << 4, 2 << 4, 20 << 4, 20 << 4, 15 << 4, 13 << 4));
+    EXPECT_EQ(PGL_FALSE, pglVerify(ctx, 0, 0, 0, 0, 63 << 4, 63 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+
+    // scaled quads expand the colors at the first use, they look like the ones of a raw texture with these colors
+    EXPECT_EQ(PGL_TRUE, pglSetBlending(ctx, PGL_TRUE));
+    EXPECT_EQ(PGL_TRUE, pglSetFilter(ctx, PGL_FILTER_LINEAR));
+    pglClear(ctx);
+    pglDrawQuad(ctx, 0, 0, 0, 0, 63 << 4, 63 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4);
+    EXPECT_EQ(PGL_TRUE, pglVerify(ctx, 0, 0, 0, 0, 63 << 4, 63 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+    std::vector<uint32_t> scaled;
+    for (int32_t y = 0; y < 64; ++y)
+    {
+        for (int32_t x = 0; x < 64; ++x)
+        {
+            scaled.push_back(pixelAt(window, x, y));
+        }
+    }
+    std::vector<uint32_t> expanded;
+    for (size_t i = 0U; i < indices.size(); ++i)
+    {
+        expanded.push_back(colors[indices[i]]);
+    }
+    PGLTexture raw = pglCreateTexture(ctx);
+    EXPECT_EQ(PGL_TRUE, pglLoadTexture(raw, TEX_W, TEX_H, PGL_FORMAT_BGRA_8888, PGL_FALSE, &expanded[0]));
+    pglBindTexture(ctx, raw);
+    pglClear(ctx);
+    pglDrawQuad(ctx, 0, 0, 0, 0, 63 << 4, 63 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4);
+    for (int32_t y = 0; y < 64; ++y)
+    {
+        for (int32_t x = 0; x < 64; ++x)
+        {
+            EXPECT_EQ(scaled[y * 64 + x], pixelAt(window, x, y));
+        }
+    }
+    pglBindTexture(ctx, texture);
+    pixelAt(window, 30, 30) ^= 1U;
+    EXPECT_EQ(PGL_FALSE, pglVerify(ctx, 0, 0, 0, 0, 63 << 4, 63 << 4, (TEX_W - 1) << 4, (TEX_H - 1) << 4));
+}
@@ -63,7 +63,7 @@ TEST(pgl, drawBitmap)
     pglInit();
     PGLSurface window = pglCreateWindow(0, 0, 0, 400, 240);
     EXPECT_TRUE(window != NULL);
-    PGLContext context = pglCreateContext();
+    PGLContext context = pglCreateContext(NULL);
     EXPECT_TRUE(context != NULL);
     pglSetSurface(context, window);
     //pglSetColor(context, 0xff, 0x00, 0xff, 0xff);
@@ -0,0 +1,77 @@
+#ifndef PGL_TEST_RLE_ENCODER_H
+#define PGL_TEST_RLE_ENCODER_H
+
+/******************************************************************************
+**
+**   File:        RleEncoder.h
+**   Description: Creates PGL_ENCODING_RLE data for the tests of the decoders and the RLE kernels
+**
+**   Copyright (C) 2017 Luxoft GmbH
+**
+**   This file is part of Safe Renderer.
+**
+**   Safe Renderer is free software: you can redistribute it and/or
+**   modify it under the terms of the GNU Lesser General Public
+**   License as published by the Free Software Foundation.
+**
+**   Safe Renderer is distributed in the hope that it will be useful,
+**   but WITHOUT ANY WARRANTY; without even the implied warranty of
+**   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+**   Lesser General Public License for more details.
+**
+**   You should have received a copy of the GNU Lesser General Public
+**   License along with Safe Renderer.  If not, see
+**   <http://www.gnu.org/licenses/>.
+**
+**   SPDX-License-Identifier: LGPL-3.0
+**
+******************************************************************************/
+
+#include <stdint.h>
+#include <cstring>
+#include <vector>
+
+/**
+ * Encodes the rows of an image: repeated pixels become runs, all others literal packets (at most 128 pixels each)
+ * @param swapped reverses the bytes of each pixel (PGL_ENCODING_RLE2)
+ */
+inline std::vector<uint8_t> encodeRle(const void* image, int32_t width, int32_t height, int32_t bpp, bool swapped = false)
+{
+    const uint8_t* pixels = static_cast<const uint8_t*>(image);
+    std::vector<uint8_t> data;
+    for (int32_t y = 0; y < height; ++y)
+    {
+        const uint8_t* row = pixels + y * width * bpp;
+        int32_t x = 0;
+        while (x < width)
+        {
+            int32_t n = 1;
+            while (((x + n) < width) && (n < 128) && (memcmp(row + x * bpp, row + (x + n) * bpp, bpp) == 0))
+            {
+                ++n;
+            }
+            const bool run = (n > 1);
+            if (!run)
+            {
+                // literal pixels up to the next repetition
+                while (((x + n) < width) && (n < 128)
+                    && (((x + n + 1) >= width) || (memcmp(row + (x + n) * bpp, row + (x + n + 1) * bpp, bpp) != 0)))
+                {
+                    ++n;
+                }
+            }
+            data.push_back(static_cast<uint8_t>((run ? 0x80 : 0x00) | (n - 1)));
+            for (int32_t i = 0; i < (run ? 1 : n); ++i)
+            {
+                for (int32_t b = 0; b < bpp; ++b)
+                {
+                    data.push_back(row[(x + i) * bpp + (swapped ? (bpp - 1 - b) : b)]);
+                }
+            }
+            x += n;
+        }
+    }
+    return data;
+}
+
+#endif // PGL_TEST_RLE_ENCODER_H